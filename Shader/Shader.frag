@@ -1,11 +1,33 @@
 #version 460
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Slot of the material table in the bindless storage buffer array
+const uint MATERIAL_BUFFER_INDEX = 0;
+
+// Specialization constants, see GraphicsPipelineKey
+layout (constant_id = 0) const float UV_SCALE = 2.0;
+layout (constant_id = 1) const bool ALBEDO_TEXTURE = true;
+
+struct Material {
+    vec4 baseColor;
+    uint albedoTextureIndex;
+};
 
 layout (location = 0) in vec3 fragColor;
 layout (location = 1) in vec2 fragTexCoord;
+layout (location = 2) flat in uint fragMaterialIndex;
 layout (location = 0) out vec4 outColor;
 
-layout (binding = 1) uniform sampler2D texSampler;
+layout (set = 1, binding = 0) uniform sampler2D textures[];
+layout (set = 1, binding = 1) readonly buffer MaterialBuffer {
+    Material materials[];
+} storageBuffers[];
 
 void main() {
-    outColor = vec4(fragColor * texture(texSampler, fragTexCoord * 2.0).rgb, 1.0);
+    Material material = storageBuffers[MATERIAL_BUFFER_INDEX].materials[fragMaterialIndex];
+    vec3 albedo = vec3(1.0);
+    if (ALBEDO_TEXTURE) {
+        albedo = texture(textures[nonuniformEXT(material.albedoTextureIndex)], fragTexCoord * UV_SCALE).rgb;
+    }
+    outColor = vec4(fragColor * material.baseColor.rgb * albedo, material.baseColor.a);
 }
@@ -1,20 +1,28 @@
 # version 460
 
-layout (binding = 0) uniform UniformBufferObject {
-    mat4 model;
+layout (set = 0, binding = 0) uniform UniformBufferObject {
     mat4 view;
     mat4 projection;
 } ubo;
 
+layout (push_constant) uniform PushConstantObject {
+    mat4 model;
+    uint materialIndex;
+} object;
+
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inColor;
 layout (location = 2) in vec2 inTexCoord;
 
 layout (location = 0) out vec3 fragColor;
 layout (location = 1) out vec2 fragTexCoord;
+layout (location = 2) flat out uint fragMaterialIndex;
+// The depth prepass and the EQUAL tested shading pass must compute bit identical depth
+invariant gl_Position;
 
 void main() {
-    gl_Position = ubo.projection * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.projection * ubo.view * object.model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
+    fragMaterialIndex = object.materialIndex;
 }
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+namespace LearnVulkan::Benchmark
+{
+    struct BenchmarkCase
+    {
+        const char* suite;
+        const char* name;
+        void (*function)();
+    };
+
+    std::vector<BenchmarkCase>& getBenchmarkCases();
+
+    struct BenchmarkRegistrar
+    {
+        BenchmarkRegistrar(const char* suite, const char* name, void (*function)()) { getBenchmarkCases().push_back({suite, name, function}); }
+    };
+
+    // Wall time of one call
+    template<typename Function>
+    double measureMilliseconds(Function&& function)
+    {
+        auto begin = std::chrono::high_resolution_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+    }
+}  // namespace LearnVulkan::Benchmark
+
+// Defines a benchmark, suite is the file name without its Benchmark suffix
+#define LEARN_VULKAN_BENCHMARK(suite, name)                                                                            \
+    static void suite##_##name();                                                                                      \
+    static const LearnVulkan::Benchmark::BenchmarkRegistrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
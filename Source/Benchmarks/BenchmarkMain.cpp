@@ -0,0 +1,39 @@
+// Runs the CPU side benchmarks, those of one suite when its name is given. Correctness is left to the tests, this
+// only prints timings. Benchmarks that need a Vulkan device run at startup with bRunStartupBenchmarks instead.
+//
+// Usage: Benchmarks [suite]
+
+#include "Benchmark.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace LearnVulkan;
+
+std::vector<Benchmark::BenchmarkCase>& Benchmark::getBenchmarkCases()
+{
+    static std::vector<BenchmarkCase> benchmarkCases;
+    return benchmarkCases;
+}
+
+int main(int argc, char** argv)
+{
+    const char* suite = argc > 1 ? argv[1] : nullptr;
+    size_t runCount = 0;
+    for (const Benchmark::BenchmarkCase& benchmarkCase : Benchmark::getBenchmarkCases())
+    {
+        if (suite && std::strcmp(suite, benchmarkCase.suite) != 0)
+        {
+            continue;
+        }
+        std::cout << benchmarkCase.suite << "." << benchmarkCase.name << std::endl;
+        benchmarkCase.function();
+        runCount++;
+    }
+    if (runCount == 0)
+    {
+        std::cerr << "No benchmarks in suite " << (suite ? suite : "") << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
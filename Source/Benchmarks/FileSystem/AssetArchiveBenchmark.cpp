@@ -0,0 +1,49 @@
+#include "Benchmark.hpp"
+#include "FileSystem/AssetArchive.hpp"
+#include "FileSystem/MappedFile.hpp"
+#include "FileSystem/SyntheticAssets.hpp"
+#include <filesystem>
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+// Cold reads come from the disk where the page cache can be dropped, warm ones from memory, where decompression
+// dominates
+LEARN_VULKAN_BENCHMARK(AssetArchive, LoadAndReadEveryFile)
+{
+    TemporaryDirectory directory;
+    std::map<std::string, std::vector<std::byte>> assets = makeSyntheticAssets();
+    for (bool bCompress : {false, true})
+    {
+        AssetArchiveWriter writer;
+        for (const auto& [path, bytes] : assets)
+        {
+            writer.addFile(path, bytes, bCompress);
+        }
+        std::string archivePath = (directory.getPath() / (bCompress ? "Compressed.pak" : "Stored.pak")).string();
+        writer.write(archivePath);
+
+        for (bool bCold : {true, false})
+        {
+            if (bCold && !evictFromPageCache(archivePath))
+            {
+                continue;
+            }
+            size_t readBytes = 0;
+            double milliseconds = measureMilliseconds([&] {
+                ArchiveFileSource archive;
+                archive.load(archivePath);
+                for (const auto& [path, bytes] : assets)
+                {
+                    FileView view;
+                    archive.open(path, view);
+                    readBytes += view.getBytes().size();
+                }
+            });
+            std::cout << "  " << (bCompress ? "LZ4" : "stored") << " archive of " << std::filesystem::file_size(archivePath) / 1024 << " KiB, " << (bCold ? "cold" : "warm")
+                      << ": " << readBytes / 1024 << " KiB loaded and read in " << milliseconds << " ms" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include "Benchmark.hpp"
+#include "FileSystem/AsyncFileReader.hpp"
+#include "FileSystem/MappedFile.hpp"
+#include "FileSystem/TemporaryDirectory.hpp"
+#include <atomic>
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+// Many small files like a material's textures and a few large ones like packed archives. Cold reads come from the
+// disk where the page cache can be dropped, warm ones from memory.
+LEARN_VULKAN_BENCHMARK(AsyncFileReader, ReadSmallAndLargeFiles)
+{
+    const uint32_t SMALL_FILE_COUNT = 200;
+    const size_t SMALL_FILE_SIZE = 4 * 1024;
+    const uint32_t LARGE_FILE_COUNT = 2;
+    const size_t LARGE_FILE_SIZE = 8 * 1024 * 1024;
+
+    TemporaryDirectory directory;
+    std::vector<std::string> paths;
+    for (uint32_t i = 0; i < SMALL_FILE_COUNT + LARGE_FILE_COUNT; i++)
+    {
+        paths.push_back(directory.writeFile("File" + std::to_string(i), makeRandomBytes(i < SMALL_FILE_COUNT ? SMALL_FILE_SIZE : LARGE_FILE_SIZE, i)));
+    }
+
+    for (AsyncFileBackend backend : {AsyncFileBackend::IoUring, AsyncFileBackend::ThreadPool})
+    {
+        AsyncFileReader reader;
+        reader.start(backend, 4);
+        for (bool bCold : {true, false})
+        {
+            if (bCold)
+            {
+                bool bEvicted = true;
+                for (const std::string& path : paths)
+                {
+                    bEvicted = evictFromPageCache(path) && bEvicted;
+                }
+                if (!bEvicted)
+                {
+                    continue;
+                }
+            }
+            std::atomic<size_t> readBytes = 0;
+            double milliseconds = measureMilliseconds([&] {
+                for (const std::string& path : paths)
+                {
+                    reader.read(path, [&](FileReadResult& result) { readBytes += result.bytes.size(); });
+                }
+                reader.wait();
+            });
+            std::cout << "  " << (reader.getBackend() == AsyncFileBackend::IoUring ? "io_uring" : "thread pool") << ", " << (bCold ? "cold" : "warm") << ": " << paths.size()
+                      << " files, " << readBytes / (1024 * 1024) << " MiB in " << milliseconds << " ms" << std::endl;
+        }
+    }
+}
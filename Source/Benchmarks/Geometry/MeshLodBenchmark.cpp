@@ -0,0 +1,20 @@
+#include "Benchmark.hpp"
+#include "Geometry/MeshLod.hpp"
+#include "Geometry/SphereMesh.hpp"
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+LEARN_VULKAN_BENCHMARK(MeshLod, BuildLodChain)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    buildUvSphere(512, 256, vertices, indices);
+    size_t triangleCount = indices.size() / 3;
+    std::vector<MeshLod> lods;
+    double milliseconds = measureMilliseconds([&] { lods = buildMeshLods(vertices, indices, 6); });
+    std::cout << "  LOD chain of " << triangleCount << " triangles: " << lods.size() << " levels in " << milliseconds << " ms, " << triangleCount / milliseconds / 1e3 << " Mtris/s"
+              << std::endl;
+}
@@ -0,0 +1,24 @@
+#include "Benchmark.hpp"
+#include "Geometry/Meshlet.hpp"
+#include "Geometry/SphereMesh.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+// Fill shows how much of each meshlet's triangle budget the builder manages to use
+LEARN_VULKAN_BENCHMARK(Meshlet, BuildSphereMeshlets)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    buildUvSphere(512, 256, vertices, indices);
+    size_t triangleCount = indices.size() / 3;
+    MeshletMesh mesh;
+    double milliseconds = measureMilliseconds([&] { mesh = buildMeshlets(vertices, indices); });
+    size_t meshletCount = std::max<size_t>(mesh.meshlets.size(), 1);
+    std::cout << "  " << mesh.meshlets.size() << " meshlets in " << milliseconds << " ms, " << static_cast<double>(mesh.vertices.size()) / meshletCount << " vertices and "
+              << static_cast<double>(triangleCount) / meshletCount << " triangles per meshlet (" << 100.0 * triangleCount / (meshletCount * MESHLET_MAX_TRIANGLES)
+              << "% triangle fill)" << std::endl;
+}
@@ -0,0 +1,33 @@
+#include "Benchmark.hpp"
+#include "Memory/TransientFrameWorkload.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+// The same frame temporaries on the heap and from a frame allocator and a pool, after a warmup that grows the
+// allocator to its working size
+LEARN_VULKAN_BENCHMARK(LinearAllocator, TransientFrames)
+{
+    const uint32_t WARMUP_FRAMES = 16;
+    const uint32_t FRAME_COUNT = 100;
+    TransientFrameWorkload workload;
+    for (bool bFrameAllocator : {false, true})
+    {
+        double maxMilliseconds = 0.0;
+        double totalMilliseconds = 0.0;
+        for (uint32_t frame = 0; frame < WARMUP_FRAMES + FRAME_COUNT; frame++)
+        {
+            double milliseconds = measureMilliseconds([&] { workload.runFrame(bFrameAllocator, frame); });
+            if (frame >= WARMUP_FRAMES)
+            {
+                maxMilliseconds = std::max(maxMilliseconds, milliseconds);
+                totalMilliseconds += milliseconds;
+            }
+        }
+        std::cout << "  " << (bFrameAllocator ? "Frame allocator and pool" : "Heap") << ": mean " << totalMilliseconds / FRAME_COUNT << " ms, max " << maxMilliseconds << " ms"
+                  << std::endl;
+    }
+}
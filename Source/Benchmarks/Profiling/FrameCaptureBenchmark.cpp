@@ -0,0 +1,39 @@
+#include "Benchmark.hpp"
+#include "FileSystem/TemporaryDirectory.hpp"
+#include "Profiling/FrameDraws.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+// Capturing runs every frame, so each write is timed with draw lists the size of a busy scene
+LEARN_VULKAN_BENCHMARK(FrameCapture, RingWrites)
+{
+    const uint32_t DRAW_COUNT = 10000;
+    const uint32_t FRAME_COUNT = 1000;
+    TemporaryDirectory directory;
+    FrameDraws draws(DRAW_COUNT);
+    FrameCaptureWriter writer;
+    if (!writer.open((directory.getPath() / "Frames.lvfc").string(), 4 * 1024 * 1024))
+    {
+        std::cout << "  Failed to open the capture" << std::endl;
+        return;
+    }
+
+    double maxMicroseconds = 0.0;
+    double meanMicroseconds = 0.0;
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        draws.update(frame);
+        FrameCaptureRecord record;
+        record.frameIndex = frame;
+        double microseconds = measureMilliseconds([&] { writer.write(record, draws.depthPrepassDraws, draws.shadingDraws, draws.objectLods); }) * 1000.0;
+        maxMicroseconds = std::max(maxMicroseconds, microseconds);
+        meanMicroseconds += microseconds / FRAME_COUNT;
+    }
+    double frameKilobytes = (sizeof(FrameCaptureRecord) + (DRAW_COUNT + DRAW_COUNT / 4) * sizeof(FrameCaptureDraw)) / 1024.0;
+    std::cout << "  " << FRAME_COUNT << " frames of " << frameKilobytes << " KiB, " << writer.getFrameCount() << " kept: write mean " << meanMicroseconds << " us, max "
+              << maxMicroseconds << " us, " << frameKilobytes / 1024.0 / (meanMicroseconds * 1e-6) << " MiB/s" << std::endl;
+}
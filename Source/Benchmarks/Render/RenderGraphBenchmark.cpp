@@ -0,0 +1,28 @@
+#include "Benchmark.hpp"
+#include "Render/RenderGraph.hpp"
+#include "Render/SyntheticRenderGraph.hpp"
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+// The graph is rebuilt every frame, so its compile is part of every frame's CPU time
+LEARN_VULKAN_BENCHMARK(RenderGraph, CompileSyntheticGraphs)
+{
+    const int ITERATIONS = 16;
+    for (uint32_t passCount : {100u, 250u, 500u, 1000u})
+    {
+        RenderGraph graph;
+        buildSyntheticRenderGraph(graph, passCount, passCount);
+        double totalMilliseconds = 0.0;
+        for (int iteration = 0; iteration < ITERATIONS; iteration++)
+        {
+            totalMilliseconds += measureMilliseconds([&] { graph.compile(); });
+        }
+        const RenderGraphStatistics& statistics = graph.getStatistics();
+        std::cout << "  " << passCount << " passes: " << totalMilliseconds * 1000.0 / ITERATIONS << " us, " << statistics.culledPassCount << " culled, " << statistics.levelCount
+                  << " levels, " << statistics.barrierCount << " barriers, " << statistics.aliasedImageCount << " aliased images, " << statistics.transientBytes / (1024 * 1024)
+                  << " -> " << statistics.aliasedBytes / (1024 * 1024) << " MiB" << std::endl;
+    }
+}
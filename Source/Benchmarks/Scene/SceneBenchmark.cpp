@@ -0,0 +1,26 @@
+#include "Benchmark.hpp"
+#include "Scene/RandomHierarchy.hpp"
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+// Every transform is marked changed before each update, the worst case a frame can see
+LEARN_VULKAN_BENCHMARK(Scene, FullTransformUpdate)
+{
+    const uint32_t ENTITY_COUNT = 100000;
+    RandomHierarchy hierarchy(ENTITY_COUNT);
+    Scene& scene = hierarchy.scene;
+    const SceneUpdateStatistics& statistics = scene.getUpdateStatistics();
+    // 0 is every core
+    for (uint32_t threadCount : {1u, 4u, 0u})
+    {
+        for (Entity entity : hierarchy.entities)
+        {
+            scene.setLocalTransform(entity, scene.getLocalTransform(entity));
+        }
+        scene.updateTransforms(threadCount);
+        std::cout << "  Full update of " << ENTITY_COUNT << " transforms in " << statistics.levelCount << " levels on " << statistics.threadCount << " threads: "
+                  << statistics.milliseconds << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,45 @@
+#include "Benchmark.hpp"
+#include "VulkanUtility/DeviceMemoryTracker.hpp"
+#include "VulkanUtility/FakeVulkanHandles.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+// Tracking sits on every allocation and free, from whichever thread makes them
+LEARN_VULKAN_BENCHMARK(DeviceMemoryTracker, ConcurrentTracking)
+{
+    const uint64_t TRACKED_COUNT = 100000;
+    const VkDeviceSize BUFFER_SIZE = 4096;
+    for (uint64_t threadCount : {1, 4})
+    {
+        DeviceCapabilities capabilities;
+        DeviceMemoryTracker tracker;
+        tracker.initialize(capabilities, false);
+        auto runOnThreads = [&](auto&& track) {
+            std::vector<std::thread> threads;
+            for (uint64_t thread = 0; thread < threadCount; thread++)
+            {
+                threads.emplace_back([&, thread]() {
+                    for (uint64_t i = thread + 1; i <= TRACKED_COUNT; i += threadCount)
+                    {
+                        track(i);
+                    }
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        };
+        double milliseconds = measureMilliseconds([&] {
+            runOnThreads([&](uint64_t i) { tracker.add(makeFakeHandle<VkDeviceMemory>(i), 0, BUFFER_SIZE, DeviceMemoryCategory::Vertex); });
+            runOnThreads([&](uint64_t i) { tracker.remove(i); });
+            tracker.endFrame(0);
+        });
+        std::cout << "  Track add and remove: " << milliseconds * 1000000.0 / TRACKED_COUNT << " ns/allocation on " << threadCount << " threads" << std::endl;
+    }
+}
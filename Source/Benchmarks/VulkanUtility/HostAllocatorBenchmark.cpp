@@ -0,0 +1,21 @@
+#include "Benchmark.hpp"
+#include "VulkanUtility/CommandChurn.hpp"
+#include <iostream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Benchmark;
+using namespace LearnVulkan::Test;
+
+LEARN_VULKAN_BENCHMARK(HostAllocator, CommandChurn)
+{
+    const uint32_t ALLOCATION_COUNT = 200000;
+    for (bool bPooled : {false, true})
+    {
+        HostAllocator allocator;
+        allocator.initialize(true, bPooled);
+        double milliseconds = measureMilliseconds([&] { runCommandChurn(allocator, ALLOCATION_COUNT); });
+        HostAllocationStatistics total = allocator.getTotalStatistics();
+        std::cout << "  " << (bPooled ? "Pooled" : "malloc") << ": " << ALLOCATION_COUNT << " allocations in " << milliseconds << " ms, peak " << total.peakBytes / 1024 << " KiB, "
+                  << 100.0 * allocator.getPooledAllocationCount() / total.allocationCount << "% pooled" << std::endl;
+    }
+}
@@ -1,9 +1,17 @@
 #include "Application/Application.hpp"
-#include "FileSystem/FileReader.hpp"
+#include "FileSystem/AssetArchive.hpp"
+#include "Memory/AllocationCounter.hpp"
+#include "Shader/ShaderFrag.hpp"
+#include "Shader/ShaderVert.hpp"
+#include "Task/TaskGraph.hpp"
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
@@ -11,6 +19,9 @@
 #include <iostream>
 #include <limits>
 #include <set>
+#include <stdexcept>
+#include <streambuf>
+#include <unordered_set>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #define TINYOBJLOADER_IMPLEMENTATION
@@ -19,26 +30,77 @@
 
 using namespace LearnVulkan;
 
+namespace
+{
+    // Part of the derived data keys, bump them whenever an importer, its settings or its output change
+    const uint32_t TEXTURE_IMPORTER_VERSION = 1;
+    const uint32_t MODEL_IMPORTER_VERSION = 1;
+    const uint32_t MESHLET_IMPORTER_VERSION = 1;
+
+    // Grows to the largest frame on overflow, enough for the draw lists of tens of thousands of objects up front
+    const size_t FRAME_ALLOCATOR_CAPACITY = 1024 * 1024;
+    // Lets lazily compiled pipelines, the frame allocator and reused containers reach their working size
+    const uint32_t ALLOCATION_CHECK_WARMUP_FRAMES = 120;
+    // Long enough for frames in flight and retired objects to drain between two samples
+    const uint64_t GROWTH_CHECK_FRAMES = 1000;
+    // Querying the budget is a driver call, heaps only change slowly
+    const uint64_t MEMORY_BUDGET_UPDATE_FRAMES = 60;
+
+    // Thrown once an initialization step has set mbQuit, so the task graph skips every step that has not started
+    struct InitializationStepFailed : std::runtime_error
+    {
+        using std::runtime_error::runtime_error;
+    };
+
+    // Lets tinyobjloader parse straight out of a mapped file
+    class TextStreamBuffer : public std::streambuf
+    {
+    public:
+        explicit TextStreamBuffer(std::string_view text)
+        {
+            char* begin = const_cast<char*>(text.data());
+            setg(begin, begin, begin + text.size());
+        }
+    };
+}  // namespace
+
 #ifdef DEBUG
 const std::vector<const char*> Application::VALIDATION_LAYERS = {"VK_LAYER_KHRONOS_validation"};
 #endif
 
 const std::vector<const char*> Application::PHYSICAL_DEVICE_EXTENSIONS = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+    VK_KHR_MAINTENANCE3_EXTENSION_NAME,
+    VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
+    VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
 #ifdef OS_MACOS
     "VK_KHR_portability_subset"
 #endif
 };
 
 const int Application::MAX_FRAMES_IN_FLIGHT = 2;
+// Widest point of the initialization graph: texture decode, model parse, device chain and pipeline compilation
+const uint32_t Application::INIT_THREAD_COUNT = 4;
+
+// Generated at build time from Shader/*.vert|frag, see Shader/CMakeLists.txt
+const std::vector<const ShaderReflection*> Application::SHADERS = {&SHADER_VERT, &SHADER_FRAG};
+
+const uint32_t Application::BINDLESS_MAX_TEXTURES = 8192;
+const uint32_t Application::BINDLESS_MAX_STORAGE_BUFFERS = 64;
+// Must match MATERIAL_BUFFER_INDEX in Shader.frag
+const uint32_t Application::MATERIAL_BUFFER_INDEX = 0;
 
 Application::Application(const ApplicationConfiguration& configuration)
     : mConfig(configuration)
+    , mVertShader(SHADER_VERT)
+    , mFragShader(SHADER_FRAG)
+    , mFrameAllocator(FRAME_ALLOCATOR_CAPACITY)
 {}
 
 int Application::initialize()
 {
     mbQuit = false;
+    mFrameLimiter.setTargetFrameRate(mConfig.frameRateLimit);
     initWindow();
     if (!mWindow)
     {
@@ -46,35 +108,105 @@ int Application::initialize()
         glfwTerminate();
         return EXIT_FAILURE;
     }
+    mountFileSystem();
+    mHostAllocator.initialize(mConfig.bTrackVulkanHostMemory, mConfig.bPoolVulkanHostAllocations);
     initVulkan();
+    if (mConfig.bRunStartupBenchmarks && !mbQuit)
+    {
+        runStartupBenchmarks();
+    }
+    if (mConfig.bHotReload && !mbQuit)
+    {
+        startHotReload();
+    }
+    if (mConfig.frameReplayPath && !mbQuit)
+    {
+        startFrameReplay();
+    }
+    else if (mConfig.frameCapturePath && !mbQuit)
+    {
+        startFrameCapture();
+    }
+    if (mConfig.bBenchmarkAntiAliasingTiers && !mbQuit)
+    {
+        startAntiAliasingBenchmark();
+    }
+    // Both benchmarks measure frame times, the prepass one waits for the anti-aliasing one to finish
+    else if (mConfig.bBenchmarkDepthPrepass && !mbQuit)
+    {
+        startDepthPrepassBenchmark();
+    }
     return EXIT_SUCCESS;
 }
 
 void Application::finalize()
 {
-    clearSwapchain();
-    vkDestroySampler(mLogicalDevice, mTextureSampler, nullptr);
-    vkDestroyImageView(mLogicalDevice, mTextureImageView, nullptr);
-    vkDestroyImage(mLogicalDevice, mTextureImage, nullptr);
-    vkFreeMemory(mLogicalDevice, mTextureImageMemory, nullptr);
-    vkDestroyDescriptorSetLayout(mLogicalDevice, mDescriptorSetLayout, nullptr);
-    vkDestroyBuffer(mLogicalDevice, mIndexBuffer, nullptr);
-    vkFreeMemory(mLogicalDevice, mIndexBufferMemory, nullptr);
-    vkDestroyBuffer(mLogicalDevice, mVertexBuffer, nullptr);
-    vkFreeMemory(mLogicalDevice, mVertexBufferMemory, nullptr);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    stopHotReload();
+    const FramePacingStatistics& pacing = mFrameLimiter.getStatistics();
+    if (pacing.frameCount > 0)
+    {
+        std::cout << "Frame pacing over " << pacing.frameCount << " frames: mean " << pacing.meanMilliseconds << " ms, variance "
+                  << pacing.varianceMilliseconds2 << " ms^2, min " << pacing.minMilliseconds << " ms, max " << pacing.maxMilliseconds << " ms" << std::endl;
+    }
+    if (mCheckedFrameCount > 0)
     {
-        vkDestroyFence(mLogicalDevice, mInFlightFences[i], nullptr);
-        vkDestroySemaphore(mLogicalDevice, mRenderFinishedSemaphores[i], nullptr);
-        vkDestroySemaphore(mLogicalDevice, mImageAvailableSemaphores[i], nullptr);
+        std::cout << "Checked " << mCheckedFrameCount << " steady-state frames for heap allocations, frame allocator peak " << mFrameAllocator.getPeak() << " bytes" << std::endl;
     }
-    vkDestroyCommandPool(mLogicalDevice, mCommandPool, nullptr);
-    vkDestroyDevice(mLogicalDevice, nullptr);
+    mDerivedDataCache.printReport("Derived data cache");
+    mHostAllocator.printReport("Vulkan host memory");
+    mDeviceMemoryTracker.printReport("Device memory");
+    printFrameCaptureReport();
+    clearSwapchain();
+    retireGraphicsPipelines();
+    mDeletionQueue.retirePipelineLayout(std::move(mPipelineLayout), mFrameIndex);
+    mDeletionQueue.retireSwapchain(mSwapchain, mFrameIndex);
+    mDeletionQueue.flush();
+    mTimestampQueryPool.reset();
+    mPipelineStatisticsQueryPool.reset();
+    destroyMeshletCulling();
+    mPostProcessPipeline.reset();
+    mPostProcessPipelineLayout.reset();
+    mPostProcessDescriptorPool.reset();
+    mPostProcessDescriptorSetLayout.reset();
+    mPostProcessSampler.reset();
+    mPipelineCache.reset();
+    mDescriptorPool.reset();
+    mBindlessResourceTable.finalize();
+    mMaterialBuffer.reset();
+    mMaterialBufferMemory.reset();
+    mUniformBuffers.clear();
+    mUniformBuffersMemory.clear();
+    mTextureSampler.reset();
+    mStressTextures.clear();
+    mTextureImageView.reset();
+    mTextureImage.reset();
+    mTextureImageMemory.reset();
+    mDescriptorSetLayout.reset();
+    mIndexBuffer.reset();
+    mIndexBufferMemory.reset();
+    mVertexBuffer.reset();
+    mVertexBufferMemory.reset();
+    mInFlightFences.clear();
+    mRenderFinishedSemaphores.clear();
+    mImageAvailableSemaphores.clear();
+    mCommandPool.reset();
 #ifdef DEBUG
-    destoryDebugUtilsMessengerEXT(mVulkanInstance, mDebugMessenger, nullptr);
+    // Anything still registered was never destroyed, the handles that own it are dropped with the device
+    mObjectRegistry.printLeaks("Destroying the device");
 #endif
-    vkDestroySurfaceKHR(mVulkanInstance, mWindowSurface, nullptr);
-    vkDestroyInstance(mVulkanInstance, nullptr);
+    vkDestroyDevice(mLogicalDevice, mHostAllocator.getCallbacks(HostAllocationSubsystem::Device));
+    mDeviceContext.device = VK_NULL_HANDLE;
+    VulkanDeviceContext::bind(nullptr);
+#ifdef DEBUG
+    destoryDebugUtilsMessengerEXT(mVulkanInstance, mDebugMessenger, mHostAllocator.getCallbacks(HostAllocationSubsystem::Instance));
+#endif
+    vkDestroySurfaceKHR(mVulkanInstance, mWindowSurface, mHostAllocator.getCallbacks(HostAllocationSubsystem::Instance));
+    vkDestroyInstance(mVulkanInstance, mHostAllocator.getCallbacks(HostAllocationSubsystem::Instance));
+    if (mHostAllocator.isEnabled() && mHostAllocator.getTotalStatistics().liveCount > 0)
+    {
+        HostAllocationStatistics leaked = mHostAllocator.getTotalStatistics();
+        std::cerr << "Vulkan leaked " << leaked.liveCount << " host allocations (" << leaked.bytes << " bytes) after destroying the instance!" << std::endl;
+    }
     if (mWindow)
     {
         glfwDestroyWindow(mWindow);
@@ -90,8 +222,124 @@ void Application::tick()
         mbQuit = true;
         return;
     }
-    glfwPollEvents();
+    uint64_t allocationCount = getThreadAllocationCount();
+    if (!mConfig.bJustInTimeFrame)
+    {
+        mFrameLimiter.wait();
+        glfwPollEvents();
+    }
     drawFrame();
+    if (mConfig.bCheckFrameAllocations && isAllocationCountingEnabled())
+    {
+        checkFrameAllocations(getThreadAllocationCount() - allocationCount);
+    }
+#ifdef DEBUG
+    checkObjectGrowth();
+#endif
+    updateMemoryTelemetry();
+}
+
+// Counts operator new calls on the main thread, by the engine or by C++ Vulkan layers and drivers, malloc is not seen
+void Application::checkFrameAllocations(uint64_t allocationCount)
+{
+    // Benchmarks switch modes on their own. Transform updates large enough to be spread over threads spawn them.
+    if (mAntiAliasingBenchmark.bActive || mDepthPrepassBenchmark.bActive || mScene.getUpdateStatistics().threadCount > 1)
+    {
+        mSteadyFrameCount = 0;
+    }
+    if (mSteadyFrameCount < ALLOCATION_CHECK_WARMUP_FRAMES)
+    {
+        mSteadyFrameCount++;
+        return;
+    }
+    mCheckedFrameCount++;
+    if (allocationCount > 0)
+    {
+        std::cerr << "Frame " << mFrameIndex << " made " << allocationCount << " heap allocations in the steady state!" << std::endl;
+        std::abort();
+    }
+}
+
+// A frame loop that runs unchanged should not create objects it never destroys, growth between two samples points at
+// the creation sites that leak. Resizes, reloads and lazily compiled pipelines also grow it, so this only warns.
+void Application::checkObjectGrowth()
+{
+    if (mFrameIndex == 0 || mFrameIndex % GROWTH_CHECK_FRAMES != 0)
+    {
+        return;
+    }
+    size_t objectCount = mObjectRegistry.getLiveCount();
+    if (mObjectCountSample > 0 && objectCount > mObjectCountSample)
+    {
+        std::cerr << "Live Vulkan objects grew from " << mObjectCountSample << " to " << objectCount << " over the last " << GROWTH_CHECK_FRAMES << " frames!" << std::endl;
+        mObjectRegistry.printLiveObjects("Vulkan objects", 8);
+    }
+    mObjectCountSample = objectCount;
+}
+
+// Runs after the allocation check, querying budgets and writing snapshots may allocate
+void Application::updateMemoryTelemetry()
+{
+    if (mFrameIndex % MEMORY_BUDGET_UPDATE_FRAMES == 0)
+    {
+        mDeviceMemoryTracker.updateBudget();
+        bool bOverBudget = mDeviceMemoryTracker.isOverBudget();
+        if (bOverBudget && !mbOverMemoryBudget)
+        {
+            std::cerr << "Device memory is over budget in frame " << mFrameIndex << "!" << std::endl;
+            mDeviceMemoryTracker.printReport("Device memory");
+        }
+        mbOverMemoryBudget = bOverBudget;
+    }
+    if (mbMemorySnapshotRequested)
+    {
+        mbMemorySnapshotRequested = false;
+        if (mConfig.memorySnapshotPath)
+        {
+            writeMemorySnapshot(mConfig.memorySnapshotPath);
+        }
+    }
+    // Soak tests set a limit, memory held after the first samples is the working set and must stay within it
+    if (mConfig.deviceMemoryGrowthLimit == 0 || mFrameIndex == 0 || mFrameIndex % GROWTH_CHECK_FRAMES != 0)
+    {
+        return;
+    }
+    uint64_t bytes = mDeviceMemoryTracker.getTotalStatistics().bytes;
+    if (mDeviceMemoryBaseline == 0)
+    {
+        mDeviceMemoryBaseline = bytes;
+        return;
+    }
+    if (bytes > mDeviceMemoryBaseline + mConfig.deviceMemoryGrowthLimit)
+    {
+        std::cerr << "Device memory grew from " << mDeviceMemoryBaseline << " to " << bytes << " bytes by frame " << mFrameIndex << "!" << std::endl;
+        mDeviceMemoryTracker.printReport("Device memory");
+        std::abort();
+    }
+}
+
+void Application::writeMemorySnapshot(const char* path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "Failed to write memory snapshot " << path << std::endl;
+        return;
+    }
+    file << "{\"frame\": " << mFrameIndex << ",\n\"device\": ";
+    mDeviceMemoryTracker.writeJson(file);
+    HostAllocationStatistics total = mHostAllocator.getTotalStatistics();
+    file << ",\n\"host\": {\"enabled\": " << (mHostAllocator.isEnabled() ? "true" : "false") << ", \"bytes\": " << total.bytes << ", \"peakBytes\": " << total.peakBytes
+         << ", \"liveCount\": " << total.liveCount << ", \"allocationCount\": " << total.allocationCount << ", \"internalBytes\": " << total.internalBytes << ",\n  \"subsystems\": [";
+    for (size_t i = 0; i < static_cast<size_t>(HostAllocationSubsystem::Count); i++)
+    {
+        HostAllocationSubsystem subsystem = static_cast<HostAllocationSubsystem>(i);
+        HostAllocationStatistics statistics = mHostAllocator.getStatistics(subsystem);
+        file << (i > 0 ? ",\n    " : "\n    ") << "{\"name\": \"" << getHostAllocationSubsystemName(subsystem) << "\", \"bytes\": " << statistics.bytes
+             << ", \"peakBytes\": " << statistics.peakBytes << ", \"liveCount\": " << statistics.liveCount << ", \"allocationCount\": " << statistics.allocationCount << "}";
+    }
+    file << "]}}" << std::endl;
+    std::cout << "Wrote memory snapshot " << path << std::endl;
 }
 
 bool Application::isQuit()
@@ -107,11 +355,34 @@ void Application::initWindow()
     // Because GLFW was originally designed to create an OpenGL context
     // we need to tell it to not create an OpenGL context with a subsequent call
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    // Replays are headless as far as anyone watching is concerned, the window only provides the swapchain
+    if (mConfig.frameReplayPath)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
 
     // create window
     mWindow = glfwCreateWindow(mConfig.windowWidth, mConfig.windowHeight, mConfig.windowTitle, nullptr, nullptr);
     glfwSetWindowUserPointer(mWindow, this);
     glfwSetFramebufferSizeCallback(mWindow, frameBufferResizeCallback);
+    glfwSetKeyCallback(mWindow, keyCallback);
+}
+
+void Application::mountFileSystem()
+{
+    // Asset paths are relative to the working directory
+    mFileSystem.mount(std::make_shared<DirectoryFileSource>("."));
+    // Packed assets take precedence, anything missing from the archive still loads from the loose files
+    std::shared_ptr<ArchiveFileSource> archive = std::make_shared<ArchiveFileSource>();
+    if (mConfig.assetArchivePath && archive->load(mConfig.assetArchivePath))
+    {
+        mFileSystem.mount(archive);
+        std::cout << "Mounted " << archive->getFileCount() << " files from " << mConfig.assetArchivePath << std::endl;
+    }
+    if (!mConfig.derivedDataCachePath || *mConfig.derivedDataCachePath)
+    {
+        mDerivedDataCache.initialize(mConfig.derivedDataCachePath ? mConfig.derivedDataCachePath : DerivedDataCache::getDefaultDirectory(), mConfig.derivedDataCacheMaxSize);
+    }
 }
 
 void Application::initVulkan()
@@ -121,39 +392,150 @@ void Application::initVulkan()
         mbQuit = true;
         return;
     }
-    createVulkanInstance();
+
+    // Decoding the texture and parsing the model only need the CPU and start right away. Device setup stays one
+    // chain in its original order, and the graphics pipelines compile beside it while it uploads the assets.
+    TaskGraph graph;
+    // Steps report failure by printing why and setting mbQuit, dependents must not run on the handles they left null
+    auto addStep = [&](const char* name, std::function<void()> function, const std::vector<TaskId>& dependencies = {}) {
+        return graph.addTask(
+            name,
+            [this, name, function = std::move(function)] {
+                function();
+                if (mbQuit)
+                {
+                    throw InitializationStepFailed(name);
+                }
+            },
+            dependencies);
+    };
+    TaskId textureDecoded = addStep("decodeTextureImage", [this] { decodeTextureImage(); });
+    TaskId modelLoaded = addStep("loadModel", [this] { loadModel(); });
+    TaskId previousDeviceStep = addStep("createVulkanInstance", [this] { createVulkanInstance(); });
+    auto addDeviceStep = [&](const char* name, std::function<void()> function, std::vector<TaskId> dependencies = {}) {
+        dependencies.push_back(previousDeviceStep);
+        previousDeviceStep = addStep(name, std::move(function), dependencies);
+        return previousDeviceStep;
+    };
 #ifdef DEBUG
-    setupDebugMessenger();
+    addDeviceStep("setupDebugMessenger", [this] { setupDebugMessenger(); });
 #endif
-    createWindowSurface();
-    pickPhysicalDevice();
-    createLogicalDevice();
-    createSwapchain();
-    createImageViews();
-    createRenderPass();
-    createDescriptorSetLayout();
-    createGraphicsPipeline();
-    createCommandPool();
-    createColorResources();
-    createDepthResources();
-    createFramebuffers();
-    createTextureImage();
-    createTextureImageView();
-    createTextureSampler();
-    loadModel();
-    createVertexBuffer();
-    createIndexBuffer();
-    createUniformBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
-    createCommandBuffers();
-    createSyncronizationObjects();
+    addDeviceStep("createWindowSurface", [this] { createWindowSurface(); });
+    TaskId devicePicked = addDeviceStep("pickPhysicalDevice", [this] { pickPhysicalDevice(); });
+    addDeviceStep("createLogicalDevice", [this] { createLogicalDevice(); });
+    addDeviceStep("initializeDeviceObjects", [this] {
+        // Callbacks of every subsystem free compatibly, owned and retired objects may have been created by any of them
+        mDeviceContext.device = mLogicalDevice;
+        mDeviceContext.allocator = mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources);
+#ifdef DEBUG
+        mDeviceContext.registry = &mObjectRegistry;
+#endif
+        mDeviceMemoryTracker.initialize(mDeviceCapabilities, mbMemoryBudgetSupported);
+        mDeviceContext.memoryTracker = &mDeviceMemoryTracker;
+        VulkanDeviceContext::bind(&mDeviceContext);
+        mDeletionQueue.initialize(mDeviceContext);
+        mRenderTargetAllocator.initialize(mDeviceCapabilities,
+                                          mLogicalDevice,
+                                          mHostAllocator.getCallbacks(HostAllocationSubsystem::RenderTargets),
+                                          mDeviceContext.registry,
+                                          &mDeviceMemoryTracker);
+        mFrameGraph.initialize(mLogicalDevice);
+    });
+    addDeviceStep("createPipelineCache", [this] { createPipelineCache(); });
+    addDeviceStep("createSwapchain", [this] { createSwapchain(VK_NULL_HANDLE); });
+    addDeviceStep("createImageViews", [this] { createImageViews(); });
+    addDeviceStep("createRenderPass", [this] { createRenderPass(); });
+    addDeviceStep("createDescriptorSetLayout", [this] { createDescriptorSetLayout(); });
+    addDeviceStep("createBindlessResourceTable", [this] { createBindlessResourceTable(); });
+    TaskId pipelineLayoutCreated = addDeviceStep("createPipelineLayout", [this] { createPipelineLayout(); });
+    // Pipeline creation needs no external synchronization and nothing else touches the pipeline map during initialization
+    addStep("createGraphicsPipelines", [this] { createGraphicsPipelines(); }, {pipelineLayoutCreated});
+    addDeviceStep("createPostProcessPipeline", [this] { createPostProcessPipeline(); });
+    addDeviceStep("createMeshletCullingPipeline", [this] { createMeshletCullingPipeline(); });
+    addDeviceStep("createCommandPool", [this] { createCommandPool(); });
+    addDeviceStep("createRenderTargets", [this] { createRenderTargets(); });
+    addDeviceStep("createFramebuffers", [this] { createFramebuffers(); });
+    addDeviceStep("printRenderTargetMemory", [this] { printRenderTargetMemory(); });
+    addDeviceStep("createTextureImage", [this] { createTextureImage(); }, {textureDecoded});
+    addDeviceStep("createTextureImageView", [this] { createTextureImageView(); });
+    addDeviceStep("createTextureSampler", [this] { createTextureSampler(); });
+    TaskId meshletsBuilt = addStep("loadModelMeshlets", [this] { loadModelMeshlets(); }, {modelLoaded, devicePicked});
+    addDeviceStep("createVertexBuffer", [this] { createVertexBuffer(); }, {modelLoaded});
+    addDeviceStep("createIndexBuffer", [this] { createIndexBuffer(); }, {meshletsBuilt});
+    addDeviceStep("createMeshletBuffer", [this] { createMeshletBuffer(); });
+    addDeviceStep("createUniformBuffers", [this] { createUniformBuffers(); });
+    addDeviceStep("createDescriptorPool", [this] { createDescriptorPool(); });
+    addDeviceStep("createDescriptorSets", [this] { createDescriptorSets(); });
+    addDeviceStep("createMaterials", [this] { createMaterials(); });
+    addDeviceStep("createCommandBuffers", [this] { createCommandBuffers(); });
+    addDeviceStep("createSyncronizationObjects", [this] { createSyncronizationObjects(); });
+
+    try
+    {
+        graph.execute(INIT_THREAD_COUNT);
+    }
+    catch (const InitializationStepFailed& failure)
+    {
+        // mbQuit stays set, the step has already printed the reason
+        std::cerr << "Vulkan initialization stopped after " << failure.what() << std::endl;
+        return;
+    }
+    graph.printReport("Vulkan initialization");
 }
 
 void Application::drawFrame()
 {
     // Wait until the previous frame has finished
-    vkWaitForFences(mLogicalDevice, 1, &mInFlightFences[mCurrentFrame], VK_TRUE, UINT64_MAX);
+    VkFence inFlightFence = mInFlightFences[mCurrentFrame];
+    vkWaitForFences(mLogicalDevice, 1, &inFlightFence, VK_TRUE, UINT64_MAX);
+
+    if (mAntiAliasingBenchmark.bActive)
+    {
+        updateAntiAliasingBenchmark();
+    }
+    if (mDepthPrepassBenchmark.bActive)
+    {
+        updateDepthPrepassBenchmark();
+    }
+    if (mFrameReplay.isOpen())
+    {
+        beginReplayFrame();
+    }
+
+    // The fence of this slot guards the frame submitted MAX_FRAMES_IN_FLIGHT frames ago
+    if (mFrameIndex >= MAX_FRAMES_IN_FLIGHT)
+    {
+        mDeletionQueue.collect(mFrameIndex - MAX_FRAMES_IN_FLIGHT);
+    }
+
+    // Reloaded resources are swapped in here, between frames, and the ones they replace are retired
+    if (mConfig.bHotReload)
+    {
+        bool bReloading = !mFileChangeEvents.empty() || !mHotReloadJobs.empty();
+        processHotReload();
+        if (bReloading || !mFileChangeEvents.empty() || !mHotReloadJobs.empty())
+        {
+            mSteadyFrameCount = 0;
+        }
+    }
+    if (mRequestedAntiAliasingTier)
+    {
+        applyAntiAliasingTier(*mRequestedAntiAliasingTier);
+        mRequestedAntiAliasingTier.reset();
+        mSteadyFrameCount = 0;
+    }
+    if (mRequestedDepthPrepass)
+    {
+        setDepthPrepass(*mRequestedDepthPrepass);
+        mRequestedDepthPrepass.reset();
+        mSteadyFrameCount = 0;
+    }
+    if (mRequestedMeshletCulling)
+    {
+        setMeshletCulling(*mRequestedMeshletCulling);
+        mRequestedMeshletCulling.reset();
+        mSteadyFrameCount = 0;
+    }
 
     // acquiring an image from the swap chain
     uint32_t imageIndex;
@@ -170,22 +552,39 @@ void Application::drawFrame()
         return;
     }
 
+    // In just-in-time mode the limiter and input sampling run after the fence wait and acquire,
+    // so the frame starts with the freshest possible input right before recording
+    if (mConfig.bJustInTimeFrame)
+    {
+        mFrameLimiter.wait();
+        glfwPollEvents();
+    }
+
     // reset the fence to the unsignaled state
     // only reset the fence if we are submitting work
-    vkResetFences(mLogicalDevice, 1, &mInFlightFences[mCurrentFrame]);
+    vkResetFences(mLogicalDevice, 1, &inFlightFence);
+
+    // The previous frame's command buffer was recorded from it and has been submitted, nothing reads it anymore
+    mFrameAllocator.reset();
+    auto updateStart = std::chrono::steady_clock::now();
+    updateUniformBuffer(mCurrentFrame);
 
     // record the command buffer
+    auto recordStart = std::chrono::steady_clock::now();
     vkResetCommandBuffer(mCommandBuffers[mCurrentFrame], 0);
     recordCommandBuffer(mCommandBuffers[mCurrentFrame], imageIndex);
-
-    updateUniformBuffer(mCurrentFrame);
+    if (mFrameCapture.isOpen() || mFrameReplay.isOpen())
+    {
+        captureFrame(imageIndex, updateStart, recordStart);
+    }
 
     // submit the command buffer
     VkSubmitInfo submitInfo {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
     VkSemaphore waitSemaphores[] = {mImageAvailableSemaphores[mCurrentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    // Post-processed tiers first touch the swapchain image with a blit
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT};
     submitInfo.waitSemaphoreCount = 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
@@ -196,7 +595,7 @@ void Application::drawFrame()
     submitInfo.pSignalSemaphores = signalSemaphores;
 
     // submit the command buffer to the graphics queue
-    if (vkQueueSubmit(mGraphicsQueue, 1, &submitInfo, mInFlightFences[mCurrentFrame]) != VK_SUCCESS)
+    if (vkQueueSubmit(mGraphicsQueue, 1, &submitInfo, inFlightFence) != VK_SUCCESS)
     {
         std::cerr << "Failed to submit draw command buffer!" << std::endl;
         mbQuit = true;
@@ -228,7 +627,12 @@ void Application::drawFrame()
         return;
     }
 
+    reportHotReloadLatency();
+    mFrameLimiter.markFrame();
     mCurrentFrame = (mCurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    mDeviceMemoryTracker.endFrame(mFrameIndex);
+    mFrameIndex++;
+    mObjectRegistry.setFrameIndex(mFrameIndex);
 }
 
 void Application::frameBufferResizeCallback(GLFWwindow* window, int width, int height)
@@ -237,6 +641,28 @@ void Application::frameBufferResizeCallback(GLFWwindow* window, int width, int h
     application->mbFramebufferResized = true;
 }
 
+void Application::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    Application* application = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+    int tier = key - GLFW_KEY_1;
+    if (action == GLFW_PRESS && tier >= 0 && tier < static_cast<int>(AntiAliasingTier::Count) && !application->mAntiAliasingBenchmark.bActive)
+    {
+        application->mRequestedAntiAliasingTier = static_cast<AntiAliasingTier>(tier);
+    }
+    if (action == GLFW_PRESS && key == GLFW_KEY_Z && !application->mDepthPrepassBenchmark.bActive)
+    {
+        application->mRequestedDepthPrepass = !application->mbDepthPrepass;
+    }
+    if (action == GLFW_PRESS && key == GLFW_KEY_M)
+    {
+        application->mRequestedMeshletCulling = !application->mbMeshletCulling;
+    }
+    if (action == GLFW_PRESS && key == GLFW_KEY_F9)
+    {
+        application->mbMemorySnapshotRequested = true;
+    }
+}
+
 bool Application::checkExtensionSupport()
 {
     uint32_t vulkanExtensionCount;
@@ -245,33 +671,21 @@ bool Application::checkExtensionSupport()
     std::vector<VkExtensionProperties> extensions(vulkanExtensionCount);
     vkEnumerateInstanceExtensionProperties(nullptr, &vulkanExtensionCount, extensions.data());
 
-    std::vector<const char*> requiredExtensions = getRequiredExtensions();
-    bool bAllSupported = true;
-    const char* unsupportedExtensionName = nullptr;
+    std::unordered_set<std::string> availableExtensions;
+    availableExtensions.reserve(vulkanExtensionCount);
+    for (const VkExtensionProperties& extension : extensions)
+    {
+        availableExtensions.insert(extension.extensionName);
+    }
 
-    for (const char* requiredExtension : requiredExtensions)
+    for (const char* requiredExtension : getRequiredExtensions())
     {
-        bool bSupported = false;
-        for (const VkExtensionProperties& extension : extensions)
+        if (availableExtensions.count(requiredExtension) == 0)
         {
-            if (strcmp(requiredExtension, extension.extensionName) == 0)
-            {
-                bSupported = true;
-                break;
-            }
-        }
-        if (!bSupported)
-        {
-            bAllSupported = false;
-            unsupportedExtensionName = requiredExtension;
-            break;
+            std::cerr << "Unsupported extension: " << requiredExtension << std::endl;
+            return false;
         }
     }
-    if (!bAllSupported)
-    {
-        std::cerr << "Unsupported extension: " << unsupportedExtensionName << std::endl;
-        return false;
-    }
     return true;
 }
 
@@ -291,7 +705,8 @@ void Application::createVulkanInstance()
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "Tamashii";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    // Descriptor indexing structures are core in Vulkan 1.2
+    appInfo.apiVersion = VK_API_VERSION_1_2;
 
     VkInstanceCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -315,7 +730,7 @@ void Application::createVulkanInstance()
     createInfo.flags = VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
 #endif
 
-    if (vkCreateInstance(&createInfo, nullptr, &mVulkanInstance) != VK_SUCCESS)
+    if (vkCreateInstance(&createInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Instance), &mVulkanInstance) != VK_SUCCESS)
     {
         mbQuit = true;
         std::cerr << "Failed to create Vulkan instance!" << std::endl;
@@ -380,7 +795,7 @@ void Application::setupDebugMessenger()
     VkDebugUtilsMessengerCreateInfoEXT createInfo {};
     populateDebugMessengerCreateInfo(createInfo);
 
-    if (createDebugUtilsMessengerEXT(mVulkanInstance, &createInfo, nullptr, &mDebugMessenger) != VK_SUCCESS)
+    if (createDebugUtilsMessengerEXT(mVulkanInstance, &createInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Instance), &mDebugMessenger) != VK_SUCCESS)
     {
         std::cerr << "Failed to set up debug messenger!" << std::endl;
         mbQuit = true;
@@ -432,13 +847,17 @@ void Application::pickPhysicalDevice()
     std::vector<VkPhysicalDevice> devices(deviceCount);
     vkEnumeratePhysicalDevices(mVulkanInstance, &deviceCount, devices.data());
 
+    // Every later question about the device is answered from the capabilities of the winner
     int highestScore = 0;
     for (const VkPhysicalDevice& device : devices)
     {
-        int deviceScore = rateDeviceSuitability(device);
+        DeviceCapabilities capabilities;
+        capabilities.query(device, mWindowSurface);
+        int deviceScore = rateDeviceSuitability(capabilities);
         if (deviceScore > highestScore)
         {
             mPhysicalDevice = device;
+            mDeviceCapabilities = std::move(capabilities);
             highestScore = deviceScore;
         }
     }
@@ -450,18 +869,41 @@ void Application::pickPhysicalDevice()
         return;
     }
 
-    vkGetPhysicalDeviceProperties(mPhysicalDevice, &mPhysicalDeviceProperties);
-    mMsaaSamples = getMaxUsableSampleCount();
+    mMaxMsaaSamples = getMaxUsableSampleCount();
+    mAntiAliasingTier = mConfig.antiAliasingTier;
+    mAntiAliasing = AntiAliasingSettings::fromTier(mAntiAliasingTier, mMaxMsaaSamples);
+    mMsaaSamples = mAntiAliasing.sampleCount;
+    mbDepthPrepass = mConfig.bDepthPrepass;
+
+    mbPipelineStatisticsQuerySupported = mDeviceCapabilities.getFeatures().pipelineStatisticsQuery;
+
+    // Enabled whenever available so the startup benchmarks can compare both paths
+    mbDynamicRenderingSupported = checkDynamicRenderingSupport(mDeviceCapabilities);
+    mbDynamicRendering = mConfig.bDynamicRendering && mbDynamicRenderingSupported;
+    if (mConfig.bDynamicRendering && !mbDynamicRenderingSupported)
+    {
+        std::cerr << "VK_KHR_dynamic_rendering is unsupported, falling back to render pass objects" << std::endl;
+    }
+
+    mbMeshletCullingSupported = checkMeshletCullingSupport(mDeviceCapabilities);
+    mbMeshletCulling = mConfig.bMeshletCulling && mbMeshletCullingSupported;
+    if (mConfig.bMeshletCulling && !mbMeshletCullingSupported)
+    {
+        std::cerr << "Multi draw indirect or VK_KHR_draw_indirect_count is unsupported, drawing whole objects" << std::endl;
+    }
+
+    // Without it, heap budgets are the heap sizes and only our own allocations count against them
+    mbMemoryBudgetSupported = mDeviceCapabilities.hasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 }
 
-int Application::rateDeviceSuitability(VkPhysicalDevice device)
+int Application::rateDeviceSuitability(const DeviceCapabilities& capabilities)
 {
-    QueueFamilyIndices indices = findQueueFamilyIndices(device);
-    bool bExtensionsSupported = checkPhysicalDeviceSupport(device);
+    QueueFamilyIndices indices = findQueueFamilyIndices(capabilities);
+    bool bExtensionsSupported = checkPhysicalDeviceSupport(capabilities);
     bool bSwapchainAdequate = false;
     if (bExtensionsSupported)
     {
-        SwapchainSupportDetails swapchainSupportDetails = querySwapchainSupport(device);
+        SwapchainSupportDetails swapchainSupportDetails = querySwapchainSupport(capabilities.getPhysicalDevice());
         bSwapchainAdequate = !swapchainSupportDetails.formats.empty() && !swapchainSupportDetails.presentModes.empty();
     }
     if (!indices.isComplete() || !bExtensionsSupported || !bSwapchainAdequate)
@@ -469,16 +911,24 @@ int Application::rateDeviceSuitability(VkPhysicalDevice device)
         return 0;
     }
 
-    VkPhysicalDeviceProperties deviceProperties;
-    VkPhysicalDeviceFeatures deviceFeatures;
-    vkGetPhysicalDeviceProperties(device, &deviceProperties);
-    vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
+    const VkPhysicalDeviceProperties& deviceProperties = capabilities.getProperties();
+    const VkPhysicalDeviceFeatures& deviceFeatures = capabilities.getFeatures();
 
     if (!deviceFeatures.samplerAnisotropy)
     {
         return 0;
     }
 
+    if (!checkDescriptorIndexingSupport(capabilities))
+    {
+        return 0;
+    }
+
+    if (!capabilities.supportsSynchronization2())
+    {
+        return 0;
+    }
+
 #ifndef OS_MACOS
     // Application cannot function without geometry shaders
     if (!deviceFeatures.geometryShader)
@@ -505,27 +955,19 @@ int Application::rateDeviceSuitability(VkPhysicalDevice device)
     return score;
 }
 
-QueueFamilyIndices Application::findQueueFamilyIndices(VkPhysicalDevice device)
+QueueFamilyIndices Application::findQueueFamilyIndices(const DeviceCapabilities& capabilities)
 {
     QueueFamilyIndices indices;
 
-    uint32_t queueFamilyCount = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
-
-    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
-
-    uint32_t i = 0;
-    for (const auto& queueFamily : queueFamilies)
+    const std::vector<VkQueueFamilyProperties>& queueFamilies = capabilities.getQueueFamilies();
+    for (uint32_t i = 0; i < queueFamilies.size(); i++)
     {
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
         {
             indices.graphicsFamily = i;
         }
 
-        VkBool32 bPresentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, mWindowSurface, &bPresentSupport);
-        if (bPresentSupport)
+        if (capabilities.supportsPresent(i))
         {
             indices.presentFamily = i;
         }
@@ -534,33 +976,47 @@ QueueFamilyIndices Application::findQueueFamilyIndices(VkPhysicalDevice device)
         {
             break;
         }
-
-        i++;
     }
 
     return indices;
 }
 
-bool Application::checkPhysicalDeviceSupport(VkPhysicalDevice device)
+bool Application::checkPhysicalDeviceSupport(const DeviceCapabilities& capabilities)
 {
-    uint32_t extensionCount;
-    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    return std::all_of(PHYSICAL_DEVICE_EXTENSIONS.begin(), PHYSICAL_DEVICE_EXTENSIONS.end(), [&capabilities](const char* extensionName) {
+        return capabilities.hasExtension(extensionName);
+    });
+}
 
-    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+bool Application::checkDescriptorIndexingSupport(const DeviceCapabilities& capabilities)
+{
+    const VkPhysicalDeviceDescriptorIndexingFeatures& descriptorIndexingFeatures = capabilities.getDescriptorIndexingFeatures();
+    return descriptorIndexingFeatures.runtimeDescriptorArray
+        && descriptorIndexingFeatures.descriptorBindingPartiallyBound
+        && descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing
+        && descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind
+        && descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind
+        && descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+}
 
-    std::set<std::string> requiredExtensions(PHYSICAL_DEVICE_EXTENSIONS.begin(), PHYSICAL_DEVICE_EXTENSIONS.end());
-    for (const auto& extension : availableExtensions)
+bool Application::checkDynamicRenderingSupport(const DeviceCapabilities& capabilities)
+{
+    // Resolve modes come from VK_KHR_depth_stencil_resolve, which is only core from Vulkan 1.2 on
+    if (capabilities.getProperties().apiVersion < VK_API_VERSION_1_2)
     {
-        requiredExtensions.erase(extension.extensionName);
+        return false;
     }
+    return capabilities.supportsDynamicRendering();
+}
 
-    return requiredExtensions.empty();
+bool Application::checkMeshletCullingSupport(const DeviceCapabilities& capabilities)
+{
+    return capabilities.getFeatures().multiDrawIndirect && capabilities.hasExtension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
 }
 
 void Application::createLogicalDevice()
 {
-    QueueFamilyIndices indices = findQueueFamilyIndices(mPhysicalDevice);
+    QueueFamilyIndices indices = findQueueFamilyIndices(mDeviceCapabilities);
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily.value(), indices.presentFamily.value()};
@@ -578,9 +1034,45 @@ void Application::createLogicalDevice()
     VkPhysicalDeviceFeatures deviceFeatures {};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
+    deviceFeatures.pipelineStatisticsQuery = mbPipelineStatisticsQuerySupported ? VK_TRUE : VK_FALSE;
+    deviceFeatures.multiDrawIndirect = mbMeshletCullingSupported ? VK_TRUE : VK_FALSE;
+
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures {};
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+    descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+    // The frame graph records its barriers with vkCmdPipelineBarrier2KHR
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features {};
+    synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+    synchronization2Features.synchronization2 = VK_TRUE;
+    descriptorIndexingFeatures.pNext = &synchronization2Features;
+
+    std::vector<const char*> extensions = PHYSICAL_DEVICE_EXTENSIONS;
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures {};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+    if (mbDynamicRenderingSupported)
+    {
+        extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        synchronization2Features.pNext = &dynamicRenderingFeatures;
+    }
+    if (mbMeshletCullingSupported)
+    {
+        extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    }
+    if (mbMemoryBudgetSupported)
+    {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
 
     VkDeviceCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &descriptorIndexingFeatures;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
@@ -591,10 +1083,10 @@ void Application::createLogicalDevice()
     createInfo.enabledLayerCount = 0;
 #endif
 
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(PHYSICAL_DEVICE_EXTENSIONS.size());
-    createInfo.ppEnabledExtensionNames = PHYSICAL_DEVICE_EXTENSIONS.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
-    if (vkCreateDevice(mPhysicalDevice, &createInfo, nullptr, &mLogicalDevice) != VK_SUCCESS)
+    if (vkCreateDevice(mPhysicalDevice, &createInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Device), &mLogicalDevice) != VK_SUCCESS)
     {
         std::cerr << "Failed to create logical device!" << std::endl;
         mbQuit = true;
@@ -602,11 +1094,21 @@ void Application::createLogicalDevice()
     }
     vkGetDeviceQueue(mLogicalDevice, indices.graphicsFamily.value(), 0, &mGraphicsQueue);
     vkGetDeviceQueue(mLogicalDevice, indices.presentFamily.value(), 0, &mPresentQueue);
+
+    if (mbDynamicRenderingSupported)
+    {
+        mCmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(vkGetDeviceProcAddr(mLogicalDevice, "vkCmdBeginRenderingKHR"));
+        mCmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(vkGetDeviceProcAddr(mLogicalDevice, "vkCmdEndRenderingKHR"));
+    }
+    if (mbMeshletCullingSupported)
+    {
+        mCmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(vkGetDeviceProcAddr(mLogicalDevice, "vkCmdDrawIndexedIndirectCountKHR"));
+    }
 }
 
 void Application::createWindowSurface()
 {
-    if (glfwCreateWindowSurface(mVulkanInstance, mWindow, nullptr, &mWindowSurface) != VK_SUCCESS)
+    if (glfwCreateWindowSurface(mVulkanInstance, mWindow, mHostAllocator.getCallbacks(HostAllocationSubsystem::Instance), &mWindowSurface) != VK_SUCCESS)
     {
         std::cerr << "Failed to create window surface!" << std::endl;
         mbQuit = true;
@@ -650,15 +1152,35 @@ VkSurfaceFormatKHR Application::chooseSwapSurfaceFormat(const std::vector<VkSurf
     return availableFormats[0];
 }
 
-VkPresentModeKHR Application::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
+VkPresentModeKHR Application::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) const
 {
+    VkPresentModeKHR requestedPresentMode;
+    switch (mConfig.presentPolicy)
+    {
+        case PresentPolicy::FifoRelaxed:
+            requestedPresentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            break;
+        case PresentPolicy::Mailbox:
+            requestedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            break;
+        case PresentPolicy::Immediate:
+            requestedPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            break;
+        case PresentPolicy::Fifo:
+        default:
+            requestedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+            break;
+    }
+
     for (const auto& availablePresentMode : availablePresentModes)
     {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+        if (availablePresentMode == requestedPresentMode)
         {
             return availablePresentMode;
         }
     }
+    std::cerr << "Requested present mode " << requestedPresentMode << " is not supported, falling back to FIFO" << std::endl;
+    // FIFO is the only mode the specification guarantees
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -678,7 +1200,8 @@ VkExtent2D Application::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabil
     return actualExtent;
 }
 
-void Application::createSwapchain()
+// On failure mSwapchain is left as it was, oldSwapchain stays owned by the caller either way
+bool Application::createSwapchain(VkSwapchainKHR oldSwapchain)
 {
     SwapchainSupportDetails swapChainSupportDetails = querySwapchainSupport(mPhysicalDevice);
     VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupportDetails.formats);
@@ -700,8 +1223,14 @@ void Application::createSwapchain()
     createInfo.imageExtent = extent;
     createInfo.imageArrayLayers = 1;
     createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    // Post-processed anti-aliasing tiers blit their result into the swapchain image
+    mbSwapchainTransferDst = (swapChainSupportDetails.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0;
+    if (mbSwapchainTransferDst)
+    {
+        createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
 
-    QueueFamilyIndices indices = findQueueFamilyIndices(mPhysicalDevice);
+    QueueFamilyIndices indices = findQueueFamilyIndices(mDeviceCapabilities);
     uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
     if (indices.graphicsFamily != indices.presentFamily)
     {
@@ -720,14 +1249,16 @@ void Application::createSwapchain()
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    createInfo.oldSwapchain = oldSwapchain;
 
-    if (vkCreateSwapchainKHR(mLogicalDevice, &createInfo, nullptr, &mSwapchain) != VK_SUCCESS)
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    if (vkCreateSwapchainKHR(mLogicalDevice, &createInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Swapchain), &swapchain) != VK_SUCCESS)
     {
         std::cerr << "Failed to create swap chain" << std::endl;
         mbQuit = true;
-        return;
+        return false;
     }
+    mSwapchain = swapchain;
 
     vkGetSwapchainImagesKHR(mLogicalDevice, mSwapchain, &imageCount, nullptr);
     mSwapchainImages.resize(imageCount);
@@ -735,10 +1266,12 @@ void Application::createSwapchain()
 
     mSwapchainImageFormat = surfaceFormat.format;
     mSwapchainExtent = extent;
+    return true;
 }
 
 void Application::recreateSwapchain()
 {
+    mSteadyFrameCount = 0;
     int width = 0, height = 0;
     glfwGetFramebufferSize(mWindow, &width, &height);
     while (width == 0 || height == 0)
@@ -746,50 +1279,58 @@ void Application::recreateSwapchain()
         glfwGetFramebufferSize(mWindow, &width, &height);
         glfwWaitEvents();
     }
-    vkDeviceWaitIdle(mLogicalDevice);
 
+    // A failed create leaves the old swapchain and everything built on it in place, finalize retires them like any other
+    VkSwapchainKHR oldSwapchain = mSwapchain;
+    if (!createSwapchain(oldSwapchain))
+    {
+        return;
+    }
+    // No device idle here: the old objects are retired and destroyed once the frames using them complete
     clearSwapchain();
-
-    createSwapchain();
+    mDeletionQueue.retireSwapchain(oldSwapchain, mFrameIndex);
     createImageViews();
     createRenderPass();
-    createGraphicsPipeline();
-    createColorResources();
-    createDepthResources();
+    // Pipelines only depend on the render pass (or the dynamic rendering attachments) through their color format and sample count
+    updateGraphicsPipelineKey();
+    retireIncompatibleGraphicsPipelines();
+    compileActiveGraphicsPipelines();
+    createRenderTargets();
     createFramebuffers();
-    createUniformBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
 }
 
+// Retires every swapchain dependent object, the swapchain itself is retired by the caller
+// because it has to stay alive as oldSwapchain while the replacement is created
 void Application::clearSwapchain()
 {
-    vkDestroyImageView(mLogicalDevice, mDepthImageView, nullptr);
-    vkDestroyImage(mLogicalDevice, mDepthImage, nullptr);
-    vkFreeMemory(mLogicalDevice, mDepthImageMemory, nullptr);
-    vkDestroyImageView(mLogicalDevice, mColorImageView, nullptr);
-    vkDestroyImage(mLogicalDevice, mColorImage, nullptr);
-    vkFreeMemory(mLogicalDevice, mColorImageMemory, nullptr);
-    for (VkFramebuffer framebuffer : mSwapchainFramebuffers)
+    clearRenderTargets();
+    for (UniqueImageView& imageView : mSwapchainImageViews)
     {
-        vkDestroyFramebuffer(mLogicalDevice, framebuffer, nullptr);
+        mDeletionQueue.retireImageView(std::move(imageView), mFrameIndex);
     }
-    vkDestroyPipeline(mLogicalDevice, mGraphicsPipeline, nullptr);
-    vkDestroyPipelineLayout(mLogicalDevice, mPipelineLayout, nullptr);
-    vkDestroyRenderPass(mLogicalDevice, mRenderPass, nullptr);
-    for (auto& imageView : mSwapchainImageViews)
-    {
-        vkDestroyImageView(mLogicalDevice, imageView, nullptr);
-    }
-    vkDestroySwapchainKHR(mLogicalDevice, mSwapchain, nullptr);
-
-    vkDestroyDescriptorPool(mLogicalDevice, mDescriptorPool, nullptr);
+    mSwapchainImageViews.clear();
+}
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+// Retires everything that depends on the swapchain extent or the anti-aliasing settings
+void Application::clearRenderTargets()
+{
+    mRenderTargetAllocator.resetStatistics();
+    mDeletionQueue.retireImageView(std::move(mDepthImageView), mFrameIndex);
+    mDeletionQueue.retireImage(std::move(mDepthImage), std::move(mDepthImageMemory), mFrameIndex);
+    mDeletionQueue.retireImageView(std::move(mColorImageView), mFrameIndex);
+    mDeletionQueue.retireImage(std::move(mColorImage), std::move(mColorImageMemory), mFrameIndex);
+    for (UniqueFramebuffer& framebuffer : mSwapchainFramebuffers)
     {
-        vkDestroyBuffer(mLogicalDevice, mUniformBuffers[i], nullptr);
-        vkFreeMemory(mLogicalDevice, mUniformBuffersMemory[i], nullptr);
+        mDeletionQueue.retireFramebuffer(std::move(framebuffer), mFrameIndex);
     }
+    mSwapchainFramebuffers.clear();
+    mDeletionQueue.retireImageView(std::move(mSceneColorImageView), mFrameIndex);
+    mDeletionQueue.retireImage(std::move(mSceneColorImage), std::move(mSceneColorImageMemory), mFrameIndex);
+    mDeletionQueue.retireImageView(std::move(mPostProcessImageView), mFrameIndex);
+    mDeletionQueue.retireImage(std::move(mPostProcessImage), std::move(mPostProcessImageMemory), mFrameIndex);
+    mDeletionQueue.retireDescriptorSet(mPostProcessDescriptorSet, mPostProcessDescriptorPool, mFrameIndex);
+    mPostProcessDescriptorSet = VK_NULL_HANDLE;
+    mDeletionQueue.retireRenderPass(std::move(mRenderPass), mFrameIndex);
 }
 
 void Application::createImageViews()
@@ -803,14 +1344,27 @@ void Application::createImageViews()
 
 void Application::createRenderPass()
 {
+    // Dynamic rendering names the attachments when the pass begins, see beginScenePass
+    if (mbDynamicRendering)
+    {
+        return;
+    }
+
+    // With MSAA the color attachment is resolved into the target, without it the color attachment is the target.
+    // The target is the swapchain image, or the scene color image when a post-process pass reads it afterwards.
+    // Attachments stay in their attachment layouts, the frame graph transitions and synchronizes them around the pass.
+    bool bResolve = mMsaaSamples != VK_SAMPLE_COUNT_1_BIT;
+    VkFormat colorFormat = getSceneColorFormat();
+
     VkAttachmentDescription colorAttachment {};
-    colorAttachment.format = mSwapchainImageFormat;
+    colorAttachment.format = colorFormat;
     colorAttachment.samples = mMsaaSamples;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    // Multisampled color only lives until it is resolved, which lets it stay in tile memory
+    colorAttachment.storeOp = bResolve ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     VkAttachmentDescription depthAttachment {};
@@ -820,18 +1374,18 @@ void Application::createRenderPass()
     depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkAttachmentDescription colorAttachmentResolve {};
-    colorAttachmentResolve.format = mSwapchainImageFormat;
+    colorAttachmentResolve.format = colorFormat;
     colorAttachmentResolve.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachmentResolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachmentResolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference colorAttachmentRef {};
     colorAttachmentRef.attachment = 0;
@@ -850,60 +1404,192 @@ void Application::createRenderPass()
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
     subpass.pDepthStencilAttachment = &depthAttachmentRef;
-    subpass.pResolveAttachments = &colorAttachmentResolveRef;
-
-    VkSubpassDependency dependency {};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    subpass.pResolveAttachments = bResolve ? &colorAttachmentResolveRef : nullptr;
 
-    std::array<VkAttachmentDescription, 3> attachments {colorAttachment, depthAttachment, colorAttachmentResolve};
+    std::vector<VkAttachmentDescription> attachments {colorAttachment, depthAttachment};
+    if (bResolve)
+    {
+        attachments.push_back(colorAttachmentResolve);
+    }
     VkRenderPassCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
     createInfo.pAttachments = attachments.data();
     createInfo.subpassCount = 1;
     createInfo.pSubpasses = &subpass;
-    createInfo.dependencyCount = 1;
-    createInfo.pDependencies = &dependency;
 
-    if (vkCreateRenderPass(mLogicalDevice, &createInfo, nullptr, &mRenderPass) != VK_SUCCESS)
+    VkRenderPass renderPass;
+    if (vkCreateRenderPass(mLogicalDevice, &createInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Swapchain), &renderPass) != VK_SUCCESS)
     {
         std::cerr << "Failed to create render pass" << std::endl;
         mbQuit = true;
+        return;
     }
+    mRenderPass = UniqueRenderPass(renderPass);
 }
 
-void Application::createGraphicsPipeline()
+void Application::createPipelineLayout()
 {
-    auto vertShaderCode = readFile("Shader/Vert.spv");
-    auto fragShaderCode = readFile("Shader/Frag.spv");
-
-    VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
-
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo {};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo {};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStageInfos[] = {vertShaderStageInfo, fragShaderStageInfo};
+    std::array<VkDescriptorSetLayout, 2> setLayouts {mDescriptorSetLayout, mBindlessResourceTable.getDescriptorSetLayout()};
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstantObject);
+    if (mVertShader.pushConstantSize > pushConstantRange.size)
+    {
+        std::cerr << "Push constant block of " << mVertShader.sourceName << " is larger than PushConstantObject!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo {};
+    VkPipelineLayout pipelineLayout;
+    if (vkCreatePipelineLayout(mLogicalDevice, &pipelineLayoutInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &pipelineLayout) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create pipeline layout" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mPipelineLayout = UniquePipelineLayout(pipelineLayout);
+}
 
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+void Application::createGraphicsPipelines()
+{
+    updateGraphicsPipelineKey();
 
+    std::vector<GraphicsPipelineKey> keys {mGraphicsPipelineKey};
+    if (mbDepthPrepass)
+    {
+        keys.push_back(getDepthPrepassPipelineKey());
+    }
+    if (mConfig.bPrecompilePipelinePermutations)
+    {
+        for (bool bSampleShading : {false, true})
+        {
+            for (BlendMode blendMode : {BlendMode::Opaque, BlendMode::AlphaBlend})
+            {
+                for (VkCullModeFlags cullMode : {VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_NONE})
+                {
+                    for (uint32_t featureFlags : {0u, static_cast<uint32_t>(PIPELINE_FEATURE_ALBEDO_TEXTURE_BIT)})
+                    {
+                        GraphicsPipelineKey key = mGraphicsPipelineKey;
+                        key.bSampleShading = bSampleShading;
+                        key.blendMode = blendMode;
+                        key.cullMode = cullMode;
+                        key.featureFlags = featureFlags;
+                        if (key != mGraphicsPipelineKey)
+                        {
+                            keys.push_back(key);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (!compileGraphicsPipelines(keys))
+    {
+        mbQuit = true;
+    }
+}
+
+bool Application::compileGraphicsPipelines(const std::vector<GraphicsPipelineKey>& keys)
+{
+    auto bindingDescription = Vertex::getBindingDescription();
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+    if (mVertShader.getVertexAttributeDescriptions(bindingDescription.binding, attributeDescriptions) != bindingDescription.stride)
+    {
+        std::cerr << "Vertex inputs of " << mVertShader.sourceName << " do not match the layout of Vertex!" << std::endl;
+        return false;
+    }
+
+    UniqueShaderModule vertShaderModule = createShaderModule(mVertShader);
+    UniqueShaderModule fragShaderModule = createShaderModule(mFragShader);
+
+    // Pipeline creation is free threaded and the cache synchronizes internally, so every key writes only its own result slot
+    std::vector<VkPipeline> pipelines(keys.size(), VK_NULL_HANDLE);
+    std::vector<double> milliseconds(keys.size(), 0.0);
+    auto begin = std::chrono::high_resolution_clock::now();
+    mPipelineCompilePool.parallelFor(keys.size(), [&](size_t i) {
+        auto keyBegin = std::chrono::high_resolution_clock::now();
+        pipelines[i] = buildGraphicsPipeline(keys[i], vertShaderModule, fragShaderModule, bindingDescription, attributeDescriptions);
+        milliseconds[i] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - keyBegin).count();
+    });
+    size_t threadCount = std::min<size_t>(keys.size(), mPipelineCompilePool.getThreadCount());
+    double totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+    vertShaderModule.reset();
+    fragShaderModule.reset();
+
+    bool bAllCompiled = true;
+    std::cout << "Compiled " << keys.size() << " graphics pipelines on " << threadCount << " threads in " << totalMilliseconds << " ms" << std::endl;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (pipelines[i] == VK_NULL_HANDLE)
+        {
+            std::cerr << "  Failed to create graphics pipeline: " << keys[i].toString() << std::endl;
+            bAllCompiled = false;
+            continue;
+        }
+        std::cout << "  " << milliseconds[i] << " ms: " << keys[i].toString() << std::endl;
+        // A replaced permutation may still be used by frames in flight
+        mCompiledGraphicsPipelineCount++;
+        UniquePipeline pipeline(pipelines[i]);
+        auto [it, bInserted] = mGraphicsPipelines.try_emplace(keys[i], std::move(pipeline));
+        if (!bInserted)
+        {
+            mDeletionQueue.retirePipeline(std::move(it->second), mFrameIndex);
+            it->second = std::move(pipeline);
+        }
+    }
+    return bAllCompiled;
+}
+
+VkPipeline Application::buildGraphicsPipeline(const GraphicsPipelineKey& key,
+                                              VkShaderModule vertShaderModule,
+                                              VkShaderModule fragShaderModule,
+                                              const VkVertexInputBindingDescription& bindingDescription,
+                                              const std::vector<VkVertexInputAttributeDescription>& attributeDescriptions) const
+{
+    struct FragmentSpecializationData
+    {
+        float uvScale;
+        VkBool32 bAlbedoTexture;
+    };
+    FragmentSpecializationData specializationData {key.uvScale, (key.featureFlags & PIPELINE_FEATURE_ALBEDO_TEXTURE_BIT) ? VK_TRUE : VK_FALSE};
+    std::array<VkSpecializationMapEntry, 2> specializationEntries {};
+    specializationEntries[0].constantID = GraphicsPipelineKey::UV_SCALE_CONSTANT_ID;
+    specializationEntries[0].offset = offsetof(FragmentSpecializationData, uvScale);
+    specializationEntries[0].size = sizeof(float);
+    specializationEntries[1].constantID = GraphicsPipelineKey::ALBEDO_TEXTURE_CONSTANT_ID;
+    specializationEntries[1].offset = offsetof(FragmentSpecializationData, bAlbedoTexture);
+    specializationEntries[1].size = sizeof(VkBool32);
+
+    VkSpecializationInfo specializationInfo {};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+    specializationInfo.pMapEntries = specializationEntries.data();
+    specializationInfo.dataSize = sizeof(FragmentSpecializationData);
+    specializationInfo.pData = &specializationData;
+
+    VkPipelineShaderStageCreateInfo vertShaderStageInfo {};
+    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertShaderStageInfo.module = vertShaderModule;
+    vertShaderStageInfo.pName = "main";
+
+    VkPipelineShaderStageCreateInfo fragShaderStageInfo {};
+    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragShaderStageInfo.module = fragShaderModule;
+    fragShaderStageInfo.pName = "main";
+    fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+    VkPipelineShaderStageCreateInfo shaderStageInfos[] = {vertShaderStageInfo, fragShaderStageInfo};
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo {};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputInfo.vertexBindingDescriptionCount = 1;
     vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
@@ -915,24 +1601,17 @@ void Application::createGraphicsPipeline()
     inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport {};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(mSwapchainExtent.width);
-    viewport.height = static_cast<float>(mSwapchainExtent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor {};
-    scissor.offset = {0, 0};
-    scissor.extent = mSwapchainExtent;
-
+    // Viewport and scissor are dynamic so permutations survive swapchain resizes
     VkPipelineViewportStateCreateInfo viewportState {};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+
+    std::array<VkDynamicState, 2> dynamicStates {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
 
     VkPipelineRasterizationStateCreateInfo rasterizationState {};
     rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -940,7 +1619,7 @@ void Application::createGraphicsPipeline()
     rasterizationState.rasterizerDiscardEnable = VK_FALSE;
     rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizationState.lineWidth = 1.0f;
-    rasterizationState.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizationState.cullMode = key.cullMode;
     rasterizationState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
     rasterizationState.depthBiasEnable = VK_FALSE;
     rasterizationState.depthBiasConstantFactor = 0.0f;
@@ -949,8 +1628,8 @@ void Application::createGraphicsPipeline()
 
     VkPipelineMultisampleStateCreateInfo multisampleState {};
     multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampleState.sampleShadingEnable = VK_TRUE;
-    multisampleState.rasterizationSamples = mMsaaSamples;
+    multisampleState.sampleShadingEnable = key.bSampleShading ? VK_TRUE : VK_FALSE;
+    multisampleState.rasterizationSamples = key.sampleCount;
     multisampleState.minSampleShading = 0.2f;
     multisampleState.pSampleMask = nullptr;
     multisampleState.alphaToCoverageEnable = VK_FALSE;
@@ -959,8 +1638,10 @@ void Application::createGraphicsPipeline()
     VkPipelineDepthStencilStateCreateInfo depthStencilState {};
     depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depthStencilState.depthTestEnable = VK_TRUE;
-    depthStencilState.depthWriteEnable = VK_TRUE;
-    depthStencilState.depthCompareOp = VK_COMPARE_OP_LESS;
+    // Blended geometry is tested against but does not occlude what is drawn after it.
+    // After a prepass depth is final, only the nearest surface of every pixel passes the EQUAL test.
+    depthStencilState.depthWriteEnable = key.blendMode == BlendMode::Opaque && key.depthPass != DepthPass::Shading ? VK_TRUE : VK_FALSE;
+    depthStencilState.depthCompareOp = key.depthPass == DepthPass::Shading ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS;
     depthStencilState.depthBoundsTestEnable = VK_FALSE;
     depthStencilState.minDepthBounds = 0.0f;  // Optional
     depthStencilState.maxDepthBounds = 1.0f;  // Optional
@@ -970,13 +1651,30 @@ void Application::createGraphicsPipeline()
 
     VkPipelineColorBlendAttachmentState colorBlendAttachmentState {};
     colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachmentState.blendEnable = VK_FALSE;
-    colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-    colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
-    colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+    if (key.depthPass == DepthPass::Prepass)
+    {
+        colorBlendAttachmentState.colorWriteMask = 0;
+    }
+    if (key.blendMode == BlendMode::AlphaBlend)
+    {
+        colorBlendAttachmentState.blendEnable = VK_TRUE;
+        colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+    else
+    {
+        colorBlendAttachmentState.blendEnable = VK_FALSE;
+        colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
 
     VkPipelineColorBlendStateCreateInfo colorBlendState {};
     colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -989,23 +1687,10 @@ void Application::createGraphicsPipeline()
     colorBlendState.blendConstants[2] = 0.0f;
     colorBlendState.blendConstants[3] = 0.0f;
 
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &mDescriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-    if (vkCreatePipelineLayout(mLogicalDevice, &pipelineLayoutInfo, nullptr, &mPipelineLayout) != VK_SUCCESS)
-    {
-        std::cerr << "Failed to create pipeline layout" << std::endl;
-        mbQuit = true;
-        return;
-    }
-
     VkGraphicsPipelineCreateInfo pipelineInfo {};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
+    // The prepass only needs positions, leaving out the fragment shader lets it run depth only
+    pipelineInfo.stageCount = key.depthPass == DepthPass::Prepass ? 1 : 2;
     pipelineInfo.pStages = shaderStageInfos;
     pipelineInfo.pVertexInputState = &vertexInputInfo;
     pipelineInfo.pInputAssemblyState = &inputAssembly;
@@ -1014,81 +1699,210 @@ void Application::createGraphicsPipeline()
     pipelineInfo.pMultisampleState = &multisampleState;
     pipelineInfo.pDepthStencilState = &depthStencilState;
     pipelineInfo.pColorBlendState = &colorBlendState;
-    pipelineInfo.pDynamicState = nullptr;
+    pipelineInfo.pDynamicState = &dynamicState;
 
     pipelineInfo.layout = mPipelineLayout;
 
-    pipelineInfo.renderPass = mRenderPass;
+    // Without a render pass the pipeline names its attachment formats instead
+    VkPipelineRenderingCreateInfoKHR renderingInfo {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &key.colorFormat;
+    renderingInfo.depthAttachmentFormat = findDepthFormat();
+    if (mbDynamicRendering)
+    {
+        pipelineInfo.pNext = &renderingInfo;
+        pipelineInfo.renderPass = VK_NULL_HANDLE;
+    }
+    else
+    {
+        pipelineInfo.renderPass = mRenderPass;
+    }
     pipelineInfo.subpass = 0;
 
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
-    if (vkCreateGraphicsPipelines(mLogicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &mGraphicsPipeline) != VK_SUCCESS)
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(mLogicalDevice, mPipelineCache, 1, &pipelineInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &pipeline) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+void Application::setViewportAndScissor(VkCommandBuffer commandBuffer)
+{
+    VkViewport viewport {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(mSwapchainExtent.width);
+    viewport.height = static_cast<float>(mSwapchainExtent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor {};
+    scissor.offset = {0, 0};
+    scissor.extent = mSwapchainExtent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+// Recording only looks pipelines up, compileActiveGraphicsPipelines builds them whenever the key changes
+VkPipeline Application::getGraphicsPipeline(const GraphicsPipelineKey& key) const
+{
+    auto it = mGraphicsPipelines.find(key);
+    return it != mGraphicsPipelines.end() ? it->second.get() : VK_NULL_HANDLE;
+}
+
+// Builds the permutations the next frame draws with that are not resident yet, permutations that were not
+// precompiled are built here rather than in the middle of recording a frame
+void Application::compileActiveGraphicsPipelines()
+{
+    std::vector<GraphicsPipelineKey> keys;
+    if (!mGraphicsPipelines.contains(mGraphicsPipelineKey))
+    {
+        keys.push_back(mGraphicsPipelineKey);
+    }
+    if (mbDepthPrepass && !mGraphicsPipelines.contains(getDepthPrepassPipelineKey()))
+    {
+        keys.push_back(getDepthPrepassPipelineKey());
+    }
+    if (!keys.empty() && !compileGraphicsPipelines(keys))
     {
-        std::cerr << "Failed to create graphics pipeline" << std::endl;
         mbQuit = true;
-        return;
     }
+}
 
-    vkDestroyShaderModule(mLogicalDevice, vertShaderModule, nullptr);
-    vkDestroyShaderModule(mLogicalDevice, fragShaderModule, nullptr);
+// The permutation used for drawing follows the anti-aliasing settings and the render pass
+void Application::updateGraphicsPipelineKey()
+{
+    mGraphicsPipelineKey.colorFormat = getSceneColorFormat();
+    mGraphicsPipelineKey.sampleCount = mMsaaSamples;
+    mGraphicsPipelineKey.bSampleShading = mAntiAliasing.bSampleShading;
+    mGraphicsPipelineKey.depthPass = mbDepthPrepass ? DepthPass::Shading : DepthPass::Combined;
 }
 
-void Application::createDescriptorSetLayout()
+// Permutations built for another render pass cannot be recompiled later, so they are dropped.
+// Dynamic rendering pipelines only depend on attachment formats and sample count, which are part of
+// the key, so permutations of other anti-aliasing tiers are kept for when the tier comes back.
+void Application::retireIncompatibleGraphicsPipelines()
 {
-    VkDescriptorSetLayoutBinding uboLayoutBinding {};
-    uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    uboLayoutBinding.descriptorCount = 1;
-    uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    uboLayoutBinding.pImmutableSamplers = nullptr;
+    if (mbDynamicRendering)
+    {
+        return;
+    }
+    for (auto it = mGraphicsPipelines.begin(); it != mGraphicsPipelines.end();)
+    {
+        if (it->first.colorFormat != mGraphicsPipelineKey.colorFormat || it->first.sampleCount != mGraphicsPipelineKey.sampleCount)
+        {
+            mDeletionQueue.retirePipeline(std::move(it->second), mFrameIndex);
+            it = mGraphicsPipelines.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
 
-    VkDescriptorSetLayoutBinding samplerLayoutBinding {};
-    samplerLayoutBinding.binding = 1;
-    samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerLayoutBinding.descriptorCount = 1;
-    samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    samplerLayoutBinding.pImmutableSamplers = nullptr;
+void Application::retireGraphicsPipelines()
+{
+    for (auto& [key, pipeline] : mGraphicsPipelines)
+    {
+        mDeletionQueue.retirePipeline(std::move(pipeline), mFrameIndex);
+    }
+    mGraphicsPipelines.clear();
+}
 
-    std::array<VkDescriptorSetLayoutBinding, 2> bindings {uboLayoutBinding, samplerLayoutBinding};
+void Application::createDescriptorSetLayout()
+{
+    // Set 0 holds per-frame data and is derived from shader reflection,
+    // textures and materials live in the bindless table (set 1)
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    for (const ShaderReflection* shader : SHADERS)
+    {
+        shader->collectDescriptorSetLayoutBindings(0, bindings);
+    }
 
     VkDescriptorSetLayoutCreateInfo uboLayoutInfo {};
     uboLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     uboLayoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
     uboLayoutInfo.pBindings = bindings.data();
 
-    if (vkCreateDescriptorSetLayout(mLogicalDevice, &uboLayoutInfo, nullptr, &mDescriptorSetLayout) != VK_SUCCESS)
+    VkDescriptorSetLayout descriptorSetLayout;
+    if (vkCreateDescriptorSetLayout(mLogicalDevice, &uboLayoutInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Descriptors), &descriptorSetLayout) != VK_SUCCESS)
     {
         std::cerr << "Failed to create descriptor set layout!" << std::endl;
         mbQuit = true;
+        return;
     }
+    mDescriptorSetLayout = UniqueDescriptorSetLayout(descriptorSetLayout);
 }
 
-VkShaderModule Application::createShaderModule(std::vector<char> shaderCode)
+void Application::createBindlessResourceTable()
+{
+    const VkPhysicalDeviceDescriptorIndexingProperties& descriptorIndexingProperties = mDeviceCapabilities.getDescriptorIndexingProperties();
+    uint32_t maxTextures = std::min({BINDLESS_MAX_TEXTURES,
+                                     descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                     descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages});
+    uint32_t maxStorageBuffers = std::min({BINDLESS_MAX_STORAGE_BUFFERS,
+                                           descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                           descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers});
+    mBindlessResourceTable.initialize(mLogicalDevice, maxTextures, maxStorageBuffers, mHostAllocator.getCallbacks(HostAllocationSubsystem::Descriptors));
+}
+
+void Application::createPipelineCache()
+{
+    // Kept for the lifetime of the device so swapchain recreation and shader hot reload
+    // only pay for the pipeline states that actually changed
+    VkPipelineCacheCreateInfo cacheInfo {};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+    VkPipelineCache pipelineCache;
+    if (vkCreatePipelineCache(mLogicalDevice, &cacheInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &pipelineCache) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create pipeline cache!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mPipelineCache = UniquePipelineCache(pipelineCache);
+}
+
+UniqueShaderModule Application::createShaderModule(const ShaderReflection& shader)
 {
     VkShaderModuleCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = shaderCode.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+    createInfo.codeSize = shader.codeSize;
+    createInfo.pCode = shader.code;
 
     VkShaderModule shaderModule;
 
-    if (vkCreateShaderModule(mLogicalDevice, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
+    if (vkCreateShaderModule(mLogicalDevice, &createInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &shaderModule) != VK_SUCCESS)
     {
-        throw std::runtime_error("Failed to create shader module!");
+        throw std::runtime_error(std::string("Failed to create shader module ") + shader.sourceName + "!");
     }
 
-    return shaderModule;
+    return UniqueShaderModule(shaderModule);
 }
 
 void Application::createFramebuffers()
 {
+    if (mbDynamicRendering)
+    {
+        return;
+    }
+
     mSwapchainFramebuffers.resize(mSwapchainImageViews.size());
 
     for (size_t i = 0; i < mSwapchainImageViews.size(); i++)
     {
-        std::array<VkImageView, 3> attachments {mColorImageView, mDepthImageView, mSwapchainImageViews[i]};
+        VkImageView targetView = mAntiAliasing.bPostProcess ? mSceneColorImageView : mSwapchainImageViews[i];
+        std::vector<VkImageView> attachments {mColorImageView, mDepthImageView, targetView};
+        if (mMsaaSamples == VK_SAMPLE_COUNT_1_BIT)
+        {
+            attachments = {targetView, mDepthImageView};
+        }
 
         VkFramebufferCreateInfo framebufferInfo {};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -1099,103 +1913,66 @@ void Application::createFramebuffers()
         framebufferInfo.height = mSwapchainExtent.height;
         framebufferInfo.layers = 1;
 
-        if (vkCreateFramebuffer(mLogicalDevice, &framebufferInfo, nullptr, &mSwapchainFramebuffers[i]) != VK_SUCCESS)
+        VkFramebuffer framebuffer;
+        if (vkCreateFramebuffer(mLogicalDevice, &framebufferInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Swapchain), &framebuffer) != VK_SUCCESS)
         {
             std::cerr << "Failed to create framebuffer!" << std::endl;
             mbQuit = true;
             return;
         }
+        mSwapchainFramebuffers[i] = UniqueFramebuffer(framebuffer);
     }
 }
 
 void Application::createCommandPool()
 {
-    QueueFamilyIndices queueFamilyIndices = findQueueFamilyIndices(mPhysicalDevice);
+    QueueFamilyIndices queueFamilyIndices = findQueueFamilyIndices(mDeviceCapabilities);
     VkCommandPoolCreateInfo poolInfo {};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
-    if (vkCreateCommandPool(mLogicalDevice, &poolInfo, nullptr, &mCommandPool) != VK_SUCCESS)
+    VkCommandPool commandPool;
+    if (vkCreateCommandPool(mLogicalDevice, &poolInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Commands), &commandPool) != VK_SUCCESS)
     {
         std::cerr << "Failed to create command pool!" << std::endl;
         mbQuit = true;
+        return;
     }
-}
-
-void Application::createColorResources()
-{
-    VkFormat colorFormat = mSwapchainImageFormat;
-    createImage(
-        mSwapchainExtent.width,
-        mSwapchainExtent.height,
-        1,
-        mMsaaSamples,
-        colorFormat,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        mColorImage,
-        mColorImageMemory);
-    mColorImageView = createImageView(mColorImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1);
-}
-
-void Application::createDepthResources()
-{
-    VkFormat depthFormat = findDepthFormat();
-    createImage(
-        mSwapchainExtent.width,
-        mSwapchainExtent.height,
-        1,
-        mMsaaSamples,
-        depthFormat,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        mDepthImage,
-        mDepthImageMemory);
-    mDepthImageView = createImageView(mDepthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
-
-    transitionImageLayout(mDepthImage, depthFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, 1);
+    mCommandPool = UniqueCommandPool(commandPool);
 }
 
 void Application::createVertexBuffer()
 {
     VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+    UniqueBuffer stagingBuffer;
+    UniqueDeviceMemory stagingBufferMemory;
+    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Staging, stagingBuffer, stagingBufferMemory);
 
     void* data;
     vkMapMemory(mLogicalDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
     memcpy(data, vertices.data(), static_cast<size_t>(bufferSize));
     vkUnmapMemory(mLogicalDevice, stagingBufferMemory);
 
-    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mVertexBuffer, mVertexBufferMemory);
+    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DeviceMemoryCategory::Vertex, mVertexBuffer, mVertexBufferMemory);
     copyBuffer(stagingBuffer, mVertexBuffer, bufferSize);
-
-    vkDestroyBuffer(mLogicalDevice, stagingBuffer, nullptr);
-    vkFreeMemory(mLogicalDevice, stagingBufferMemory, nullptr);
 }
 
 void Application::createIndexBuffer()
 {
     VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+    UniqueBuffer stagingBuffer;
+    UniqueDeviceMemory stagingBufferMemory;
+    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Staging, stagingBuffer, stagingBufferMemory);
 
     void* data;
     vkMapMemory(mLogicalDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
     memcpy(data, indices.data(), static_cast<size_t>(bufferSize));
     vkUnmapMemory(mLogicalDevice, stagingBufferMemory);
 
-    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, mIndexBuffer, mIndexBufferMemory);
+    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DeviceMemoryCategory::Index, mIndexBuffer, mIndexBufferMemory);
     copyBuffer(stagingBuffer, mIndexBuffer, bufferSize);
-
-    vkDestroyBuffer(mLogicalDevice, stagingBuffer, nullptr);
-    vkFreeMemory(mLogicalDevice, stagingBufferMemory, nullptr);
 }
 
 void Application::createUniformBuffers()
@@ -1206,29 +1983,30 @@ void Application::createUniformBuffers()
     VkDeviceSize bufferSize = sizeof(UniformBufferObject);
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
     {
-        createBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, mUniformBuffers[i], mUniformBuffersMemory[i]);
+        createBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Uniform, mUniformBuffers[i], mUniformBuffersMemory[i]);
     }
 }
 
 void Application::createDescriptorPool()
 {
-    std::array<VkDescriptorPoolSize, 2> poolSizes {};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    VkDescriptorPoolSize poolSize {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSize.descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
 
     VkDescriptorPoolCreateInfo poolInfo {};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
     poolInfo.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
 
-    if (vkCreateDescriptorPool(mLogicalDevice, &poolInfo, nullptr, &mDescriptorPool) != VK_SUCCESS)
+    VkDescriptorPool descriptorPool;
+    if (vkCreateDescriptorPool(mLogicalDevice, &poolInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Descriptors), &descriptorPool) != VK_SUCCESS)
     {
         std::cerr << "Failed to create Descriptor Pool!" << std::endl;
         mbQuit = true;
+        return;
     }
+    mDescriptorPool = UniqueDescriptorPool(descriptorPool);
 }
 
 void Application::createDescriptorSets()
@@ -1256,33 +2034,79 @@ void Application::createDescriptorSets()
         bufferInfo.offset = 0;
         bufferInfo.range = sizeof(UniformBufferObject);
 
-        VkDescriptorImageInfo imageInfo {};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = mTextureImageView;
-        imageInfo.sampler = mTextureSampler;
+        VkWriteDescriptorSet writeDescriptorSet {};
+        writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSet.dstSet = mDescriptorSets[i];
+        writeDescriptorSet.dstBinding = 0;
+        writeDescriptorSet.dstArrayElement = 0;
+        writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writeDescriptorSet.descriptorCount = 1;
+        writeDescriptorSet.pBufferInfo = &bufferInfo;
+        writeDescriptorSet.pImageInfo = nullptr;
+        writeDescriptorSet.pTexelBufferView = nullptr;
 
-        std::array<VkWriteDescriptorSet, 2> writeDescriptorSets {};
-        writeDescriptorSets[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeDescriptorSets[0].dstSet = mDescriptorSets[i];
-        writeDescriptorSets[0].dstBinding = 0;
-        writeDescriptorSets[0].dstArrayElement = 0;
-        writeDescriptorSets[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        writeDescriptorSets[0].descriptorCount = 1;
-        writeDescriptorSets[0].pBufferInfo = &bufferInfo;
-        writeDescriptorSets[0].pImageInfo = nullptr;
-        writeDescriptorSets[0].pTexelBufferView = nullptr;
+        vkUpdateDescriptorSets(mLogicalDevice, 1, &writeDescriptorSet, 0, nullptr);
+    }
+}
 
-        writeDescriptorSets[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeDescriptorSets[1].dstSet = mDescriptorSets[i];
-        writeDescriptorSets[1].dstBinding = 1;
-        writeDescriptorSets[1].dstArrayElement = 0;
-        writeDescriptorSets[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        writeDescriptorSets[1].descriptorCount = 1;
-        writeDescriptorSets[1].pBufferInfo = nullptr;
-        writeDescriptorSets[1].pImageInfo = &imageInfo;
-        writeDescriptorSets[1].pTexelBufferView = nullptr;
+void Application::createMaterials()
+{
+    // Every stress material gets a distinct image, so the stress scene measures descriptor and residency cost for as
+    // many textures as it has table slots. They are kept small, a solid color each, to bound the upload time.
+    const int STRESS_TEXTURE_SIZE = 16;
+    std::vector<unsigned char> stressPixels(STRESS_TEXTURE_SIZE * STRESS_TEXTURE_SIZE * STBI_rgb_alpha);
+    mStressTextures.resize(mConfig.bindlessStressTextureCount);
+    for (uint32_t i = 0; i < mConfig.bindlessStressTextureCount; i++)
+    {
+        for (size_t pixel = 0; pixel < stressPixels.size(); pixel += STBI_rgb_alpha)
+        {
+            stressPixels[pixel + 0] = static_cast<unsigned char>(i * 37);
+            stressPixels[pixel + 1] = static_cast<unsigned char>(i * 91);
+            stressPixels[pixel + 2] = static_cast<unsigned char>(i * 157);
+            stressPixels[pixel + 3] = 255;
+        }
+        StressTexture& texture = mStressTextures[i];
+        uint32_t mipLevels;
+        uploadTextureImage(stressPixels.data(), STRESS_TEXTURE_SIZE, STRESS_TEXTURE_SIZE, texture.image, texture.memory, mipLevels);
+        texture.imageView = createImageView(texture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
+    }
 
-        vkUpdateDescriptorSets(mLogicalDevice, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+    uint32_t materialCount = 1 + mConfig.bindlessStressTextureCount;
+    mMaterials.resize(materialCount);
+    for (uint32_t i = 0; i < materialCount; i++)
+    {
+        VkImageView imageView = i == 0 ? mTextureImageView : mStressTextures[i - 1].imageView;
+        mMaterials[i].baseColor = glm::vec4(1.0f);
+        mMaterials[i].albedoTextureIndex = mBindlessResourceTable.registerTexture(imageView, mTextureSampler);
+    }
+    // Distant objects all share the first material
+    mDrawObjects.resize(materialCount + mConfig.distantObjectCount);
+    mDrawObjectEntities.resize(mDrawObjects.size());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(mDrawObjects.size()); i++)
+    {
+        Entity entity = mScene.createEntity();
+        mScene.getMeshes().add(entity.index, {0});
+        mScene.getMaterials().add(entity.index, {i < materialCount ? i : 0});
+        mDrawObjectEntities[i] = entity;
+        mEntityDrawObjects.resize(std::max<size_t>(mEntityDrawObjects.size(), entity.index + 1));
+        mEntityDrawObjects[entity.index] = i;
+        mDrawObjects[i].model = glm::mat4(1.0f);
+        mDrawObjects[i].materialIndex = mScene.getMaterials().get(entity.index).materialIndex;
+    }
+    mDrawObjectLods.assign(mDrawObjects.size(), 0);
+    updateModelBounds();
+
+    VkDeviceSize bufferSize = sizeof(Material) * mMaterials.size();
+    createBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Storage, mMaterialBuffer, mMaterialBufferMemory);
+
+    void* data;
+    vkMapMemory(mLogicalDevice, mMaterialBufferMemory, 0, bufferSize, 0, &data);
+    memcpy(data, mMaterials.data(), static_cast<size_t>(bufferSize));
+    vkUnmapMemory(mLogicalDevice, mMaterialBufferMemory);
+
+    if (mBindlessResourceTable.registerStorageBuffer(mMaterialBuffer, 0, bufferSize) != MATERIAL_BUFFER_INDEX)
+    {
+        throw std::runtime_error("Material buffer must occupy the first bindless storage buffer slot!");
     }
 }
 
@@ -1313,35 +2137,168 @@ void Application::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t im
     {
         throw std::runtime_error("Failed to begin recording command buffer!");
     }
+    if (mTimestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdResetQueryPool(commandBuffer, mTimestampQueryPool, 2 * mCurrentFrame, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, mTimestampQueryPool, 2 * mCurrentFrame);
+    }
+    // Queries cannot be reset inside the render pass that uses them
+    if (mPipelineStatisticsQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdResetQueryPool(commandBuffer, mPipelineStatisticsQueryPool, mCurrentFrame, 1);
+    }
+    // The frame graph only tracks images, the culling dispatch and its buffer barriers come first
+    recordMeshletCulling(commandBuffer);
 
-    VkRenderPassBeginInfo renderPassInfo {};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = mRenderPass;
-    renderPassInfo.framebuffer = mSwapchainFramebuffers[imageIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = mSwapchainExtent;
+    // Passes, barriers and the final transition to present all come from the frame graph
+    mImageIndex = imageIndex;
+    mFrameGraph.bindImage(mFrameGraphSwapchainImage, mSwapchainImages[imageIndex]);
+    mFrameGraph.execute(commandBuffer);
 
-    std::array<VkClearValue, 2> clearValues {};
-    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};  // clear color
-    clearValues[1].depthStencil = {1.0f, 0};
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+    if (mTimestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, mTimestampQueryPool, 2 * mCurrentFrame + 1);
+        mbTimestampsWritten[mCurrentFrame] = true;
+    }
+    if (mPipelineStatisticsQueryPool != VK_NULL_HANDLE)
+    {
+        mbPipelineStatisticsWritten[mCurrentFrame] = true;
+    }
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mGraphicsPipeline);
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to record command buffer!");
+    }
+}
+
+void Application::recordScenePass(VkCommandBuffer commandBuffer)
+{
+    beginScenePass(commandBuffer);
+    if (mPipelineStatisticsQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdBeginQuery(commandBuffer, mPipelineStatisticsQueryPool, mCurrentFrame, 0);
+    }
+    setViewportAndScissor(commandBuffer);
 
     VkBuffer vertexBuffers[] = {mVertexBuffer};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
     vkCmdBindIndexBuffer(commandBuffer, mIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1, &mDescriptorSets[mCurrentFrame], 0, nullptr);
+    // Both sets are bound once, per-draw data travels in push constants
+    std::array<VkDescriptorSet, 2> descriptorSets {mDescriptorSets[mCurrentFrame], mBindlessResourceTable.getDescriptorSet()};
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
     // vkCmdDraw(commandBuffer, static_cast<uint32_t>(vertices.size()), 1, 0, 0);
-    vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
-    vkCmdEndRenderPass(commandBuffer);
+    // A permutation that failed to compile has already stopped the application, its draws are skipped until then
+    VkPipeline depthPrepassPipeline = mbDepthPrepass ? getGraphicsPipeline(getDepthPrepassPipelineKey()) : VK_NULL_HANDLE;
+    if (depthPrepassPipeline != VK_NULL_HANDLE)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, depthPrepassPipeline);
+        recordDrawList(commandBuffer, mDepthPrepassDraws);
+    }
+    VkPipeline shadingPipeline = getGraphicsPipeline(mGraphicsPipelineKey);
+    if (shadingPipeline != VK_NULL_HANDLE)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shadingPipeline);
+        recordDrawList(commandBuffer, mShadingDraws);
+    }
 
-    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    if (mPipelineStatisticsQueryPool != VK_NULL_HANDLE)
     {
-        throw std::runtime_error("Failed to record command buffer!");
+        vkCmdEndQuery(commandBuffer, mPipelineStatisticsQueryPool, mCurrentFrame);
+    }
+    endScenePass(commandBuffer);
+}
+
+void Application::recordDrawList(VkCommandBuffer commandBuffer, std::span<const DrawCommand> draws)
+{
+    for (const DrawCommand& draw : draws)
+    {
+        vkCmdPushConstants(commandBuffer, mPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantObject), &mDrawObjects[draw.objectIndex]);
+        // Slots are only assigned for this frame while any object is culled
+        uint32_t slot = mMeshletSlotCount > 0 ? mMeshletObjectSlots[draw.objectIndex] : NO_MESHLET_SLOT;
+        if (slot != NO_MESHLET_SLOT)
+        {
+            // The meshlets that survived culling, counted on the GPU
+            const MeshletCullingFrame& frame = mMeshletCullingFrames[mCurrentFrame];
+            uint32_t meshletCount = mMeshletCullingConstants.meshletCount;
+            mCmdDrawIndexedIndirectCount(commandBuffer, frame.drawBuffer, static_cast<VkDeviceSize>(slot) * meshletCount * sizeof(VkDrawIndexedIndirectCommand), frame.drawCountBuffer,
+                                         slot * sizeof(uint32_t), meshletCount, sizeof(VkDrawIndexedIndirectCommand));
+            continue;
+        }
+        const MeshLod& lod = mMeshLods[mDrawObjectLods[draw.objectIndex]];
+        vkCmdDrawIndexed(commandBuffer, lod.indexCount, 1, lod.firstIndex, 0, 0);
+    }
+}
+
+// Same attachments, load and store ops either way, the frame graph has already put them in their attachment layouts
+void Application::beginScenePass(VkCommandBuffer commandBuffer)
+{
+    std::array<VkClearValue, 2> clearValues {};
+    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};  // clear color
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    if (!mbDynamicRendering)
+    {
+        VkRenderPassBeginInfo renderPassInfo {};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = mRenderPass;
+        renderPassInfo.framebuffer = mSwapchainFramebuffers[mImageIndex];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = mSwapchainExtent;
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        return;
+    }
+
+    VkImageView targetView = mAntiAliasing.bPostProcess ? mSceneColorImageView : mSwapchainImageViews[mImageIndex];
+    VkRenderingAttachmentInfoKHR colorAttachment {};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.clearValue = clearValues[0];
+    if (mMsaaSamples != VK_SAMPLE_COUNT_1_BIT)
+    {
+        colorAttachment.imageView = mColorImageView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT_KHR;
+        colorAttachment.resolveImageView = targetView;
+        colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+    else
+    {
+        colorAttachment.imageView = targetView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    }
+
+    VkRenderingAttachmentInfoKHR depthAttachment {};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    depthAttachment.imageView = mDepthImageView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue = clearValues[1];
+
+    VkRenderingInfoKHR renderingInfo {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = mSwapchainExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+    mCmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void Application::endScenePass(VkCommandBuffer commandBuffer)
+{
+    if (mbDynamicRendering)
+    {
+        mCmdEndRendering(commandBuffer);
+    }
+    else
+    {
+        vkCmdEndRenderPass(commandBuffer);
     }
 }
 
@@ -1360,46 +2317,52 @@ void Application::createSyncronizationObjects()
 
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
     {
-        if (vkCreateSemaphore(mLogicalDevice, &semaphoreInfo, nullptr, &mImageAvailableSemaphores[i]) != VK_SUCCESS)
+        VkSemaphore imageAvailableSemaphore;
+        if (vkCreateSemaphore(mLogicalDevice, &semaphoreInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Synchronization), &imageAvailableSemaphore) != VK_SUCCESS)
         {
             std::cerr << "Failed to create Image Available Semaphore!" << std::endl;
             mbQuit = true;
             return;
         }
+        mImageAvailableSemaphores[i] = UniqueSemaphore(imageAvailableSemaphore);
 
-        if (vkCreateSemaphore(mLogicalDevice, &semaphoreInfo, nullptr, &mRenderFinishedSemaphores[i]) != VK_SUCCESS)
+        VkSemaphore renderFinishedSemaphore;
+        if (vkCreateSemaphore(mLogicalDevice, &semaphoreInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Synchronization), &renderFinishedSemaphore) != VK_SUCCESS)
         {
             std::cerr << "Failed to create Render Finished Semaphore!" << std::endl;
             mbQuit = true;
             return;
         }
+        mRenderFinishedSemaphores[i] = UniqueSemaphore(renderFinishedSemaphore);
 
-        if (vkCreateFence(mLogicalDevice, &fenceInfo, nullptr, &mInFlightFences[i]) != VK_SUCCESS)
+        VkFence inFlightFence;
+        if (vkCreateFence(mLogicalDevice, &fenceInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Synchronization), &inFlightFence) != VK_SUCCESS)
         {
             std::cerr << "Failed to create In Flight Fence!" << std::endl;
             mbQuit = true;
             return;
         }
+        mInFlightFences[i] = UniqueFence(inFlightFence);
     }
 }
 
 uint32_t Application::findPhysicalDeviceMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
 {
-    VkPhysicalDeviceMemoryProperties memoryProperties;
-    vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &memoryProperties);
-
-    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    uint32_t typeIndex;
+    if (mDeviceCapabilities.findMemoryType(typeFilter, properties, typeIndex))
     {
-        if ((typeFilter & (1 << i)) && ((memoryProperties.memoryTypes[i].propertyFlags & properties) == properties))
-        {
-            return i;
-        }
+        return typeIndex;
     }
-
     throw std::runtime_error("Failed to find suitable physical device memory type!");
 }
 
-void Application::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+void Application::createBuffer(VkDeviceSize size,
+                               VkBufferUsageFlags usage,
+                               VkMemoryPropertyFlags properties,
+                               DeviceMemoryCategory category,
+                               UniqueBuffer& buffer,
+                               UniqueDeviceMemory& bufferMemory,
+                               std::source_location location)
 {
     VkBufferCreateInfo bufferInfo {};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -1407,25 +2370,32 @@ void Application::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMe
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    if (vkCreateBuffer(mLogicalDevice, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+    VkBuffer newBuffer;
+    if (vkCreateBuffer(mLogicalDevice, &bufferInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources), &newBuffer) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create buffer!");
     }
+    // Owned right away so the buffer is destroyed if allocating its memory throws
+    UniqueBuffer ownedBuffer(newBuffer, 0, location);
 
     VkMemoryRequirements memoryRequirements;
-    vkGetBufferMemoryRequirements(mLogicalDevice, buffer, &memoryRequirements);
+    vkGetBufferMemoryRequirements(mLogicalDevice, newBuffer, &memoryRequirements);
 
     VkMemoryAllocateInfo allocInfo {};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     allocInfo.allocationSize = memoryRequirements.size;
     allocInfo.memoryTypeIndex = findPhysicalDeviceMemoryType(memoryRequirements.memoryTypeBits, properties);
 
-    if (vkAllocateMemory(mLogicalDevice, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+    VkDeviceMemory newBufferMemory;
+    if (vkAllocateMemory(mLogicalDevice, &allocInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources), &newBufferMemory) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to allocate buffer memory!");
     }
+    mDeviceMemoryTracker.add(newBufferMemory, allocInfo.memoryTypeIndex, allocInfo.allocationSize, category);
 
-    vkBindBufferMemory(mLogicalDevice, buffer, bufferMemory, 0);
+    vkBindBufferMemory(mLogicalDevice, newBuffer, newBufferMemory, 0);
+    buffer = std::move(ownedBuffer);
+    bufferMemory = UniqueDeviceMemory(newBufferMemory, allocInfo.allocationSize, location);
 }
 
 void Application::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
@@ -1441,7 +2411,18 @@ void Application::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSiz
     endSingleTimeCommands(commandBuffer);
 }
 
-void Application::createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
+void Application::createImage(uint32_t width,
+                              uint32_t height,
+                              uint32_t mipLevels,
+                              VkSampleCountFlagBits numSamples,
+                              VkFormat format,
+                              VkImageTiling tiling,
+                              VkImageUsageFlags usage,
+                              VkMemoryPropertyFlags properties,
+                              DeviceMemoryCategory category,
+                              UniqueImage& image,
+                              UniqueDeviceMemory& imageMemory,
+                              std::source_location location)
 {
     VkImageCreateInfo imageInfo {};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -1459,28 +2440,34 @@ void Application::createImage(uint32_t width, uint32_t height, uint32_t mipLevel
     imageInfo.samples = numSamples;
     imageInfo.flags = 0;
 
-    if (vkCreateImage(mLogicalDevice, &imageInfo, nullptr, &image) != VK_SUCCESS)
+    VkImage newImage;
+    if (vkCreateImage(mLogicalDevice, &imageInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources), &newImage) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create image");
     }
+    UniqueImage ownedImage(newImage, 0, location);
 
     VkMemoryRequirements memoryRequirements;
-    vkGetImageMemoryRequirements(mLogicalDevice, image, &memoryRequirements);
+    vkGetImageMemoryRequirements(mLogicalDevice, newImage, &memoryRequirements);
 
     VkMemoryAllocateInfo allocInfo {};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     allocInfo.allocationSize = memoryRequirements.size;
     allocInfo.memoryTypeIndex = findPhysicalDeviceMemoryType(memoryRequirements.memoryTypeBits, properties);
 
-    if (vkAllocateMemory(mLogicalDevice, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
+    VkDeviceMemory newImageMemory;
+    if (vkAllocateMemory(mLogicalDevice, &allocInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources), &newImageMemory) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to allocate image memory");
     }
+    mDeviceMemoryTracker.add(newImageMemory, allocInfo.memoryTypeIndex, allocInfo.allocationSize, category);
 
-    vkBindImageMemory(mLogicalDevice, image, imageMemory, 0);
+    vkBindImageMemory(mLogicalDevice, newImage, newImageMemory, 0);
+    image = std::move(ownedImage);
+    imageMemory = UniqueDeviceMemory(newImageMemory, allocInfo.allocationSize, location);
 }
 
-VkImageView Application::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels)
+UniqueImageView Application::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels, std::source_location location)
 {
     VkImageViewCreateInfo viewInfo {};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -1500,12 +2487,12 @@ VkImageView Application::createImageView(VkImage image, VkFormat format, VkImage
     viewInfo.subresourceRange.layerCount = 1;
 
     VkImageView imageView;
-    if (vkCreateImageView(mLogicalDevice, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
+    if (vkCreateImageView(mLogicalDevice, &viewInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources), &imageView) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create image view");
     }
 
-    return imageView;
+    return UniqueImageView(imageView, 0, location);
 }
 
 void Application::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
@@ -1530,8 +2517,7 @@ void Application::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t wid
 
 void Application::generateMipmaps(VkImage image, VkFormat imageFormat, int32_t width, int32_t height, uint32_t mipLevels)
 {
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, imageFormat, &formatProperties);
+    VkFormatProperties formatProperties = mDeviceCapabilities.getFormatProperties(imageFormat);
     if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
     {
         throw std::runtime_error("Texture image format does not support linear blitting!");
@@ -1644,10 +2630,23 @@ void Application::updateUniformBuffer(uint32_t currentImageIndex)
     float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
     UniformBufferObject ubo {};
-    ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
     ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-    ubo.projection = glm::perspective(glm::radians(45.0f), mSwapchainExtent.width / static_cast<float>(mSwapchainExtent.height), 0.1f, 10.0f);
+    ubo.projection = glm::perspective(glm::radians(45.0f), mSwapchainExtent.width / static_cast<float>(mSwapchainExtent.height), 0.1f, 100.0f);
     ubo.projection[1][1] = -1;
+    if (mFrameReplay.isOpen())
+    {
+        const FrameCaptureRecord& frame = mFrameReplay.getFrame(mReplayFrame);
+        time = frame.time;
+        ubo.view = frame.view;
+        ubo.projection = frame.projection;
+    }
+    mFrameInputs.time = time;
+    mFrameInputs.view = ubo.view;
+    mFrameInputs.projection = ubo.projection;
+
+    updateDrawObjects(time);
+    buildDrawLists(ubo.view, ubo.projection);
+    updateMeshletCulling(ubo.view, ubo.projection);
 
     void* data;
     vkMapMemory(mLogicalDevice, mUniformBuffersMemory[currentImageIndex], 0, sizeof(ubo), 0, &data);
@@ -1655,46 +2654,138 @@ void Application::updateUniformBuffer(uint32_t currentImageIndex)
     vkUnmapMemory(mLogicalDevice, mUniformBuffersMemory[currentImageIndex]);
 }
 
-void Application::createTextureImage()
+void Application::updateDrawObjects(float time)
 {
-    int textureWidth, textureHeight, textureChannels;
-    stbi_uc* pixels = stbi_load(texturePath.c_str(), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
-    if (!pixels)
+    glm::quat rotation = glm::angleAxis(time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    // Stress scene objects are laid out on a grid behind the main one
+    const uint32_t GRID_WIDTH = 32;
+    // Distant objects fill a wedge facing away from the camera, far enough to pick coarse levels of detail
+    const float DISTANT_MIN_DISTANCE = 5.0f;
+    const float DISTANT_MAX_DISTANCE = 60.0f;
+    const float DISTANT_HALF_ANGLE = glm::radians(20.0f);
+    const float GOLDEN_RATIO_FRACTION = 0.618034f;
+    uint32_t firstDistantObject = static_cast<uint32_t>(mDrawObjects.size()) - mConfig.distantObjectCount;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(mDrawObjects.size()); i++)
+    {
+        glm::vec3 offset(0.0f);
+        if (i >= firstDistantObject)
+        {
+            float t = (i - firstDistantObject + 0.5f) / mConfig.distantObjectCount;
+            float distance = DISTANT_MIN_DISTANCE + t * (DISTANT_MAX_DISTANCE - DISTANT_MIN_DISTANCE);
+            float spread = std::fmod((i - firstDistantObject) * GOLDEN_RATIO_FRACTION, 1.0f) * 2.0f - 1.0f;
+            float angle = glm::radians(225.0f) + spread * DISTANT_HALF_ANGLE;
+            offset = glm::vec3(std::cos(angle) * distance, std::sin(angle) * distance, 0.0f);
+        }
+        else if (i > 0)
+        {
+            offset = glm::vec3(-static_cast<float>(i / GRID_WIDTH) * 1.5f, static_cast<float>(i % GRID_WIDTH) * 1.5f - GRID_WIDTH * 0.75f, 0.0f);
+        }
+        mScene.setLocalTransform(mDrawObjectEntities[i], {offset, rotation, glm::vec3(1.0f)});
+    }
+
+    mScene.updateTransforms();
+    for (const Entity& entity : mScene.getChangedEntities())
+    {
+        mDrawObjects[mEntityDrawObjects[entity.index]].model = mScene.getWorldMatrix(entity);
+    }
+}
+
+// Every draw object shows the model, so they all share its bounds
+void Application::updateModelBounds()
+{
+    glm::vec3 minimum(std::numeric_limits<float>::max());
+    glm::vec3 maximum(-std::numeric_limits<float>::max());
+    for (const Vertex& vertex : vertices)
+    {
+        minimum = glm::min(minimum, vertex.pos);
+        maximum = glm::max(maximum, vertex.pos);
+    }
+    BoundingSphere bounds {(minimum + maximum) * 0.5f, 0.0f};
+    for (const Vertex& vertex : vertices)
+    {
+        bounds.radius = std::max(bounds.radius, glm::length(vertex.pos - bounds.center));
+    }
+    for (const Entity& entity : mDrawObjectEntities)
+    {
+        mScene.setLocalBounds(entity, bounds);
+    }
+}
+
+void Application::decodeTextureImage()
+{
+    auto startTime = std::chrono::steady_clock::now();
+    FileView file;
+    if (!mFileSystem.open(texturePath, file))
+    {
+        throw std::runtime_error("Failed to open " + texturePath);
+    }
+    DerivedDataKey key = DerivedDataKey("Texture", TEXTURE_IMPORTER_VERSION).addValue(STBI_rgb_alpha).add(file.getBytes());
+    FileView cooked;
+    if (mDerivedDataCache.load(key, cooked))
+    {
+        DerivedDataReader reader(cooked.getBytes());
+        std::shared_ptr<std::vector<unsigned char>> pixels = std::make_shared<std::vector<unsigned char>>();
+        if (reader.read(mDecodedTexture.width) && reader.read(mDecodedTexture.height) && reader.readVector(*pixels) && reader.isAtEnd() &&
+            pixels->size() == static_cast<size_t>(mDecodedTexture.width) * mDecodedTexture.height * STBI_rgb_alpha)
+        {
+            mDecodedTexture.pixels = std::shared_ptr<unsigned char>(pixels, pixels->data());
+            return;
+        }
+    }
+
+    int textureChannels;
+    const stbi_uc* encoded = reinterpret_cast<const stbi_uc*>(file.getData());
+    mDecodedTexture.pixels.reset(stbi_load_from_memory(encoded, static_cast<int>(file.getSize()), &mDecodedTexture.width, &mDecodedTexture.height, &textureChannels, STBI_rgb_alpha),
+                                 stbi_image_free);
+    if (!mDecodedTexture.pixels)
     {
         throw std::runtime_error("Failed to load Texture Image!");
     }
-    mMipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(textureWidth, textureHeight)))) + 1;
+
+    const unsigned char* pixels = mDecodedTexture.pixels.get();
+    DerivedDataWriter writer;
+    writer.write(mDecodedTexture.width);
+    writer.write(mDecodedTexture.height);
+    writer.writeVector(std::vector<unsigned char>(pixels, pixels + static_cast<size_t>(mDecodedTexture.width) * mDecodedTexture.height * STBI_rgb_alpha));
+    mDerivedDataCache.store(key, writer.getBytes(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+void Application::createTextureImage()
+{
+    uploadTextureImage(mDecodedTexture.pixels.get(), mDecodedTexture.width, mDecodedTexture.height, mTextureImage, mTextureImageMemory, mMipLevels);
+    mDecodedTexture = {};
+}
+
+void Application::uploadTextureImage(const unsigned char* pixels, int textureWidth, int textureHeight, UniqueImage& image, UniqueDeviceMemory& imageMemory, uint32_t& mipLevels)
+{
+    mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(textureWidth, textureHeight)))) + 1;
     VkDeviceSize imageSize = textureWidth * textureHeight * STBI_rgb_alpha;
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+    UniqueBuffer stagingBuffer;
+    UniqueDeviceMemory stagingBufferMemory;
+    createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Staging, stagingBuffer, stagingBufferMemory);
 
     void* data;
     vkMapMemory(mLogicalDevice, stagingBufferMemory, 0, imageSize, 0, &data);
     memcpy(data, pixels, static_cast<size_t>(imageSize));
     vkUnmapMemory(mLogicalDevice, stagingBufferMemory);
 
-    stbi_image_free(pixels);
-
     createImage(
         static_cast<uint32_t>(textureWidth),
         static_cast<uint32_t>(textureHeight),
-        mMipLevels,
+        mipLevels,
         VK_SAMPLE_COUNT_1_BIT,
         VK_FORMAT_R8G8B8A8_SRGB,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        mTextureImage,
-        mTextureImageMemory);
+        DeviceMemoryCategory::Texture,
+        image,
+        imageMemory);
 
-    transitionImageLayout(mTextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mMipLevels);
-    copyBufferToImage(stagingBuffer, mTextureImage, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
-    generateMipmaps(mTextureImage, VK_FORMAT_R8G8B8A8_SRGB, textureWidth, textureHeight, mMipLevels);
-
-    vkDestroyBuffer(mLogicalDevice, stagingBuffer, nullptr);
-    vkFreeMemory(mLogicalDevice, stagingBufferMemory, nullptr);
+    transitionImageLayout(image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+    copyBufferToImage(stagingBuffer, image, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
+    generateMipmaps(image, VK_FORMAT_R8G8B8A8_SRGB, textureWidth, textureHeight, mipLevels);
 }
 
 void Application::createTextureImageView()
@@ -1713,7 +2804,7 @@ void Application::createTextureSampler()
     samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
 
     samplerInfo.anisotropyEnable = VK_TRUE;
-    samplerInfo.maxAnisotropy = mPhysicalDeviceProperties.limits.maxSamplerAnisotropy;
+    samplerInfo.maxAnisotropy = mDeviceCapabilities.getProperties().limits.maxSamplerAnisotropy;
 
     samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
     samplerInfo.unnormalizedCoordinates = VK_FALSE;
@@ -1726,15 +2817,17 @@ void Application::createTextureSampler()
     samplerInfo.minLod = 0.0f;
     samplerInfo.maxLod = static_cast<float>(mMipLevels);
 
-    if (vkCreateSampler(mLogicalDevice, &samplerInfo, nullptr, &mTextureSampler) != VK_SUCCESS)
+    VkSampler sampler;
+    if (vkCreateSampler(mLogicalDevice, &samplerInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources), &sampler) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create texture sampler");
     }
+    mTextureSampler = UniqueSampler(sampler);
 }
 
 VkSampleCountFlagBits Application::getMaxUsableSampleCount() const
 {
-    VkSampleCountFlags counts = mPhysicalDeviceProperties.limits.framebufferColorSampleCounts & mPhysicalDeviceProperties.limits.framebufferDepthSampleCounts;
+    VkSampleCountFlags counts = mDeviceCapabilities.getProperties().limits.framebufferColorSampleCounts & mDeviceCapabilities.getProperties().limits.framebufferDepthSampleCounts;
 
     if (counts & VK_SAMPLE_COUNT_64_BIT)
     {
@@ -1766,72 +2859,27 @@ VkSampleCountFlagBits Application::getMaxUsableSampleCount() const
 
 void Application::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
 {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    VkImageMemoryBarrier imageMemoryBarrier {};
-    imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    imageMemoryBarrier.oldLayout = oldLayout;
-    imageMemoryBarrier.newLayout = newLayout;
-    imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageMemoryBarrier.image = image;
+    VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
     {
-        imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
         if (hasStencilComponent(format))
         {
-            imageMemoryBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+            aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
         }
     }
-    else
-    {
-        imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    }
-    imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
-    imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
-    imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-    imageMemoryBarrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        imageMemoryBarrier.srcAccessMask = 0;
-        imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-    {
-        imageMemoryBarrier.srcAccessMask = 0;
-        imageMemoryBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    }
-    else
-    {
-        throw std::invalid_argument("Unsupported layout transition!");
-    }
-
-    vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 
+    // Stages and accesses follow from the layouts, so any pair of layouts can be transitioned
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    mFrameGraph.recordImageBarrier(commandBuffer, image, aspectMask, mipLevels, getLayoutState(oldLayout), getLayoutState(newLayout));
     endSingleTimeCommands(commandBuffer);
 }
 
-VkFormat Application::findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features)
+VkFormat Application::findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const
 {
     for (VkFormat format : candidates)
     {
-        VkFormatProperties formatProperties;
-        vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, format, &formatProperties);
+        VkFormatProperties formatProperties = mDeviceCapabilities.getFormatProperties(format);
 
         if (tiling == VK_IMAGE_TILING_LINEAR && (formatProperties.linearTilingFeatures & features) == features)
         {
@@ -1846,7 +2894,7 @@ VkFormat Application::findSupportedFormat(const std::vector<VkFormat>& candidate
     throw std::runtime_error("Failed to find supported format!");
 }
 
-VkFormat Application::findDepthFormat()
+VkFormat Application::findDepthFormat() const
 {
     return findSupportedFormat({VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 }
@@ -1857,12 +2905,117 @@ bool Application::hasStencilComponent(VkFormat format)
 }
 
 void Application::loadModel()
+{
+    auto startTime = std::chrono::steady_clock::now();
+    FileView file;
+    if (!mFileSystem.open(modelPath, file))
+    {
+        throw std::runtime_error("Failed to open " + modelPath);
+    }
+    DerivedDataKey key = DerivedDataKey("Model", MODEL_IMPORTER_VERSION).add(file.getBytes());
+    mModelCacheKey = key.toString();
+    FileView cooked;
+    if (mDerivedDataCache.load(key, cooked))
+    {
+        DerivedDataReader reader(cooked.getBytes());
+        if (reader.readVector(vertices) && reader.readVector(indices) && reader.readVector(mMeshLods) && reader.isAtEnd() && !mMeshLods.empty())
+        {
+            return;
+        }
+        vertices.clear();
+        indices.clear();
+        mMeshLods.clear();
+    }
+
+    parseModel(file, vertices, indices);
+    mMeshLods = buildModelLods(vertices, indices);
+
+    DerivedDataWriter writer;
+    writer.writeVector(vertices);
+    writer.writeVector(indices);
+    writer.writeVector(mMeshLods);
+    mDerivedDataCache.store(key, writer.getBytes(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+void Application::loadModelMeshlets()
+{
+    if (!mbMeshletCullingSupported)
+    {
+        return;
+    }
+    auto startTime = std::chrono::steady_clock::now();
+    // Built from the cooked model, so keyed by the model's key rather than its source
+    DerivedDataKey key = DerivedDataKey("Meshlets", MESHLET_IMPORTER_VERSION).add(mModelCacheKey).addValue(MESHLET_MAX_VERTICES).addValue(MESHLET_MAX_TRIANGLES);
+    FileView cooked;
+    if (mDerivedDataCache.load(key, cooked))
+    {
+        DerivedDataReader reader(cooked.getBytes());
+        std::vector<uint32_t> meshletIndices;
+        if (reader.readVector(mMeshlets.meshlets) && reader.readVector(mMeshlets.bounds) && reader.readVector(mMeshlets.vertices) && reader.readVector(mMeshlets.triangles) &&
+            reader.readVector(meshletIndices) && reader.isAtEnd())
+        {
+            mMeshletFirstIndex = static_cast<uint32_t>(indices.size());
+            indices.insert(indices.end(), meshletIndices.begin(), meshletIndices.end());
+            return;
+        }
+        mMeshlets = {};
+    }
+
+    mMeshlets = buildModelMeshlets(vertices, indices, mMeshLods[0], mMeshletFirstIndex);
+
+    DerivedDataWriter writer;
+    writer.writeVector(mMeshlets.meshlets);
+    writer.writeVector(mMeshlets.bounds);
+    writer.writeVector(mMeshlets.vertices);
+    writer.writeVector(mMeshlets.triangles);
+    writer.writeVector(std::vector<uint32_t>(indices.begin() + mMeshletFirstIndex, indices.end()));
+    mDerivedDataCache.store(key, writer.getBytes(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+// Appends the coarser levels to indices
+std::vector<MeshLod> Application::buildModelLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    const uint32_t MAX_LOD_COUNT = 6;
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<MeshLod> lods = buildMeshLods(vertices, indices, MAX_LOD_COUNT);
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Built " << lods.size() << " levels of detail in " << milliseconds << " ms:";
+    for (const MeshLod& lod : lods)
+    {
+        std::cout << " " << lod.indexCount / 3 << " triangles (error " << lod.error << ")";
+    }
+    std::cout << std::endl;
+    return lods;
+}
+
+// Clusters the given level and appends the meshlet ordered copy of its indices, starting at meshletFirstIndex
+MeshletMesh Application::buildModelMeshlets(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const MeshLod& lod, uint32_t& meshletFirstIndex)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<uint32_t> lodIndices(indices.begin() + lod.firstIndex, indices.begin() + lod.firstIndex + lod.indexCount);
+    MeshletMesh meshlets = buildMeshlets(vertices, lodIndices);
+    std::vector<uint32_t> meshletIndices = unpackMeshletIndices(meshlets);
+    meshletFirstIndex = static_cast<uint32_t>(indices.size());
+    indices.insert(indices.end(), meshletIndices.begin(), meshletIndices.end());
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    size_t meshletCount = std::max<size_t>(meshlets.meshlets.size(), 1);
+    std::cout << "Built " << meshlets.meshlets.size() << " meshlets in " << milliseconds << " ms: " << static_cast<double>(meshlets.vertices.size()) / meshletCount
+              << " vertices, " << static_cast<double>(meshlets.triangles.size() / 3) / meshletCount << " triangles each" << std::endl;
+    return meshlets;
+}
+
+void Application::parseModel(const FileView& file, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
     std::string warning, error;
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &error, modelPath.c_str()))
+    // Without a material reader mtllib is skipped, materials come from the bindless material buffer instead
+    TextStreamBuffer buffer(file.getText());
+    std::istream stream(&buffer);
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &error, &stream))
     {
         throw std::runtime_error(warning + error);
     }
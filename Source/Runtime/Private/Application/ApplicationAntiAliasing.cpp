@@ -0,0 +1,295 @@
+#include "Application/Application.hpp"
+#include "Shader/FxaaComp.hpp"
+#include <array>
+#include <iostream>
+#include <stdexcept>
+
+using namespace LearnVulkan;
+
+// Anti-aliasing tiers: MSAA render targets, the FXAA compute pass and the tier benchmark.
+// Tiers are switched with the number keys 1-5 and applied between frames.
+
+namespace
+{
+    const uint32_t BENCHMARK_WARMUP_FRAMES = 60;
+    const uint32_t BENCHMARK_MEASURED_FRAMES = 300;
+    const uint32_t FXAA_GROUP_SIZE = 8;
+}  // namespace
+
+const VkFormat Application::SCENE_COLOR_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+// Retired sets wait for frames in flight, a resize and a tier switch may retire one each per frame
+const uint32_t Application::POST_PROCESS_DESCRIPTOR_SETS = 8;
+
+VkFormat Application::getSceneColorFormat() const
+{
+    return mAntiAliasing.bPostProcess ? SCENE_COLOR_FORMAT : mSwapchainImageFormat;
+}
+
+void Application::applyAntiAliasingTier(AntiAliasingTier tier)
+{
+    AntiAliasingSettings settings = AntiAliasingSettings::fromTier(tier, mMaxMsaaSamples);
+    if (settings.bPostProcess && !mbSwapchainTransferDst)
+    {
+        std::cerr << "Swapchain images cannot be blitted to, " << toString(tier) << " is unavailable" << std::endl;
+        return;
+    }
+    bool bRenderTargetsChanged = settings.sampleCount != mAntiAliasing.sampleCount || settings.bPostProcess != mAntiAliasing.bPostProcess;
+    mAntiAliasingTier = tier;
+    mAntiAliasing = settings;
+    mMsaaSamples = settings.sampleCount;
+
+    // Sample shading alone only selects another pipeline permutation
+    if (bRenderTargetsChanged)
+    {
+        clearRenderTargets();
+        createRenderPass();
+        createRenderTargets();
+        createFramebuffers();
+    }
+    updateGraphicsPipelineKey();
+    retireIncompatibleGraphicsPipelines();
+    compileActiveGraphicsPipelines();
+    std::cout << "Anti-aliasing: " << toString(tier) << ", " << mMsaaSamples << " samples" << std::endl;
+    printRenderTargetMemory();
+}
+
+VkDeviceSize Application::getRenderTargetMemorySize() const
+{
+    return mRenderTargetAllocator.getStatistics().committedBytes;
+}
+
+void Application::printRenderTargetMemory() const
+{
+    const double MEBIBYTE = 1024.0 * 1024.0;
+    RenderTargetMemoryStatistics statistics = mRenderTargetAllocator.getStatistics();
+    std::cout << "Render targets at " << mSwapchainExtent.width << "x" << mSwapchainExtent.height << ": requested " << statistics.requestedBytes / MEBIBYTE
+              << " MiB, allocated " << statistics.allocatedBytes / MEBIBYTE << " MiB, committed " << statistics.committedBytes / MEBIBYTE << " MiB, saved "
+              << (statistics.requestedBytes - statistics.committedBytes) / MEBIBYTE << " MiB (" << statistics.lazyAllocationCount << " lazily allocated, "
+              << statistics.aliasedImageCount << " aliased images)" << std::endl;
+    const RenderGraphStatistics& graphStatistics = mFrameGraph.getStatistics();
+    std::cout << "Frame graph: " << graphStatistics.passCount << " passes in " << graphStatistics.levelCount << " levels, " << graphStatistics.barrierCount << " barriers, "
+              << graphStatistics.aliasedImageCount << " aliased images" << std::endl;
+}
+
+void Application::createPostProcessPipeline()
+{
+    VkSamplerCreateInfo samplerInfo {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.maxLod = 0.0f;
+    VkSampler sampler;
+    if (vkCreateSampler(mLogicalDevice, &samplerInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources), &sampler) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create post-process sampler!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mPostProcessSampler = UniqueSampler(sampler);
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    FXAA_COMP.collectDescriptorSetLayoutBindings(0, bindings);
+    VkDescriptorSetLayoutCreateInfo layoutInfo {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VkDescriptorSetLayout descriptorSetLayout;
+    if (vkCreateDescriptorSetLayout(mLogicalDevice, &layoutInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Descriptors), &descriptorSetLayout) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create post-process descriptor set layout!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mPostProcessDescriptorSetLayout = UniqueDescriptorSetLayout(descriptorSetLayout);
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = POST_PROCESS_DESCRIPTOR_SETS;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = POST_PROCESS_DESCRIPTOR_SETS;
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = POST_PROCESS_DESCRIPTOR_SETS;
+    VkDescriptorPool descriptorPool;
+    if (vkCreateDescriptorPool(mLogicalDevice, &poolInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Descriptors), &descriptorPool) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create post-process descriptor pool!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mPostProcessDescriptorPool = UniqueDescriptorPool(descriptorPool);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+    VkPipelineLayout pipelineLayout;
+    if (vkCreatePipelineLayout(mLogicalDevice, &pipelineLayoutInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &pipelineLayout) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create post-process pipeline layout!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mPostProcessPipelineLayout = UniquePipelineLayout(pipelineLayout);
+
+    UniqueShaderModule computeShaderModule = createShaderModule(FXAA_COMP);
+    VkComputePipelineCreateInfo pipelineInfo {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = computeShaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = mPostProcessPipelineLayout;
+    VkPipeline pipeline;
+    if (vkCreateComputePipelines(mLogicalDevice, mPipelineCache, 1, &pipelineInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &pipeline) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create post-process pipeline!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mPostProcessPipeline = UniquePipeline(pipeline);
+}
+
+void Application::createPostProcessDescriptorSet()
+{
+    // A fresh set per resource generation, the previous one is retired with the images it points at
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = mPostProcessDescriptorPool;
+    VkDescriptorSetLayout descriptorSetLayout = mPostProcessDescriptorSetLayout;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &descriptorSetLayout;
+    if (vkAllocateDescriptorSets(mLogicalDevice, &allocInfo, &mPostProcessDescriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate post-process descriptor set!");
+    }
+
+    VkDescriptorImageInfo sceneColorInfo {};
+    sceneColorInfo.sampler = mPostProcessSampler;
+    sceneColorInfo.imageView = mSceneColorImageView;
+    sceneColorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkDescriptorImageInfo outputInfo {};
+    outputInfo.imageView = mPostProcessImageView;
+    outputInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    std::array<VkWriteDescriptorSet, 2> descriptorWrites {};
+    descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[0].dstSet = mPostProcessDescriptorSet;
+    descriptorWrites[0].dstBinding = 0;
+    descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrites[0].descriptorCount = 1;
+    descriptorWrites[0].pImageInfo = &sceneColorInfo;
+    descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[1].dstSet = mPostProcessDescriptorSet;
+    descriptorWrites[1].dstBinding = 1;
+    descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descriptorWrites[1].descriptorCount = 1;
+    descriptorWrites[1].pImageInfo = &outputInfo;
+    vkUpdateDescriptorSets(mLogicalDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+void Application::recordPostProcess(VkCommandBuffer commandBuffer)
+{
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPostProcessPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPostProcessPipelineLayout, 0, 1, &mPostProcessDescriptorSet, 0, nullptr);
+    vkCmdDispatch(commandBuffer, (mSwapchainExtent.width + FXAA_GROUP_SIZE - 1) / FXAA_GROUP_SIZE, (mSwapchainExtent.height + FXAA_GROUP_SIZE - 1) / FXAA_GROUP_SIZE, 1);
+}
+
+void Application::recordPostProcessBlit(VkCommandBuffer commandBuffer)
+{
+    // A blit rather than a copy, it converts the float image to the swapchain format
+    VkImageBlit blit {};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[1] = {static_cast<int32_t>(mSwapchainExtent.width), static_cast<int32_t>(mSwapchainExtent.height), 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[1] = blit.srcOffsets[1];
+    vkCmdBlitImage(commandBuffer, mPostProcessImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, mSwapchainImages[mImageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+}
+
+void Application::startAntiAliasingBenchmark()
+{
+    if (mDeviceCapabilities.getProperties().limits.timestampComputeAndGraphics)
+    {
+        VkQueryPoolCreateInfo queryPoolInfo {};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = 2 * MAX_FRAMES_IN_FLIGHT;
+        VkQueryPool queryPool;
+        if (vkCreateQueryPool(mLogicalDevice, &queryPoolInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Commands), &queryPool) == VK_SUCCESS)
+        {
+            mTimestampQueryPool = UniqueQueryPool(queryPool);
+        }
+    }
+    if (mTimestampQueryPool == VK_NULL_HANDLE)
+    {
+        std::cerr << "GPU timestamps unavailable, the anti-aliasing benchmark reports CPU frame times only" << std::endl;
+    }
+    mbTimestampsWritten.assign(MAX_FRAMES_IN_FLIGHT, false);
+    mAntiAliasingBenchmark = {};
+    mAntiAliasingBenchmark.bActive = true;
+    mRequestedAntiAliasingTier = AntiAliasingTier::Off;
+}
+
+void Application::updateAntiAliasingBenchmark()
+{
+    AntiAliasingBenchmark& benchmark = mAntiAliasingBenchmark;
+    // The fence of this slot has just been waited on, so its timestamps are available
+    if (mTimestampQueryPool != VK_NULL_HANDLE && mbTimestampsWritten[mCurrentFrame])
+    {
+        std::array<uint64_t, 2> timestamps {};
+        if (vkGetQueryPoolResults(mLogicalDevice, mTimestampQueryPool, 2 * mCurrentFrame, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            benchmark.gpuMilliseconds += (timestamps[1] - timestamps[0]) * mDeviceCapabilities.getProperties().limits.timestampPeriod * 1e-6;
+            benchmark.gpuFrameCount++;
+        }
+        mbTimestampsWritten[mCurrentFrame] = false;
+    }
+
+    benchmark.frame++;
+    if (benchmark.frame == BENCHMARK_WARMUP_FRAMES)
+    {
+        // Frames of the previous tier and the pipeline compilation of this one are excluded
+        benchmark.gpuMilliseconds = 0.0;
+        benchmark.gpuFrameCount = 0;
+        mFrameLimiter.resetStatistics();
+    }
+    else if (benchmark.frame == BENCHMARK_WARMUP_FRAMES + BENCHMARK_MEASURED_FRAMES)
+    {
+        if (mAntiAliasingTier != benchmark.tier)
+        {
+            std::cout << "Anti-aliasing benchmark, " << toString(benchmark.tier) << ": unavailable" << std::endl;
+        }
+        else
+        {
+            std::cout << "Anti-aliasing benchmark, " << toString(benchmark.tier) << ": frame " << mFrameLimiter.getStatistics().meanMilliseconds << " ms";
+            if (benchmark.gpuFrameCount > 0)
+            {
+                std::cout << ", GPU " << benchmark.gpuMilliseconds / benchmark.gpuFrameCount << " ms";
+            }
+            std::cout << ", render targets " << getRenderTargetMemorySize() / (1024.0 * 1024.0) << " MiB committed at " << mSwapchainExtent.width << "x" << mSwapchainExtent.height << std::endl;
+        }
+
+        benchmark.tier = static_cast<AntiAliasingTier>(static_cast<uint8_t>(benchmark.tier) + 1);
+        benchmark.frame = 0;
+        if (benchmark.tier == AntiAliasingTier::Count)
+        {
+            benchmark.bActive = false;
+            mRequestedAntiAliasingTier = mConfig.antiAliasingTier;
+            if (mConfig.bBenchmarkDepthPrepass)
+            {
+                startDepthPrepassBenchmark();
+            }
+        }
+        else
+        {
+            mRequestedAntiAliasingTier = benchmark.tier;
+        }
+    }
+}
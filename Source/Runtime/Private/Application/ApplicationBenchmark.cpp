@@ -0,0 +1,301 @@
+#include "Application/Application.hpp"
+#include <array>
+#include <chrono>
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+
+using namespace LearnVulkan;
+
+// CPU micro benchmarks that need the device, enabled with ApplicationConfiguration::bRunStartupBenchmarks. Everything
+// that runs without one is checked in Source/Tests. Command buffers are only recorded, never submitted, so only host
+// side cost is measured.
+
+namespace
+{
+    const int BENCHMARK_ITERATIONS = 16;
+}  // namespace
+
+void Application::runStartupBenchmarks()
+{
+    benchmarkDescriptorBinding(10000);
+    benchmarkPerDrawData(10000);
+    benchmarkRenderingPaths(100);
+    benchmarkVulkanHandles(10000);
+    benchmarkDeviceMemoryTracker(1000);
+}
+
+template<typename PerDrawFunction>
+double Application::measureDrawRecording(VkCommandBuffer commandBuffer, uint32_t drawCount, PerDrawFunction&& perDraw)
+{
+    VkCommandBufferBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    mImageIndex = 0;
+    std::array<VkDescriptorSet, 2> descriptorSets {mDescriptorSets[0], mBindlessResourceTable.getDescriptorSet()};
+    VkPipeline pipeline = getGraphicsPipeline(mGraphicsPipelineKey);
+    VkBuffer vertexBuffer = mVertexBuffer;
+    VkDeviceSize offset = 0;
+
+    double totalMicroseconds = 0.0;
+    // The first iteration warms up driver side command buffer allocations and is discarded
+    for (int iteration = 0; iteration <= BENCHMARK_ITERATIONS; iteration++)
+    {
+        auto begin = std::chrono::high_resolution_clock::now();
+
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        beginScenePass(commandBuffer);
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        setViewportAndScissor(commandBuffer);
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+        vkCmdBindIndexBuffer(commandBuffer, mIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+        for (uint32_t i = 0; i < drawCount; i++)
+        {
+            perDraw(commandBuffer, i);
+            vkCmdDrawIndexed(commandBuffer, mMeshLods[0].indexCount, 1, 0, 0, 0);
+        }
+        endScenePass(commandBuffer);
+        vkEndCommandBuffer(commandBuffer);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        vkResetCommandBuffer(commandBuffer, 0);
+        if (iteration > 0)
+        {
+            totalMicroseconds += std::chrono::duration<double, std::micro>(end - begin).count();
+        }
+    }
+    return totalMicroseconds / BENCHMARK_ITERATIONS;
+}
+
+void Application::benchmarkDescriptorBinding(uint32_t drawCount)
+{
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkCommandBufferAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = mCommandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(mLogicalDevice, &allocInfo, &commandBuffer) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to allocate benchmark command buffer!" << std::endl;
+        return;
+    }
+
+    VkDescriptorSet bindlessSet = mBindlessResourceTable.getDescriptorSet();
+    uint32_t materialCount = static_cast<uint32_t>(mMaterials.size());
+    PushConstantObject pushConstants {glm::mat4(1.0f), 0};
+
+    double bindlessMicroseconds = measureDrawRecording(commandBuffer, drawCount, [&](VkCommandBuffer cmd, uint32_t i) {
+        pushConstants.materialIndex = i % materialCount;
+        vkCmdPushConstants(cmd, mPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantObject), &pushConstants);
+    });
+    // Emulates the classic path where every material owns a descriptor set bound before its draw
+    double rebindMicroseconds = measureDrawRecording(commandBuffer, drawCount, [&](VkCommandBuffer cmd, uint32_t i) {
+        pushConstants.materialIndex = i % materialCount;
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 1, 1, &bindlessSet, 0, nullptr);
+        vkCmdPushConstants(cmd, mPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantObject), &pushConstants);
+    });
+
+    std::cout << "Descriptor binding benchmark (" << drawCount << " draws, " << mBindlessResourceTable.getTextureCount() << " bindless textures)" << std::endl
+              << "  bindless, bound once: " << bindlessMicroseconds << " us, " << bindlessMicroseconds * 1000.0 / drawCount << " ns/draw" << std::endl
+              << "  rebound per draw:     " << rebindMicroseconds << " us, " << rebindMicroseconds * 1000.0 / drawCount << " ns/draw" << std::endl;
+
+    vkFreeCommandBuffers(mLogicalDevice, mCommandPool, 1, &commandBuffer);
+}
+
+void Application::benchmarkPerDrawData(uint32_t drawCount)
+{
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkCommandBufferAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = mCommandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(mLogicalDevice, &allocInfo, &commandBuffer) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to allocate benchmark command buffer!" << std::endl;
+        return;
+    }
+
+    PushConstantObject pushConstants {glm::mat4(1.0f), 0};
+
+    double pushConstantMicroseconds = measureDrawRecording(commandBuffer, drawCount, [&](VkCommandBuffer cmd, uint32_t i) {
+        pushConstants.model[3][0] = static_cast<float>(i);
+        vkCmdPushConstants(cmd, mPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantObject), &pushConstants);
+    });
+    // Per-object uniform data would need one descriptor set per object, alternate between the
+    // per-frame sets so the driver cannot skip the redundant bind
+    double descriptorSetMicroseconds = measureDrawRecording(commandBuffer, drawCount, [&](VkCommandBuffer cmd, uint32_t i) {
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1, &mDescriptorSets[i % MAX_FRAMES_IN_FLIGHT], 0, nullptr);
+    });
+
+    std::cout << "Per-draw data benchmark (" << drawCount << " draws)" << std::endl
+              << "  push constants:          " << pushConstantMicroseconds << " us, " << pushConstantMicroseconds * 1000.0 / drawCount << " ns/draw" << std::endl
+              << "  per-draw descriptor set: " << descriptorSetMicroseconds << " us, " << descriptorSetMicroseconds * 1000.0 / drawCount << " ns/draw" << std::endl;
+
+    vkFreeCommandBuffers(mLogicalDevice, mCommandPool, 1, &commandBuffer);
+}
+
+// What a resize costs with and without render pass and framebuffer objects, and how many pipelines
+// each path compiles while the anti-aliasing tiers are cycled through twice.
+// The extent does not change, every iteration recreates what recreateSwapchain recreates after the image views.
+void Application::benchmarkRenderingPaths(uint32_t recreateCount)
+{
+    bool bConfiguredDynamicRendering = mbDynamicRendering;
+    AntiAliasingTier configuredTier = mAntiAliasingTier;
+    auto switchPath = [this](bool bDynamicRendering) {
+        vkDeviceWaitIdle(mLogicalDevice);
+        clearRenderTargets();
+        retireGraphicsPipelines();
+        mDeletionQueue.flush();
+        mbDynamicRendering = bDynamicRendering;
+        createRenderPass();
+        createGraphicsPipelines();
+        createRenderTargets();
+        createFramebuffers();
+    };
+
+    std::cout << "Rendering path benchmark (" << recreateCount << " render target recreations at " << mSwapchainExtent.width << "x" << mSwapchainExtent.height << ")" << std::endl;
+    for (bool bDynamicRendering : {false, true})
+    {
+        const char* name = bDynamicRendering ? "dynamic rendering" : "render pass objects";
+        if (bDynamicRendering && !mbDynamicRenderingSupported)
+        {
+            std::cout << "  " << name << ": unsupported" << std::endl;
+            continue;
+        }
+        switchPath(bDynamicRendering);
+        size_t objectCount = (mRenderPass != VK_NULL_HANDLE ? 1 : 0) + mSwapchainFramebuffers.size();
+
+        // Destruction is part of the cost, the device is idle so retired objects can be flushed right away
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < recreateCount; i++)
+        {
+            clearRenderTargets();
+            createRenderPass();
+            updateGraphicsPipelineKey();
+            retireIncompatibleGraphicsPipelines();
+            compileActiveGraphicsPipelines();
+            createRenderTargets();
+            createFramebuffers();
+            mDeletionQueue.flush();
+        }
+        double recreateMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - begin).count() / recreateCount;
+
+        uint64_t compiledBefore = mCompiledGraphicsPipelineCount;
+        for (int cycle = 0; cycle < 2; cycle++)
+        {
+            for (uint8_t tier = 0; tier < static_cast<uint8_t>(AntiAliasingTier::Count); tier++)
+            {
+                applyAntiAliasingTier(static_cast<AntiAliasingTier>(tier));
+                mDeletionQueue.flush();
+            }
+        }
+        std::cout << "  " << name << ": " << recreateMicroseconds << " us per recreation, " << objectCount << " render pass and framebuffer objects per recreation, "
+                  << mCompiledGraphicsPipelineCount - compiledBefore << " pipelines compiled over two tier cycles, " << mGraphicsPipelines.size() << " resident" << std::endl;
+        applyAntiAliasingTier(configuredTier);
+    }
+    switchPath(bConfiguredDynamicRendering);
+}
+
+// Owning handles are only the raw handle and convert implicitly, so recording through them should cost the same as
+// through raw handles. Create and destroy churn is measured raw, wrapped and wrapped with a registry.
+void Application::benchmarkVulkanHandles(uint32_t drawCount)
+{
+    const uint32_t SAMPLER_COUNT = 1000;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkCommandBufferAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = mCommandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(mLogicalDevice, &allocInfo, &commandBuffer) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to allocate benchmark command buffer!" << std::endl;
+        return;
+    }
+    VkBuffer rawIndexBuffer = mIndexBuffer;
+    double rawMicroseconds = measureDrawRecording(commandBuffer, drawCount, [&](VkCommandBuffer cmd, uint32_t) {
+        vkCmdBindIndexBuffer(cmd, rawIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    });
+    double wrappedMicroseconds = measureDrawRecording(commandBuffer, drawCount, [&](VkCommandBuffer cmd, uint32_t) {
+        vkCmdBindIndexBuffer(cmd, mIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    });
+    vkFreeCommandBuffers(mLogicalDevice, mCommandPool, 1, &commandBuffer);
+
+    VkSamplerCreateInfo samplerInfo {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    const VkAllocationCallbacks* callbacks = mHostAllocator.getCallbacks(HostAllocationSubsystem::Resources);
+    VulkanObjectRegistry registry;
+    VulkanDeviceContext untrackedContext {mLogicalDevice, callbacks, nullptr};
+    VulkanDeviceContext trackedContext {mLogicalDevice, callbacks, &registry};
+    std::vector<VkSampler> rawSamplers(SAMPLER_COUNT, VK_NULL_HANDLE);
+    std::vector<UniqueSampler> samplers(SAMPLER_COUNT);
+
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (VkSampler& sampler : rawSamplers)
+    {
+        vkCreateSampler(mLogicalDevice, &samplerInfo, callbacks, &sampler);
+    }
+    for (VkSampler sampler : rawSamplers)
+    {
+        vkDestroySampler(mLogicalDevice, sampler, callbacks);
+    }
+    double rawChurnMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    double churnMilliseconds[2] = {};
+    for (const VulkanDeviceContext* context : {&untrackedContext, &trackedContext})
+    {
+        // Every sampler is destroyed before the next binding, nothing else creates handles during startup benchmarks
+        VulkanDeviceContext::bind(context);
+        begin = std::chrono::high_resolution_clock::now();
+        for (UniqueSampler& sampler : samplers)
+        {
+            VkSampler newSampler = VK_NULL_HANDLE;
+            vkCreateSampler(mLogicalDevice, &samplerInfo, callbacks, &newSampler);
+            sampler = UniqueSampler(newSampler);
+        }
+        samplers.clear();
+        samplers.resize(SAMPLER_COUNT);
+        churnMilliseconds[context == &trackedContext] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+    }
+    VulkanDeviceContext::bind(&mDeviceContext);
+
+    std::cout << "Vulkan handle benchmark (" << drawCount << " index buffer binds, " << SAMPLER_COUNT << " samplers)" << std::endl
+              << "  raw handle recording:     " << rawMicroseconds << " us, " << rawMicroseconds * 1000.0 / drawCount << " ns/draw" << std::endl
+              << "  owning handle recording:  " << wrappedMicroseconds << " us, " << wrappedMicroseconds * 1000.0 / drawCount << " ns/draw" << std::endl
+              << "  raw create and destroy:   " << rawChurnMilliseconds << " ms" << std::endl
+              << "  owning handles:           " << churnMilliseconds[0] << " ms" << std::endl
+              << "  owning handles, tracked:  " << churnMilliseconds[1] << " ms" << std::endl;
+}
+
+// Creating and destroying staging buffers through createBuffer, which tracks every allocation by category and heap
+void Application::benchmarkDeviceMemoryTracker(uint32_t bufferCount)
+{
+    const uint32_t BUFFER_SIZE = 4096;
+    std::vector<UniqueBuffer> buffers(bufferCount);
+    std::vector<UniqueDeviceMemory> memories(bufferCount);
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < bufferCount; i++)
+    {
+        createBuffer(BUFFER_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Staging, buffers[i],
+                     memories[i]);
+    }
+    double createMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+    begin = std::chrono::high_resolution_clock::now();
+    buffers.clear();
+    memories.clear();
+    double destroyMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+
+    std::cout << "Device memory tracker benchmark (" << bufferCount << " staging buffers)" << std::endl
+              << "  create buffers:  " << createMilliseconds << " ms" << std::endl
+              << "  destroy buffers: " << destroyMilliseconds << " ms" << std::endl;
+}
@@ -0,0 +1,150 @@
+#include "Application/Application.hpp"
+#include <cmath>
+#include <iostream>
+
+using namespace LearnVulkan;
+
+// Depth prepass, draw ordering, level of detail selection and the prepass benchmark.
+// The prepass is toggled with Z and applied between frames.
+
+namespace
+{
+    const uint32_t BENCHMARK_WARMUP_FRAMES = 60;
+    const uint32_t BENCHMARK_MEASURED_FRAMES = 300;
+    // Every draw uses the scene permutation, state sorting only groups materials for now
+    const uint32_t SCENE_PIPELINE_INDEX = 0;
+    // Fraction of the pixel error a level has to clear before it is switched to, or may exceed before it is left
+    const float LOD_HYSTERESIS = 0.25f;
+}  // namespace
+
+// Only positions matter without a fragment shader, so the shading only fields are normalized
+// and every permutation sharing cull mode and render targets shares one prepass pipeline
+GraphicsPipelineKey Application::getDepthPrepassPipelineKey() const
+{
+    GraphicsPipelineKey key = mGraphicsPipelineKey;
+    key.depthPass = DepthPass::Prepass;
+    key.bSampleShading = false;
+    key.blendMode = BlendMode::Opaque;
+    key.uvScale = GraphicsPipelineKey {}.uvScale;
+    key.featureFlags = 0;
+    return key;
+}
+
+void Application::setDepthPrepass(bool bEnabled)
+{
+    mbDepthPrepass = bEnabled;
+    updateGraphicsPipelineKey();
+    compileActiveGraphicsPipelines();
+    std::cout << "Depth prepass: " << (mbDepthPrepass ? "on" : "off") << std::endl;
+}
+
+// The prepass goes front to back so its own depth test rejects as much as possible. The EQUAL tested
+// pass shades each pixel once whatever the order, so it is sorted for state. Without a prepass the
+// color pass itself goes front to back. Both passes draw an object with the same level of detail, the
+// EQUAL test only passes on the depth the prepass laid down.
+void Application::buildDrawLists(const glm::mat4& view, const glm::mat4& projection)
+{
+    // Lives until the frame allocator is reset at the start of the next frame's update
+    uint32_t objectCount = static_cast<uint32_t>(mDrawObjects.size());
+    mDepthPrepassDraws = mFrameAllocator.allocateArray<DrawCommand>(mbDepthPrepass ? objectCount : 0);
+    mShadingDraws = mFrameAllocator.allocateArray<DrawCommand>(objectCount);
+    DrawSortOrder shadingOrder = mbDepthPrepass ? DrawSortOrder::State : DrawSortOrder::FrontToBack;
+    // Pixels covered by one unit at view depth 1
+    float pixelsPerUnit = std::abs(projection[1][1]) * 0.5f * mSwapchainExtent.height;
+    for (uint32_t i = 0; i < objectCount; i++)
+    {
+        const PushConstantObject& object = mDrawObjects[i];
+        // Distance of the bounds center along the view direction, the camera looks down -z
+        const BoundingSphere& bounds = mScene.getBounds().get(mDrawObjectEntities[i].index).world;
+        float viewDepth = -(view * glm::vec4(bounds.center, 1.0f)).z;
+        if (mConfig.lodPixelError > 0.0f)
+        {
+            mDrawObjectLods[i] = selectMeshLod(mMeshLods, viewDepth, pixelsPerUnit, mConfig.lodPixelError, LOD_HYSTERESIS, mDrawObjectLods[i]);
+        }
+        if (mbDepthPrepass)
+        {
+            mDepthPrepassDraws[i] = {makeDrawSortKey(DrawSortOrder::FrontToBack, viewDepth, SCENE_PIPELINE_INDEX, 0), i};
+        }
+        mShadingDraws[i] = {makeDrawSortKey(shadingOrder, viewDepth, SCENE_PIPELINE_INDEX, object.materialIndex), i};
+    }
+    sortDrawCommands(mDepthPrepassDraws);
+    sortDrawCommands(mShadingDraws);
+}
+
+void Application::startDepthPrepassBenchmark()
+{
+    if (mbPipelineStatisticsQuerySupported && mPipelineStatisticsQueryPool == VK_NULL_HANDLE)
+    {
+        VkQueryPoolCreateInfo queryPoolInfo {};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        queryPoolInfo.queryCount = MAX_FRAMES_IN_FLIGHT;
+        queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+        VkQueryPool queryPool;
+        if (vkCreateQueryPool(mLogicalDevice, &queryPoolInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Commands), &queryPool) == VK_SUCCESS)
+        {
+            mPipelineStatisticsQueryPool = UniqueQueryPool(queryPool);
+        }
+    }
+    if (mPipelineStatisticsQueryPool == VK_NULL_HANDLE)
+    {
+        std::cerr << "Pipeline statistics queries unavailable, the depth prepass benchmark reports frame times only" << std::endl;
+    }
+    mbPipelineStatisticsWritten.assign(MAX_FRAMES_IN_FLIGHT, false);
+    mDepthPrepassBenchmark = {};
+    mDepthPrepassBenchmark.bActive = true;
+    mRequestedDepthPrepass = false;
+}
+
+void Application::updateDepthPrepassBenchmark()
+{
+    DepthPrepassBenchmark& benchmark = mDepthPrepassBenchmark;
+    // The fence of this slot has just been waited on, so its query is available
+    if (mPipelineStatisticsQueryPool != VK_NULL_HANDLE && mbPipelineStatisticsWritten[mCurrentFrame])
+    {
+        uint64_t fragmentInvocations = 0;
+        if (vkGetQueryPoolResults(mLogicalDevice, mPipelineStatisticsQueryPool, mCurrentFrame, 1, sizeof(fragmentInvocations), &fragmentInvocations, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            benchmark.fragmentInvocations += fragmentInvocations;
+            benchmark.queryFrameCount++;
+        }
+        mbPipelineStatisticsWritten[mCurrentFrame] = false;
+    }
+
+    benchmark.frame++;
+    if (benchmark.frame == BENCHMARK_WARMUP_FRAMES)
+    {
+        // Frames before the switch and the pipeline compilation after it are excluded
+        benchmark.fragmentInvocations = 0;
+        benchmark.queryFrameCount = 0;
+        mFrameLimiter.resetStatistics();
+    }
+    else if (benchmark.frame == BENCHMARK_WARMUP_FRAMES + BENCHMARK_MEASURED_FRAMES)
+    {
+        std::cout << "Depth prepass benchmark, " << (benchmark.bPrepass ? "with" : "without") << " prepass: frame " << mFrameLimiter.getStatistics().meanMilliseconds << " ms";
+        double invocations = 0.0;
+        if (benchmark.queryFrameCount > 0)
+        {
+            invocations = static_cast<double>(benchmark.fragmentInvocations) / benchmark.queryFrameCount;
+            std::cout << ", " << invocations << " fragment shader invocations";
+            if (benchmark.bPrepass && benchmark.baselineInvocations > 0.0)
+            {
+                std::cout << " (" << 100.0 * (1.0 - invocations / benchmark.baselineInvocations) << "% saved)";
+            }
+        }
+        std::cout << " at " << mSwapchainExtent.width << "x" << mSwapchainExtent.height << ", " << toString(mAntiAliasingTier) << std::endl;
+
+        if (!benchmark.bPrepass)
+        {
+            benchmark.baselineInvocations = invocations;
+            benchmark.bPrepass = true;
+            benchmark.frame = 0;
+            mRequestedDepthPrepass = true;
+        }
+        else
+        {
+            benchmark.bActive = false;
+            mRequestedDepthPrepass = mConfig.bDepthPrepass;
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#include "Application/Application.hpp"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+using namespace LearnVulkan;
+
+// Frame capture and replay. Capturing writes what every frame was built from into a crash-safe ring buffer, replay
+// feeds a capture back through the frame loop, in a hidden window, so a spike can be profiled again.
+
+namespace
+{
+    // Captured frames whose update and record times are printed next to their replayed ones
+    const size_t REPLAY_REPORTED_FRAME_COUNT = 5;
+
+    bool isSameDrawList(std::span<const DrawCommand> draws, std::span<const FrameCaptureDraw> captured, const std::vector<uint32_t>& objectLods)
+    {
+        if (draws.size() != captured.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < draws.size(); i++)
+        {
+            uint32_t objectIndex = draws[i].objectIndex;
+            if (objectIndex != captured[i].objectIndex || objectIndex >= objectLods.size() || objectLods[objectIndex] != captured[i].lod)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    float getMilliseconds(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+    {
+        return std::chrono::duration<float, std::milli>(end - begin).count();
+    }
+}  // namespace
+
+void Application::startFrameCapture()
+{
+    if (!mFrameCapture.open(mConfig.frameCapturePath, mConfig.frameCaptureSize))
+    {
+        std::cerr << "Failed to create frame capture " << mConfig.frameCapturePath << std::endl;
+        return;
+    }
+    mFrameCaptureStart = std::chrono::steady_clock::now();
+    std::cout << "Capturing frames into " << mConfig.frameCapturePath << std::endl;
+}
+
+void Application::startFrameReplay()
+{
+    if (!mFrameReplay.open(mConfig.frameReplayPath) || mFrameReplay.getFrameCount() == 0)
+    {
+        std::cerr << "Failed to open frame capture " << mConfig.frameReplayPath << std::endl;
+        mFrameReplay.close();
+        mbQuit = true;
+        return;
+    }
+    if (mFrameReplay.getFrame(0).objectCount != mDrawObjects.size())
+    {
+        std::cerr << "Frame capture has " << mFrameReplay.getFrame(0).objectCount << " objects, the scene " << mDrawObjects.size()
+                  << ", replaying anyway" << std::endl;
+    }
+    mReplayMilliseconds.assign(mFrameReplay.getFrameCount(), 0.0);
+    std::cout << "Replaying " << mFrameReplay.getFrameCount() << " of " << mFrameReplay.getWrittenCount() << " captured frames from " << mConfig.frameReplayPath
+              << std::endl;
+}
+
+// Toggles are requested like input would, only when the capture changed them, so unavailable ones warn once
+void Application::beginReplayFrame()
+{
+    const FrameCaptureRecord& frame = mFrameReplay.getFrame(mReplayFrame);
+    const FrameCaptureRecord* previous = mReplayFrame > 0 ? &mFrameReplay.getFrame(mReplayFrame - 1) : nullptr;
+    AntiAliasingTier tier = static_cast<AntiAliasingTier>(frame.antiAliasingTier);
+    if (frame.antiAliasingTier < static_cast<uint8_t>(AntiAliasingTier::Count) && tier != mAntiAliasingTier &&
+        (!previous || previous->antiAliasingTier != frame.antiAliasingTier))
+    {
+        mRequestedAntiAliasingTier = tier;
+    }
+    bool bDepthPrepass = (frame.flags & FRAME_CAPTURE_DEPTH_PREPASS_BIT) != 0;
+    if (bDepthPrepass != mbDepthPrepass && (!previous || ((previous->flags ^ frame.flags) & FRAME_CAPTURE_DEPTH_PREPASS_BIT)))
+    {
+        mRequestedDepthPrepass = bDepthPrepass;
+    }
+    bool bMeshletCulling = (frame.flags & FRAME_CAPTURE_MESHLET_CULLING_BIT) != 0;
+    if (bMeshletCulling != mbMeshletCulling && (!previous || ((previous->flags ^ frame.flags) & FRAME_CAPTURE_MESHLET_CULLING_BIT)))
+    {
+        mRequestedMeshletCulling = bMeshletCulling;
+    }
+    // Levels of detail are picked with hysteresis, starting from the captured ones picks the same levels again
+    if (!previous)
+    {
+        for (std::span<const FrameCaptureDraw> draws : {mFrameReplay.getDepthPrepassDraws(0), mFrameReplay.getShadingDraws(0)})
+        {
+            for (const FrameCaptureDraw& draw : draws)
+            {
+                if (draw.objectIndex < mDrawObjectLods.size() && draw.lod < mMeshLods.size())
+                {
+                    mDrawObjectLods[draw.objectIndex] = draw.lod;
+                }
+            }
+        }
+    }
+    // Only the level of detail depends on the extent, the camera comes from the capture either way
+    if (frame.swapchainWidth != mSwapchainExtent.width || frame.swapchainHeight != mSwapchainExtent.height)
+    {
+        glfwSetWindowSize(mWindow, static_cast<int>(frame.swapchainWidth), static_cast<int>(frame.swapchainHeight));
+    }
+}
+
+void Application::captureFrame(uint32_t imageIndex, std::chrono::steady_clock::time_point updateStart, std::chrono::steady_clock::time_point recordStart)
+{
+    auto captureStart = std::chrono::steady_clock::now();
+    float updateMilliseconds = getMilliseconds(updateStart, recordStart);
+    float recordMilliseconds = getMilliseconds(recordStart, captureStart);
+    if (mFrameReplay.isOpen())
+    {
+        endReplayFrame(updateMilliseconds, recordMilliseconds);
+        return;
+    }
+
+    mFrameInputs.frameIndex = mFrameIndex;
+    mFrameInputs.timestampMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(updateStart - mFrameCaptureStart).count();
+    mFrameInputs.graphicsPipelineKeyHash = mGraphicsPipelineKey.hash();
+    mFrameInputs.updateMilliseconds = updateMilliseconds;
+    mFrameInputs.recordMilliseconds = recordMilliseconds;
+    mFrameInputs.swapchainWidth = mSwapchainExtent.width;
+    mFrameInputs.swapchainHeight = mSwapchainExtent.height;
+    mFrameInputs.currentFrame = mCurrentFrame;
+    mFrameInputs.imageIndex = imageIndex;
+    mFrameInputs.objectCount = static_cast<uint32_t>(mDrawObjects.size());
+    mFrameInputs.antiAliasingTier = static_cast<uint8_t>(mAntiAliasingTier);
+    mFrameInputs.flags = (mbDepthPrepass ? FRAME_CAPTURE_DEPTH_PREPASS_BIT : 0) | (mbMeshletCulling ? FRAME_CAPTURE_MESHLET_CULLING_BIT : 0) |
+                         (mbDynamicRendering ? FRAME_CAPTURE_DYNAMIC_RENDERING_BIT : 0);
+    mFrameCapture.write(mFrameInputs, mDepthPrepassDraws, mShadingDraws, mDrawObjectLods);
+
+    uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - captureStart).count();
+    mFrameCaptureNanoseconds += nanoseconds;
+    mFrameCaptureMaxNanoseconds = std::max(mFrameCaptureMaxNanoseconds, nanoseconds);
+    mCapturedFrameMilliseconds += updateMilliseconds + recordMilliseconds;
+}
+
+void Application::endReplayFrame(float updateMilliseconds, float recordMilliseconds)
+{
+    mReplayMilliseconds[mReplayFrame] += updateMilliseconds + recordMilliseconds;
+    if (!isSameDrawList(mDepthPrepassDraws, mFrameReplay.getDepthPrepassDraws(mReplayFrame), mDrawObjectLods) ||
+        !isSameDrawList(mShadingDraws, mFrameReplay.getShadingDraws(mReplayFrame), mDrawObjectLods))
+    {
+        mReplayMismatchCount++;
+    }
+    if (++mReplayFrame < mFrameReplay.getFrameCount())
+    {
+        return;
+    }
+    mReplayFrame = 0;
+    if (++mReplayPass == mConfig.frameReplayPassCount)
+    {
+        printReplayReport();
+        mFrameReplay.close();
+        mbQuit = true;
+    }
+}
+
+void Application::printFrameCaptureReport() const
+{
+    uint64_t writtenCount = mFrameCapture.getWrittenCount();
+    if (writtenCount == 0)
+    {
+        return;
+    }
+    double meanMicroseconds = mFrameCaptureNanoseconds * 1e-3 / writtenCount;
+    std::cout << "Frame capture: " << writtenCount << " frames written, the last " << mFrameCapture.getFrameCount() << " kept, " << mFrameCapture.getDroppedCount()
+              << " dropped, " << meanMicroseconds << " us mean, " << mFrameCaptureMaxNanoseconds * 1e-3 << " us max per frame, "
+              << 100.0 * mFrameCaptureNanoseconds * 1e-6 / std::max(mCapturedFrameMilliseconds, 1e-3) << "% of update and recording" << std::endl;
+}
+
+void Application::printReplayReport() const
+{
+    size_t frameCount = mFrameReplay.getFrameCount();
+    double capturedMilliseconds = 0.0;
+    for (size_t i = 0; i < frameCount; i++)
+    {
+        const FrameCaptureRecord& frame = mFrameReplay.getFrame(i);
+        capturedMilliseconds += frame.updateMilliseconds + frame.recordMilliseconds;
+    }
+    double replayedMilliseconds = std::accumulate(mReplayMilliseconds.begin(), mReplayMilliseconds.end(), 0.0) / mReplayPass;
+    std::cout << "Replayed " << frameCount << " frames " << mReplayPass << " times: update and record " << replayedMilliseconds / frameCount << " ms mean, captured "
+              << capturedMilliseconds / frameCount << " ms, draw lists differed in " << mReplayMismatchCount << " frames" << std::endl;
+
+    // The slowest captured frames are what the replay was run for, their replayed times show whether the spike reproduces
+    std::vector<size_t> order(frameCount);
+    std::iota(order.begin(), order.end(), 0);
+    auto getCapturedMilliseconds = [this](size_t i) { return mFrameReplay.getFrame(i).updateMilliseconds + mFrameReplay.getFrame(i).recordMilliseconds; };
+    size_t reportedCount = std::min(REPLAY_REPORTED_FRAME_COUNT, frameCount);
+    std::partial_sort(order.begin(), order.begin() + reportedCount, order.end(), [&](size_t a, size_t b) { return getCapturedMilliseconds(a) > getCapturedMilliseconds(b); });
+    for (size_t i = 0; i < reportedCount; i++)
+    {
+        const FrameCaptureRecord& frame = mFrameReplay.getFrame(order[i]);
+        std::cout << "  frame " << frame.frameIndex << ": captured " << frame.updateMilliseconds << " + " << frame.recordMilliseconds << " ms, replayed "
+                  << mReplayMilliseconds[order[i]] / mReplayPass << " ms, " << frame.shadingDrawCount << " draws" << std::endl;
+    }
+}
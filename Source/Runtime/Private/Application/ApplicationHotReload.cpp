@@ -0,0 +1,298 @@
+#include "Application/Application.hpp"
+#include "FileSystem/MappedFile.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stb_image.h>
+
+using namespace LearnVulkan;
+
+// Hot reload, enabled with ApplicationConfiguration::bHotReload.
+// Files are compiled or parsed on worker threads, Vulkan objects are only created and swapped on the
+// main thread between frames and the objects they replace go through the deletion queue.
+
+namespace
+{
+    const char* const WATCHED_DIRECTORIES[] = {"Shader", "Texture", "Model"};
+    const uint32_t SPIRV_MAGIC = 0x07230203;
+    // Part of the derived data key of compiled shaders, bump it whenever the compile command changes
+    const uint32_t SHADER_COMPILER_VERSION = 1;
+
+    double millisecondsSince(std::chrono::steady_clock::time_point time)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - time).count();
+    }
+
+    std::function<bool()> reportFailure(std::string message)
+    {
+        return [message = std::move(message)]() {
+            std::cerr << message << std::endl;
+            return false;
+        };
+    }
+}  // namespace
+
+void Application::startHotReload()
+{
+    for (const char* directory : WATCHED_DIRECTORIES)
+    {
+        mFileWatcher.addDirectory(directory);
+    }
+    if (!mFileWatcher.start())
+    {
+        std::cerr << "Failed to start hot reload!" << std::endl;
+    }
+}
+
+void Application::stopHotReload()
+{
+    mFileWatcher.stop();
+    // Results still in flight are dropped, nothing has been created on the device for them yet
+    for (HotReloadJob& job : mHotReloadJobs)
+    {
+        job.future.wait();
+    }
+    mHotReloadJobs.clear();
+}
+
+void Application::processHotReload()
+{
+    mFileWatcher.pollEvents(mFileChangeEvents);
+
+    // One job per file at a time, a change to a file that is still loading waits for a later frame
+    for (auto event = mFileChangeEvents.begin(); event != mFileChangeEvents.end();)
+    {
+        bool bBusy = std::any_of(mHotReloadJobs.begin(), mHotReloadJobs.end(), [&](const HotReloadJob& job) { return job.path == event->path; });
+        if (bBusy)
+        {
+            ++event;
+            continue;
+        }
+
+        const std::string& path = event->path;
+        std::future<std::function<bool()>> future;
+        if (path == std::string("Shader/") + mVertShader.sourceName)
+        {
+            future = std::async(std::launch::async, [this, path]() { return reloadShader(path, mVertShader, mVertShaderCode); });
+        }
+        else if (path == std::string("Shader/") + mFragShader.sourceName)
+        {
+            future = std::async(std::launch::async, [this, path]() { return reloadShader(path, mFragShader, mFragShaderCode); });
+        }
+        else if (path == texturePath)
+        {
+            future = std::async(std::launch::async, [this, path]() { return reloadTexture(path); });
+        }
+        else if (path == modelPath)
+        {
+            future = std::async(std::launch::async, [this, path]() { return reloadModel(path); });
+        }
+
+        if (future.valid())
+        {
+            mHotReloadJobs.push_back({path, event->detectedTime, std::move(future)});
+        }
+        event = mFileChangeEvents.erase(event);
+    }
+
+    for (auto job = mHotReloadJobs.begin(); job != mHotReloadJobs.end();)
+    {
+        if (job->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++job;
+            continue;
+        }
+        try
+        {
+            std::function<bool()> apply = job->future.get();
+            if (apply())
+            {
+                mHotReloadLatencies.emplace_back(job->path, job->detectedTime);
+            }
+        }
+        catch (const std::exception& exception)
+        {
+            std::cerr << "Failed to reload " << job->path << ": " << exception.what() << std::endl;
+        }
+        job = mHotReloadJobs.erase(job);
+    }
+}
+
+void Application::reportHotReloadLatency()
+{
+    for (const auto& [path, detectedTime] : mHotReloadLatencies)
+    {
+        std::cout << "Hot reload of " << path << " took " << millisecondsSince(detectedTime) << " ms from save to first frame using it" << std::endl;
+    }
+    mHotReloadLatencies.clear();
+}
+
+std::function<bool()> Application::reloadShader(const std::string& path, ShaderReflection& shader, std::vector<uint32_t>& codeStorage)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    // Same compiler and target environment as Shader/CMakeLists.txt
+    const std::string COMPILER = LEARN_VULKAN_GLSLANG_VALIDATOR;
+    const std::string TARGET_ENVIRONMENT = "vulkan1.2";
+    MappedFile source;
+    if (!source.open(path))
+    {
+        return reportFailure("Failed to open " + path + ", keeping the previous shader");
+    }
+    // Shaders have no #include, so the source is everything the SPIR-V depends on. The compiler's modification
+    // time stands in for its version.
+    std::error_code error;
+    DerivedDataKey key = DerivedDataKey("Shader", SHADER_COMPILER_VERSION)
+                             .add(COMPILER)
+                             .addValue(std::filesystem::last_write_time(COMPILER, error).time_since_epoch().count())
+                             .add(TARGET_ENVIRONMENT)
+                             .add(source.getBytes());
+
+    std::vector<uint32_t> code;
+    FileView cached;
+    bool bCached = mDerivedDataCache.load(key, cached) && cached.getSize() % sizeof(uint32_t) == 0 && cached.getSize() > 0;
+    if (bCached)
+    {
+        code.resize(cached.getSize() / sizeof(uint32_t));
+        memcpy(code.data(), cached.getData(), cached.getSize());
+    }
+    else
+    {
+        std::filesystem::path output = std::filesystem::temp_directory_path() / ("LearnVulkan." + std::filesystem::path(path).filename().string() + ".spv");
+        std::string command = "\"" + COMPILER + "\" -V --target-env " + TARGET_ENVIRONMENT + " \"" + path + "\" -o \"" + output.string() + "\"";
+        if (std::system(command.c_str()) != 0)
+        {
+            return reportFailure("Failed to compile " + path + ", keeping the previous shader");
+        }
+
+        MappedFile spirv;
+        if (!spirv.open(output.string()))
+        {
+            return reportFailure("Failed to read " + output.string());
+        }
+        code.resize(spirv.getSize() / sizeof(uint32_t));
+        memcpy(code.data(), spirv.getData(), code.size() * sizeof(uint32_t));
+        if (code.empty() || code[0] != SPIRV_MAGIC || spirv.getSize() % sizeof(uint32_t) != 0)
+        {
+            return reportFailure(output.string() + " is not valid SPIR-V");
+        }
+        mDerivedDataCache.store(key, spirv.getBytes(), millisecondsSince(startTime));
+    }
+    double compileMilliseconds = millisecondsSince(startTime);
+
+    return [this, &shader, &codeStorage, code = std::move(code), path, bCached, compileMilliseconds]() mutable {
+        // Only the code is replaced: descriptor, vertex input and push constant interfaces are baked into
+        // the layouts and draw code, so edits that change them still need a rebuild of the application
+        codeStorage = std::move(code);
+        shader.code = codeStorage.data();
+        shader.codeSize = codeStorage.size() * sizeof(uint32_t);
+
+        // Every permutation shares both stages, the replaced pipelines are retired by compileGraphicsPipelines
+        std::vector<GraphicsPipelineKey> keys;
+        for (const auto& [key, pipeline] : mGraphicsPipelines)
+        {
+            keys.push_back(key);
+        }
+        bool bCompiled = compileGraphicsPipelines(keys);
+        std::cout << "Reloaded " << path << (bCached ? ", loaded from the derived data cache in " : ", compiled in ") << compileMilliseconds << " ms" << std::endl;
+        return bCompiled;
+    };
+}
+
+std::function<bool()> Application::reloadTexture(const std::string& path)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    int textureWidth, textureHeight, textureChannels;
+    std::shared_ptr<stbi_uc> pixels(stbi_load(path.c_str(), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha), stbi_image_free);
+    if (!pixels)
+    {
+        return reportFailure("Failed to decode " + path + ", keeping the previous texture");
+    }
+    double decodeMilliseconds = millisecondsSince(startTime);
+
+    return [this, pixels, textureWidth, textureHeight, path, decodeMilliseconds]() {
+        if (mBindlessResourceTable.getTextureCount() + 1 > mBindlessResourceTable.getTextureCapacity())
+        {
+            std::cerr << "Not enough bindless texture slots to reload " << path << std::endl;
+            return false;
+        }
+
+        UniqueImage image;
+        UniqueDeviceMemory imageMemory;
+        uint32_t mipLevels;
+        uploadTextureImage(pixels.get(), textureWidth, textureHeight, image, imageMemory, mipLevels);
+        UniqueImageView imageView = createImageView(image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
+
+        // Only the first material samples the model texture, the stress materials keep their own. Frames in flight
+        // still sample the old slot, so the new texture gets a fresh one and the old slot is released once those
+        // frames complete. Until then either index is valid to read.
+        Material& material = mMaterials[0];
+        uint32_t oldIndex = material.albedoTextureIndex;
+        material.albedoTextureIndex = mBindlessResourceTable.registerTexture(imageView, mTextureSampler);
+        mDeletionQueue.retireCallback([this, oldIndex]() { mBindlessResourceTable.releaseTexture(oldIndex); }, mFrameIndex);
+        VkDeviceSize bufferSize = sizeof(Material);
+        void* data;
+        vkMapMemory(mLogicalDevice, mMaterialBufferMemory, 0, bufferSize, 0, &data);
+        memcpy(data, mMaterials.data(), static_cast<size_t>(bufferSize));
+        vkUnmapMemory(mLogicalDevice, mMaterialBufferMemory);
+
+        mDeletionQueue.retireImageView(std::move(mTextureImageView), mFrameIndex);
+        mDeletionQueue.retireImage(std::move(mTextureImage), std::move(mTextureImageMemory), mFrameIndex);
+        mTextureImage = std::move(image);
+        mTextureImageMemory = std::move(imageMemory);
+        mTextureImageView = std::move(imageView);
+        mMipLevels = mipLevels;
+        std::cout << "Reloaded " << path << ", decoded in " << decodeMilliseconds << " ms" << std::endl;
+        return true;
+    };
+}
+
+std::function<bool()> Application::reloadModel(const std::string& path)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<Vertex> newVertices;
+    std::vector<uint32_t> newIndices;
+    FileView file;
+    if (!mapFile(path, file))
+    {
+        return reportFailure("Failed to open " + path + ", keeping the previous model");
+    }
+    parseModel(file, newVertices, newIndices);
+    if (newIndices.empty())
+    {
+        return reportFailure(path + " has no triangles, keeping the previous model");
+    }
+    double parseMilliseconds = millisecondsSince(startTime);
+    std::vector<MeshLod> newLods = buildModelLods(newVertices, newIndices);
+    MeshletMesh newMeshlets;
+    uint32_t newMeshletFirstIndex = 0;
+    if (mbMeshletCullingSupported)
+    {
+        newMeshlets = buildModelMeshlets(newVertices, newIndices, newLods[0], newMeshletFirstIndex);
+    }
+
+    return [this, newVertices = std::move(newVertices), newIndices = std::move(newIndices), newLods = std::move(newLods), newMeshlets = std::move(newMeshlets), newMeshletFirstIndex, path,
+            parseMilliseconds]() mutable {
+        mDeletionQueue.retireBuffer(std::move(mVertexBuffer), std::move(mVertexBufferMemory), mFrameIndex);
+        mDeletionQueue.retireBuffer(std::move(mIndexBuffer), std::move(mIndexBufferMemory), mFrameIndex);
+        if (mMeshletBuffer != VK_NULL_HANDLE)
+        {
+            mDeletionQueue.retireBuffer(std::move(mMeshletBuffer), std::move(mMeshletBufferMemory), mFrameIndex);
+        }
+        vertices = std::move(newVertices);
+        indices = std::move(newIndices);
+        mMeshLods = std::move(newLods);
+        mMeshlets = std::move(newMeshlets);
+        mMeshletFirstIndex = newMeshletFirstIndex;
+        // Level indices of the previous model may not exist in the new chain
+        std::fill(mDrawObjectLods.begin(), mDrawObjectLods.end(), 0);
+        createVertexBuffer();
+        createIndexBuffer();
+        createMeshletBuffer();
+        updateModelBounds();
+        std::cout << "Reloaded " << path << ", parsed in " << parseMilliseconds << " ms" << std::endl;
+        return true;
+    };
+}
@@ -0,0 +1,299 @@
+#include "Application/Application.hpp"
+#include "Shader/MeshletCullComp.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+using namespace LearnVulkan;
+
+// Meshlet culling: a compute pass culls the meshlets of every full detail object against the frustum and
+// their normal cones and writes the survivors as indexed indirect draws, drawn with vkCmdDrawIndexedIndirectCount.
+// Toggled with M and applied between frames. Objects at coarser levels of detail keep their single draw.
+
+namespace
+{
+    const uint32_t MESHLET_CULLING_GROUP_SIZE = 64;
+    const uint32_t MESHLET_CULLING_BINDING_COUNT = 4;
+}  // namespace
+
+const uint32_t Application::NO_MESHLET_SLOT = UINT32_MAX;
+
+void Application::createMeshletCullingPipeline()
+{
+    if (!mbMeshletCullingSupported)
+    {
+        return;
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    MESHLET_CULL_COMP.collectDescriptorSetLayoutBindings(0, bindings);
+    VkDescriptorSetLayoutCreateInfo layoutInfo {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VkDescriptorSetLayout descriptorSetLayout;
+    if (vkCreateDescriptorSetLayout(mLogicalDevice, &layoutInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Descriptors), &descriptorSetLayout) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create meshlet culling descriptor set layout!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mMeshletCullingDescriptorSetLayout = UniqueDescriptorSetLayout(descriptorSetLayout);
+
+    VkDescriptorPoolSize poolSize {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = MESHLET_CULLING_BINDING_COUNT * MAX_FRAMES_IN_FLIGHT;
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    VkDescriptorPool descriptorPool;
+    if (vkCreateDescriptorPool(mLogicalDevice, &poolInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Descriptors), &descriptorPool) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create meshlet culling descriptor pool!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mMeshletCullingDescriptorPool = UniqueDescriptorPool(descriptorPool);
+
+    // One set per frame in flight, rewritten in place whenever its buffers change
+    mMeshletCullingFrames.resize(MAX_FRAMES_IN_FLIGHT);
+    std::vector<VkDescriptorSetLayout> setLayouts(MAX_FRAMES_IN_FLIGHT, mMeshletCullingDescriptorSetLayout);
+    std::vector<VkDescriptorSet> descriptorSets(MAX_FRAMES_IN_FLIGHT);
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = mMeshletCullingDescriptorPool;
+    allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    allocInfo.pSetLayouts = setLayouts.data();
+    if (vkAllocateDescriptorSets(mLogicalDevice, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to allocate meshlet culling descriptor sets!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        mMeshletCullingFrames[i].descriptorSet = descriptorSets[i];
+    }
+
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(MeshletCullingPushConstantObject);
+    if (MESHLET_CULL_COMP.pushConstantSize > pushConstantRange.size)
+    {
+        std::cerr << "Push constant block of " << MESHLET_CULL_COMP.sourceName << " is larger than MeshletCullingPushConstantObject!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    VkPipelineLayout pipelineLayout;
+    if (vkCreatePipelineLayout(mLogicalDevice, &pipelineLayoutInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &pipelineLayout) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create meshlet culling pipeline layout!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mMeshletCullingPipelineLayout = UniquePipelineLayout(pipelineLayout);
+
+    UniqueShaderModule computeShaderModule = createShaderModule(MESHLET_CULL_COMP);
+    VkComputePipelineCreateInfo pipelineInfo {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = computeShaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = mMeshletCullingPipelineLayout;
+    VkPipeline pipeline;
+    if (vkCreateComputePipelines(mLogicalDevice, mPipelineCache, 1, &pipelineInfo, mHostAllocator.getCallbacks(HostAllocationSubsystem::Pipelines), &pipeline) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create meshlet culling pipeline!" << std::endl;
+        mbQuit = true;
+        return;
+    }
+    mMeshletCullingPipeline = UniquePipeline(pipeline);
+}
+
+// Bounds and index range of every meshlet, the index ranges point at the meshlet ordered copy of level 0
+void Application::createMeshletBuffer()
+{
+    if (mMeshlets.meshlets.empty())
+    {
+        return;
+    }
+    std::vector<MeshletBufferObject> meshletObjects(mMeshlets.meshlets.size());
+    for (size_t i = 0; i < meshletObjects.size(); i++)
+    {
+        const Meshlet& meshlet = mMeshlets.meshlets[i];
+        const MeshletBounds& bounds = mMeshlets.bounds[i];
+        meshletObjects[i].sphere = glm::vec4(bounds.center, bounds.radius);
+        meshletObjects[i].cone = glm::vec4(bounds.coneAxis, bounds.coneCutoff);
+        meshletObjects[i].firstIndex = mMeshletFirstIndex + meshlet.triangleOffset * 3;
+        meshletObjects[i].indexCount = meshlet.triangleCount * 3;
+    }
+    VkDeviceSize bufferSize = sizeof(MeshletBufferObject) * meshletObjects.size();
+
+    UniqueBuffer stagingBuffer;
+    UniqueDeviceMemory stagingBufferMemory;
+    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Staging, stagingBuffer, stagingBufferMemory);
+
+    void* data;
+    vkMapMemory(mLogicalDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
+    memcpy(data, meshletObjects.data(), static_cast<size_t>(bufferSize));
+    vkUnmapMemory(mLogicalDevice, stagingBufferMemory);
+
+    createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DeviceMemoryCategory::Storage, mMeshletBuffer, mMeshletBufferMemory);
+    copyBuffer(stagingBuffer, mMeshletBuffer, bufferSize);
+}
+
+void Application::setMeshletCulling(bool bEnabled)
+{
+    if (bEnabled && !mbMeshletCullingSupported)
+    {
+        std::cerr << "Meshlet culling is unsupported on this device" << std::endl;
+        return;
+    }
+    mbMeshletCulling = bEnabled;
+    std::cout << "Meshlet culling: " << (mbMeshletCulling ? "on" : "off") << std::endl;
+}
+
+// Runs after the draw lists are built, so the level of every object is known. Only objects at level 0 get a slot.
+void Application::updateMeshletCulling(const glm::mat4& view, const glm::mat4& projection)
+{
+    mMeshletSlotCount = 0;
+    if (!mbMeshletCulling || mMeshletBuffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+    mMeshletObjectSlots.resize(mDrawObjects.size());
+    for (size_t i = 0; i < mDrawObjects.size(); i++)
+    {
+        mMeshletObjectSlots[i] = mDrawObjectLods[i] == 0 ? mMeshletSlotCount++ : NO_MESHLET_SLOT;
+    }
+    if (mMeshletSlotCount == 0)
+    {
+        return;
+    }
+
+    // Gribb and Hartmann: with clip = M * world, a clip space plane is a sum or difference of the rows of M.
+    // Depth runs from 0 to 1, so the near plane is the third row alone.
+    glm::mat4 viewProjection = projection * view;
+    auto row = [&viewProjection](int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+    std::array<glm::vec4, 6> planes {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)};
+    for (size_t i = 0; i < planes.size(); i++)
+    {
+        mMeshletCullingConstants.frustumPlanes[i] = planes[i] / glm::length(glm::vec3(planes[i]));
+    }
+    mMeshletCullingConstants.cameraPosition = glm::inverse(view)[3];
+    mMeshletCullingConstants.meshletCount = static_cast<uint32_t>(mMeshlets.meshlets.size());
+    mMeshletCullingConstants.bConeCulling = mGraphicsPipelineKey.cullMode == VK_CULL_MODE_BACK_BIT ? 1 : 0;
+
+    MeshletCullingFrame& frame = mMeshletCullingFrames[mCurrentFrame];
+    updateMeshletCullingFrame(frame);
+
+    void* data;
+    vkMapMemory(mLogicalDevice, frame.objectBufferMemory, 0, sizeof(glm::mat4) * mMeshletSlotCount, 0, &data);
+    glm::mat4* models = static_cast<glm::mat4*>(data);
+    for (size_t i = 0; i < mDrawObjects.size(); i++)
+    {
+        if (mMeshletObjectSlots[i] != NO_MESHLET_SLOT)
+        {
+            models[mMeshletObjectSlots[i]] = mDrawObjects[i].model;
+        }
+    }
+    vkUnmapMemory(mLogicalDevice, frame.objectBufferMemory);
+}
+
+// Grows the buffers of a frame to the current slot and meshlet counts. The fence of the frame has been waited on,
+// so its descriptor set can be rewritten, the replaced buffers are still retired in case a resize is in flight.
+void Application::updateMeshletCullingFrame(MeshletCullingFrame& frame)
+{
+    uint32_t meshletCount = mMeshletCullingConstants.meshletCount;
+    if (frame.slotCapacity >= mMeshletSlotCount && frame.meshletCount == meshletCount && frame.meshletBuffer == mMeshletBuffer)
+    {
+        return;
+    }
+    if (frame.objectBuffer != VK_NULL_HANDLE)
+    {
+        mDeletionQueue.retireBuffer(std::move(frame.objectBuffer), std::move(frame.objectBufferMemory), mFrameIndex);
+        mDeletionQueue.retireBuffer(std::move(frame.drawBuffer), std::move(frame.drawBufferMemory), mFrameIndex);
+        mDeletionQueue.retireBuffer(std::move(frame.drawCountBuffer), std::move(frame.drawCountBufferMemory), mFrameIndex);
+    }
+    frame.slotCapacity = std::max(mMeshletSlotCount, frame.slotCapacity);
+    frame.meshletCount = meshletCount;
+    frame.meshletBuffer = mMeshletBuffer;
+
+    VkDeviceSize objectBufferSize = sizeof(glm::mat4) * frame.slotCapacity;
+    VkDeviceSize drawBufferSize = sizeof(VkDrawIndexedIndirectCommand) * frame.slotCapacity * meshletCount;
+    VkDeviceSize drawCountBufferSize = sizeof(uint32_t) * frame.slotCapacity;
+    createBuffer(objectBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, DeviceMemoryCategory::Storage,
+                 frame.objectBuffer, frame.objectBufferMemory);
+    createBuffer(drawBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DeviceMemoryCategory::Storage,
+                 frame.drawBuffer, frame.drawBufferMemory);
+    createBuffer(drawCountBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                 DeviceMemoryCategory::Storage, frame.drawCountBuffer, frame.drawCountBufferMemory);
+
+    std::array<VkDescriptorBufferInfo, MESHLET_CULLING_BINDING_COUNT> bufferInfos {};
+    bufferInfos[0] = {mMeshletBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[1] = {frame.objectBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[2] = {frame.drawBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[3] = {frame.drawCountBuffer, 0, VK_WHOLE_SIZE};
+    std::array<VkWriteDescriptorSet, MESHLET_CULLING_BINDING_COUNT> descriptorWrites {};
+    for (uint32_t i = 0; i < MESHLET_CULLING_BINDING_COUNT; i++)
+    {
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = frame.descriptorSet;
+        descriptorWrites[i].dstBinding = i;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(mLogicalDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+void Application::recordMeshletCulling(VkCommandBuffer commandBuffer)
+{
+    if (!mbMeshletCulling || mMeshletSlotCount == 0)
+    {
+        return;
+    }
+    const MeshletCullingFrame& frame = mMeshletCullingFrames[mCurrentFrame];
+    vkCmdFillBuffer(commandBuffer, frame.drawCountBuffer, 0, sizeof(uint32_t) * mMeshletSlotCount, 0);
+
+    VkMemoryBarrier clearBarrier {};
+    clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mMeshletCullingPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mMeshletCullingPipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, mMeshletCullingPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(MeshletCullingPushConstantObject), &mMeshletCullingConstants);
+    vkCmdDispatch(commandBuffer, (mMeshletCullingConstants.meshletCount + MESHLET_CULLING_GROUP_SIZE - 1) / MESHLET_CULLING_GROUP_SIZE, mMeshletSlotCount, 1);
+
+    VkMemoryBarrier drawBarrier {};
+    drawBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    drawBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    drawBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
+}
+
+void Application::destroyMeshletCulling()
+{
+    // Frames own their buffers
+    mMeshletCullingFrames.clear();
+    mMeshletBuffer.reset();
+    mMeshletBufferMemory.reset();
+    mMeshletCullingPipeline.reset();
+    mMeshletCullingPipelineLayout.reset();
+    mMeshletCullingDescriptorPool.reset();
+    mMeshletCullingDescriptorSetLayout.reset();
+}
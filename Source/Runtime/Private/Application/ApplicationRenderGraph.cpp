@@ -0,0 +1,178 @@
+#include "Application/Application.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace LearnVulkan;
+
+// Frame graph: the scene pass, the optional FXAA and blit passes and the transition to present.
+// Rebuilt with the render targets whenever the swapchain or the anti-aliasing tier changes.
+
+void Application::createRenderTargets()
+{
+    buildFrameGraph();
+    createFrameGraphImages();
+
+    if (mColorImage != VK_NULL_HANDLE)
+    {
+        mColorImageView = createImageView(mColorImage, getSceneColorFormat(), VK_IMAGE_ASPECT_COLOR_BIT, 1);
+    }
+    mDepthImageView = createImageView(mDepthImage, findDepthFormat(), VK_IMAGE_ASPECT_DEPTH_BIT, 1);
+    if (mAntiAliasing.bPostProcess)
+    {
+        mSceneColorImageView = createImageView(mSceneColorImage, SCENE_COLOR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+        mPostProcessImageView = createImageView(mPostProcessImage, SCENE_COLOR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+        createPostProcessDescriptorSet();
+    }
+}
+
+void Application::buildFrameGraph()
+{
+    mFrameGraph.clear();
+    mFrameGraphImages.clear();
+    mColorImage = {};
+    mColorImageMemory = {};
+    mColorImageView = {};
+    mDepthImage = {};
+    mDepthImageMemory = {};
+    mDepthImageView = {};
+    mSceneColorImage = {};
+    mSceneColorImageMemory = {};
+    mSceneColorImageView = {};
+    mPostProcessImage = {};
+    mPostProcessImageMemory = {};
+    mPostProcessImageView = {};
+    mPostProcessDescriptorSet = VK_NULL_HANDLE;
+
+    // Acquisition is waited on at these stages, see drawFrame
+    RenderGraphImageState acquiredState {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_NONE_KHR, VK_IMAGE_LAYOUT_UNDEFINED};
+    mFrameGraphSwapchainImage = mFrameGraph.importImage("Swapchain", VK_IMAGE_ASPECT_COLOR_BIT, acquiredState);
+
+    RenderTargetDescription description {};
+    description.width = mSwapchainExtent.width;
+    description.height = mSwapchainExtent.height;
+
+    RenderGraphPass scenePass = mFrameGraph.addPass("Scene", [this](VkCommandBuffer commandBuffer) { recordScenePass(commandBuffer); });
+    if (mMsaaSamples != VK_SAMPLE_COUNT_1_BIT)
+    {
+        description.format = getSceneColorFormat();
+        description.samples = mMsaaSamples;
+        description.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        description.bTransient = true;
+        RenderGraphResource color = addFrameGraphImage("Multisampled color", description, VK_IMAGE_ASPECT_COLOR_BIT, mColorImage, mColorImageMemory);
+        mFrameGraph.addAccess(scenePass, color, RenderGraphAccess::ColorAttachmentWrite);
+    }
+
+    VkFormat depthFormat = findDepthFormat();
+    description.format = depthFormat;
+    description.samples = mMsaaSamples;
+    description.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    description.bTransient = true;
+    VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (hasStencilComponent(depthFormat))
+    {
+        depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    RenderGraphResource depth = addFrameGraphImage("Depth", description, depthAspect, mDepthImage, mDepthImageMemory);
+    mFrameGraph.addAccess(scenePass, depth, RenderGraphAccess::DepthAttachmentWrite);
+
+    if (!mAntiAliasing.bPostProcess)
+    {
+        mFrameGraph.addAccess(scenePass, mFrameGraphSwapchainImage, RenderGraphAccess::ColorAttachmentWrite);
+    }
+    else
+    {
+        description.format = SCENE_COLOR_FORMAT;
+        description.samples = VK_SAMPLE_COUNT_1_BIT;
+        description.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        description.bTransient = false;
+        RenderGraphResource sceneColor = addFrameGraphImage("Scene color", description, VK_IMAGE_ASPECT_COLOR_BIT, mSceneColorImage, mSceneColorImageMemory);
+        mFrameGraph.addAccess(scenePass, sceneColor, RenderGraphAccess::ColorAttachmentWrite);
+
+        description.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        RenderGraphResource postProcessOutput = addFrameGraphImage("FXAA output", description, VK_IMAGE_ASPECT_COLOR_BIT, mPostProcessImage, mPostProcessImageMemory);
+
+        RenderGraphPass fxaaPass = mFrameGraph.addPass("FXAA", [this](VkCommandBuffer commandBuffer) { recordPostProcess(commandBuffer); });
+        mFrameGraph.addAccess(fxaaPass, sceneColor, RenderGraphAccess::ComputeSampledRead);
+        mFrameGraph.addAccess(fxaaPass, postProcessOutput, RenderGraphAccess::ComputeStorageWrite);
+
+        RenderGraphPass blitPass = mFrameGraph.addPass("Blit to swapchain", [this](VkCommandBuffer commandBuffer) { recordPostProcessBlit(commandBuffer); });
+        mFrameGraph.addAccess(blitPass, postProcessOutput, RenderGraphAccess::TransferRead);
+        mFrameGraph.addAccess(blitPass, mFrameGraphSwapchainImage, RenderGraphAccess::TransferWrite);
+    }
+
+    RenderGraphPass presentPass = mFrameGraph.addPass("Present", nullptr);
+    mFrameGraph.addAccess(presentPass, mFrameGraphSwapchainImage, RenderGraphAccess::Present);
+
+    mFrameGraph.compile();
+#ifdef DEBUG
+    std::string error;
+    if (!mFrameGraph.validate(error))
+    {
+        std::cerr << "Invalid frame graph: " << error << std::endl;
+    }
+#endif
+}
+
+RenderGraphResource Application::addFrameGraphImage(const std::string& name, const RenderTargetDescription& description, VkImageAspectFlags aspectMask, UniqueImage& image, UniqueDeviceMemory& memory)
+{
+    RenderGraphImageDescription graphDescription {};
+    graphDescription.aspectMask = aspectMask;
+    if (!mRenderTargetAllocator.usesLazyAllocation(description))
+    {
+        VkMemoryRequirements memoryRequirements = mRenderTargetAllocator.getMemoryRequirements(description);
+        graphDescription.size = memoryRequirements.size;
+        graphDescription.memoryTypeBits = memoryRequirements.memoryTypeBits;
+    }
+    RenderGraphResource resource = mFrameGraph.createImage(name, graphDescription);
+    mFrameGraphImages.push_back({resource, description, &image, &memory});
+    return resource;
+}
+
+void Application::createFrameGraphImages()
+{
+    auto findImage = [this](RenderGraphResource resource) -> FrameGraphImage& {
+        return *std::find_if(mFrameGraphImages.begin(), mFrameGraphImages.end(), [resource](const FrameGraphImage& image) { return image.resource == resource; });
+    };
+
+    std::vector<RenderTargetDescription> descriptions;
+    std::vector<VkImage> images;
+    std::vector<VkDeviceMemory> memories;
+    for (const std::vector<RenderGraphResource>& group : mFrameGraph.getAliasGroups())
+    {
+        descriptions.clear();
+        for (RenderGraphResource resource : group)
+        {
+            descriptions.push_back(findImage(resource).description);
+        }
+        images.resize(group.size());
+        memories.resize(group.size());
+        if (group.size() == 1)
+        {
+            mRenderTargetAllocator.createImage(descriptions[0], images[0], memories[0]);
+        }
+        else
+        {
+            mRenderTargetAllocator.createAliasedImages(descriptions.data(), static_cast<uint32_t>(group.size()), images.data(), memories.data());
+        }
+        for (size_t i = 0; i < group.size(); i++)
+        {
+            FrameGraphImage& image = findImage(group[i]);
+            *image.image = UniqueImage(images[i]);
+            *image.memory = UniqueDeviceMemory(memories[i]);
+        }
+    }
+
+    // Lazily allocated images are left out of every alias group
+    for (FrameGraphImage& image : mFrameGraphImages)
+    {
+        if (*image.image == VK_NULL_HANDLE)
+        {
+            VkImage lazyImage;
+            VkDeviceMemory lazyMemory;
+            mRenderTargetAllocator.createImage(image.description, lazyImage, lazyMemory);
+            *image.image = UniqueImage(lazyImage);
+            *image.memory = UniqueDeviceMemory(lazyMemory);
+        }
+        mFrameGraph.bindImage(image.resource, *image.image);
+    }
+}
@@ -0,0 +1,230 @@
+#include "Compression/Lz4.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    const size_t MIN_MATCH = 4;
+    // The format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end
+    const size_t LAST_LITERALS = 5;
+    const size_t MATCH_FIND_LIMIT = 12;
+    const size_t MAX_OFFSET = 65535;
+    const uint32_t HASH_BITS = 16;
+    const uint32_t RUN_MASK = 15;
+    // Short copies move whole chunks of this size where both buffers have room, a few bytes past the end of the
+    // copy are written and then overwritten by the next sequence
+    const size_t WILD_COPY_SIZE = 16;
+
+    uint32_t read32(const std::byte* data)
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint32_t hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // Lengths of 15 and more continue in bytes of 255 and a final byte below 255
+    bool writeLength(size_t length, std::byte*& output, const std::byte* outputEnd)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            if (output == outputEnd)
+            {
+                return false;
+            }
+            *output++ = std::byte {255};
+        }
+        if (output == outputEnd)
+        {
+            return false;
+        }
+        *output++ = static_cast<std::byte>(length);
+        return true;
+    }
+
+    bool readLength(size_t& length, const std::byte*& input, const std::byte* inputEnd)
+    {
+        uint8_t value;
+        do
+        {
+            if (input == inputEnd)
+            {
+                return false;
+            }
+            value = static_cast<uint8_t>(*input++);
+            length += value;
+        } while (value == 255);
+        return true;
+    }
+
+    bool writeSequence(const std::byte* literals, size_t literalLength, size_t offset, size_t matchLength, std::byte*& output, const std::byte* outputEnd)
+    {
+        if (output == outputEnd)
+        {
+            return false;
+        }
+        std::byte* token = output++;
+        size_t literalRun = std::min<size_t>(literalLength, RUN_MASK);
+        size_t matchRun = matchLength ? std::min<size_t>(matchLength - MIN_MATCH, RUN_MASK) : 0;
+        *token = static_cast<std::byte>((literalRun << 4) | matchRun);
+        if (literalRun == RUN_MASK && !writeLength(literalLength - RUN_MASK, output, outputEnd))
+        {
+            return false;
+        }
+        if (static_cast<size_t>(outputEnd - output) < literalLength)
+        {
+            return false;
+        }
+        std::copy_n(literals, literalLength, output);
+        output += literalLength;
+        // The last sequence has literals only
+        if (matchLength == 0)
+        {
+            return true;
+        }
+        if (outputEnd - output < 2)
+        {
+            return false;
+        }
+        *output++ = static_cast<std::byte>(offset & 0xFF);
+        *output++ = static_cast<std::byte>(offset >> 8);
+        return matchRun < RUN_MASK || writeLength(matchLength - MIN_MATCH - RUN_MASK, output, outputEnd);
+    }
+}  // namespace
+
+size_t LearnVulkan::getLz4CompressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t LearnVulkan::compressLz4(std::span<const std::byte> source, std::span<std::byte> destination)
+{
+    const std::byte* input = source.data();
+    const size_t size = source.size();
+    std::byte* output = destination.data();
+    const std::byte* outputEnd = output + destination.size();
+
+    size_t anchor = 0;
+    if (size > MATCH_FIND_LIMIT)
+    {
+        // Last position seen for each hashed 4 byte sequence, plus one so 0 means none
+        std::vector<uint32_t> table(size_t {1} << HASH_BITS, 0);
+        const size_t matchLimit = size - LAST_LITERALS;
+        size_t position = 0;
+        while (position < size - MATCH_FIND_LIMIT)
+        {
+            uint32_t sequence = read32(input + position);
+            uint32_t& slot = table[hash(sequence)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(position + 1);
+            if (candidate == 0 || position + 1 - candidate > MAX_OFFSET || read32(input + candidate - 1) != sequence)
+            {
+                position++;
+                continue;
+            }
+            candidate--;
+
+            size_t matchLength = MIN_MATCH;
+            while (position + matchLength < matchLimit && input[candidate + matchLength] == input[position + matchLength])
+            {
+                matchLength++;
+            }
+            if (!writeSequence(input + anchor, position - anchor, position - candidate, matchLength, output, outputEnd))
+            {
+                return 0;
+            }
+            position += matchLength;
+            anchor = position;
+        }
+    }
+    if (!writeSequence(input + anchor, size - anchor, 0, 0, output, outputEnd))
+    {
+        return 0;
+    }
+    return static_cast<size_t>(output - destination.data());
+}
+
+bool LearnVulkan::decompressLz4(std::span<const std::byte> source, std::span<std::byte> destination)
+{
+    const std::byte* input = source.data();
+    const std::byte* inputEnd = input + source.size();
+    std::byte* output = destination.data();
+    std::byte* outputEnd = output + destination.size();
+
+    while (input < inputEnd)
+    {
+        uint8_t token = static_cast<uint8_t>(*input++);
+        size_t literalLength = token >> 4;
+        if (literalLength == RUN_MASK && !readLength(literalLength, input, inputEnd))
+        {
+            return false;
+        }
+        if (static_cast<size_t>(inputEnd - input) < literalLength || static_cast<size_t>(outputEnd - output) < literalLength)
+        {
+            return false;
+        }
+        if (literalLength < RUN_MASK && static_cast<size_t>(inputEnd - input) >= WILD_COPY_SIZE && static_cast<size_t>(outputEnd - output) >= WILD_COPY_SIZE)
+        {
+            memcpy(output, input, WILD_COPY_SIZE);
+        }
+        else
+        {
+            std::copy_n(input, literalLength, output);
+        }
+        input += literalLength;
+        output += literalLength;
+        if (input == inputEnd)
+        {
+            break;
+        }
+
+        if (inputEnd - input < 2)
+        {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(input[0]) | (static_cast<size_t>(input[1]) << 8);
+        input += 2;
+        size_t matchLength = token & RUN_MASK;
+        if (matchLength == RUN_MASK && !readLength(matchLength, input, inputEnd))
+        {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(output - destination.data()) || static_cast<size_t>(outputEnd - output) < matchLength)
+        {
+            return false;
+        }
+        const std::byte* match = output - offset;
+        if (offset >= sizeof(uint64_t) && static_cast<size_t>(outputEnd - output) >= matchLength + sizeof(uint64_t))
+        {
+            // Every 8 byte chunk only reads bytes written before it, so this also handles overlapping matches
+            for (size_t i = 0; i < matchLength; i += sizeof(uint64_t))
+            {
+                memcpy(output + i, match + i, sizeof(uint64_t));
+            }
+            output += matchLength;
+        }
+        else if (offset >= matchLength)
+        {
+            memcpy(output, match, matchLength);
+            output += matchLength;
+        }
+        else
+        {
+            // Overlapping match repeats the last offset bytes
+            for (size_t i = 0; i < matchLength; i++)
+            {
+                *output++ = match[i];
+            }
+        }
+    }
+    return output == outputEnd;
+}
@@ -0,0 +1,360 @@
+#include "FileSystem/AssetArchive.hpp"
+#include "Compression/Lz4.hpp"
+#include "FileSystem/MappedFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // "LVPK", fields are little endian like every platform the renderer runs on
+    const uint32_t ARCHIVE_MAGIC = 0x4B50564C;
+    const uint32_t ARCHIVE_VERSION = 1;
+    // Page aligned, so a stored entry is mapped exactly like a loose file would be
+    const uint64_t DATA_ALIGNMENT = 4096;
+    // Unit of compression and of parallel decompression
+    const uint32_t BLOCK_SIZE = 256 * 1024;
+
+    struct ArchiveHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t blockCount;
+        uint64_t entriesOffset;
+        uint64_t blocksOffset;
+        uint64_t pathsOffset;
+        uint64_t pathsSize;
+    };
+
+    struct ArchiveEntry
+    {
+        uint64_t pathHash;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t firstBlock;
+        uint32_t blockCount;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+    };
+
+    struct ArchiveBlock
+    {
+        uint64_t offset;
+        uint32_t storedSize;
+        uint32_t size;
+    };
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool isInRange(uint64_t offset, uint64_t size, uint64_t totalSize)
+    {
+        return offset <= totalSize && size <= totalSize - offset;
+    }
+
+    template<typename T>
+    bool readValue(std::span<const std::byte> bytes, uint64_t offset, T& value)
+    {
+        if (!isInRange(offset, sizeof(T), bytes.size()))
+        {
+            return false;
+        }
+        memcpy(&value, bytes.data() + offset, sizeof(T));
+        return true;
+    }
+
+    void writeBytes(std::ofstream& file, uint64_t& offset, const void* data, size_t size)
+    {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        offset += size;
+    }
+
+    void writePadding(std::ofstream& file, uint64_t& offset, uint64_t alignment)
+    {
+        static const char ZEROS[DATA_ALIGNMENT] = {};
+        writeBytes(file, offset, ZEROS, alignUp(offset, alignment) - offset);
+    }
+}  // namespace
+
+void AssetArchiveWriter::addFile(const std::string& path, std::vector<std::byte> bytes, bool bCompress)
+{
+    mFiles.push_back({VirtualFileSystem::normalizePath(path), std::move(bytes), bCompress});
+}
+
+bool AssetArchiveWriter::addNativeFile(const std::string& path, const std::string& nativePath, bool bCompress)
+{
+    MappedFile file;
+    if (!file.open(nativePath))
+    {
+        return false;
+    }
+    std::span<const std::byte> bytes = file.getBytes();
+    addFile(path, std::vector<std::byte>(bytes.begin(), bytes.end()), bCompress);
+    return true;
+}
+
+void AssetArchiveWriter::write(const std::string& archivePath) const
+{
+    std::vector<const PendingFile*> files;
+    for (const PendingFile& file : mFiles)
+    {
+        files.push_back(&file);
+    }
+    std::sort(files.begin(), files.end(), [](const PendingFile* a, const PendingFile* b) {
+        uint64_t hashA = ArchiveFileSource::hashPath(a->path);
+        uint64_t hashB = ArchiveFileSource::hashPath(b->path);
+        return hashA != hashB ? hashA < hashB : a->path < b->path;
+    });
+    for (size_t i = 1; i < files.size(); i++)
+    {
+        if (files[i - 1]->path == files[i]->path)
+        {
+            throw std::runtime_error("Archive contains " + files[i]->path + " twice");
+        }
+    }
+
+    std::ofstream file(archivePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to create " + archivePath);
+    }
+    ArchiveHeader header {};
+    uint64_t offset = 0;
+    writeBytes(file, offset, &header, sizeof(header));
+
+    std::vector<ArchiveEntry> entries;
+    std::vector<ArchiveBlock> blocks;
+    std::string paths;
+    std::vector<std::byte> compressed(getLz4CompressBound(BLOCK_SIZE));
+    for (const PendingFile* pendingFile : files)
+    {
+        writePadding(file, offset, DATA_ALIGNMENT);
+        const std::vector<std::byte>& bytes = pendingFile->bytes;
+        ArchiveEntry entry {};
+        entry.pathHash = ArchiveFileSource::hashPath(pendingFile->path);
+        entry.offset = offset;
+        entry.size = bytes.size();
+        entry.firstBlock = static_cast<uint32_t>(blocks.size());
+        entry.pathOffset = static_cast<uint32_t>(paths.size());
+        entry.pathLength = static_cast<uint32_t>(pendingFile->path.size());
+        paths += pendingFile->path;
+
+        if (!pendingFile->bCompress)
+        {
+            writeBytes(file, offset, bytes.data(), bytes.size());
+            entries.push_back(entry);
+            continue;
+        }
+        bool bAnyCompressed = false;
+        for (size_t start = 0; start < bytes.size(); start += BLOCK_SIZE)
+        {
+            std::span<const std::byte> block(bytes.data() + start, std::min<size_t>(BLOCK_SIZE, bytes.size() - start));
+            size_t compressedSize = compressLz4(block, compressed);
+            bool bCompressed = compressedSize > 0 && compressedSize < block.size();
+            bAnyCompressed = bAnyCompressed || bCompressed;
+            blocks.push_back({offset, static_cast<uint32_t>(bCompressed ? compressedSize : block.size()), static_cast<uint32_t>(block.size())});
+            writeBytes(file, offset, bCompressed ? compressed.data() : block.data(), blocks.back().storedSize);
+        }
+        // Uncompressed blocks are contiguous, so if none shrank the data is already laid out as a stored entry
+        if (bAnyCompressed)
+        {
+            entry.blockCount = static_cast<uint32_t>(blocks.size()) - entry.firstBlock;
+        }
+        else
+        {
+            blocks.resize(entry.firstBlock);
+        }
+        entries.push_back(entry);
+    }
+
+    writePadding(file, offset, alignof(ArchiveEntry));
+    header.magic = ARCHIVE_MAGIC;
+    header.version = ARCHIVE_VERSION;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.blockCount = static_cast<uint32_t>(blocks.size());
+    header.entriesOffset = offset;
+    writeBytes(file, offset, entries.data(), entries.size() * sizeof(ArchiveEntry));
+    header.blocksOffset = offset;
+    writeBytes(file, offset, blocks.data(), blocks.size() * sizeof(ArchiveBlock));
+    header.pathsOffset = offset;
+    header.pathsSize = paths.size();
+    writeBytes(file, offset, paths.data(), paths.size());
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write " + archivePath);
+    }
+}
+
+bool ArchiveFileSource::load(const std::string& archivePath)
+{
+    std::shared_ptr<MappedFile> archive = std::make_shared<MappedFile>();
+    if (!archive->open(archivePath))
+    {
+        return false;
+    }
+    std::span<const std::byte> bytes = archive->getBytes();
+    ArchiveHeader header;
+    if (!readValue(bytes, 0, header) || header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION ||
+        !isInRange(header.pathsOffset, header.pathsSize, bytes.size()))
+    {
+        return false;
+    }
+    std::string_view paths(reinterpret_cast<const char*>(bytes.data() + header.pathsOffset), header.pathsSize);
+
+    // Everything is validated here so open never reads outside the mapping, even for a damaged archive
+    std::vector<Block> blocks(header.blockCount);
+    for (uint32_t i = 0; i < header.blockCount; i++)
+    {
+        ArchiveBlock block;
+        if (!readValue(bytes, header.blocksOffset + uint64_t {i} * sizeof(ArchiveBlock), block) ||
+            !isInRange(block.offset, block.storedSize, bytes.size()) || block.storedSize > block.size)
+        {
+            return false;
+        }
+        blocks[i] = {block.offset, block.storedSize, block.size};
+    }
+    std::vector<Entry> entries(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; i++)
+    {
+        ArchiveEntry entry;
+        if (!readValue(bytes, header.entriesOffset + uint64_t {i} * sizeof(ArchiveEntry), entry) ||
+            !isInRange(entry.pathOffset, entry.pathLength, paths.size()) || !isInRange(entry.firstBlock, entry.blockCount, blocks.size()))
+        {
+            return false;
+        }
+        if (entry.blockCount == 0 && !isInRange(entry.offset, entry.size, bytes.size()))
+        {
+            return false;
+        }
+        // Block i decompresses to offset i * BLOCK_SIZE of the file
+        for (uint32_t blockIndex = 0; blockIndex < entry.blockCount; blockIndex++)
+        {
+            uint64_t start = uint64_t {blockIndex} * BLOCK_SIZE;
+            if (start >= entry.size || blocks[entry.firstBlock + blockIndex].size != std::min<uint64_t>(BLOCK_SIZE, entry.size - start))
+            {
+                return false;
+            }
+        }
+        if (entry.blockCount > 0 && uint64_t {entry.blockCount} * BLOCK_SIZE < entry.size)
+        {
+            return false;
+        }
+        entries[i] = {entry.pathHash, entry.offset, entry.size, entry.firstBlock, entry.blockCount, paths.substr(entry.pathOffset, entry.pathLength)};
+    }
+    if (!std::is_sorted(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.pathHash < b.pathHash; }))
+    {
+        return false;
+    }
+
+    mArchive = std::move(archive);
+    mEntries = std::move(entries);
+    mBlocks = std::move(blocks);
+    return true;
+}
+
+bool ArchiveFileSource::contains(const std::string& path) const
+{
+    return find(path) != nullptr;
+}
+
+bool ArchiveFileSource::open(const std::string& path, FileView& view) const
+{
+    const Entry* entry = find(path);
+    if (!entry)
+    {
+        return false;
+    }
+    if (entry->blockCount == 0)
+    {
+        view = FileView(mArchive, mArchive->getBytes().subspan(entry->offset, entry->size));
+        return true;
+    }
+    std::shared_ptr<std::vector<std::byte>> bytes = std::make_shared<std::vector<std::byte>>(entry->size);
+    if (!decompress(*entry, bytes->data()))
+    {
+        return false;
+    }
+    std::span<const std::byte> span(*bytes);
+    view = FileView(std::move(bytes), span);
+    return true;
+}
+
+std::string ArchiveFileSource::getNativePath(const std::string& path) const
+{
+    (void)path;
+    return {};
+}
+
+uint64_t ArchiveFileSource::hashPath(std::string_view path)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : path)
+    {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+const ArchiveFileSource::Entry* ArchiveFileSource::find(const std::string& path) const
+{
+    uint64_t pathHash = hashPath(path);
+    auto it = std::lower_bound(mEntries.begin(), mEntries.end(), pathHash, [](const Entry& entry, uint64_t hash) { return entry.pathHash < hash; });
+    for (; it != mEntries.end() && it->pathHash == pathHash; it++)
+    {
+        if (it->path == path)
+        {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+bool ArchiveFileSource::decompress(const Entry& entry, std::byte* destination) const
+{
+    std::span<const std::byte> archiveBytes = mArchive->getBytes();
+    std::atomic<uint32_t> nextBlock = 0;
+    std::atomic<bool> bFailed = false;
+    auto decompressBlocks = [&]() {
+        for (uint32_t i = nextBlock++; i < entry.blockCount && !bFailed; i = nextBlock++)
+        {
+            const Block& block = mBlocks[entry.firstBlock + i];
+            std::span<const std::byte> source = archiveBytes.subspan(block.offset, block.storedSize);
+            std::byte* target = destination + uint64_t {i} * BLOCK_SIZE;
+            if (block.storedSize == block.size)
+            {
+                memcpy(target, source.data(), block.size);
+            }
+            else if (!decompressLz4(source, {target, block.size}))
+            {
+                bFailed = true;
+            }
+        }
+    };
+
+    // Blocks are independent, large entries decompress on every core with the calling thread taking part
+    uint32_t threadCount = std::min(entry.blockCount, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(decompressBlocks);
+    }
+    decompressBlocks();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    return !bFailed;
+}
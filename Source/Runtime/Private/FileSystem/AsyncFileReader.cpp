@@ -0,0 +1,416 @@
+#include "FileSystem/AsyncFileReader.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define LEARN_VULKAN_IO_URING 1
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+using namespace LearnVulkan;
+
+#ifdef LEARN_VULKAN_IO_URING
+namespace
+{
+    // Reads are capped below the kernel's per call limit, larger files take several
+    const size_t MAX_READ_SIZE = size_t(1) << 30;
+}  // namespace
+
+// Submission and completion rings shared with the kernel, set up with the raw system calls so there is no
+// dependency on liburing. Only the reader thread touches them.
+struct AsyncFileReader::IoUring
+{
+    int fileDescriptor = -1;
+    void* submissionRing = MAP_FAILED;
+    size_t submissionRingSize = 0;
+    void* completionRing = MAP_FAILED;
+    size_t completionRingSize = 0;
+    io_uring_sqe* submissionEntries = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t submissionEntriesSize = 0;
+
+    unsigned* submissionTail = nullptr;
+    unsigned submissionMask = 0;
+    unsigned* submissionArray = nullptr;
+    unsigned* completionHead = nullptr;
+    unsigned* completionTail = nullptr;
+    unsigned completionMask = 0;
+    io_uring_cqe* completionEntries = nullptr;
+    unsigned unsubmittedCount = 0;
+
+    ~IoUring()
+    {
+        if (submissionEntries != MAP_FAILED)
+        {
+            munmap(submissionEntries, submissionEntriesSize);
+        }
+        if (completionRing != MAP_FAILED && completionRing != submissionRing)
+        {
+            munmap(completionRing, completionRingSize);
+        }
+        if (submissionRing != MAP_FAILED)
+        {
+            munmap(submissionRing, submissionRingSize);
+        }
+        if (fileDescriptor >= 0)
+        {
+            close(fileDescriptor);
+        }
+    }
+
+    bool create(unsigned entryCount)
+    {
+        io_uring_params parameters {};
+        fileDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, entryCount, &parameters));
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+        completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+        bool bSingleMapping = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (bSingleMapping)
+        {
+            submissionRingSize = completionRingSize = std::max(submissionRingSize, completionRingSize);
+        }
+        submissionRing = mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fileDescriptor, IORING_OFF_SQ_RING);
+        if (submissionRing == MAP_FAILED)
+        {
+            return false;
+        }
+        completionRing = bSingleMapping ? submissionRing : mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fileDescriptor, IORING_OFF_CQ_RING);
+        if (completionRing == MAP_FAILED)
+        {
+            return false;
+        }
+        submissionEntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+        submissionEntries = static_cast<io_uring_sqe*>(mmap(nullptr, submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fileDescriptor, IORING_OFF_SQES));
+        if (submissionEntries == MAP_FAILED)
+        {
+            return false;
+        }
+
+        char* submission = static_cast<char*>(submissionRing);
+        submissionTail = reinterpret_cast<unsigned*>(submission + parameters.sq_off.tail);
+        submissionMask = *reinterpret_cast<unsigned*>(submission + parameters.sq_off.ring_mask);
+        submissionArray = reinterpret_cast<unsigned*>(submission + parameters.sq_off.array);
+        char* completion = static_cast<char*>(completionRing);
+        completionHead = reinterpret_cast<unsigned*>(completion + parameters.cq_off.head);
+        completionTail = reinterpret_cast<unsigned*>(completion + parameters.cq_off.tail);
+        completionMask = *reinterpret_cast<unsigned*>(completion + parameters.cq_off.ring_mask);
+        completionEntries = reinterpret_cast<io_uring_cqe*>(completion + parameters.cq_off.cqes);
+        return true;
+    }
+
+    // Callers keep at most as many reads in flight as the ring has entries, so there is always a free one
+    void pushRead(int file, iovec* vector, uint64_t offset, uint64_t userData)
+    {
+        unsigned tail = *submissionTail;
+        unsigned index = tail & submissionMask;
+        io_uring_sqe& entry = submissionEntries[index];
+        std::memset(&entry, 0, sizeof(entry));
+        // READV rather than READ, it has been available since io_uring itself
+        entry.opcode = IORING_OP_READV;
+        entry.fd = file;
+        entry.addr = reinterpret_cast<uint64_t>(vector);
+        entry.len = 1;
+        entry.off = offset;
+        entry.user_data = userData;
+        submissionArray[index] = index;
+        // The kernel must see the entry before the new tail
+        std::atomic_ref<unsigned>(*submissionTail).store(tail + 1, std::memory_order_release);
+        unsubmittedCount++;
+    }
+
+    // Submits everything pushed and blocks until at least one read has completed
+    bool submitAndWait()
+    {
+        while (true)
+        {
+            long result = syscall(__NR_io_uring_enter, fileDescriptor, unsubmittedCount, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result >= 0)
+            {
+                unsubmittedCount -= static_cast<unsigned>(result);
+                return true;
+            }
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {
+                return false;
+            }
+        }
+    }
+
+    template<typename Function>
+    void forEachCompletion(Function&& function)
+    {
+        unsigned head = *completionHead;
+        unsigned tail = std::atomic_ref<unsigned>(*completionTail).load(std::memory_order_acquire);
+        for (; head != tail; head++)
+        {
+            const io_uring_cqe& entry = completionEntries[head & completionMask];
+            function(entry.user_data, entry.res);
+        }
+        // Hands the entries back to the kernel once they have been read
+        std::atomic_ref<unsigned>(*completionHead).store(head, std::memory_order_release);
+    }
+};
+#else
+struct AsyncFileReader::IoUring
+{};
+#endif
+
+AsyncFileReader::AsyncFileReader() = default;
+
+AsyncFileReader::~AsyncFileReader()
+{
+    stop();
+}
+
+void AsyncFileReader::start(AsyncFileBackend backend, uint32_t threadCount)
+{
+    stop();
+    mbRunning = true;
+#ifdef LEARN_VULKAN_IO_URING
+    if (backend == AsyncFileBackend::IoUring)
+    {
+        std::unique_ptr<IoUring> ring = std::make_unique<IoUring>();
+        if (ring->create(QUEUE_DEPTH))
+        {
+            mRing = std::move(ring);
+            mBackend = AsyncFileBackend::IoUring;
+            mThreads.emplace_back(&AsyncFileReader::runIoUring, this);
+            return;
+        }
+        std::cerr << "io_uring is unavailable, reading files on a thread pool" << std::endl;
+    }
+#endif
+    mBackend = AsyncFileBackend::ThreadPool;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        mThreads.emplace_back(&AsyncFileReader::runThreadPool, this);
+    }
+}
+
+void AsyncFileReader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mbRunning = false;
+    }
+    mRequestAvailable.notify_all();
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+    mThreads.clear();
+    mRing.reset();
+}
+
+void AsyncFileReader::read(std::string path, FileReadCallback callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mbRunning)
+        {
+            mPendingCount++;
+            mRequests.push_back({std::move(path), std::move(callback)});
+            mRequestAvailable.notify_one();
+            return;
+        }
+    }
+    FileReadResult result;
+    result.bSuccess = readWholeFile(path, result.bytes);
+    result.path = std::move(path);
+    callback(result);
+}
+
+void AsyncFileReader::wait()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReadCompleted.wait(lock, [this] { return mPendingCount == 0; });
+}
+
+void AsyncFileReader::complete(FileReadCallback& callback, FileReadResult& result)
+{
+    callback(result);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPendingCount--;
+    if (mPendingCount == 0)
+    {
+        mReadCompleted.notify_all();
+    }
+}
+
+void AsyncFileReader::runThreadPool()
+{
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mRequestAvailable.wait(lock, [this] { return !mRequests.empty() || !mbRunning; });
+            // Stopping still drains the queue
+            if (mRequests.empty())
+            {
+                return;
+            }
+            request = std::move(mRequests.front());
+            mRequests.pop_front();
+        }
+        FileReadResult result;
+        result.bSuccess = readWholeFile(request.path, result.bytes);
+        result.path = std::move(request.path);
+        complete(request.callback, result);
+    }
+}
+
+#ifdef LEARN_VULKAN_IO_URING
+void AsyncFileReader::runIoUring()
+{
+    struct Read
+    {
+        Request request;
+        int fileDescriptor = -1;
+        std::vector<std::byte> bytes;
+        size_t offset = 0;
+        iovec vector {};
+    };
+    std::vector<Read> reads(QUEUE_DEPTH);
+    std::vector<uint32_t> freeSlots;
+    for (uint32_t slot = QUEUE_DEPTH; slot > 0; slot--)
+    {
+        freeSlots.push_back(slot - 1);
+    }
+
+    auto submit = [&](uint32_t slot) {
+        Read& read = reads[slot];
+        read.vector.iov_base = read.bytes.data() + read.offset;
+        read.vector.iov_len = std::min(read.bytes.size() - read.offset, MAX_READ_SIZE);
+        mRing->pushRead(read.fileDescriptor, &read.vector, read.offset, slot);
+    };
+    auto finish = [&](uint32_t slot, bool bSuccess) {
+        Read& read = reads[slot];
+        if (read.fileDescriptor >= 0)
+        {
+            close(read.fileDescriptor);
+        }
+        FileReadResult result;
+        result.path = std::move(read.request.path);
+        result.bytes = std::move(read.bytes);
+        result.bSuccess = bSuccess;
+        FileReadCallback callback = std::move(read.request.callback);
+        read = {};
+        freeSlots.push_back(slot);
+        complete(callback, result);
+    };
+
+    std::vector<Request> batch;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            bool bIdle = freeSlots.size() == QUEUE_DEPTH;
+            if (bIdle)
+            {
+                mRequestAvailable.wait(lock, [this] { return !mRequests.empty() || !mbRunning; });
+                if (mRequests.empty())
+                {
+                    return;
+                }
+            }
+            // Requests arriving while reads are in flight are picked up after the next completion
+            while (!mRequests.empty() && batch.size() < freeSlots.size())
+            {
+                batch.push_back(std::move(mRequests.front()));
+                mRequests.pop_front();
+            }
+        }
+
+        for (Request& request : batch)
+        {
+            uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            Read& read = reads[slot];
+            read.request = std::move(request);
+            read.fileDescriptor = open(read.request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat status;
+            if (read.fileDescriptor < 0 || fstat(read.fileDescriptor, &status) != 0 || !S_ISREG(status.st_mode))
+            {
+                finish(slot, false);
+                continue;
+            }
+            read.bytes.resize(static_cast<size_t>(status.st_size));
+            if (read.bytes.empty())
+            {
+                finish(slot, true);
+                continue;
+            }
+            submit(slot);
+        }
+        batch.clear();
+
+        if (freeSlots.size() == QUEUE_DEPTH)
+        {
+            continue;
+        }
+        if (!mRing->submitAndWait())
+        {
+            // The kernel may still write into the buffers of reads in flight, they cannot be failed and freed
+            std::cerr << "io_uring_enter failed: " << std::strerror(errno) << std::endl;
+            std::abort();
+        }
+        mRing->forEachCompletion([&](uint64_t slot, int32_t result) {
+            Read& read = reads[slot];
+            if (result == -EAGAIN || result == -EINTR)
+            {
+                submit(static_cast<uint32_t>(slot));
+                return;
+            }
+            // Zero bytes before the end means the file was truncated while reading
+            if (result <= 0)
+            {
+                finish(static_cast<uint32_t>(slot), false);
+                return;
+            }
+            read.offset += static_cast<size_t>(result);
+            if (read.offset < read.bytes.size())
+            {
+                submit(static_cast<uint32_t>(slot));
+            }
+            else
+            {
+                finish(static_cast<uint32_t>(slot), true);
+            }
+        });
+    }
+}
+#else
+void AsyncFileReader::runIoUring()
+{}
+#endif
+
+bool AsyncFileReader::readWholeFile(const std::string& path, std::vector<std::byte>& bytes)
+{
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())));
+}
@@ -0,0 +1,338 @@
+#include "FileSystem/DerivedDataCache.hpp"
+#include "FileSystem/MappedFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // "LVDD"
+    const uint32_t ENTRY_MAGIC = 0x4444564C;
+    const uint32_t ENTRY_VERSION = 1;
+    const uint64_t CONTENT_HASH_SEED = 0x9E3779B97F4A7C15ull;
+    // Trimming goes a little below the limit so the next few stores do not trim again
+    const double TRIM_TARGET = 0.9;
+    // Temporary files younger than this may still be renamed into place, older ones are left over from crashes
+    const std::chrono::hours TEMPORARY_FILE_LIFETIME(1);
+
+    struct EntryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t size;
+        uint64_t contentHash;
+        double buildMilliseconds;
+    };
+
+    uint64_t rotateLeft(uint64_t value, int count)
+    {
+        return (value << count) | (value >> (64 - count));
+    }
+
+    // MurmurHash3 finalizer
+    uint64_t finalizeHash(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point time)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - time).count();
+    }
+}  // namespace
+
+DerivedDataKey::DerivedDataKey(std::string_view importer, uint32_t version)
+    : mHashes {0x243F6A8885A308D3ull, 0x13198A2E03707344ull}
+{
+    add(importer);
+    addValue(version);
+}
+
+DerivedDataKey& DerivedDataKey::add(std::span<const std::byte> bytes)
+{
+    // Chained through both seeds, the length keeps "ab" + "c" apart from "a" + "bc"
+    uint64_t length = bytes.size();
+    for (uint64_t& hash : mHashes)
+    {
+        hash = hashBytes(bytes, hashBytes(std::as_bytes(std::span(&length, 1)), hash));
+    }
+    return *this;
+}
+
+DerivedDataKey& DerivedDataKey::add(std::string_view text)
+{
+    return add(std::as_bytes(std::span(text.data(), text.size())));
+}
+
+std::string DerivedDataKey::toString() const
+{
+    char text[33];
+    snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(mHashes[0]), static_cast<unsigned long long>(mHashes[1]));
+    return text;
+}
+
+uint64_t DerivedDataKey::hashBytes(std::span<const std::byte> bytes, uint64_t seed)
+{
+    // Murmur style mixing of 8 bytes at a time
+    const uint64_t MULTIPLIER_0 = 0x87C37B91114253D5ull;
+    const uint64_t MULTIPLIER_1 = 0x4CF5AD432745937Full;
+    uint64_t hash = seed ^ (bytes.size() * MULTIPLIER_0);
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= bytes.size(); offset += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, bytes.data() + offset, sizeof(word));
+        hash ^= rotateLeft(word * MULTIPLIER_0, 31) * MULTIPLIER_1;
+        hash = rotateLeft(hash, 27) * 5 + 0x52DCE729;
+    }
+    uint64_t tail = 0;
+    if (offset < bytes.size())
+    {
+        memcpy(&tail, bytes.data() + offset, bytes.size() - offset);
+    }
+    hash ^= rotateLeft(tail * MULTIPLIER_0, 31) * MULTIPLIER_1;
+    return finalizeHash(hash);
+}
+
+bool DerivedDataCache::initialize(const std::string& directory, uint64_t maxSize)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        std::cerr << "Derived data cache disabled, cannot create " << directory << ": " << error.message() << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDirectory = directory;
+    mMaxSize = maxSize;
+    mTotalSize = 0;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file(error))
+        {
+            mTotalSize += entry.file_size(error);
+        }
+    }
+    if (mTotalSize > mMaxSize)
+    {
+        trim(static_cast<uint64_t>(static_cast<double>(mMaxSize) * TRIM_TARGET));
+    }
+    return true;
+}
+
+bool DerivedDataCache::load(const DerivedDataKey& key, FileView& data)
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+    auto startTime = std::chrono::steady_clock::now();
+    std::string path = getEntryPath(key);
+    FileView entry;
+    if (!mapFile(path, entry))
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStatistics.missCount++;
+        return false;
+    }
+
+    EntryHeader header;
+    bool bValid = entry.getSize() >= sizeof(header);
+    if (bValid)
+    {
+        memcpy(&header, entry.getData(), sizeof(header));
+        std::span<const std::byte> contents = entry.getBytes().subspan(sizeof(header));
+        bValid = header.magic == ENTRY_MAGIC && header.version == ENTRY_VERSION && header.size == contents.size() &&
+                 header.contentHash == DerivedDataKey::hashBytes(contents, CONTENT_HASH_SEED);
+    }
+    if (!bValid)
+    {
+        removeEntry(path);
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStatistics.missCount++;
+        mStatistics.corruptCount++;
+        return false;
+    }
+
+    // The modification time is the recency used by trim
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    data = FileView(std::make_shared<FileView>(entry), entry.getBytes().subspan(sizeof(header)));
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStatistics.hitCount++;
+    mStatistics.bytesRead += entry.getSize();
+    mStatistics.savedMilliseconds += header.buildMilliseconds - millisecondsSince(startTime);
+    return true;
+}
+
+void DerivedDataCache::store(const DerivedDataKey& key, std::span<const std::byte> data, double buildMilliseconds)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    std::string path = getEntryPath(key);
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+    // Unique per process and thread, so concurrent writers of the same entry never share a temporary file
+    static std::atomic<uint32_t> sTemporaryIndex = 0;
+    std::string temporaryPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+                                std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "." + std::to_string(sTemporaryIndex++) + ".tmp";
+    EntryHeader header {ENTRY_MAGIC, ENTRY_VERSION, data.size(), DerivedDataKey::hashBytes(data, CONTENT_HASH_SEED), buildMilliseconds};
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+    uint64_t previousSize = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        previousSize = 0;
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStatistics.storeCount++;
+    mStatistics.bytesWritten += sizeof(header) + data.size();
+    // Replacing an entry another process wrote meanwhile only grows the cache by the difference
+    mTotalSize += sizeof(header) + data.size();
+    mTotalSize -= std::min(previousSize, mTotalSize);
+    if (mTotalSize > mMaxSize)
+    {
+        trim(static_cast<uint64_t>(static_cast<double>(mMaxSize) * TRIM_TARGET));
+    }
+}
+
+DerivedDataStatistics DerivedDataCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStatistics;
+}
+
+void DerivedDataCache::printReport(const char* title) const
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    DerivedDataStatistics statistics = getStatistics();
+    uint32_t lookupCount = statistics.hitCount + statistics.missCount;
+    if (lookupCount == 0 && statistics.storeCount == 0)
+    {
+        return;
+    }
+    double hitRate = lookupCount > 0 ? 100.0 * statistics.hitCount / lookupCount : 0.0;
+    std::cout << title << ": " << statistics.hitCount << " hits, " << statistics.missCount << " misses (" << hitRate << "% hit rate), " << statistics.savedMilliseconds
+              << " ms saved, " << statistics.bytesRead / 1024 << " KiB read, " << statistics.storeCount << " stores (" << statistics.bytesWritten / 1024 << " KiB), "
+              << statistics.corruptCount << " corrupt, " << statistics.evictionCount << " evicted" << std::endl;
+}
+
+std::string DerivedDataCache::getDefaultDirectory()
+{
+    std::filesystem::path root;
+#ifdef _WIN32
+    if (const char* localAppData = std::getenv("LOCALAPPDATA"))
+    {
+        root = localAppData;
+    }
+#else
+    if (const char* cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome)
+    {
+        root = cacheHome;
+    }
+    else if (const char* home = std::getenv("HOME"))
+    {
+        root = std::filesystem::path(home) / ".cache";
+    }
+#endif
+    if (root.empty())
+    {
+        root = std::filesystem::temp_directory_path();
+    }
+    return (root / "LearnVulkan" / "DerivedData").string();
+}
+
+std::string DerivedDataCache::getEntryPath(const DerivedDataKey& key) const
+{
+    // Fanned out by the first two digits to keep directories small
+    std::string name = key.toString();
+    return mDirectory + "/" + name.substr(0, 2) + "/" + name;
+}
+
+void DerivedDataCache::removeEntry(const std::string& path)
+{
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(path, error);
+    if (!error && std::filesystem::remove(path, error))
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTotalSize -= std::min(size, mTotalSize);
+    }
+}
+
+void DerivedDataCache::trim(uint64_t targetSize)
+{
+    struct Entry
+    {
+        std::filesystem::path path;
+        uint64_t size;
+        std::filesystem::file_time_type lastUse;
+    };
+    // Rescanned rather than tracked, other processes share the directory
+    std::vector<Entry> entries;
+    std::error_code error;
+    mTotalSize = 0;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(mDirectory, error))
+    {
+        if (entry.is_regular_file(error))
+        {
+            entries.push_back({entry.path(), entry.file_size(error), entry.last_write_time(error)});
+            mTotalSize += entries.back().size;
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+    const std::filesystem::file_time_type now = std::filesystem::file_time_type::clock::now();
+    for (const Entry& entry : entries)
+    {
+        if (mTotalSize <= targetSize)
+        {
+            break;
+        }
+        if (entry.path.extension() == ".tmp" && now - entry.lastUse < TEMPORARY_FILE_LIFETIME)
+        {
+            continue;
+        }
+        if (std::filesystem::remove(entry.path, error))
+        {
+            mTotalSize -= entry.size;
+            mStatistics.evictionCount++;
+        }
+    }
+}
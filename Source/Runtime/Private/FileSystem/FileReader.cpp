@@ -1,22 +0,0 @@
-#include "FileSystem/FileReader.hpp"
-
-using namespace std;
-
-vector<char> readFile(const string& filename)
-{
-    ifstream file(filename, ios::ate | ios::binary);
-
-    if (!file.is_open())
-    {
-        throw runtime_error("Failed to open file: " + filename);
-    }
-
-    size_t fileSize = static_cast<size_t>(file.tellg());
-    vector<char> buffer(fileSize);
-
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-
-    file.close();
-    return buffer;
-}
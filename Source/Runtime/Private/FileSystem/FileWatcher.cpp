@@ -0,0 +1,158 @@
+#include "FileSystem/FileWatcher.hpp"
+#include <algorithm>
+#include <iostream>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#include <unordered_map>
+#endif
+
+using namespace LearnVulkan;
+
+FileWatcher::~FileWatcher()
+{
+    stop();
+}
+
+void FileWatcher::addDirectory(const std::string& directory)
+{
+    mDirectories.push_back(directory);
+}
+
+bool FileWatcher::start()
+{
+    if (mbRunning)
+    {
+        return true;
+    }
+#ifdef __linux__
+    mInotifyFileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mInotifyFileDescriptor < 0)
+    {
+        std::cerr << "Failed to initialize inotify!" << std::endl;
+        return false;
+    }
+    for (const std::string& directory : mDirectories)
+    {
+        // Editors either rewrite the file in place or write a temporary file and rename it over the original
+        int watchDescriptor = inotify_add_watch(mInotifyFileDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watchDescriptor < 0)
+        {
+            std::cerr << "Failed to watch directory: " << directory << std::endl;
+        }
+        mWatchDescriptors.push_back(watchDescriptor);
+    }
+#endif
+    mbRunning = true;
+    mThread = std::thread(&FileWatcher::run, this);
+    return true;
+}
+
+void FileWatcher::stop()
+{
+    if (!mbRunning)
+    {
+        return;
+    }
+    mbRunning = false;
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+#ifdef __linux__
+    close(mInotifyFileDescriptor);
+    mInotifyFileDescriptor = -1;
+    mWatchDescriptors.clear();
+#endif
+}
+
+void FileWatcher::pollEvents(std::vector<FileChangeEvent>& events)
+{
+    std::lock_guard<std::mutex> lock(mEventMutex);
+    events.insert(events.end(), mPendingEvents.begin(), mPendingEvents.end());
+    mPendingEvents.clear();
+}
+
+void FileWatcher::pushEvent(std::string path)
+{
+    std::lock_guard<std::mutex> lock(mEventMutex);
+    auto existing = std::find_if(mPendingEvents.begin(), mPendingEvents.end(), [&](const FileChangeEvent& event) { return event.path == path; });
+    // Keep the first detection time so latency measurements start at the first write
+    if (existing == mPendingEvents.end())
+    {
+        mPendingEvents.push_back({std::move(path), std::chrono::steady_clock::now()});
+    }
+}
+
+#ifdef __linux__
+void FileWatcher::run()
+{
+    alignas(inotify_event) char buffer[4096];
+    pollfd pollDescriptor {mInotifyFileDescriptor, POLLIN, 0};
+    while (mbRunning)
+    {
+        // Wake up regularly to notice stop()
+        if (poll(&pollDescriptor, 1, 100) <= 0)
+        {
+            continue;
+        }
+        ssize_t length;
+        while ((length = read(mInotifyFileDescriptor, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* pointer = buffer; pointer < buffer + length;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(pointer);
+                pointer += sizeof(inotify_event) + event->len;
+                if (event->len == 0)
+                {
+                    continue;
+                }
+                auto watch = std::find(mWatchDescriptors.begin(), mWatchDescriptors.end(), event->wd);
+                if (watch == mWatchDescriptors.end())
+                {
+                    continue;
+                }
+                const std::string& directory = mDirectories[watch - mWatchDescriptors.begin()];
+                pushEvent(directory + "/" + event->name);
+            }
+        }
+    }
+}
+#else
+void FileWatcher::run()
+{
+    std::unordered_map<std::string, std::filesystem::file_time_type> lastWriteTimes;
+    bool bFirstScan = true;
+    while (mbRunning)
+    {
+        for (const std::string& directory : mDirectories)
+        {
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+            {
+                if (!entry.is_regular_file(error))
+                {
+                    continue;
+                }
+                std::string path = directory + "/" + entry.path().filename().string();
+                std::filesystem::file_time_type writeTime = entry.last_write_time(error);
+                auto [it, bInserted] = lastWriteTimes.try_emplace(path, writeTime);
+                if (!bInserted && it->second != writeTime)
+                {
+                    it->second = writeTime;
+                    pushEvent(path);
+                }
+                else if (bInserted && !bFirstScan)
+                {
+                    pushEvent(path);
+                }
+            }
+        }
+        bFirstScan = false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+}
+#endif
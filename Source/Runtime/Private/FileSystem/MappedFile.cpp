@@ -0,0 +1,241 @@
+#include "FileSystem/MappedFile.hpp"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace LearnVulkan;
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    moveFrom(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+void MappedFile::moveFrom(MappedFile& other)
+{
+    mData = other.mData;
+    mSize = other.mSize;
+    mbOpen = other.mbOpen;
+    mbWritable = other.mbWritable;
+    other.mData = nullptr;
+    other.mSize = 0;
+    other.mbOpen = false;
+    other.mbWritable = false;
+#ifdef _WIN32
+    mFileHandle = other.mFileHandle;
+    mMappingHandle = other.mMappingHandle;
+    other.mFileHandle = nullptr;
+    other.mMappingHandle = nullptr;
+#endif
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& path)
+{
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    mFileHandle = file;
+    mbOpen = true;
+    // Mapping an empty file fails, an open file with an empty view is what callers expect
+    if (size.QuadPart == 0)
+    {
+        return true;
+    }
+
+    mMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mMappingHandle ? MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+        close();
+        return false;
+    }
+    mData = static_cast<const std::byte*>(data);
+    mSize = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+bool MappedFile::create(const std::string& path, size_t size)
+{
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    mFileHandle = file;
+    mbOpen = true;
+    mbWritable = true;
+    if (size == 0)
+    {
+        return true;
+    }
+
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+    {
+        close();
+        return false;
+    }
+    mMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    void* data = mMappingHandle ? MapViewOfFile(mMappingHandle, FILE_MAP_WRITE, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+        close();
+        return false;
+    }
+    mData = static_cast<const std::byte*>(data);
+    mSize = size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData)
+    {
+        UnmapViewOfFile(mData);
+    }
+    if (mMappingHandle)
+    {
+        CloseHandle(mMappingHandle);
+    }
+    if (mFileHandle)
+    {
+        CloseHandle(mFileHandle);
+    }
+    mData = nullptr;
+    mSize = 0;
+    mbOpen = false;
+    mbWritable = false;
+    mFileHandle = nullptr;
+    mMappingHandle = nullptr;
+}
+#else
+bool MappedFile::open(const std::string& path)
+{
+    close();
+    int fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+    struct stat status;
+    if (fstat(fileDescriptor, &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    // The mapping keeps its own reference to the file, the descriptor is not needed past this point
+    size_t size = static_cast<size_t>(status.st_size);
+    void* data = nullptr;
+    if (size > 0)
+    {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fileDescriptor);
+            return false;
+        }
+    }
+    ::close(fileDescriptor);
+
+    mData = static_cast<const std::byte*>(data);
+    mSize = size;
+    mbOpen = true;
+    return true;
+}
+
+bool MappedFile::create(const std::string& path, size_t size)
+{
+    close();
+    int fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+    void* data = nullptr;
+    if (size > 0)
+    {
+        // Extending a truncated file leaves a hole, pages are only backed once they are written
+        if (ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0)
+        {
+            ::close(fileDescriptor);
+            return false;
+        }
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fileDescriptor);
+            return false;
+        }
+    }
+    ::close(fileDescriptor);
+
+    mData = static_cast<const std::byte*>(data);
+    mSize = size;
+    mbOpen = true;
+    mbWritable = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData)
+    {
+        munmap(const_cast<std::byte*>(mData), mSize);
+    }
+    mData = nullptr;
+    mSize = 0;
+    mbOpen = false;
+    mbWritable = false;
+}
+#endif
+
+bool LearnVulkan::evictFromPageCache(const std::string& path)
+{
+#ifdef __linux__
+    int fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+    // Only clean pages are dropped, so freshly written files are flushed first
+    bool bEvicted = fdatasync(fileDescriptor) == 0 && posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fileDescriptor);
+    return bEvicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
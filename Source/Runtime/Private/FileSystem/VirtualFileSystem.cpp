@@ -0,0 +1,86 @@
+#include "FileSystem/VirtualFileSystem.hpp"
+#include "FileSystem/MappedFile.hpp"
+#include <algorithm>
+#include <filesystem>
+
+using namespace LearnVulkan;
+
+bool LearnVulkan::mapFile(const std::string& path, FileView& view)
+{
+    std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>();
+    if (!mapping->open(path))
+    {
+        return false;
+    }
+    std::span<const std::byte> bytes = mapping->getBytes();
+    view = FileView(std::move(mapping), bytes);
+    return true;
+}
+
+DirectoryFileSource::DirectoryFileSource(std::string root)
+    : mRoot(std::move(root))
+{}
+
+bool DirectoryFileSource::contains(const std::string& path) const
+{
+    std::error_code error;
+    return std::filesystem::is_regular_file(getNativePath(path), error);
+}
+
+bool DirectoryFileSource::open(const std::string& path, FileView& view) const
+{
+    return mapFile(getNativePath(path), view);
+}
+
+std::string DirectoryFileSource::getNativePath(const std::string& path) const
+{
+    return mRoot.empty() || mRoot == "." ? path : mRoot + "/" + path;
+}
+
+void VirtualFileSystem::mount(std::shared_ptr<IFileSource> source)
+{
+    mSources.push_back(std::move(source));
+}
+
+bool VirtualFileSystem::exists(const std::string& path) const
+{
+    std::string normalizedPath = normalizePath(path);
+    return std::any_of(mSources.rbegin(), mSources.rend(), [&](const std::shared_ptr<IFileSource>& source) { return source->contains(normalizedPath); });
+}
+
+bool VirtualFileSystem::open(const std::string& path, FileView& view) const
+{
+    std::string normalizedPath = normalizePath(path);
+    for (auto it = mSources.rbegin(); it != mSources.rend(); it++)
+    {
+        if ((*it)->contains(normalizedPath))
+        {
+            return (*it)->open(normalizedPath, view);
+        }
+    }
+    return false;
+}
+
+std::string VirtualFileSystem::getNativePath(const std::string& path) const
+{
+    std::string normalizedPath = normalizePath(path);
+    for (auto it = mSources.rbegin(); it != mSources.rend(); it++)
+    {
+        if ((*it)->contains(normalizedPath))
+        {
+            return (*it)->getNativePath(normalizedPath);
+        }
+    }
+    return {};
+}
+
+std::string VirtualFileSystem::normalizePath(std::string_view path)
+{
+    std::string normalizedPath(path);
+    std::replace(normalizedPath.begin(), normalizedPath.end(), '\\', '/');
+    while (normalizedPath.rfind("./", 0) == 0)
+    {
+        normalizedPath.erase(0, 2);
+    }
+    return normalizedPath;
+}
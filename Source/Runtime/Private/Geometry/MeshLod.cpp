@@ -0,0 +1,548 @@
+#include "Geometry/MeshLod.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // Borders and seams are held in place by planes through their edges. When ordering collapses these count
+    // this much more than the surface planes, the reported error weighs them the same.
+    const double BORDER_WEIGHT = 10.0;
+    // Coarser levels stop here, and once simplification stalls on locked vertices
+    const size_t MIN_LOD_TRIANGLES = 64;
+    const double MIN_LOD_REDUCTION = 0.15;
+
+    enum class VertexKind : uint8_t
+    {
+        // Interior vertex with a single wedge, collapses onto any neighbour
+        Manifold,
+        // On an open edge, collapses along the border only
+        Border,
+        // Two wedges with different attributes, both collapse together along the seam
+        Seam,
+        // Anything else (seam on a border, non-manifold, more than two wedges) stays where it is
+        Locked,
+    };
+
+    struct Quadric
+    {
+        double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+        double c = 0.0;
+        // Area the planes came from
+        double weight = 0.0;
+
+        // Squared distance to the plane dot(normal, p) + distance = 0 over an area, normal has unit length
+        void addPlane(const glm::dvec3& normal, double distance, double planeWeight)
+        {
+            a00 += planeWeight * normal.x * normal.x;
+            a11 += planeWeight * normal.y * normal.y;
+            a22 += planeWeight * normal.z * normal.z;
+            a01 += planeWeight * normal.x * normal.y;
+            a02 += planeWeight * normal.x * normal.z;
+            a12 += planeWeight * normal.y * normal.z;
+            b0 += planeWeight * normal.x * distance;
+            b1 += planeWeight * normal.y * distance;
+            b2 += planeWeight * normal.z * distance;
+            c += planeWeight * distance * distance;
+            weight += planeWeight;
+        }
+
+        void add(const Quadric& other)
+        {
+            a00 += other.a00;
+            a11 += other.a11;
+            a22 += other.a22;
+            a01 += other.a01;
+            a02 += other.a02;
+            a12 += other.a12;
+            b0 += other.b0;
+            b1 += other.b1;
+            b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+        }
+
+        // Area weighted sum of squared distances of p to the accumulated planes
+        double evaluate(const glm::dvec3& p) const
+        {
+            double error = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+                         + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+            return std::max(error, 0.0);
+        }
+    };
+
+    // Planes of the triangles around a position, and the border and seam edge constraints kept apart so they can be weighted
+    struct PositionQuadrics
+    {
+        Quadric surface;
+        Quadric boundary;
+
+        void add(const PositionQuadrics& other)
+        {
+            surface.add(other.surface);
+            boundary.add(other.boundary);
+        }
+
+        // Mean squared distance of p to all planes
+        double getError(const glm::dvec3& p) const
+        {
+            double weight = surface.weight + boundary.weight;
+            return weight > 0.0 ? (surface.evaluate(p) + boundary.evaluate(p)) / weight : 0.0;
+        }
+
+        double getCost(const glm::dvec3& p) const
+        {
+            double weight = surface.weight + boundary.weight;
+            return weight > 0.0 ? (surface.evaluate(p) + BORDER_WEIGHT * boundary.evaluate(p)) / weight : 0.0;
+        }
+    };
+
+    // Plane containing the edge and perpendicular to the triangle, keeps the edge from sliding sideways
+    void addEdgeConstraint(Quadric& quadric0, Quadric& quadric1, const glm::dvec3& p0, const glm::dvec3& p1, const glm::dvec3& triangleNormal, double area)
+    {
+        glm::dvec3 normal = glm::cross(p1 - p0, triangleNormal);
+        double length = glm::length(normal);
+        if (length == 0.0)
+        {
+            return;
+        }
+        normal /= length;
+        quadric0.addPlane(normal, -glm::dot(normal, p0), area);
+        quadric1.addPlane(normal, -glm::dot(normal, p0), area);
+    }
+
+    class Simplifier
+    {
+    public:
+        Simplifier(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+            : mVertices(vertices)
+            , mIndices(indices)
+        {
+            buildWedges();
+            buildPositionTriangles();
+            classifyVertices();
+            buildQuadrics();
+        }
+
+        std::vector<uint32_t> simplify(size_t targetIndexCount, float& error)
+        {
+            double maxError = 0.0;
+            std::vector<uint32_t> remap(mVertices.size());
+            std::vector<uint8_t> locked(mVertices.size());
+            while (mIndices.size() > targetIndexCount)
+            {
+                buildPositionTriangles();
+
+                std::vector<Collapse> collapses = findCollapses();
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+                // An interior collapse removes two triangles, the rest of the pass works on an outdated mesh,
+                // so every collapse locks the neighbourhood it changes
+                size_t collapseLimit = (mIndices.size() - targetIndexCount) / 6 + 1;
+                std::iota(remap.begin(), remap.end(), 0);
+                std::fill(locked.begin(), locked.end(), 0);
+                size_t collapseCount = 0;
+                for (const Collapse& collapse : collapses)
+                {
+                    if (collapseCount == collapseLimit)
+                    {
+                        break;
+                    }
+                    uint32_t from = collapse.from;
+                    uint32_t to = mPositionIds[collapse.target];
+                    if (locked[from] || locked[to] || flipsTriangle(from, to))
+                    {
+                        continue;
+                    }
+
+                    if (mKinds[from] == VertexKind::Seam)
+                    {
+                        uint32_t targets[2];
+                        matchSeamWedges(from, to, targets);
+                        remap[from] = targets[0];
+                        remap[mNextWedge[from]] = targets[1];
+                    }
+                    else
+                    {
+                        remap[from] = collapse.target;
+                    }
+                    mQuadrics[to].add(mQuadrics[from]);
+                    maxError = std::max(maxError, collapse.error);
+
+                    locked[to] = 1;
+                    for (uint32_t triangle = mTriangleOffsets[from]; triangle < mTriangleOffsets[from + 1]; triangle++)
+                    {
+                        for (uint32_t corner = 0; corner < 3; corner++)
+                        {
+                            locked[mPositionIds[mIndices[mTriangles[triangle] * 3 + corner]]] = 1;
+                        }
+                    }
+                    collapseCount++;
+                }
+                if (collapseCount == 0)
+                {
+                    break;
+                }
+
+                // Triangles that had both ends of a collapsed edge are gone
+                size_t writeIndex = 0;
+                for (size_t i = 0; i < mIndices.size(); i += 3)
+                {
+                    uint32_t a = remap[mIndices[i]];
+                    uint32_t b = remap[mIndices[i + 1]];
+                    uint32_t c = remap[mIndices[i + 2]];
+                    if (mPositionIds[a] == mPositionIds[b] || mPositionIds[b] == mPositionIds[c] || mPositionIds[c] == mPositionIds[a])
+                    {
+                        continue;
+                    }
+                    mIndices[writeIndex++] = a;
+                    mIndices[writeIndex++] = b;
+                    mIndices[writeIndex++] = c;
+                }
+                mIndices.resize(writeIndex);
+            }
+            error = static_cast<float>(std::sqrt(maxError));
+            return std::move(mIndices);
+        }
+
+    private:
+        struct Collapse
+        {
+            // Position moved away, and the vertex it lands on
+            uint32_t from;
+            uint32_t target;
+            double cost;
+            double error;
+        };
+
+        const std::vector<Vertex>& mVertices;
+        std::vector<uint32_t> mIndices;
+        // Every position is represented by the first vertex found there, wedges of a position are linked in a cycle
+        std::vector<uint32_t> mPositionIds;
+        std::vector<uint32_t> mNextWedge;
+        std::vector<uint32_t> mWedgeCounts;
+        std::vector<VertexKind> mKinds;
+        std::vector<PositionQuadrics> mQuadrics;
+        // Triangles around every position, rebuilt every pass, all edge queries walk these
+        std::vector<uint32_t> mTriangleOffsets;
+        std::vector<uint32_t> mTriangles;
+
+        glm::dvec3 getPosition(uint32_t vertex) const { return glm::dvec3(mVertices[vertex].pos); }
+
+        // Triangles with the directed edge a -> b between positions
+        uint32_t countPositionEdges(uint32_t a, uint32_t b) const
+        {
+            uint32_t count = 0;
+            for (uint32_t triangle = mTriangleOffsets[a]; triangle < mTriangleOffsets[a + 1]; triangle++)
+            {
+                const uint32_t* corners = &mIndices[mTriangles[triangle] * 3];
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    count += mPositionIds[corners[corner]] == a && mPositionIds[corners[(corner + 1) % 3]] == b ? 1 : 0;
+                }
+            }
+            return count;
+        }
+
+        bool hasPositionEdge(uint32_t a, uint32_t b) const { return countPositionEdges(a, b) != 0; }
+
+        // Directed edge between two wedges
+        bool hasVertexEdge(uint32_t a, uint32_t b) const
+        {
+            uint32_t position = mPositionIds[a];
+            for (uint32_t triangle = mTriangleOffsets[position]; triangle < mTriangleOffsets[position + 1]; triangle++)
+            {
+                const uint32_t* corners = &mIndices[mTriangles[triangle] * 3];
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    if (corners[corner] == a && corners[(corner + 1) % 3] == b)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        bool isBorderEdge(uint32_t a, uint32_t b) const { return hasPositionEdge(a, b) != hasPositionEdge(b, a); }
+
+        // Unreferenced vertices are left out so they never stand in for a wedge
+        void buildWedges()
+        {
+            size_t vertexCount = mVertices.size();
+            std::vector<uint8_t> referenced(vertexCount);
+            for (uint32_t index : mIndices)
+            {
+                referenced[index] = 1;
+            }
+
+            mPositionIds.resize(vertexCount);
+            mNextWedge.resize(vertexCount);
+            mWedgeCounts.assign(vertexCount, 0);
+            std::unordered_map<glm::vec3, uint32_t> firstVertices;
+            firstVertices.reserve(vertexCount);
+            for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+            {
+                mNextWedge[vertex] = vertex;
+                if (!referenced[vertex])
+                {
+                    mPositionIds[vertex] = vertex;
+                    continue;
+                }
+                auto [it, bInserted] = firstVertices.try_emplace(mVertices[vertex].pos, vertex);
+                uint32_t position = it->second;
+                mPositionIds[vertex] = position;
+                if (!bInserted)
+                {
+                    mNextWedge[vertex] = mNextWedge[position];
+                    mNextWedge[position] = vertex;
+                }
+                mWedgeCounts[position]++;
+            }
+        }
+
+        void classifyVertices()
+        {
+            mKinds.assign(mVertices.size(), VertexKind::Manifold);
+            std::vector<uint8_t> bBorder(mVertices.size());
+            for (size_t i = 0; i < mIndices.size(); i++)
+            {
+                uint32_t a = mPositionIds[mIndices[i]];
+                uint32_t b = mPositionIds[mIndices[i - i % 3 + (i + 1) % 3]];
+                if (countPositionEdges(a, b) > 1)
+                {
+                    // Edge shared by more than two triangles
+                    mKinds[a] = VertexKind::Locked;
+                    mKinds[b] = VertexKind::Locked;
+                }
+                else if (!hasPositionEdge(b, a))
+                {
+                    bBorder[a] = 1;
+                    bBorder[b] = 1;
+                }
+            }
+            for (uint32_t position = 0; position < mVertices.size(); position++)
+            {
+                if (mPositionIds[position] != position || mKinds[position] == VertexKind::Locked)
+                {
+                    continue;
+                }
+                if (mWedgeCounts[position] > 2 || (mWedgeCounts[position] == 2 && bBorder[position]))
+                {
+                    mKinds[position] = VertexKind::Locked;
+                }
+                else if (mWedgeCounts[position] == 2)
+                {
+                    mKinds[position] = VertexKind::Seam;
+                }
+                else if (bBorder[position])
+                {
+                    mKinds[position] = VertexKind::Border;
+                }
+            }
+        }
+
+        void buildQuadrics()
+        {
+            mQuadrics.assign(mVertices.size(), PositionQuadrics {});
+            for (size_t i = 0; i < mIndices.size(); i += 3)
+            {
+                uint32_t vertices[3] = {mIndices[i], mIndices[i + 1], mIndices[i + 2]};
+                glm::dvec3 p[3] = {getPosition(vertices[0]), getPosition(vertices[1]), getPosition(vertices[2])};
+                glm::dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+                double doubleArea = glm::length(normal);
+                if (doubleArea == 0.0)
+                {
+                    continue;
+                }
+                normal /= doubleArea;
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    mQuadrics[mPositionIds[vertices[corner]]].surface.addPlane(normal, -glm::dot(normal, p[0]), doubleArea * 0.5);
+                }
+
+                // Open edges, and seam edges whose other side uses different wedges
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    uint32_t a = vertices[corner];
+                    uint32_t b = vertices[(corner + 1) % 3];
+                    bool bBorder = !hasPositionEdge(mPositionIds[b], mPositionIds[a]);
+                    bool bSeam = !bBorder && !hasVertexEdge(b, a);
+                    if (bBorder || bSeam)
+                    {
+                        addEdgeConstraint(mQuadrics[mPositionIds[a]].boundary, mQuadrics[mPositionIds[b]].boundary, p[corner], p[(corner + 1) % 3], normal, doubleArea * 0.5);
+                    }
+                }
+            }
+        }
+
+        void buildPositionTriangles()
+        {
+            mTriangleOffsets.assign(mVertices.size() + 1, 0);
+            for (uint32_t index : mIndices)
+            {
+                mTriangleOffsets[mPositionIds[index] + 1]++;
+            }
+            std::partial_sum(mTriangleOffsets.begin(), mTriangleOffsets.end(), mTriangleOffsets.begin());
+            mTriangles.resize(mIndices.size());
+            std::vector<uint32_t> cursors(mTriangleOffsets.begin(), mTriangleOffsets.end() - 1);
+            for (size_t i = 0; i < mIndices.size(); i++)
+            {
+                mTriangles[cursors[mPositionIds[mIndices[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // Each wedge of a seam vertex has to land on the wedge of the target on its own side of the seam
+        bool matchSeamWedges(uint32_t from, uint32_t to, uint32_t targets[2]) const
+        {
+            uint32_t wedges[2] = {from, mNextWedge[from]};
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                targets[i] = UINT32_MAX;
+                uint32_t target = to;
+                do
+                {
+                    if (hasVertexEdge(wedges[i], target) || hasVertexEdge(target, wedges[i]))
+                    {
+                        targets[i] = target;
+                        break;
+                    }
+                    target = mNextWedge[target];
+                } while (target != to);
+            }
+            return targets[0] != UINT32_MAX && targets[1] != UINT32_MAX && targets[0] != targets[1];
+        }
+
+        bool canCollapse(uint32_t fromVertex, uint32_t toVertex) const
+        {
+            uint32_t from = mPositionIds[fromVertex];
+            uint32_t to = mPositionIds[toVertex];
+            switch (mKinds[from])
+            {
+                case VertexKind::Manifold: return true;
+                case VertexKind::Border: return (mKinds[to] == VertexKind::Border || mKinds[to] == VertexKind::Locked) && isBorderEdge(from, to);
+                case VertexKind::Seam:
+                {
+                    uint32_t targets[2];
+                    return (mKinds[to] == VertexKind::Seam || mKinds[to] == VertexKind::Locked) && matchSeamWedges(from, to, targets);
+                }
+                default: return false;
+            }
+        }
+
+        // Cheapest allowed collapse of every position
+        std::vector<Collapse> findCollapses() const
+        {
+            std::vector<Collapse> best(mVertices.size(), {0, 0, std::numeric_limits<double>::infinity(), 0.0});
+            for (size_t i = 0; i < mIndices.size(); i++)
+            {
+                uint32_t a = mIndices[i];
+                uint32_t b = mIndices[i - i % 3 + (i + 1) % 3];
+                // Both directions of every edge are candidates
+                for (uint32_t direction = 0; direction < 2; direction++, std::swap(a, b))
+                {
+                    uint32_t from = mPositionIds[a];
+                    if (from == mPositionIds[b])
+                    {
+                        continue;
+                    }
+                    glm::dvec3 target = getPosition(b);
+                    double cost = mQuadrics[from].getCost(target);
+                    if (cost < best[from].cost && canCollapse(a, b))
+                    {
+                        best[from] = {from, b, cost, mQuadrics[from].getError(target)};
+                    }
+                }
+            }
+            std::vector<Collapse> collapses;
+            for (const Collapse& collapse : best)
+            {
+                if (collapse.cost != std::numeric_limits<double>::infinity())
+                {
+                    collapses.push_back(collapse);
+                }
+            }
+            return collapses;
+        }
+
+        // Moving from onto to must not turn any remaining triangle around
+        bool flipsTriangle(uint32_t from, uint32_t to) const
+        {
+            glm::dvec3 target = getPosition(to);
+            for (uint32_t triangle = mTriangleOffsets[from]; triangle < mTriangleOffsets[from + 1]; triangle++)
+            {
+                const uint32_t* corners = &mIndices[mTriangles[triangle] * 3];
+                glm::dvec3 p[3];
+                glm::dvec3 moved[3];
+                bool bCollapses = false;
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    uint32_t position = mPositionIds[corners[corner]];
+                    bCollapses |= position == to;
+                    p[corner] = getPosition(corners[corner]);
+                    moved[corner] = position == from ? target : p[corner];
+                }
+                if (bCollapses)
+                {
+                    continue;
+                }
+                glm::dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::dvec3 movedNormal = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+                if (glm::dot(normal, movedNormal) <= 0.0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+}  // namespace
+
+std::vector<uint32_t> LearnVulkan::simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float& error)
+{
+    Simplifier simplifier(vertices, indices);
+    return simplifier.simplify(targetIndexCount, error);
+}
+
+std::vector<MeshLod> LearnVulkan::buildMeshLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, uint32_t maxLodCount)
+{
+    std::vector<MeshLod> lods {{0, static_cast<uint32_t>(indices.size()), 0.0f}};
+    std::vector<uint32_t> lodIndices = indices;
+    while (lods.size() < maxLodCount && lodIndices.size() / 3 >= 2 * MIN_LOD_TRIANGLES)
+    {
+        // Every level simplifies the previous one, so its error adds to theirs
+        float error = 0.0f;
+        std::vector<uint32_t> simplified = simplifyMesh(vertices, lodIndices, lodIndices.size() / 6 * 3, error);
+        if (simplified.size() > lodIndices.size() * (1.0 - MIN_LOD_REDUCTION))
+        {
+            break;
+        }
+        lods.push_back({static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(simplified.size()), lods.back().error + error});
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        lodIndices = std::move(simplified);
+    }
+    return lods;
+}
+
+uint32_t LearnVulkan::selectMeshLod(const std::vector<MeshLod>& lods, float viewDepth, float pixelsPerUnit, float pixelError, float hysteresis, uint32_t currentLod)
+{
+    const float MIN_DEPTH = 1e-3f;
+    float pixelsPerModelUnit = pixelsPerUnit / std::max(viewDepth, MIN_DEPTH);
+    auto fits = [&](uint32_t lod, float limit) { return lods[lod].error * pixelsPerModelUnit <= limit; };
+
+    uint32_t lod = std::min<uint32_t>(currentLod, static_cast<uint32_t>(lods.size()) - 1);
+    while (lod + 1 < lods.size() && fits(lod + 1, pixelError * (1.0f - hysteresis)))
+    {
+        lod++;
+    }
+    while (lod > 0 && !fits(lod, pixelError * (1.0f + hysteresis)))
+    {
+        lod--;
+    }
+    return lod;
+}
@@ -0,0 +1,295 @@
+#include "Geometry/Meshlet.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    const uint32_t NO_LOCAL_INDEX = UINT32_MAX;
+    // How strongly growth prefers triangles whose vertices have few triangles left to place over the closest ones.
+    // Finishing vertices keeps small islands from being stranded between meshlets, distance keeps meshlets round.
+    const float LIVE_TRIANGLE_WEIGHT = 0.25f;
+
+    glm::vec3 getTriangleCentroid(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t triangle)
+    {
+        return (vertices[indices[triangle * 3]].pos + vertices[indices[triangle * 3 + 1]].pos + vertices[indices[triangle * 3 + 2]].pos) * (1.0f / 3.0f);
+    }
+
+    // Ritter's sphere, within a few percent of the minimal one for the point counts of a meshlet
+    void computeBoundingSphere(const std::vector<glm::vec3>& points, glm::vec3& center, float& radius)
+    {
+        auto farthestFrom = [&points](const glm::vec3& origin) {
+            size_t farthest = 0;
+            float farthestDistance = -1.0f;
+            for (size_t i = 0; i < points.size(); i++)
+            {
+                glm::vec3 offset = points[i] - origin;
+                float distance = glm::dot(offset, offset);
+                if (distance > farthestDistance)
+                {
+                    farthest = i;
+                    farthestDistance = distance;
+                }
+            }
+            return points[farthest];
+        };
+        glm::vec3 a = farthestFrom(points[0]);
+        glm::vec3 b = farthestFrom(a);
+        center = (a + b) * 0.5f;
+        radius = glm::length(b - a) * 0.5f;
+        for (const glm::vec3& point : points)
+        {
+            float distance = glm::length(point - center);
+            if (distance > radius)
+            {
+                // Grow just enough to take the point in, moving the center towards it
+                float newRadius = (radius + distance) * 0.5f;
+                center = center + (point - center) * ((newRadius - radius) / distance);
+                radius = newRadius;
+            }
+        }
+    }
+
+    MeshletBounds computeMeshletBounds(const std::vector<Vertex>& vertices, const MeshletMesh& mesh, const Meshlet& meshlet)
+    {
+        MeshletBounds bounds {};
+        std::vector<glm::vec3> points(meshlet.vertexCount);
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+        {
+            points[i] = vertices[mesh.vertices[meshlet.vertexOffset + i]].pos;
+        }
+        computeBoundingSphere(points, bounds.center, bounds.radius);
+
+        std::vector<glm::vec3> normals;
+        glm::vec3 normalSum(0.0f);
+        for (uint32_t triangle = 0; triangle < meshlet.triangleCount; triangle++)
+        {
+            const uint8_t* corners = &mesh.triangles[(meshlet.triangleOffset + triangle) * 3];
+            glm::vec3 normal = glm::cross(points[corners[1]] - points[corners[0]], points[corners[2]] - points[corners[0]]);
+            float length = glm::length(normal);
+            // Degenerate triangles are never rasterized and do not constrain the cone
+            if (length > 0.0f)
+            {
+                normals.push_back(normal / length);
+                normalSum += normals.back();
+            }
+        }
+
+        bounds.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        bounds.coneCutoff = 1.0f;
+        float axisLength = glm::length(normalSum);
+        if (normals.empty() || axisLength < 1e-6f)
+        {
+            return bounds;
+        }
+        bounds.coneAxis = normalSum / axisLength;
+        float minDot = 1.0f;
+        for (const glm::vec3& normal : normals)
+        {
+            minDot = std::min(minDot, glm::dot(normal, bounds.coneAxis));
+        }
+        // Normals spreading over a hemisphere or more face the camera from anywhere
+        if (minDot > 0.0f)
+        {
+            bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+        return bounds;
+    }
+}  // namespace
+
+MeshletMesh LearnVulkan::buildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t maxVertices, uint32_t maxTriangles)
+{
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+
+    // Triangles around every vertex, and how many of them are still waiting for a meshlet
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    for (uint32_t index : indices)
+    {
+        triangleOffsets[index + 1]++;
+    }
+    std::vector<uint32_t> liveTriangleCounts(vertexCount);
+    for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        liveTriangleCounts[vertex] = triangleOffsets[vertex + 1];
+        triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+    }
+    std::vector<uint32_t> vertexTriangles(indices.size());
+    std::vector<uint32_t> cursors(triangleOffsets.begin(), triangleOffsets.end() - 1);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(indices.size()); i++)
+    {
+        vertexTriangles[cursors[indices[i]]++] = i / 3;
+    }
+
+    MeshletMesh mesh;
+    std::vector<uint8_t> bEmitted(triangleCount, 0);
+    std::vector<uint32_t> localIndices(vertexCount, NO_LOCAL_INDEX);
+    Meshlet meshlet {};
+    glm::vec3 centroidSum(0.0f);
+    uint32_t seedCursor = 0;
+    // Vertices of the previous meshlet, the next one starts next to it
+    uint32_t seedVertexOffset = 0;
+    uint32_t seedVertexCount = 0;
+
+    // Triangles still to place around the corners of a triangle
+    auto getLiveScore = [&](uint32_t triangle) {
+        uint32_t score = 0;
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            score += liveTriangleCounts[indices[triangle * 3 + corner]];
+        }
+        return score;
+    };
+
+    // Best unemitted triangle around the vertices of the current meshlet that still fits
+    auto findAdjacentTriangle = [&]() {
+        uint32_t best = UINT32_MAX;
+        uint32_t bestNewVertices = UINT32_MAX;
+        float bestScore = std::numeric_limits<float>::max();
+        glm::vec3 centroid = centroidSum / static_cast<float>(meshlet.triangleCount);
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+        {
+            uint32_t vertex = mesh.vertices[meshlet.vertexOffset + i];
+            for (uint32_t adjacent = triangleOffsets[vertex]; adjacent < triangleOffsets[vertex + 1]; adjacent++)
+            {
+                uint32_t triangle = vertexTriangles[adjacent];
+                if (bEmitted[triangle])
+                {
+                    continue;
+                }
+                uint32_t newVertices = 0;
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    newVertices += localIndices[indices[triangle * 3 + corner]] == NO_LOCAL_INDEX ? 1 : 0;
+                }
+                if (meshlet.vertexCount + newVertices > maxVertices || newVertices > bestNewVertices)
+                {
+                    continue;
+                }
+                // Fewest new vertices first, then close to the centroid and finishing vertices off
+                glm::vec3 offset = getTriangleCentroid(vertices, indices, triangle) - centroid;
+                float score = glm::dot(offset, offset) * (1.0f + LIVE_TRIANGLE_WEIGHT * getLiveScore(triangle));
+                if (newVertices < bestNewVertices || score < bestScore)
+                {
+                    best = triangle;
+                    bestNewVertices = newVertices;
+                    bestScore = score;
+                }
+            }
+        }
+        return best;
+    };
+
+    auto findSeedTriangle = [&]() {
+        uint32_t best = UINT32_MAX;
+        uint32_t bestLiveScore = UINT32_MAX;
+        for (uint32_t i = 0; i < seedVertexCount; i++)
+        {
+            uint32_t vertex = mesh.vertices[seedVertexOffset + i];
+            for (uint32_t adjacent = triangleOffsets[vertex]; adjacent < triangleOffsets[vertex + 1]; adjacent++)
+            {
+                uint32_t triangle = vertexTriangles[adjacent];
+                uint32_t liveScore = bEmitted[triangle] ? UINT32_MAX : getLiveScore(triangle);
+                if (liveScore < bestLiveScore)
+                {
+                    best = triangle;
+                    bestLiveScore = liveScore;
+                }
+            }
+        }
+        if (best != UINT32_MAX)
+        {
+            return best;
+        }
+        // Nothing left around the previous meshlet, continue in index order
+        while (bEmitted[seedCursor])
+        {
+            seedCursor++;
+        }
+        return seedCursor;
+    };
+
+    auto flushMeshlet = [&]() {
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+        {
+            localIndices[mesh.vertices[meshlet.vertexOffset + i]] = NO_LOCAL_INDEX;
+        }
+        mesh.meshlets.push_back(meshlet);
+        mesh.bounds.push_back(computeMeshletBounds(vertices, mesh, meshlet));
+        seedVertexOffset = meshlet.vertexOffset;
+        seedVertexCount = meshlet.vertexCount;
+        meshlet.vertexOffset += meshlet.vertexCount;
+        meshlet.triangleOffset += meshlet.triangleCount;
+        meshlet.vertexCount = 0;
+        meshlet.triangleCount = 0;
+        centroidSum = glm::vec3(0.0f);
+    };
+
+    for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        uint32_t triangle = meshlet.triangleCount > 0 ? findAdjacentTriangle() : UINT32_MAX;
+        if (triangle == UINT32_MAX)
+        {
+            // Nothing adjacent fits
+            if (meshlet.triangleCount > 0)
+            {
+                flushMeshlet();
+            }
+            triangle = findSeedTriangle();
+        }
+
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            uint32_t vertex = indices[triangle * 3 + corner];
+            if (localIndices[vertex] == NO_LOCAL_INDEX)
+            {
+                localIndices[vertex] = meshlet.vertexCount++;
+                mesh.vertices.push_back(vertex);
+            }
+            mesh.triangles.push_back(static_cast<uint8_t>(localIndices[vertex]));
+            liveTriangleCounts[vertex]--;
+        }
+        meshlet.triangleCount++;
+        centroidSum += getTriangleCentroid(vertices, indices, triangle);
+        bEmitted[triangle] = 1;
+
+        if (meshlet.triangleCount == maxTriangles)
+        {
+            flushMeshlet();
+        }
+    }
+    if (meshlet.triangleCount > 0)
+    {
+        flushMeshlet();
+    }
+    return mesh;
+}
+
+std::vector<uint32_t> LearnVulkan::unpackMeshletIndices(const MeshletMesh& mesh)
+{
+    std::vector<uint32_t> indices(mesh.triangles.size());
+    for (const Meshlet& meshlet : mesh.meshlets)
+    {
+        for (uint32_t i = meshlet.triangleOffset * 3; i < (meshlet.triangleOffset + meshlet.triangleCount) * 3; i++)
+        {
+            indices[i] = mesh.vertices[meshlet.vertexOffset + mesh.triangles[i]];
+        }
+    }
+    return indices;
+}
+
+// A triangle faces away when the camera is behind its plane. With every normal within the cone half angle a of
+// the axis, all of them face away from any point p for which p - camera is within 90 - a degrees of the axis,
+// that is dot(p - camera, axis) >= sin(a) * |p - camera|. Over the bounding sphere, dot(p - camera, axis) is at least
+// dot(center - camera, axis) - radius and |p - camera| at most |center - camera| + radius.
+bool LearnVulkan::isMeshletBackfacing(const MeshletBounds& bounds, const glm::vec3& cameraPosition)
+{
+    if (bounds.coneCutoff >= 1.0f)
+    {
+        return false;
+    }
+    glm::vec3 offset = bounds.center - cameraPosition;
+    return glm::dot(offset, bounds.coneAxis) - bounds.radius >= bounds.coneCutoff * (glm::length(offset) + bounds.radius);
+}
@@ -0,0 +1,190 @@
+#include "Memory/AllocationCounter.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+using namespace LearnVulkan;
+
+#ifdef LEARN_VULKAN_COUNT_ALLOCATIONS
+namespace
+{
+    // Trivially constructible, so counting works in allocations made before thread_local initializers run
+    thread_local uint64_t threadAllocationCount = 0;
+
+    void* allocate(size_t size)
+    {
+        threadAllocationCount++;
+        // malloc(0) may return nullptr, operator new has to return a unique pointer
+        if (void* memory = std::malloc(size > 0 ? size : 1))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(size_t size, std::align_val_t alignment)
+    {
+        threadAllocationCount++;
+        size_t alignmentBytes = static_cast<size_t>(alignment);
+        // aligned_alloc wants a multiple of the alignment
+        size = (std::max<size_t>(size, 1) + alignmentBytes - 1) & ~(alignmentBytes - 1);
+#ifdef _WIN32
+        void* memory = _aligned_malloc(size, alignmentBytes);
+#else
+        void* memory = std::aligned_alloc(alignmentBytes, size);
+#endif
+        if (memory)
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void deallocateAligned(void* memory)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}  // namespace
+
+bool LearnVulkan::isAllocationCountingEnabled()
+{
+    return true;
+}
+
+uint64_t LearnVulkan::getThreadAllocationCount()
+{
+    return threadAllocationCount;
+}
+
+void* operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return allocate(size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return allocateAligned(size, alignment);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    deallocateAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    deallocateAligned(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    deallocateAligned(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+    deallocateAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    deallocateAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    deallocateAligned(memory);
+}
+#else
+bool LearnVulkan::isAllocationCountingEnabled()
+{
+    return false;
+}
+
+uint64_t LearnVulkan::getThreadAllocationCount()
+{
+    return 0;
+}
+#endif
@@ -0,0 +1,57 @@
+#include "Memory/LinearAllocator.hpp"
+#include <algorithm>
+#include <cstdint>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // Growth after an overflow rounds up to this, so a peak creeping up by a few bytes does not reallocate every frame
+    const size_t GROWTH_GRANULARITY = 64 * 1024;
+
+    size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}  // namespace
+
+LinearAllocator::LinearAllocator(size_t capacity)
+    : mBlock(capacity > 0 ? std::make_unique_for_overwrite<std::byte[]>(capacity) : nullptr)
+    , mCapacity(capacity)
+{}
+
+void* LinearAllocator::allocate(size_t size, size_t alignment)
+{
+    if (size == 0)
+    {
+        return nullptr;
+    }
+    // Aligned by address, the block itself is only aligned for max_align_t
+    uintptr_t base = reinterpret_cast<uintptr_t>(mBlock.get());
+    size_t offset = mBlock ? alignUp(base + mOffset, alignment) - base : 0;
+    if (mBlock && offset + size <= mCapacity)
+    {
+        mOffset = offset + size;
+        mPeak = std::max(mPeak, getUsed());
+        return mBlock.get() + offset;
+    }
+
+    mOverflowBlocks.push_back(std::make_unique_for_overwrite<std::byte[]>(size + alignment - 1));
+    mOverflowSize += size + alignment - 1;
+    mOverflowCount++;
+    mPeak = std::max(mPeak, getUsed());
+    uintptr_t overflowBase = reinterpret_cast<uintptr_t>(mOverflowBlocks.back().get());
+    return reinterpret_cast<void*>(alignUp(overflowBase, alignment));
+}
+
+void LinearAllocator::reset()
+{
+    if (!mOverflowBlocks.empty())
+    {
+        mOverflowBlocks.clear();
+        mCapacity = alignUp(std::max(mPeak, mCapacity * 2), GROWTH_GRANULARITY);
+        mBlock = std::make_unique_for_overwrite<std::byte[]>(mCapacity);
+    }
+    mOffset = 0;
+    mOverflowSize = 0;
+}
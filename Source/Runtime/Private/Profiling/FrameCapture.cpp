@@ -0,0 +1,255 @@
+#include "Profiling/FrameCapture.hpp"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // "LVFC", fields are little endian like every platform the renderer runs on
+    const uint32_t CAPTURE_MAGIC = 0x4346564C;
+    const uint32_t CAPTURE_VERSION = 1;
+    // "FRAM" starts a frame, "WRAP" tells the reader the next frame is at the start of the ring
+    const uint32_t FRAME_MAGIC = 0x4D415246;
+    const uint32_t WRAP_MAGIC = 0x50415257;
+    // Keeps every frame, and the draws and matrices in it, aligned in the mapping
+    const uint64_t FRAME_ALIGNMENT = 16;
+    const uint64_t MIN_CAPACITY = 64 * 1024;
+
+    // At the start of the file, the ring follows. Only complete frames are ever between begin and end.
+    struct CaptureHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+        uint64_t begin;
+        uint64_t end;
+        uint64_t frameCount;
+        uint64_t writtenCount;
+        uint64_t reserved[2];
+    };
+
+    struct FrameHeader
+    {
+        uint32_t magic;
+        uint32_t size;
+        uint64_t reserved;
+    };
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint64_t getFrameSize(uint64_t drawCount)
+    {
+        return alignUp(sizeof(FrameHeader) + sizeof(FrameCaptureRecord) + drawCount * sizeof(FrameCaptureDraw), FRAME_ALIGNMENT);
+    }
+
+    CaptureHeader& getHeader(std::byte* ring)
+    {
+        return *reinterpret_cast<CaptureHeader*>(ring - sizeof(CaptureHeader));
+    }
+
+    // Past the last frame that fits before the end of the ring, either there is no room for a header or a marker
+    bool isWrapped(const std::byte* ring, uint64_t capacity, uint64_t offset)
+    {
+        if (offset + sizeof(FrameHeader) > capacity)
+        {
+            return true;
+        }
+        uint32_t magic;
+        std::memcpy(&magic, ring + offset, sizeof(magic));
+        return magic == WRAP_MAGIC;
+    }
+}  // namespace
+
+bool FrameCaptureWriter::open(const std::string& path, size_t capacity)
+{
+    close();
+    std::error_code error;
+    if (std::filesystem::exists(path, error))
+    {
+        std::filesystem::rename(path, path + ".previous", error);
+    }
+    mCapacity = capacity / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+    if (mCapacity < MIN_CAPACITY || !mFile.create(path, sizeof(CaptureHeader) + mCapacity))
+    {
+        mCapacity = 0;
+        return false;
+    }
+    mRing = mFile.getMutableData() + sizeof(CaptureHeader);
+    mBegin = 0;
+    mEnd = 0;
+    mFrameCount = 0;
+    mWrittenCount = 0;
+    mDroppedCount = 0;
+    getHeader(mRing) = {CAPTURE_MAGIC, CAPTURE_VERSION, mCapacity, 0, 0, 0, 0, {}};
+    return true;
+}
+
+void FrameCaptureWriter::close()
+{
+    mFile.close();
+    mRing = nullptr;
+    mCapacity = 0;
+}
+
+bool FrameCaptureWriter::write(const FrameCaptureRecord& record,
+                               std::span<const DrawCommand> depthPrepassDraws,
+                               std::span<const DrawCommand> shadingDraws,
+                               std::span<const uint32_t> objectLods)
+{
+    if (!mRing)
+    {
+        return false;
+    }
+    uint64_t size = getFrameSize(depthPrepassDraws.size() + shadingDraws.size());
+    if (size > mCapacity / MAX_FRAME_SHARE)
+    {
+        mDroppedCount++;
+        return false;
+    }
+
+    // Frames are never split, one that does not fit before the end of the ring starts over at the beginning
+    uint64_t offset = mEnd + size <= mCapacity ? mEnd : 0;
+    while (mFrameCount > 0 && !isFree(offset, size))
+    {
+        evictOldest();
+        offset = mEnd + size <= mCapacity ? mEnd : 0;
+    }
+    CaptureHeader& captureHeader = getHeader(mRing);
+    if (mFrameCount == 0)
+    {
+        mBegin = 0;
+        mEnd = 0;
+        offset = 0;
+        captureHeader.begin = 0;
+        captureHeader.end = 0;
+    }
+    else if (offset == 0 && mEnd + sizeof(FrameHeader) <= mCapacity)
+    {
+        FrameHeader marker {WRAP_MAGIC, 0, 0};
+        std::memcpy(mRing + mEnd, &marker, sizeof(marker));
+    }
+
+    std::byte* destination = mRing + offset;
+    FrameHeader header {FRAME_MAGIC, static_cast<uint32_t>(size), 0};
+    std::memcpy(destination, &header, sizeof(header));
+    FrameCaptureRecord copy = record;
+    copy.depthPrepassDrawCount = static_cast<uint32_t>(depthPrepassDraws.size());
+    copy.shadingDrawCount = static_cast<uint32_t>(shadingDraws.size());
+    std::memcpy(destination + sizeof(FrameHeader), &copy, sizeof(copy));
+    FrameCaptureDraw* draws = reinterpret_cast<FrameCaptureDraw*>(destination + sizeof(FrameHeader) + sizeof(FrameCaptureRecord));
+    for (std::span<const DrawCommand> list : {depthPrepassDraws, shadingDraws})
+    {
+        for (const DrawCommand& draw : list)
+        {
+            *draws++ = {draw.objectIndex, draw.objectIndex < objectLods.size() ? objectLods[draw.objectIndex] : 0};
+        }
+    }
+
+    // Published only once its bytes are in place, a crash before this leaves the frame invisible
+    mEnd = offset + size;
+    mFrameCount++;
+    mWrittenCount++;
+    std::atomic_thread_fence(std::memory_order_release);
+    captureHeader.end = mEnd;
+    std::atomic_thread_fence(std::memory_order_release);
+    captureHeader.frameCount = mFrameCount;
+    captureHeader.writtenCount = mWrittenCount;
+    return true;
+}
+
+bool FrameCaptureWriter::isFree(uint64_t offset, uint64_t size) const
+{
+    // Live frames are either in one piece from begin to end, or run from begin to the end of the ring and on from its start
+    if (mBegin < mEnd)
+    {
+        return offset == mEnd || offset + size <= mBegin;
+    }
+    return offset == mEnd && mEnd + size <= mBegin;
+}
+
+void FrameCaptureWriter::evictOldest()
+{
+    FrameHeader header;
+    std::memcpy(&header, mRing + mBegin, sizeof(header));
+    mFrameCount--;
+    uint64_t begin = mBegin + header.size;
+    if (mFrameCount > 0 && isWrapped(mRing, mCapacity, begin))
+    {
+        begin = 0;
+    }
+    // The count drops first, a crash in between leaves a reader one frame short rather than one frame over
+    getHeader(mRing).frameCount = mFrameCount;
+    std::atomic_thread_fence(std::memory_order_release);
+    mBegin = begin;
+    getHeader(mRing).begin = mBegin;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+bool FrameCaptureReader::open(const std::string& path)
+{
+    close();
+    if (!mFile.open(path))
+    {
+        return false;
+    }
+    std::span<const std::byte> bytes = mFile.getBytes();
+    CaptureHeader header;
+    if (bytes.size() < sizeof(header))
+    {
+        close();
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION || header.capacity != bytes.size() - sizeof(header) || header.begin >= header.capacity ||
+        header.frameCount > header.capacity / getFrameSize(0))
+    {
+        close();
+        return false;
+    }
+
+    const std::byte* ring = bytes.data() + sizeof(header);
+    uint64_t offset = header.begin;
+    mFrames.reserve(header.frameCount);
+    for (uint64_t i = 0; i < header.frameCount; i++)
+    {
+        if (isWrapped(ring, header.capacity, offset))
+        {
+            offset = 0;
+        }
+        FrameHeader frameHeader;
+        std::memcpy(&frameHeader, ring + offset, sizeof(frameHeader));
+        Frame frame;
+        if (frameHeader.magic != FRAME_MAGIC || frameHeader.size < getFrameSize(0) || offset + frameHeader.size > header.capacity)
+        {
+            close();
+            return false;
+        }
+        std::memcpy(&frame.record, ring + offset + sizeof(FrameHeader), sizeof(FrameCaptureRecord));
+        uint64_t drawCount = uint64_t {frame.record.depthPrepassDrawCount} + frame.record.shadingDrawCount;
+        if (getFrameSize(drawCount) != frameHeader.size)
+        {
+            close();
+            return false;
+        }
+        const FrameCaptureDraw* draws = reinterpret_cast<const FrameCaptureDraw*>(ring + offset + sizeof(FrameHeader) + sizeof(FrameCaptureRecord));
+        frame.depthPrepassDraws = {draws, frame.record.depthPrepassDrawCount};
+        frame.shadingDraws = {draws + frame.record.depthPrepassDrawCount, frame.record.shadingDrawCount};
+        mFrames.push_back(frame);
+        offset += frameHeader.size;
+    }
+    mWrittenCount = header.writtenCount;
+    return true;
+}
+
+void FrameCaptureReader::close()
+{
+    mFile.close();
+    mFrames.clear();
+    mWrittenCount = 0;
+}
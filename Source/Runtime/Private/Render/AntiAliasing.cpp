@@ -0,0 +1,43 @@
+#include "Render/AntiAliasing.hpp"
+#include <algorithm>
+
+using namespace LearnVulkan;
+
+const char* LearnVulkan::toString(AntiAliasingTier tier)
+{
+    switch (tier)
+    {
+        case AntiAliasingTier::Off: return "off";
+        case AntiAliasingTier::Msaa2x: return "2x MSAA";
+        case AntiAliasingTier::Msaa4x: return "4x MSAA";
+        case AntiAliasingTier::MsaaSampleShading: return "MSAA with sample shading";
+        case AntiAliasingTier::Fxaa: return "FXAA";
+        default: return "unknown";
+    }
+}
+
+AntiAliasingSettings AntiAliasingSettings::fromTier(AntiAliasingTier tier, VkSampleCountFlagBits maxSampleCount)
+{
+    AntiAliasingSettings settings {};
+    switch (tier)
+    {
+        case AntiAliasingTier::Msaa2x:
+            settings.sampleCount = VK_SAMPLE_COUNT_2_BIT;
+            break;
+        case AntiAliasingTier::Msaa4x:
+            settings.sampleCount = VK_SAMPLE_COUNT_4_BIT;
+            break;
+        case AntiAliasingTier::MsaaSampleShading:
+            settings.sampleCount = maxSampleCount;
+            settings.bSampleShading = true;
+            break;
+        case AntiAliasingTier::Fxaa:
+            settings.bPostProcess = true;
+            break;
+        default:
+            break;
+    }
+    settings.sampleCount = static_cast<VkSampleCountFlagBits>(std::min(settings.sampleCount, maxSampleCount));
+    settings.bSampleShading = settings.bSampleShading && settings.sampleCount != VK_SAMPLE_COUNT_1_BIT;
+    return settings;
+}
@@ -0,0 +1,174 @@
+#include "Render/BindlessResourceTable.hpp"
+#include <array>
+#include <stdexcept>
+
+using namespace LearnVulkan;
+
+void BindlessResourceTable::initialize(VkDevice device, uint32_t maxTextures, uint32_t maxStorageBuffers, const VkAllocationCallbacks* allocator)
+{
+    mDevice = device;
+    mAllocator = allocator;
+    mTextureSlots.reset(maxTextures);
+    mStorageBufferSlots.reset(maxStorageBuffers);
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings {};
+    bindings[TEXTURE_BINDING].binding = TEXTURE_BINDING;
+    bindings[TEXTURE_BINDING].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[TEXTURE_BINDING].descriptorCount = maxTextures;
+    bindings[TEXTURE_BINDING].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindings[TEXTURE_BINDING].pImmutableSamplers = nullptr;
+
+    bindings[STORAGE_BUFFER_BINDING].binding = STORAGE_BUFFER_BINDING;
+    bindings[STORAGE_BUFFER_BINDING].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[STORAGE_BUFFER_BINDING].descriptorCount = maxStorageBuffers;
+    bindings[STORAGE_BUFFER_BINDING].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindings[STORAGE_BUFFER_BINDING].pImmutableSamplers = nullptr;
+
+    // Unwritten slots are never accessed, and written slots may change while other slots are in use
+    VkDescriptorBindingFlags bindingFlag = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    std::array<VkDescriptorBindingFlags, 2> bindingFlags {bindingFlag, bindingFlag};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo {};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(mDevice, &layoutInfo, mAllocator, &mDescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create bindless descriptor set layout!");
+    }
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = maxTextures;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = maxStorageBuffers;
+
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = 1;
+
+    if (vkCreateDescriptorPool(mDevice, &poolInfo, mAllocator, &mDescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create bindless descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = mDescriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &mDescriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(mDevice, &allocInfo, &mDescriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate bindless descriptor set!");
+    }
+}
+
+void BindlessResourceTable::finalize()
+{
+    vkDestroyDescriptorPool(mDevice, mDescriptorPool, mAllocator);
+    vkDestroyDescriptorSetLayout(mDevice, mDescriptorSetLayout, mAllocator);
+    mDescriptorPool = VK_NULL_HANDLE;
+    mDescriptorSetLayout = VK_NULL_HANDLE;
+    mDescriptorSet = VK_NULL_HANDLE;
+}
+
+uint32_t BindlessResourceTable::registerTexture(VkImageView imageView, VkSampler sampler)
+{
+    uint32_t index = mTextureSlots.allocate();
+
+    VkDescriptorImageInfo imageInfo {};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+
+    VkWriteDescriptorSet writeDescriptorSet {};
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSet.dstSet = mDescriptorSet;
+    writeDescriptorSet.dstBinding = TEXTURE_BINDING;
+    writeDescriptorSet.dstArrayElement = index;
+    writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(mDevice, 1, &writeDescriptorSet, 0, nullptr);
+    return index;
+}
+
+void BindlessResourceTable::releaseTexture(uint32_t index)
+{
+    mTextureSlots.release(index);
+}
+
+uint32_t BindlessResourceTable::registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    uint32_t index = mStorageBufferSlots.allocate();
+
+    VkDescriptorBufferInfo bufferInfo {};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = offset;
+    bufferInfo.range = range;
+
+    VkWriteDescriptorSet writeDescriptorSet {};
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSet.dstSet = mDescriptorSet;
+    writeDescriptorSet.dstBinding = STORAGE_BUFFER_BINDING;
+    writeDescriptorSet.dstArrayElement = index;
+    writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(mDevice, 1, &writeDescriptorSet, 0, nullptr);
+    return index;
+}
+
+void BindlessResourceTable::releaseStorageBuffer(uint32_t index)
+{
+    mStorageBufferSlots.release(index);
+}
+
+void BindlessResourceTable::SlotAllocator::reset(uint32_t capacity)
+{
+    mCapacity = capacity;
+    mNextUnused = 0;
+    mFreeList.clear();
+    mUsedSlots.assign(capacity, false);
+}
+
+uint32_t BindlessResourceTable::SlotAllocator::allocate()
+{
+    if (!mFreeList.empty())
+    {
+        uint32_t index = mFreeList.back();
+        mFreeList.pop_back();
+        mUsedSlots[index] = true;
+        return index;
+    }
+    if (mNextUnused >= mCapacity)
+    {
+        throw std::runtime_error("Bindless resource table is full!");
+    }
+    mUsedSlots[mNextUnused] = true;
+    return mNextUnused++;
+}
+
+void BindlessResourceTable::SlotAllocator::release(uint32_t index)
+{
+    if (index >= mCapacity || !mUsedSlots[index])
+    {
+        throw std::runtime_error("Bindless slot released twice or never allocated!");
+    }
+    mUsedSlots[index] = false;
+    mFreeList.push_back(index);
+}
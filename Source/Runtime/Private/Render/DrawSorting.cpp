@@ -0,0 +1,35 @@
+#include "Render/DrawSorting.hpp"
+#include <algorithm>
+#include <bit>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    const uint32_t PIPELINE_BITS = 12;
+    const uint32_t MATERIAL_BITS = 20;
+
+    // Non-negative floats order like their bit patterns, depths behind the camera clamp to zero
+    uint64_t getDepthBits(float viewDepth)
+    {
+        return std::bit_cast<uint32_t>(std::max(viewDepth, 0.0f));
+    }
+}  // namespace
+
+uint64_t LearnVulkan::makeDrawSortKey(DrawSortOrder order, float viewDepth, uint32_t pipelineIndex, uint32_t materialIndex)
+{
+    uint64_t state = (static_cast<uint64_t>(pipelineIndex & ((1u << PIPELINE_BITS) - 1)) << MATERIAL_BITS) | (materialIndex & ((1u << MATERIAL_BITS) - 1));
+    uint64_t depth = getDepthBits(viewDepth);
+    switch (order)
+    {
+        case DrawSortOrder::FrontToBack: return (depth << 32) | state;
+        case DrawSortOrder::State: return (state << 32) | depth;
+        case DrawSortOrder::BackToFront: return ((~depth & 0xffffffffull) << 32) | state;
+        default: return state;
+    }
+}
+
+void LearnVulkan::sortDrawCommands(std::span<DrawCommand> commands)
+{
+    std::sort(commands.begin(), commands.end(), [](const DrawCommand& a, const DrawCommand& b) { return a.sortKey < b.sortKey; });
+}
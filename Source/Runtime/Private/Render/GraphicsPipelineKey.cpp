@@ -0,0 +1,38 @@
+#include "Render/GraphicsPipelineKey.hpp"
+#include <sstream>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    void hashCombine(size_t& seed, size_t value)
+    {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+}  // namespace
+
+size_t GraphicsPipelineKey::hash() const
+{
+    size_t seed = std::hash<uint32_t>()(static_cast<uint32_t>(colorFormat));
+    hashCombine(seed, std::hash<uint32_t>()(static_cast<uint32_t>(sampleCount)));
+    hashCombine(seed, std::hash<bool>()(bSampleShading));
+    hashCombine(seed, std::hash<uint8_t>()(static_cast<uint8_t>(blendMode)));
+    hashCombine(seed, std::hash<uint8_t>()(static_cast<uint8_t>(depthPass)));
+    hashCombine(seed, std::hash<uint32_t>()(cullMode));
+    hashCombine(seed, std::hash<float>()(uvScale));
+    hashCombine(seed, std::hash<uint32_t>()(featureFlags));
+    return seed;
+}
+
+std::string GraphicsPipelineKey::toString() const
+{
+    std::ostringstream stream;
+    stream << "format " << colorFormat << ", msaa " << sampleCount << "x"
+           << (bSampleShading ? ", sample shading" : "")
+           << (blendMode == BlendMode::AlphaBlend ? ", alpha blend" : ", opaque")
+           << (depthPass == DepthPass::Prepass ? ", depth prepass" : depthPass == DepthPass::Shading ? ", depth equal" : "")
+           << (cullMode == VK_CULL_MODE_NONE ? ", no cull" : cullMode == VK_CULL_MODE_FRONT_BIT ? ", front cull" : ", back cull")
+           << ", uv scale " << uvScale
+           << ((featureFlags & PIPELINE_FEATURE_ALBEDO_TEXTURE_BIT) ? ", albedo texture" : "");
+    return stream.str();
+}
@@ -0,0 +1,839 @@
+#include "Render/RenderGraph.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    bool covers(VkFlags64 mask, VkFlags64 required)
+    {
+        return (required & ~mask) == 0;
+    }
+}  // namespace
+
+RenderGraphImageState LearnVulkan::getAccessState(RenderGraphAccess access)
+{
+    switch (access)
+    {
+        case RenderGraphAccess::ColorAttachmentWrite:
+            // Blended pipelines read the attachment as well
+            return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        case RenderGraphAccess::DepthAttachmentWrite:
+            return {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
+                    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+        case RenderGraphAccess::DepthAttachmentRead:
+            return {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+        case RenderGraphAccess::FragmentSampledRead:
+            return {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        case RenderGraphAccess::ComputeSampledRead:
+            return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        case RenderGraphAccess::ComputeStorageRead:
+            return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR, VK_IMAGE_LAYOUT_GENERAL};
+        case RenderGraphAccess::ComputeStorageWrite:
+            return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_GENERAL};
+        case RenderGraphAccess::TransferRead:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+        case RenderGraphAccess::TransferWrite:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+        case RenderGraphAccess::Present:
+            // The present engine waits on a semaphore, nothing in the command buffer runs after the transition
+            return {VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+    }
+    throw std::invalid_argument("Unknown render graph access!");
+}
+
+bool LearnVulkan::isWriteAccess(RenderGraphAccess access)
+{
+    switch (access)
+    {
+        case RenderGraphAccess::ColorAttachmentWrite:
+        case RenderGraphAccess::DepthAttachmentWrite:
+        case RenderGraphAccess::ComputeStorageWrite:
+        case RenderGraphAccess::TransferWrite:
+            return true;
+        default:
+            return false;
+    }
+}
+
+RenderGraphImageState LearnVulkan::getLayoutState(VkImageLayout layout)
+{
+    switch (layout)
+    {
+        case VK_IMAGE_LAYOUT_UNDEFINED:
+        case VK_IMAGE_LAYOUT_PREINITIALIZED:
+            return {VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR, layout};
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            return getAccessState(RenderGraphAccess::ColorAttachmentWrite);
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            return getAccessState(RenderGraphAccess::DepthAttachmentWrite);
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+            return getAccessState(RenderGraphAccess::DepthAttachmentRead);
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            return {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR, layout};
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            return getAccessState(RenderGraphAccess::TransferRead);
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            return getAccessState(RenderGraphAccess::TransferWrite);
+        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+            return getAccessState(RenderGraphAccess::Present);
+        default:
+            return {VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR, layout};
+    }
+}
+
+void RenderGraph::initialize(VkDevice device)
+{
+    mCmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier2KHR"));
+    if (mCmdPipelineBarrier2 == nullptr)
+    {
+        throw std::runtime_error("Failed to load vkCmdPipelineBarrier2KHR!");
+    }
+}
+
+void RenderGraph::clear()
+{
+    mResources.clear();
+    mPasses.clear();
+    mLevels.clear();
+    mAliasGroups.clear();
+    mStatistics = {};
+}
+
+RenderGraphResource RenderGraph::createImage(const std::string& name, const RenderGraphImageDescription& description)
+{
+    Resource resource {};
+    resource.name = name;
+    resource.description = description;
+    resource.bImported = false;
+    resource.initialState = {VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR, VK_IMAGE_LAYOUT_UNDEFINED};
+    mResources.push_back(resource);
+    return static_cast<RenderGraphResource>(mResources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::importImage(const std::string& name, VkImageAspectFlags aspectMask, const RenderGraphImageState& initialState)
+{
+    Resource resource {};
+    resource.name = name;
+    resource.description.aspectMask = aspectMask;
+    resource.bImported = true;
+    resource.initialState = initialState;
+    mResources.push_back(resource);
+    return static_cast<RenderGraphResource>(mResources.size() - 1);
+}
+
+RenderGraphPass RenderGraph::addPass(const std::string& name, RecordFunction record)
+{
+    Pass pass {};
+    pass.name = name;
+    pass.record = std::move(record);
+    mPasses.push_back(std::move(pass));
+    return static_cast<RenderGraphPass>(mPasses.size() - 1);
+}
+
+void RenderGraph::addAccess(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access)
+{
+    mPasses[pass].accesses.push_back({resource, access});
+    if (access == RenderGraphAccess::Present)
+    {
+        mPasses[pass].bSideEffect = true;
+    }
+}
+
+void RenderGraph::setSideEffect(RenderGraphPass pass)
+{
+    mPasses[pass].bSideEffect = true;
+}
+
+void RenderGraph::setSecondaryRecordable(RenderGraphPass pass)
+{
+    mPasses[pass].bSecondaryRecordable = true;
+}
+
+void RenderGraph::compile()
+{
+    mLevels.clear();
+    mAliasGroups.clear();
+    mStatistics = {};
+    mStatistics.passCount = static_cast<uint32_t>(mPasses.size());
+
+    cullPasses();
+    assignLevels();
+    planAliasing();
+    planBarriers();
+}
+
+void RenderGraph::cullPasses()
+{
+    // Walks backwards, a pass survives if it has a side effect or writes something a surviving later pass reads
+    std::vector<bool> bNeeded(mResources.size(), false);
+    for (size_t i = mPasses.size(); i-- > 0;)
+    {
+        Pass& pass = mPasses[i];
+        bool bLive = pass.bSideEffect;
+        for (const Access& access : pass.accesses)
+        {
+            if (isWriteAccess(access.access) && (bNeeded[access.resource] || mResources[access.resource].bImported))
+            {
+                bLive = true;
+            }
+        }
+        pass.bCulled = !bLive;
+        if (!bLive)
+        {
+            mStatistics.culledPassCount++;
+            continue;
+        }
+        for (const Access& access : pass.accesses)
+        {
+            if (isWriteAccess(access.access))
+            {
+                bNeeded[access.resource] = false;
+            }
+        }
+        for (const Access& access : pass.accesses)
+        {
+            if (!isWriteAccess(access.access))
+            {
+                bNeeded[access.resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::assignLevels()
+{
+    // A pass runs one level after everything it depends on. Layout transitions count as writes, but readers
+    // wanting the layout a transition just produced can share its level, the transition's barrier covers them.
+    struct History
+    {
+        int32_t lastModifyLevel = -1;
+        int32_t lastReadLevel = -1;
+        bool bLastModifyIsTransition = false;
+        VkImageLayout layout;
+    };
+    std::vector<History> histories(mResources.size());
+    for (size_t i = 0; i < mResources.size(); i++)
+    {
+        histories[i].layout = mResources[i].initialState.layout;
+        mResources[i].bUsed = false;
+    }
+
+    uint32_t levelCount = 0;
+    for (Pass& pass : mPasses)
+    {
+        if (pass.bCulled)
+        {
+            continue;
+        }
+        int32_t level = 0;
+        for (const Access& access : pass.accesses)
+        {
+            const History& history = histories[access.resource];
+            bool bWrite = isWriteAccess(access.access);
+            bool bTransition = getAccessState(access.access).layout != history.layout;
+            int32_t after = history.lastModifyLevel;
+            if (bWrite || bTransition)
+            {
+                after = std::max(history.lastModifyLevel, history.lastReadLevel);
+            }
+            else if (history.bLastModifyIsTransition)
+            {
+                after = history.lastModifyLevel - 1;
+            }
+            level = std::max(level, after + 1);
+        }
+        pass.level = static_cast<uint32_t>(level);
+        levelCount = std::max(levelCount, pass.level + 1);
+
+        for (const Access& access : pass.accesses)
+        {
+            History& history = histories[access.resource];
+            bool bWrite = isWriteAccess(access.access);
+            VkImageLayout layout = getAccessState(access.access).layout;
+            if (bWrite || layout != history.layout)
+            {
+                history.lastModifyLevel = level;
+                history.lastReadLevel = bWrite ? -1 : level;
+                history.bLastModifyIsTransition = !bWrite;
+                history.layout = layout;
+            }
+            else
+            {
+                history.lastReadLevel = std::max(history.lastReadLevel, level);
+            }
+
+            Resource& resource = mResources[access.resource];
+            if (!resource.bUsed)
+            {
+                resource.bUsed = true;
+                resource.firstLevel = pass.level;
+            }
+            resource.firstLevel = std::min(resource.firstLevel, pass.level);
+            resource.lastLevel = std::max(resource.lastLevel, pass.level);
+        }
+    }
+
+    mLevels.resize(levelCount);
+    for (size_t i = 0; i < mPasses.size(); i++)
+    {
+        if (!mPasses[i].bCulled)
+        {
+            mLevels[mPasses[i].level].passes.push_back(static_cast<RenderGraphPass>(i));
+        }
+    }
+    mStatistics.levelCount = levelCount;
+}
+
+void RenderGraph::planAliasing()
+{
+    struct Slot
+    {
+        uint32_t lastLevel;
+        VkDeviceSize size;
+        uint32_t memoryTypeBits;
+        std::vector<RenderGraphResource> members;
+    };
+
+    std::vector<RenderGraphResource> candidates;
+    for (size_t i = 0; i < mResources.size(); i++)
+    {
+        Resource& resource = mResources[i];
+        // Every transient image is its own predecessor across frames unless it shares memory
+        resource.aliasPredecessor = static_cast<RenderGraphResource>(i);
+        if (resource.bUsed && !resource.bImported && resource.description.size > 0)
+        {
+            candidates.push_back(static_cast<RenderGraphResource>(i));
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [this](RenderGraphResource a, RenderGraphResource b) { return mResources[a].firstLevel < mResources[b].firstLevel; });
+
+    // Greedy interval packing: the best fitting free slot, otherwise the largest free one grows
+    std::vector<Slot> slots;
+    for (RenderGraphResource candidate : candidates)
+    {
+        const Resource& resource = mResources[candidate];
+        Slot* best = nullptr;
+        for (Slot& slot : slots)
+        {
+            if (slot.lastLevel >= resource.firstLevel || (slot.memoryTypeBits & resource.description.memoryTypeBits) == 0)
+            {
+                continue;
+            }
+            bool bFits = slot.size >= resource.description.size;
+            bool bBestFits = best != nullptr && best->size >= resource.description.size;
+            if (best == nullptr || (bFits && (!bBestFits || slot.size < best->size)) || (!bFits && !bBestFits && slot.size > best->size))
+            {
+                best = &slot;
+            }
+        }
+        if (best == nullptr)
+        {
+            slots.push_back({resource.lastLevel, resource.description.size, resource.description.memoryTypeBits, {candidate}});
+            continue;
+        }
+        best->lastLevel = resource.lastLevel;
+        best->size = std::max(best->size, resource.description.size);
+        best->memoryTypeBits &= resource.description.memoryTypeBits;
+        best->members.push_back(candidate);
+    }
+
+    for (Slot& slot : slots)
+    {
+        for (size_t i = 0; i < slot.members.size(); i++)
+        {
+            mResources[slot.members[i]].aliasPredecessor = slot.members[(i + slot.members.size() - 1) % slot.members.size()];
+            mStatistics.transientBytes += mResources[slot.members[i]].description.size;
+        }
+        if (slot.members.size() > 1)
+        {
+            mStatistics.aliasedImageCount += static_cast<uint32_t>(slot.members.size());
+        }
+        mStatistics.aliasedBytes += slot.size;
+        mAliasGroups.push_back(std::move(slot.members));
+    }
+}
+
+void RenderGraph::planBarriers()
+{
+    struct State
+    {
+        VkImageLayout layout;
+        VkPipelineStageFlags2KHR writeStages;
+        VkAccessFlags2KHR writeAccess;
+        // Reads since the last write, a following write has to wait for them
+        VkPipelineStageFlags2KHR readStages;
+        // What the last barrier made the last write visible to
+        VkPipelineStageFlags2KHR visibleStages;
+        VkAccessFlags2KHR visibleAccess;
+        bool bFirstUse;
+    };
+    std::vector<State> states(mResources.size());
+    for (size_t i = 0; i < mResources.size(); i++)
+    {
+        const Resource& resource = mResources[i];
+        states[i] = {resource.initialState.layout, resource.initialState.stageMask, resource.initialState.accessMask, 0, 0, 0, !resource.bImported};
+    }
+    std::vector<int32_t> levelBarriers(mResources.size(), -1);
+    // The first use of a transient image waits for whatever used its memory last, which is only known at the end
+    std::vector<std::pair<uint32_t, uint32_t>> firstUseBarriers(mResources.size(), {UINT32_MAX, 0});
+
+    for (uint32_t levelIndex = 0; levelIndex < mLevels.size(); levelIndex++)
+    {
+        Level& level = mLevels[levelIndex];
+        for (RenderGraphPass passIndex : level.passes)
+        {
+            for (const Access& access : mPasses[passIndex].accesses)
+            {
+                const State& state = states[access.resource];
+                RenderGraphImageState target = getAccessState(access.access);
+                RenderGraphBarrier barrier {access.resource, state.writeStages | state.readStages, state.writeAccess, target.stageMask, target.accessMask, state.layout, target.layout};
+                bool bNeeded = false;
+                if (state.bFirstUse)
+                {
+                    barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+                    barrier.srcAccessMask = VK_ACCESS_2_NONE_KHR;
+                    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                    bNeeded = true;
+                }
+                else if (state.layout != target.layout)
+                {
+                    bNeeded = true;
+                }
+                else if (isWriteAccess(access.access))
+                {
+                    bNeeded = barrier.srcStageMask != 0;
+                }
+                else
+                {
+                    // Reads after reads need nothing, reads after a write only if it is not visible to them yet
+                    barrier.srcStageMask = state.writeStages;
+                    bNeeded = state.writeStages != 0 && !(covers(state.visibleStages, target.stageMask) && covers(state.visibleAccess, target.accessMask));
+                }
+                if (!bNeeded)
+                {
+                    continue;
+                }
+
+                int32_t& barrierIndex = levelBarriers[access.resource];
+                if (barrierIndex < 0)
+                {
+                    barrierIndex = static_cast<int32_t>(level.barriers.size());
+                    level.barriers.push_back(barrier);
+                    if (state.bFirstUse)
+                    {
+                        firstUseBarriers[access.resource] = {levelIndex, static_cast<uint32_t>(barrierIndex)};
+                    }
+                }
+                else
+                {
+                    // Same level accesses never conflict, so they share a layout and one barrier
+                    RenderGraphBarrier& merged = level.barriers[barrierIndex];
+                    merged.srcStageMask |= barrier.srcStageMask;
+                    merged.srcAccessMask |= barrier.srcAccessMask;
+                    merged.dstStageMask |= barrier.dstStageMask;
+                    merged.dstAccessMask |= barrier.dstAccessMask;
+                }
+            }
+        }
+
+        for (const RenderGraphBarrier& barrier : level.barriers)
+        {
+            State& state = states[barrier.resource];
+            // A layout transition is a write later accesses outside its second scope have to wait for
+            if (barrier.oldLayout != barrier.newLayout)
+            {
+                state.writeStages |= barrier.dstStageMask;
+            }
+            state.layout = barrier.newLayout;
+            state.visibleStages = barrier.dstStageMask;
+            state.visibleAccess = barrier.dstAccessMask;
+            state.bFirstUse = false;
+            levelBarriers[barrier.resource] = -1;
+        }
+        for (RenderGraphPass passIndex : level.passes)
+        {
+            for (const Access& access : mPasses[passIndex].accesses)
+            {
+                if (isWriteAccess(access.access))
+                {
+                    State& state = states[access.resource];
+                    state.writeStages = 0;
+                    state.writeAccess = 0;
+                    state.readStages = 0;
+                }
+            }
+        }
+        for (RenderGraphPass passIndex : level.passes)
+        {
+            for (const Access& access : mPasses[passIndex].accesses)
+            {
+                State& state = states[access.resource];
+                RenderGraphImageState target = getAccessState(access.access);
+                if (isWriteAccess(access.access))
+                {
+                    state.writeStages |= target.stageMask;
+                    state.writeAccess |= target.accessMask;
+                    state.visibleStages = 0;
+                    state.visibleAccess = 0;
+                }
+                else
+                {
+                    state.readStages |= target.stageMask;
+                }
+            }
+        }
+        mStatistics.barrierCount += static_cast<uint32_t>(level.barriers.size());
+    }
+
+    for (size_t i = 0; i < mResources.size(); i++)
+    {
+        mResources[i].finalState = {states[i].writeStages | states[i].readStages, states[i].writeAccess, states[i].layout};
+    }
+    for (size_t i = 0; i < mResources.size(); i++)
+    {
+        if (firstUseBarriers[i].first == UINT32_MAX)
+        {
+            continue;
+        }
+        const RenderGraphImageState& previous = mResources[mResources[i].aliasPredecessor].finalState;
+        RenderGraphBarrier& barrier = mLevels[firstUseBarriers[i].first].barriers[firstUseBarriers[i].second];
+        barrier.srcStageMask = previous.stageMask;
+        barrier.srcAccessMask = previous.accessMask;
+    }
+}
+
+bool RenderGraph::validate(std::string& error) const
+{
+    // Positions order everything on one timeline: the initial state at 0, barriers of level L at 2L + 1, its accesses at 2L + 2
+    struct Event
+    {
+        uint32_t position;
+        VkPipelineStageFlags2KHR stageMask;
+        VkAccessFlags2KHR accessMask;
+    };
+    struct History
+    {
+        VkImageLayout layout;
+        bool bWritten;
+        Event lastWrite;
+        std::vector<Event> reads;
+        bool bTransitioned;
+        Event transition;
+    };
+
+    std::vector<History> histories(mResources.size());
+    for (size_t i = 0; i < mResources.size(); i++)
+    {
+        const Resource& resource = mResources[i];
+        histories[i] = {resource.initialState.layout, resource.bImported, {0, resource.initialState.stageMask, resource.initialState.accessMask}, {}, false, {}};
+    }
+
+    auto findBarrier = [this](RenderGraphResource resource, const Event& from, uint32_t position, VkPipelineStageFlags2KHR dstStageMask, VkAccessFlags2KHR dstAccessMask) {
+        for (uint32_t level = from.position / 2; 2 * level + 1 < position; level++)
+        {
+            if (2 * level + 1 <= from.position)
+            {
+                continue;
+            }
+            for (const RenderGraphBarrier& barrier : mLevels[level].barriers)
+            {
+                if (barrier.resource == resource && covers(barrier.srcStageMask, from.stageMask) && covers(barrier.srcAccessMask, from.accessMask)
+                    && covers(barrier.dstStageMask, dstStageMask) && covers(barrier.dstAccessMask, dstAccessMask))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    for (uint32_t levelIndex = 0; levelIndex < mLevels.size(); levelIndex++)
+    {
+        const Level& level = mLevels[levelIndex];
+        uint32_t barrierPosition = 2 * levelIndex + 1;
+        uint32_t accessPosition = 2 * levelIndex + 2;
+
+        // Passes sharing a level run unordered, they may only read the same image in the same layout
+        for (size_t a = 0; a < level.passes.size(); a++)
+        {
+            for (size_t b = a + 1; b < level.passes.size(); b++)
+            {
+                for (const Access& first : mPasses[level.passes[a]].accesses)
+                {
+                    for (const Access& second : mPasses[level.passes[b]].accesses)
+                    {
+                        if (first.resource == second.resource
+                            && (isWriteAccess(first.access) || isWriteAccess(second.access) || getAccessState(first.access).layout != getAccessState(second.access).layout))
+                        {
+                            error = "Passes " + mPasses[level.passes[a]].name + " and " + mPasses[level.passes[b]].name + " conflict on " + mResources[first.resource].name;
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (const RenderGraphBarrier& barrier : level.barriers)
+        {
+            History& history = histories[barrier.resource];
+            const std::string& name = mResources[barrier.resource].name;
+            if (barrier.oldLayout != VK_IMAGE_LAYOUT_UNDEFINED && barrier.oldLayout != history.layout)
+            {
+                error = "Barrier on " + name + " transitions from a layout the image is not in";
+                return false;
+            }
+            if (barrier.oldLayout != barrier.newLayout)
+            {
+                // The transition writes the image, earlier reads and writes have to be done by then
+                for (const Event& read : history.reads)
+                {
+                    if (!covers(barrier.srcStageMask, read.stageMask))
+                    {
+                        error = "Layout transition of " + name + " does not wait for earlier reads";
+                        return false;
+                    }
+                }
+                bool bDiscards = barrier.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED;
+                if (history.bWritten && !(covers(barrier.srcStageMask, history.lastWrite.stageMask) && (bDiscards || covers(barrier.srcAccessMask, history.lastWrite.accessMask))))
+                {
+                    error = "Layout transition of " + name + " does not wait for the last write";
+                    return false;
+                }
+                if (bDiscards && !mResources[barrier.resource].bImported)
+                {
+                    history.bWritten = false;
+                    history.reads.clear();
+                }
+                history.bTransitioned = true;
+                history.transition = {barrierPosition, barrier.dstStageMask, 0};
+            }
+            history.layout = barrier.newLayout;
+        }
+
+        for (RenderGraphPass passIndex : level.passes)
+        {
+            const Pass& pass = mPasses[passIndex];
+            for (const Access& access : pass.accesses)
+            {
+                const History& history = histories[access.resource];
+                const std::string& name = mResources[access.resource].name;
+                RenderGraphImageState state = getAccessState(access.access);
+                bool bWrite = isWriteAccess(access.access);
+                if (history.layout != state.layout)
+                {
+                    error = pass.name + " accesses " + name + " in the wrong layout";
+                    return false;
+                }
+                if (!bWrite && !history.bWritten && !mResources[access.resource].bImported)
+                {
+                    error = pass.name + " reads " + name + " before it is written";
+                    return false;
+                }
+                if (history.bWritten && history.lastWrite.position > 0
+                    && !findBarrier(access.resource, history.lastWrite, accessPosition, state.stageMask, bWrite ? VK_ACCESS_2_NONE_KHR : state.accessMask))
+                {
+                    error = "Missing barrier before " + pass.name + " after the last write of " + name;
+                    return false;
+                }
+                if (history.bTransitioned && !covers(history.transition.stageMask, state.stageMask) && !findBarrier(access.resource, history.transition, accessPosition, state.stageMask, VK_ACCESS_2_NONE_KHR))
+                {
+                    error = "Missing barrier before " + pass.name + " after the layout transition of " + name;
+                    return false;
+                }
+                if (bWrite)
+                {
+                    for (const Event& read : history.reads)
+                    {
+                        if (read.position < accessPosition && !findBarrier(access.resource, {read.position, read.stageMask, 0}, accessPosition, state.stageMask, VK_ACCESS_2_NONE_KHR))
+                        {
+                            error = "Missing barrier before " + pass.name + " writes " + name + " after it was read";
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (RenderGraphPass passIndex : level.passes)
+        {
+            for (const Access& access : mPasses[passIndex].accesses)
+            {
+                History& history = histories[access.resource];
+                RenderGraphImageState state = getAccessState(access.access);
+                if (isWriteAccess(access.access))
+                {
+                    history.bWritten = true;
+                    history.lastWrite = {accessPosition, state.stageMask, state.accessMask};
+                    history.reads.clear();
+                    history.bTransitioned = false;
+                }
+            }
+        }
+        for (RenderGraphPass passIndex : level.passes)
+        {
+            for (const Access& access : mPasses[passIndex].accesses)
+            {
+                if (!isWriteAccess(access.access))
+                {
+                    histories[access.resource].reads.push_back({accessPosition, getAccessState(access.access).stageMask, 0});
+                }
+            }
+        }
+    }
+
+    // Images sharing memory must never be alive at the same time, and each one has to wait for the previous occupant
+    for (const std::vector<RenderGraphResource>& group : mAliasGroups)
+    {
+        for (size_t i = 0; i < group.size(); i++)
+        {
+            const Resource& resource = mResources[group[i]];
+            if (i > 0 && mResources[group[i - 1]].lastLevel >= resource.firstLevel)
+            {
+                error = mResources[group[i - 1]].name + " and " + resource.name + " share memory while both are alive";
+                return false;
+            }
+            const Resource& predecessor = mResources[resource.aliasPredecessor];
+            bool bFound = false;
+            for (const RenderGraphBarrier& barrier : mLevels[resource.firstLevel].barriers)
+            {
+                if (barrier.resource == group[i])
+                {
+                    bFound = barrier.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && covers(barrier.srcStageMask, predecessor.finalState.stageMask);
+                }
+            }
+            if (!bFound)
+            {
+                error = "First use of " + resource.name + " does not wait for " + predecessor.name + " which used its memory before";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void RenderGraph::bindImage(RenderGraphResource resource, VkImage image)
+{
+    mResources[resource].image = image;
+}
+
+void RenderGraph::execute(VkCommandBuffer commandBuffer, const RenderGraphParallelRecording* parallelRecording)
+{
+    for (const Level& level : mLevels)
+    {
+        if (!level.barriers.empty())
+        {
+            mImageBarriers.clear();
+            for (const RenderGraphBarrier& barrier : level.barriers)
+            {
+                mImageBarriers.push_back(makeImageBarrier(barrier));
+            }
+            VkDependencyInfoKHR dependencyInfo {};
+            dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+            dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(mImageBarriers.size());
+            dependencyInfo.pImageMemoryBarriers = mImageBarriers.data();
+            mCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+        }
+        recordLevel(commandBuffer, level, parallelRecording);
+    }
+}
+
+void RenderGraph::recordLevel(VkCommandBuffer commandBuffer, const Level& level, const RenderGraphParallelRecording* parallelRecording)
+{
+    // Passes of one level are independent, so their order inside the level does not matter
+    mSecondaryPasses.clear();
+    for (RenderGraphPass passIndex : level.passes)
+    {
+        const Pass& pass = mPasses[passIndex];
+        if (!pass.record)
+        {
+            continue;
+        }
+        if (parallelRecording != nullptr && pass.bSecondaryRecordable)
+        {
+            mSecondaryPasses.push_back(passIndex);
+        }
+        else
+        {
+            pass.record(commandBuffer);
+        }
+    }
+    if (mSecondaryPasses.empty())
+    {
+        return;
+    }
+    if (mSecondaryPasses.size() == 1)
+    {
+        mPasses[mSecondaryPasses[0]].record(commandBuffer);
+        return;
+    }
+
+    // Threads outlive the frame, so a parallel level costs no thread creation
+    if (!mWorkerPool)
+    {
+        mWorkerPool = std::make_unique<WorkerPool>();
+    }
+    mSecondaryCommandBuffers.assign(mSecondaryPasses.size(), VK_NULL_HANDLE);
+    mWorkerPool->parallelFor(mSecondaryPasses.size(), [&](size_t i) {
+        VkCommandBufferInheritanceInfo inheritanceInfo {};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        VkCommandBufferBeginInfo beginInfo {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        VkCommandBuffer secondary = parallelRecording->getSecondaryCommandBuffer(mSecondaryPasses[i]);
+        vkBeginCommandBuffer(secondary, &beginInfo);
+        mPasses[mSecondaryPasses[i]].record(secondary);
+        vkEndCommandBuffer(secondary);
+        mSecondaryCommandBuffers[i] = secondary;
+    });
+    vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(mSecondaryCommandBuffers.size()), mSecondaryCommandBuffers.data());
+}
+
+VkImageMemoryBarrier2KHR RenderGraph::makeImageBarrier(const RenderGraphBarrier& barrier) const
+{
+    VkImageMemoryBarrier2KHR imageBarrier {};
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    imageBarrier.srcStageMask = barrier.srcStageMask;
+    imageBarrier.srcAccessMask = barrier.srcAccessMask;
+    imageBarrier.dstStageMask = barrier.dstStageMask;
+    imageBarrier.dstAccessMask = barrier.dstAccessMask;
+    imageBarrier.oldLayout = barrier.oldLayout;
+    imageBarrier.newLayout = barrier.newLayout;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = mResources[barrier.resource].image;
+    imageBarrier.subresourceRange = {mResources[barrier.resource].description.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+    return imageBarrier;
+}
+
+void RenderGraph::recordImageBarrier(VkCommandBuffer commandBuffer,
+                                     VkImage image,
+                                     VkImageAspectFlags aspectMask,
+                                     uint32_t mipLevels,
+                                     const RenderGraphImageState& oldState,
+                                     const RenderGraphImageState& newState) const
+{
+    VkImageMemoryBarrier2KHR imageBarrier {};
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    imageBarrier.srcStageMask = oldState.stageMask;
+    // Only writes need to be made available
+    imageBarrier.srcAccessMask = oldState.accessMask & (VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR
+                                                        | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR);
+    imageBarrier.dstStageMask = newState.stageMask;
+    imageBarrier.dstAccessMask = newState.accessMask;
+    imageBarrier.oldLayout = oldState.layout;
+    imageBarrier.newLayout = newState.layout;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = image;
+    imageBarrier.subresourceRange = {aspectMask, 0, mipLevels, 0, 1};
+
+    VkDependencyInfoKHR dependencyInfo {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependencyInfo.imageMemoryBarrierCount = 1;
+    dependencyInfo.pImageMemoryBarriers = &imageBarrier;
+    mCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
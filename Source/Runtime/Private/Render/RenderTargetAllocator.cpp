@@ -0,0 +1,169 @@
+#include "Render/RenderTargetAllocator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace LearnVulkan;
+
+void RenderTargetAllocator::initialize(const DeviceCapabilities& capabilities,
+                                       VkDevice device,
+                                       const VkAllocationCallbacks* allocator,
+                                       VulkanObjectRegistry* registry,
+                                       DeviceMemoryTracker* memoryTracker)
+{
+    mCapabilities = &capabilities;
+    mDevice = device;
+    mAllocator = allocator;
+    mRegistry = registry;
+    mMemoryTracker = memoryTracker;
+    uint32_t typeIndex;
+    mbLazyAllocationSupported = capabilities.findMemoryType(UINT32_MAX, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, typeIndex);
+}
+
+VkMemoryRequirements RenderTargetAllocator::getMemoryRequirements(const RenderTargetDescription& description) const
+{
+    VkImage image = createUnboundImage(description, false);
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(mDevice, image, &memoryRequirements);
+    vkDestroyImage(mDevice, image, mAllocator);
+    return memoryRequirements;
+}
+
+void RenderTargetAllocator::createImage(const RenderTargetDescription& description, VkImage& image, VkDeviceMemory& memory)
+{
+    bool bLazy = usesLazyAllocation(description);
+    image = createUnboundImage(description, bLazy);
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(mDevice, image, &memoryRequirements);
+    memory = allocate(memoryRequirements, bLazy);
+    mRequestedBytes += memoryRequirements.size;
+    vkBindImageMemory(mDevice, image, memory, 0);
+}
+
+void RenderTargetAllocator::createAliasedImages(const RenderTargetDescription* descriptions, uint32_t count, VkImage* images, VkDeviceMemory* memories)
+{
+    VkMemoryRequirements sharedRequirements {};
+    sharedRequirements.memoryTypeBits = UINT32_MAX;
+    std::vector<VkMemoryRequirements> requirements(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // Lazily allocated memory only backs transient attachments, which cannot alias storage or sampled images
+        images[i] = createUnboundImage(descriptions[i], false);
+        vkGetImageMemoryRequirements(mDevice, images[i], &requirements[i]);
+        sharedRequirements.size = std::max(sharedRequirements.size, requirements[i].size);
+        sharedRequirements.alignment = std::max(sharedRequirements.alignment, requirements[i].alignment);
+        sharedRequirements.memoryTypeBits &= requirements[i].memoryTypeBits;
+        mRequestedBytes += requirements[i].size;
+    }
+
+    // No memory type suits every image, fall back to one allocation each
+    if (sharedRequirements.memoryTypeBits == 0)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            memories[i] = allocate(requirements[i], false);
+            vkBindImageMemory(mDevice, images[i], memories[i], 0);
+        }
+        return;
+    }
+
+    VkDeviceMemory memory = allocate(sharedRequirements, false);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        vkBindImageMemory(mDevice, images[i], memory, 0);
+        memories[i] = i == 0 ? memory : VK_NULL_HANDLE;
+    }
+    mAliasedImageCount += count;
+}
+
+void RenderTargetAllocator::resetStatistics()
+{
+    mAllocations.clear();
+    mRequestedBytes = 0;
+    mAliasedImageCount = 0;
+}
+
+RenderTargetMemoryStatistics RenderTargetAllocator::getStatistics() const
+{
+    RenderTargetMemoryStatistics statistics {};
+    statistics.requestedBytes = mRequestedBytes;
+    statistics.aliasedImageCount = mAliasedImageCount;
+    for (const Allocation& allocation : mAllocations)
+    {
+        statistics.allocatedBytes += allocation.size;
+        if (allocation.bLazy)
+        {
+            VkDeviceSize committedBytes = 0;
+            vkGetDeviceMemoryCommitment(mDevice, allocation.memory, &committedBytes);
+            statistics.committedBytes += committedBytes;
+            statistics.lazyAllocationCount++;
+        }
+        else
+        {
+            statistics.committedBytes += allocation.size;
+        }
+    }
+    return statistics;
+}
+
+VkImage RenderTargetAllocator::createUnboundImage(const RenderTargetDescription& description, bool bLazy) const
+{
+    VkImageCreateInfo imageInfo {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = description.width;
+    imageInfo.extent.height = description.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = description.format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // Lazily allocated memory requires the transient usage bit, which in turn only allows attachment usages
+    imageInfo.usage = bLazy ? (description.usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) : (description.usage & ~VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = description.samples;
+    imageInfo.flags = 0;
+
+    VkImage image;
+    if (vkCreateImage(mDevice, &imageInfo, mAllocator, &image) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create render target image");
+    }
+    return image;
+}
+
+VkDeviceMemory RenderTargetAllocator::allocate(const VkMemoryRequirements& requirements, bool bLazy)
+{
+    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    uint32_t typeIndex = 0;
+    if (!(bLazy && mCapabilities->findMemoryType(requirements.memoryTypeBits, properties | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, typeIndex)))
+    {
+        bLazy = false;
+        if (!mCapabilities->findMemoryType(requirements.memoryTypeBits, properties, typeIndex))
+        {
+            throw std::runtime_error("Failed to find suitable memory type for render target!");
+        }
+    }
+
+    VkMemoryAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = requirements.size;
+    allocInfo.memoryTypeIndex = typeIndex;
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(mDevice, &allocInfo, mAllocator, &memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate render target memory");
+    }
+    mAllocations.push_back({memory, requirements.size, bLazy});
+    if (mRegistry)
+    {
+        mRegistry->add(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)(memory), requirements.size, std::source_location::current());
+    }
+    if (mMemoryTracker)
+    {
+        mMemoryTracker->add(memory, typeIndex, requirements.size, DeviceMemoryCategory::RenderTarget);
+    }
+    return memory;
+}
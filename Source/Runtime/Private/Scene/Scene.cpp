@@ -0,0 +1,390 @@
+#include "Scene/Scene.hpp"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // Slots a thread claims at a time, large enough that neighbouring chunks rarely share a cache line
+    const uint32_t TRANSFORM_CHUNK_SIZE = 2048;
+    // Below this many slots per thread, waking threads costs more than it saves
+    const uint32_t MIN_SLOTS_PER_THREAD = 16384;
+
+    glm::mat4 composeTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        glm::mat3 rotationMatrix = glm::mat3_cast(rotation);
+        return glm::mat4(glm::vec4(rotationMatrix[0] * scale.x, 0.0f), glm::vec4(rotationMatrix[1] * scale.y, 0.0f), glm::vec4(rotationMatrix[2] * scale.z, 0.0f),
+                         glm::vec4(position, 1.0f));
+    }
+
+    template<typename T>
+    void permute(std::vector<T>& values, const std::vector<uint32_t>& order)
+    {
+        std::vector<T> permuted(values.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            permuted[i] = values[order[i]];
+        }
+        values.swap(permuted);
+    }
+}  // namespace
+
+Entity Scene::createEntity(Entity parent)
+{
+    uint32_t parentIndex = NO_INDEX;
+    if (parent != NULL_ENTITY)
+    {
+        if (!isAlive(parent))
+        {
+            throw std::runtime_error("Parent entity has been destroyed!");
+        }
+        parentIndex = parent.index;
+    }
+
+    Entity entity;
+    if (!mFreeIndices.empty())
+    {
+        entity.index = mFreeIndices.back();
+        mFreeIndices.pop_back();
+    }
+    else
+    {
+        entity.index = static_cast<uint32_t>(mGenerations.size());
+        mGenerations.push_back(0);
+        mTransformSlots.push_back(NO_INDEX);
+    }
+    entity.generation = mGenerations[entity.index];
+
+    // Appended out of order, the next update sorts it into its level
+    mTransformSlots[entity.index] = static_cast<uint32_t>(mSlotEntities.size());
+    mSlotEntities.push_back(entity.index);
+    mParents.push_back(parentIndex);
+    mPositions.push_back(glm::vec3(0.0f));
+    mRotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    mScales.push_back(glm::vec3(1.0f));
+    mWorldMatrices.push_back(glm::mat4(1.0f));
+    mDirtyFlags.push_back(1);
+    mChangedFlags.push_back(0);
+    mbHierarchyChanged = true;
+    mbAnyDirty = true;
+    return entity;
+}
+
+void Scene::destroyEntity(Entity entity)
+{
+    if (!isAlive(entity))
+    {
+        return;
+    }
+    // The hierarchy may be unsorted, so descendants are found by sweeping until no more are marked
+    std::vector<uint8_t> bRemoved(mSlotEntities.size(), 0);
+    bRemoved[getSlot(entity)] = 1;
+    bool bMarked = true;
+    while (bMarked)
+    {
+        bMarked = false;
+        for (size_t slot = 0; slot < mSlotEntities.size(); slot++)
+        {
+            if (!bRemoved[slot] && mParents[slot] != NO_INDEX && bRemoved[mTransformSlots[mParents[slot]]])
+            {
+                bRemoved[slot] = 1;
+                bMarked = true;
+            }
+        }
+    }
+
+    // From the back, so the slot moved into a hole is never one still to be removed
+    for (size_t i = mSlotEntities.size(); i-- > 0;)
+    {
+        if (!bRemoved[i])
+        {
+            continue;
+        }
+        uint32_t slot = static_cast<uint32_t>(i);
+        uint32_t index = mSlotEntities[slot];
+        uint32_t last = static_cast<uint32_t>(mSlotEntities.size()) - 1;
+        mSlotEntities[slot] = mSlotEntities[last];
+        mParents[slot] = mParents[last];
+        mPositions[slot] = mPositions[last];
+        mRotations[slot] = mRotations[last];
+        mScales[slot] = mScales[last];
+        mWorldMatrices[slot] = mWorldMatrices[last];
+        mDirtyFlags[slot] = mDirtyFlags[last];
+        mTransformSlots[mSlotEntities[slot]] = slot;
+        mSlotEntities.pop_back();
+        mParents.pop_back();
+        mPositions.pop_back();
+        mRotations.pop_back();
+        mScales.pop_back();
+        mWorldMatrices.pop_back();
+        mDirtyFlags.pop_back();
+        mChangedFlags.pop_back();
+
+        mTransformSlots[index] = NO_INDEX;
+        mGenerations[index]++;
+        mFreeIndices.push_back(index);
+        mMeshes.remove(index);
+        mMaterials.remove(index);
+        mBounds.remove(index);
+    }
+    mbHierarchyChanged = true;
+}
+
+bool Scene::isAlive(Entity entity) const
+{
+    return entity.index < mGenerations.size() && mGenerations[entity.index] == entity.generation && mTransformSlots[entity.index] != NO_INDEX;
+}
+
+size_t Scene::getEntityCount() const
+{
+    return mSlotEntities.size();
+}
+
+void Scene::setParent(Entity entity, Entity parent)
+{
+    uint32_t slot = getSlot(entity);
+    uint32_t parentIndex = NO_INDEX;
+    if (parent != NULL_ENTITY)
+    {
+        if (!isAlive(parent))
+        {
+            throw std::runtime_error("Parent entity has been destroyed!");
+        }
+        for (uint32_t ancestor = parent.index; ancestor != NO_INDEX; ancestor = mParents[getSlot({ancestor, mGenerations[ancestor]})])
+        {
+            if (ancestor == entity.index)
+            {
+                throw std::runtime_error("An entity cannot be parented to itself or one of its descendants!");
+            }
+        }
+        parentIndex = parent.index;
+    }
+    mParents[slot] = parentIndex;
+    mDirtyFlags[slot] = 1;
+    mbHierarchyChanged = true;
+    mbAnyDirty = true;
+}
+
+Entity Scene::getParent(Entity entity) const
+{
+    uint32_t parentIndex = mParents[getSlot(entity)];
+    return parentIndex == NO_INDEX ? NULL_ENTITY : Entity {parentIndex, mGenerations[parentIndex]};
+}
+
+void Scene::setLocalTransform(Entity entity, const Transform& transform)
+{
+    uint32_t slot = getSlot(entity);
+    mPositions[slot] = transform.position;
+    mRotations[slot] = transform.rotation;
+    mScales[slot] = transform.scale;
+    mDirtyFlags[slot] = 1;
+    mbAnyDirty = true;
+}
+
+Transform Scene::getLocalTransform(Entity entity) const
+{
+    uint32_t slot = getSlot(entity);
+    return {mPositions[slot], mRotations[slot], mScales[slot]};
+}
+
+const glm::mat4& Scene::getWorldMatrix(Entity entity) const
+{
+    return mWorldMatrices[getSlot(entity)];
+}
+
+void Scene::setLocalBounds(Entity entity, const BoundingSphere& bounds)
+{
+    uint32_t slot = getSlot(entity);
+    mBounds.add(entity.index, {bounds, bounds});
+    mDirtyFlags[slot] = 1;
+    mbAnyDirty = true;
+}
+
+void Scene::updateTransforms(uint32_t threadCount)
+{
+    auto begin = std::chrono::high_resolution_clock::now();
+    mChangedEntities.clear();
+    mUpdateStatistics = {};
+    if (mbHierarchyChanged)
+    {
+        sortHierarchy();
+        mbHierarchyChanged = false;
+    }
+    uint32_t levelCount = mLevelOffsets.empty() ? 0 : static_cast<uint32_t>(mLevelOffsets.size()) - 1;
+    mUpdateStatistics.levelCount = levelCount;
+    if (!mbAnyDirty)
+    {
+        return;
+    }
+
+    uint32_t slotCount = static_cast<uint32_t>(mSlotEntities.size());
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    uint32_t workerCount = std::clamp(slotCount / MIN_SLOTS_PER_THREAD, 1u, threadCount);
+
+    // Threads claim chunks of a level, then wait for each other before the next level reads its results.
+    // A single thread needs no barrier, and skipping it keeps small scenes from allocating every update.
+    for (std::atomic<uint32_t>& cursor : mLevelCursors)
+    {
+        cursor.store(0, std::memory_order_relaxed);
+    }
+    std::atomic<uint32_t> updatedCount = 0;
+    std::optional<std::barrier<>> levelBarrier;
+    if (workerCount > 1)
+    {
+        levelBarrier.emplace(workerCount);
+    }
+    auto worker = [&]() {
+        uint32_t updated = 0;
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            uint32_t levelBegin = mLevelOffsets[level];
+            uint32_t levelEnd = mLevelOffsets[level + 1];
+            for (uint32_t first = levelBegin + mLevelCursors[level].fetch_add(TRANSFORM_CHUNK_SIZE); first < levelEnd;
+                 first = levelBegin + mLevelCursors[level].fetch_add(TRANSFORM_CHUNK_SIZE))
+            {
+                updated += updateTransformRange(first, std::min(first + TRANSFORM_CHUNK_SIZE, levelEnd));
+            }
+            if (workerCount > 1)
+            {
+                levelBarrier->arrive_and_wait();
+            }
+        }
+        updatedCount += updated;
+    };
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < workerCount; i++)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers)
+    {
+        thread.join();
+    }
+    mbAnyDirty = false;
+
+    for (uint32_t slot = 0; slot < slotCount; slot++)
+    {
+        if (!mChangedFlags[slot])
+        {
+            continue;
+        }
+        uint32_t index = mSlotEntities[slot];
+        mChangedEntities.push_back({index, mGenerations[index]});
+        if (mBounds.contains(index))
+        {
+            Bounds& bounds = mBounds.get(index);
+            const glm::mat4& world = mWorldMatrices[slot];
+            float scale = std::max({glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))});
+            bounds.world.center = glm::vec3(world * glm::vec4(bounds.local.center, 1.0f));
+            bounds.world.radius = bounds.local.radius * scale;
+        }
+    }
+
+    mUpdateStatistics.updatedTransformCount = updatedCount;
+    mUpdateStatistics.threadCount = workerCount;
+    mUpdateStatistics.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+}
+
+uint32_t Scene::getSlot(Entity entity) const
+{
+    if (!isAlive(entity))
+    {
+        throw std::runtime_error("Entity has been destroyed!");
+    }
+    return mTransformSlots[entity.index];
+}
+
+// Counting sort of the slots by depth, stable so siblings keep their relative order
+void Scene::sortHierarchy()
+{
+    uint32_t slotCount = static_cast<uint32_t>(mSlotEntities.size());
+    std::vector<uint32_t> depths(slotCount, NO_INDEX);
+    std::vector<uint32_t> chain;
+    uint32_t maxDepth = 0;
+    for (uint32_t slot = 0; slot < slotCount; slot++)
+    {
+        // Walk up to the first ancestor of known depth, then assign depths on the way back down
+        uint32_t current = slot;
+        while (depths[current] == NO_INDEX && mParents[current] != NO_INDEX)
+        {
+            chain.push_back(current);
+            current = mTransformSlots[mParents[current]];
+        }
+        if (depths[current] == NO_INDEX)
+        {
+            depths[current] = 0;
+        }
+        for (uint32_t depth = depths[current]; !chain.empty(); chain.pop_back())
+        {
+            depths[chain.back()] = ++depth;
+        }
+        maxDepth = std::max(maxDepth, depths[slot]);
+    }
+
+    mLevelOffsets.assign(slotCount > 0 ? maxDepth + 2 : 1, 0);
+    for (uint32_t slot = 0; slot < slotCount; slot++)
+    {
+        mLevelOffsets[depths[slot] + 1]++;
+    }
+    for (size_t level = 1; level < mLevelOffsets.size(); level++)
+    {
+        mLevelOffsets[level] += mLevelOffsets[level - 1];
+    }
+    mLevelCursors = std::vector<std::atomic<uint32_t>>(mLevelOffsets.size() - 1);
+    std::vector<uint32_t> order(slotCount);
+    std::vector<uint32_t> cursors(mLevelOffsets.begin(), mLevelOffsets.end() - 1);
+    for (uint32_t slot = 0; slot < slotCount; slot++)
+    {
+        order[cursors[depths[slot]]++] = slot;
+    }
+
+    permute(mSlotEntities, order);
+    permute(mParents, order);
+    permute(mPositions, order);
+    permute(mRotations, order);
+    permute(mScales, order);
+    permute(mWorldMatrices, order);
+    permute(mDirtyFlags, order);
+    mChangedFlags.assign(slotCount, 0);
+    mParentSlots.resize(slotCount);
+    for (uint32_t slot = 0; slot < slotCount; slot++)
+    {
+        mTransformSlots[mSlotEntities[slot]] = slot;
+    }
+    for (uint32_t slot = 0; slot < slotCount; slot++)
+    {
+        mParentSlots[slot] = mParents[slot] == NO_INDEX ? NO_INDEX : mTransformSlots[mParents[slot]];
+    }
+}
+
+// Parents are in an earlier level, so their flags and matrices are final by the time a level runs
+uint32_t Scene::updateTransformRange(uint32_t firstSlot, uint32_t endSlot)
+{
+    uint32_t updated = 0;
+    for (uint32_t slot = firstSlot; slot < endSlot; slot++)
+    {
+        uint32_t parentSlot = mParentSlots[slot];
+        bool bParentChanged = parentSlot != NO_INDEX && mChangedFlags[parentSlot];
+        if (!mDirtyFlags[slot] && !bParentChanged)
+        {
+            mChangedFlags[slot] = 0;
+            continue;
+        }
+        glm::mat4 local = composeTransform(mPositions[slot], mRotations[slot], mScales[slot]);
+        mWorldMatrices[slot] = parentSlot != NO_INDEX ? mWorldMatrices[parentSlot] * local : local;
+        mDirtyFlags[slot] = 0;
+        mChangedFlags[slot] = 1;
+        updated++;
+    }
+    return updated;
+}
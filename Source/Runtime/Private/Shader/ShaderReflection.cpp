@@ -0,0 +1,65 @@
+#include "Shader/ShaderReflection.hpp"
+#include <stdexcept>
+#include <string>
+
+using namespace LearnVulkan;
+
+uint32_t ShaderReflection::getVertexAttributeDescriptions(uint32_t binding, std::vector<VkVertexInputAttributeDescription>& attributeDescriptions) const
+{
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < vertexInputCount; i++)
+    {
+        VkVertexInputAttributeDescription attributeDescription {};
+        attributeDescription.binding = binding;
+        attributeDescription.location = vertexInputs[i].location;
+        attributeDescription.format = vertexInputs[i].format;
+        attributeDescription.offset = offset;
+        attributeDescriptions.push_back(attributeDescription);
+        offset += vertexInputs[i].size;
+    }
+    return offset;
+}
+
+void ShaderReflection::collectDescriptorSetLayoutBindings(uint32_t set, std::vector<VkDescriptorSetLayoutBinding>& layoutBindings) const
+{
+    for (uint32_t i = 0; i < descriptorBindingCount; i++)
+    {
+        const ShaderDescriptorBinding& descriptorBinding = descriptorBindings[i];
+        if (descriptorBinding.set != set)
+        {
+            continue;
+        }
+
+        bool bMerged = false;
+        for (VkDescriptorSetLayoutBinding& layoutBinding : layoutBindings)
+        {
+            if (layoutBinding.binding != descriptorBinding.binding)
+            {
+                continue;
+            }
+            if (layoutBinding.descriptorType != descriptorBinding.descriptorType || layoutBinding.descriptorCount != descriptorBinding.descriptorCount)
+            {
+                throw std::runtime_error(std::string("Conflicting declaration of set ") + std::to_string(set) + " binding " + std::to_string(descriptorBinding.binding) + " in " + sourceName);
+            }
+            layoutBinding.stageFlags |= stage;
+            bMerged = true;
+            break;
+        }
+        if (bMerged)
+        {
+            continue;
+        }
+
+        if (descriptorBinding.descriptorCount == 0)
+        {
+            throw std::runtime_error(std::string("Runtime sized descriptor arrays belong to the bindless table, found one in ") + sourceName);
+        }
+        VkDescriptorSetLayoutBinding layoutBinding {};
+        layoutBinding.binding = descriptorBinding.binding;
+        layoutBinding.descriptorType = descriptorBinding.descriptorType;
+        layoutBinding.descriptorCount = descriptorBinding.descriptorCount;
+        layoutBinding.stageFlags = stage;
+        layoutBinding.pImmutableSamplers = nullptr;
+        layoutBindings.push_back(layoutBinding);
+    }
+}
@@ -0,0 +1,169 @@
+#include "Task/TaskGraph.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+
+using namespace LearnVulkan;
+
+TaskId TaskGraph::addTask(const char* name, std::function<void()> function, const std::vector<TaskId>& dependencies)
+{
+    TaskId id = static_cast<TaskId>(mTasks.size());
+    for (TaskId dependency : dependencies)
+    {
+        if (dependency >= id)
+        {
+            throw std::invalid_argument(std::string("Task ") + name + " depends on a task that was not added yet");
+        }
+        mTasks[dependency].dependents.push_back(id);
+    }
+    Task& task = mTasks.emplace_back();
+    task.name = name;
+    task.function = std::move(function);
+    task.dependencies = dependencies;
+    return id;
+}
+
+void TaskGraph::execute(uint32_t threadCount)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    mThreadCount = static_cast<uint32_t>(std::clamp<size_t>(threadCount, 1, std::max<size_t>(mTasks.size(), 1)));
+
+    std::vector<uint32_t> remainingDependencies(mTasks.size());
+    std::priority_queue<TaskId, std::vector<TaskId>, std::greater<TaskId>> readyTasks;
+    for (TaskId id = 0; id < mTasks.size(); id++)
+    {
+        remainingDependencies[id] = static_cast<uint32_t>(mTasks[id].dependencies.size());
+        if (remainingDependencies[id] == 0)
+        {
+            readyTasks.push(id);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable taskFinished;
+    size_t finishedCount = 0;
+    std::exception_ptr failure;
+    Clock::time_point startTime = Clock::now();
+
+    auto run = [&](uint32_t threadIndex) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            taskFinished.wait(lock, [&] { return !readyTasks.empty() || finishedCount == mTasks.size() || failure; });
+            if (finishedCount == mTasks.size() || failure)
+            {
+                return;
+            }
+            TaskId id = readyTasks.top();
+            readyTasks.pop();
+            Task& task = mTasks[id];
+            lock.unlock();
+
+            Clock::time_point taskStart = Clock::now();
+            std::exception_ptr taskFailure;
+            try
+            {
+                task.function();
+            }
+            catch (...)
+            {
+                taskFailure = std::current_exception();
+            }
+            Clock::time_point taskEnd = Clock::now();
+
+            lock.lock();
+            task.startMilliseconds = std::chrono::duration<double, std::milli>(taskStart - startTime).count();
+            task.milliseconds = std::chrono::duration<double, std::milli>(taskEnd - taskStart).count();
+            task.threadIndex = threadIndex;
+            finishedCount++;
+            if (taskFailure && !failure)
+            {
+                failure = taskFailure;
+            }
+            for (TaskId dependent : task.dependents)
+            {
+                if (--remainingDependencies[dependent] == 0)
+                {
+                    readyTasks.push(dependent);
+                }
+            }
+            taskFinished.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < mThreadCount; i++)
+    {
+        workers.emplace_back(run, i);
+    }
+    run(0);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    mWallMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+}
+
+void TaskGraph::printReport(const char* title) const
+{
+    // Ids are a topological order, so every dependency's path is final before its dependents look at it
+    std::vector<double> pathMilliseconds(mTasks.size(), 0.0);
+    std::vector<TaskId> pathPredecessors(mTasks.size(), UINT32_MAX);
+    double taskMilliseconds = 0.0;
+    TaskId pathEnd = UINT32_MAX;
+    for (TaskId id = 0; id < mTasks.size(); id++)
+    {
+        for (TaskId dependency : mTasks[id].dependencies)
+        {
+            if (pathMilliseconds[dependency] > pathMilliseconds[id])
+            {
+                pathMilliseconds[id] = pathMilliseconds[dependency];
+                pathPredecessors[id] = dependency;
+            }
+        }
+        pathMilliseconds[id] += mTasks[id].milliseconds;
+        taskMilliseconds += mTasks[id].milliseconds;
+        if (pathEnd == UINT32_MAX || pathMilliseconds[id] > pathMilliseconds[pathEnd])
+        {
+            pathEnd = id;
+        }
+    }
+
+    std::cout << title << ": " << mWallMilliseconds << " ms on " << mThreadCount << " threads, " << taskMilliseconds << " ms of tasks in " << mTasks.size() << " steps" << std::endl;
+    for (const Task& task : mTasks)
+    {
+        std::cout << "  " << task.name << ": " << task.milliseconds << " ms, started at " << task.startMilliseconds << " ms on thread " << task.threadIndex << std::endl;
+    }
+    if (pathEnd == UINT32_MAX)
+    {
+        return;
+    }
+
+    std::vector<TaskId> path;
+    for (TaskId id = pathEnd; id != UINT32_MAX; id = pathPredecessors[id])
+    {
+        path.push_back(id);
+    }
+    std::cout << "  Critical path " << pathMilliseconds[pathEnd] << " ms:";
+    for (auto it = path.rbegin(); it != path.rend(); it++)
+    {
+        std::cout << (it == path.rbegin() ? " " : " -> ") << mTasks[*it].name << " (" << mTasks[*it].milliseconds << " ms)";
+    }
+    std::cout << std::endl;
+}
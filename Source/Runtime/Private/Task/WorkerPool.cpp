@@ -0,0 +1,88 @@
+#include "Task/WorkerPool.hpp"
+#include <algorithm>
+
+using namespace LearnVulkan;
+
+WorkerPool::WorkerPool(uint32_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+    mWorkers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        mWorkers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mbStopping = true;
+    }
+    mLoopStarted.notify_all();
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+void WorkerPool::run(size_t count, InvokeFunction invoke, void* context)
+{
+    // Waking workers costs more than a single call
+    if (mWorkers.empty() || count <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            invoke(context, i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mInvoke = invoke;
+        mContext = context;
+        mCount = count;
+        mNextIndex = 0;
+        mBusyCount = static_cast<uint32_t>(mWorkers.size());
+        mGeneration++;
+    }
+    mLoopStarted.notify_all();
+    runItems();
+    // Workers that woke late still have to see the loop is done before its function goes out of scope
+    std::unique_lock<std::mutex> lock(mMutex);
+    mLoopFinished.wait(lock, [this]() { return mBusyCount == 0; });
+}
+
+void WorkerPool::runItems()
+{
+    for (size_t i = mNextIndex++; i < mCount; i = mNextIndex++)
+    {
+        mInvoke(mContext, i);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mLoopStarted.wait(lock, [&]() { return mbStopping || mGeneration != generation; });
+            if (mbStopping)
+            {
+                return;
+            }
+            generation = mGeneration;
+        }
+        runItems();
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (--mBusyCount == 0)
+        {
+            mLoopFinished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#include "Time/FrameLimiter.hpp"
+#include <algorithm>
+#include <thread>
+
+using namespace LearnVulkan;
+
+void FrameLimiter::setTargetFrameRate(uint32_t framesPerSecond)
+{
+    if (framesPerSecond == 0)
+    {
+        mFramePeriod = Clock::duration::zero();
+        return;
+    }
+    mFramePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond));
+    mNextDeadline = Clock::now() + mFramePeriod;
+}
+
+void FrameLimiter::wait()
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    Clock::time_point now = Clock::now();
+    // Fell behind by more than a frame, don't try to catch up with a burst of unthrottled frames
+    if (now > mNextDeadline + mFramePeriod)
+    {
+        mNextDeadline = now;
+    }
+
+    Clock::duration remaining = mNextDeadline - now;
+    if (remaining > SPIN_THRESHOLD)
+    {
+        std::this_thread::sleep_for(remaining - SPIN_THRESHOLD);
+    }
+    while (Clock::now() < mNextDeadline)
+    {
+        std::this_thread::yield();
+    }
+
+    mNextDeadline += mFramePeriod;
+}
+
+void FrameLimiter::markFrame()
+{
+    Clock::time_point now = Clock::now();
+    if (!mbHasLastFrame)
+    {
+        mLastFrame = now;
+        mbHasLastFrame = true;
+        return;
+    }
+
+    double frameMilliseconds = std::chrono::duration<double, std::milli>(now - mLastFrame).count();
+    mLastFrame = now;
+
+    mStatistics.frameCount++;
+    if (mStatistics.frameCount == 1)
+    {
+        mStatistics.minMilliseconds = frameMilliseconds;
+        mStatistics.maxMilliseconds = frameMilliseconds;
+    }
+    else
+    {
+        mStatistics.minMilliseconds = std::min(mStatistics.minMilliseconds, frameMilliseconds);
+        mStatistics.maxMilliseconds = std::max(mStatistics.maxMilliseconds, frameMilliseconds);
+    }
+    double delta = frameMilliseconds - mStatistics.meanMilliseconds;
+    mStatistics.meanMilliseconds += delta / static_cast<double>(mStatistics.frameCount);
+    mSquaredDeviationSum += delta * (frameMilliseconds - mStatistics.meanMilliseconds);
+    mStatistics.varianceMilliseconds2 = mSquaredDeviationSum / static_cast<double>(mStatistics.frameCount);
+}
+
+void FrameLimiter::resetStatistics()
+{
+    mStatistics = {};
+    mSquaredDeviationSum = 0.0;
+    mbHasLastFrame = false;
+}
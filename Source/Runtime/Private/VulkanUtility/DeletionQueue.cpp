@@ -0,0 +1,197 @@
+#include "VulkanUtility/DeletionQueue.hpp"
+#include <iostream>
+
+using namespace LearnVulkan;
+
+// Non-dispatchable handles are pointers on 64-bit platforms and uint64_t elsewhere, a C-style cast handles both
+#define TO_HANDLE(handle) ((uint64_t)(handle))
+#define FROM_HANDLE(type, handle) ((type)(handle))
+
+DeletionQueue::~DeletionQueue()
+{
+    if (getPendingCount() != 0)
+    {
+        std::cerr << "DeletionQueue destroyed with " << getPendingCount() << " pending objects, they are leaked!" << std::endl;
+    }
+}
+
+void DeletionQueue::initialize(const VulkanDeviceContext& context)
+{
+    mDevice = context.device;
+    mAllocator = context.allocator;
+    mRegistry = context.registry;
+    mMemoryTracker = context.memoryTracker;
+}
+
+void DeletionQueue::retireBuffer(UniqueBuffer&& buffer, UniqueDeviceMemory&& memory, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_BUFFER>(TO_HANDLE(buffer.release()), TO_HANDLE(memory.release()), frameIndex);
+}
+
+void DeletionQueue::retireImage(UniqueImage&& image, UniqueDeviceMemory&& memory, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_IMAGE>(TO_HANDLE(image.release()), TO_HANDLE(memory.release()), frameIndex);
+}
+
+void DeletionQueue::retireImageView(UniqueImageView&& imageView, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_IMAGE_VIEW>(TO_HANDLE(imageView.release()), 0, frameIndex);
+}
+
+void DeletionQueue::retireSampler(UniqueSampler&& sampler, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_SAMPLER>(TO_HANDLE(sampler.release()), 0, frameIndex);
+}
+
+void DeletionQueue::retireFramebuffer(UniqueFramebuffer&& framebuffer, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_FRAMEBUFFER>(TO_HANDLE(framebuffer.release()), 0, frameIndex);
+}
+
+void DeletionQueue::retireRenderPass(UniqueRenderPass&& renderPass, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_RENDER_PASS>(TO_HANDLE(renderPass.release()), 0, frameIndex);
+}
+
+void DeletionQueue::retirePipeline(UniquePipeline&& pipeline, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_PIPELINE>(TO_HANDLE(pipeline.release()), 0, frameIndex);
+}
+
+void DeletionQueue::retirePipelineLayout(UniquePipelineLayout&& pipelineLayout, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_PIPELINE_LAYOUT>(TO_HANDLE(pipelineLayout.release()), 0, frameIndex);
+}
+
+void DeletionQueue::retireDescriptorPool(UniqueDescriptorPool&& descriptorPool, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_DESCRIPTOR_POOL>(TO_HANDLE(descriptorPool.release()), 0, frameIndex);
+}
+
+void DeletionQueue::retireDescriptorSet(VkDescriptorSet descriptorSet, VkDescriptorPool descriptorPool, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_DESCRIPTOR_SET>(TO_HANDLE(descriptorSet), TO_HANDLE(descriptorPool), frameIndex);
+}
+
+void DeletionQueue::retireSwapchain(VkSwapchainKHR swapchain, uint64_t frameIndex)
+{
+    retire<VK_OBJECT_TYPE_SWAPCHAIN_KHR>(TO_HANDLE(swapchain), 0, frameIndex);
+}
+
+void DeletionQueue::retireCallback(std::function<void()> callback, uint64_t frameIndex)
+{
+    mRetiredCallbacks.emplace_back(frameIndex, std::move(callback));
+    mRetiredCount++;
+}
+
+void DeletionQueue::collect(uint64_t completedFrameIndex)
+{
+    while (!mRetiredObjects.empty() && mRetiredObjects.front().frameIndex <= completedFrameIndex)
+    {
+        destroy(mRetiredObjects.front());
+        mRetiredObjects.pop_front();
+    }
+    while (!mRetiredCallbacks.empty() && mRetiredCallbacks.front().first <= completedFrameIndex)
+    {
+        mRetiredCallbacks.front().second();
+        mRetiredCallbacks.pop_front();
+        mDestroyedCount++;
+    }
+}
+
+void DeletionQueue::flush()
+{
+    for (const RetiredObject& object : mRetiredObjects)
+    {
+        destroy(object);
+    }
+    mRetiredObjects.clear();
+    for (auto& [frameIndex, callback] : mRetiredCallbacks)
+    {
+        callback();
+        mDestroyedCount++;
+    }
+    mRetiredCallbacks.clear();
+}
+
+void DeletionQueue::retire(VkObjectType type, uint64_t handle, uint64_t auxiliaryHandle, uint64_t frameIndex)
+{
+    if (handle == 0)
+    {
+        return;
+    }
+    mRetiredObjects.push_back({type, handle, auxiliaryHandle, frameIndex});
+    mRetiredCount++;
+}
+
+void DeletionQueue::destroy(const RetiredObject& object)
+{
+    if (!mDestroyFunction(mDevice, object.type, object.handle, object.auxiliaryHandle, mAllocator))
+    {
+        std::cerr << "DeletionQueue failed to destroy object of type " << object.type << ", it is leaked!" << std::endl;
+        mLeakedCount++;
+        return;
+    }
+    if (mRegistry)
+    {
+        mRegistry->remove(object.type, object.handle);
+        if (object.type == VK_OBJECT_TYPE_BUFFER || object.type == VK_OBJECT_TYPE_IMAGE)
+        {
+            mRegistry->remove(VK_OBJECT_TYPE_DEVICE_MEMORY, object.auxiliaryHandle);
+        }
+    }
+    if (mMemoryTracker && (object.type == VK_OBJECT_TYPE_BUFFER || object.type == VK_OBJECT_TYPE_IMAGE))
+    {
+        mMemoryTracker->remove(object.auxiliaryHandle);
+    }
+    mDestroyedCount++;
+}
+
+bool DeletionQueue::destroyVulkanObject(VkDevice device, VkObjectType type, uint64_t handle, uint64_t auxiliaryHandle, const VkAllocationCallbacks* allocator)
+{
+    switch (type)
+    {
+        case VK_OBJECT_TYPE_BUFFER:
+            vkDestroyBuffer(device, FROM_HANDLE(VkBuffer, handle), allocator);
+            vkFreeMemory(device, FROM_HANDLE(VkDeviceMemory, auxiliaryHandle), allocator);
+            break;
+        case VK_OBJECT_TYPE_IMAGE:
+            vkDestroyImage(device, FROM_HANDLE(VkImage, handle), allocator);
+            vkFreeMemory(device, FROM_HANDLE(VkDeviceMemory, auxiliaryHandle), allocator);
+            break;
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+            vkDestroyImageView(device, FROM_HANDLE(VkImageView, handle), allocator);
+            break;
+        case VK_OBJECT_TYPE_SAMPLER:
+            vkDestroySampler(device, FROM_HANDLE(VkSampler, handle), allocator);
+            break;
+        case VK_OBJECT_TYPE_FRAMEBUFFER:
+            vkDestroyFramebuffer(device, FROM_HANDLE(VkFramebuffer, handle), allocator);
+            break;
+        case VK_OBJECT_TYPE_RENDER_PASS:
+            vkDestroyRenderPass(device, FROM_HANDLE(VkRenderPass, handle), allocator);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE:
+            vkDestroyPipeline(device, FROM_HANDLE(VkPipeline, handle), allocator);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+            vkDestroyPipelineLayout(device, FROM_HANDLE(VkPipelineLayout, handle), allocator);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+            vkDestroyDescriptorPool(device, FROM_HANDLE(VkDescriptorPool, handle), allocator);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET:
+        {
+            VkDescriptorSet descriptorSet = FROM_HANDLE(VkDescriptorSet, handle);
+            vkFreeDescriptorSets(device, FROM_HANDLE(VkDescriptorPool, auxiliaryHandle), 1, &descriptorSet);
+            break;
+        }
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+            vkDestroySwapchainKHR(device, FROM_HANDLE(VkSwapchainKHR, handle), allocator);
+            break;
+        default:
+            // Unreachable through the retire functions, canDestroy lists the cases above
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+#include "VulkanUtility/DeviceCapabilities.hpp"
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // Last of the contiguous core formats, the ones added by extensions and later versions have sparse values
+    const VkFormat LAST_CORE_FORMAT = VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+}  // namespace
+
+void DeviceCapabilities::query(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface)
+{
+    mPhysicalDevice = physicalDevice;
+    vkGetPhysicalDeviceProperties(physicalDevice, &mProperties);
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &mMemoryProperties);
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+    mExtensions.clear();
+    mExtensions.reserve(extensionCount);
+    for (const VkExtensionProperties& extension : extensions)
+    {
+        mExtensions.insert(extension.extensionName);
+    }
+
+    // Extension structures are only chained when the device knows them
+    mDescriptorIndexingFeatures = {};
+    mDescriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    mSynchronization2Features = {};
+    mSynchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+    mDynamicRenderingFeatures = {};
+    mDynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2 features {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &mDescriptorIndexingFeatures;
+    void** next = &mDescriptorIndexingFeatures.pNext;
+    if (hasExtension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+    {
+        *next = &mSynchronization2Features;
+        next = &mSynchronization2Features.pNext;
+    }
+    if (hasExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+    {
+        *next = &mDynamicRenderingFeatures;
+        next = &mDynamicRenderingFeatures.pNext;
+    }
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+    mFeatures = features.features;
+    // The chain points into this object, don't leave dangling pointers behind when it is copied
+    mDescriptorIndexingFeatures.pNext = nullptr;
+    mSynchronization2Features.pNext = nullptr;
+    mDynamicRenderingFeatures.pNext = nullptr;
+
+    mDescriptorIndexingProperties = {};
+    mDescriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &mDescriptorIndexingProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    mQueueFamilies.resize(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, mQueueFamilies.data());
+    mPresentSupport.assign(queueFamilyCount, false);
+    for (uint32_t i = 0; i < queueFamilyCount; i++)
+    {
+        VkBool32 bPresentSupport = VK_FALSE;
+        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &bPresentSupport);
+        mPresentSupport[i] = bPresentSupport == VK_TRUE;
+    }
+
+    mFormatProperties.resize(static_cast<size_t>(LAST_CORE_FORMAT) + 1);
+    for (size_t format = 0; format < mFormatProperties.size(); format++)
+    {
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, static_cast<VkFormat>(format), &mFormatProperties[format]);
+    }
+}
+
+VkFormatProperties DeviceCapabilities::getFormatProperties(VkFormat format) const
+{
+    if (format >= 0 && static_cast<size_t>(format) < mFormatProperties.size())
+    {
+        return mFormatProperties[format];
+    }
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, format, &formatProperties);
+    return formatProperties;
+}
+
+bool DeviceCapabilities::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex) const
+{
+    for (uint32_t i = 0; i < mMemoryProperties.memoryTypeCount; i++)
+    {
+        if ((typeFilter & (1 << i)) && ((mMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties))
+        {
+            typeIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
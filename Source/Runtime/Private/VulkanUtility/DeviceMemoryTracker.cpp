@@ -0,0 +1,207 @@
+#include "VulkanUtility/DeviceMemoryTracker.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    double toMebibytes(uint64_t bytes)
+    {
+        return bytes / (1024.0 * 1024.0);
+    }
+}  // namespace
+
+const char* LearnVulkan::getDeviceMemoryCategoryName(DeviceMemoryCategory category)
+{
+    switch (category)
+    {
+        case DeviceMemoryCategory::Vertex: return "Vertex";
+        case DeviceMemoryCategory::Index: return "Index";
+        case DeviceMemoryCategory::Uniform: return "Uniform";
+        case DeviceMemoryCategory::Storage: return "Storage";
+        case DeviceMemoryCategory::Texture: return "Texture";
+        case DeviceMemoryCategory::RenderTarget: return "Render target";
+        case DeviceMemoryCategory::Staging: return "Staging";
+        default: return "Unknown";
+    }
+}
+
+void DeviceMemoryTracker::initialize(const DeviceCapabilities& capabilities, bool bMemoryBudget)
+{
+    mCapabilities = &capabilities;
+    mbMemoryBudget = bMemoryBudget;
+    const VkPhysicalDeviceMemoryProperties& memoryProperties = capabilities.getMemoryProperties();
+    mHeapCount = memoryProperties.memoryHeapCount;
+    for (uint32_t i = 0; i < mHeapCount; i++)
+    {
+        mHeapBudgets[i] = memoryProperties.memoryHeaps[i].size;
+    }
+    updateBudget();
+}
+
+void DeviceMemoryTracker::add(VkDeviceMemory memory, uint32_t memoryTypeIndex, VkDeviceSize bytes, DeviceMemoryCategory category)
+{
+    if (memory == VK_NULL_HANDLE)
+    {
+        return;
+    }
+    uint32_t heapIndex = mCapabilities->getMemoryProperties().memoryTypes[memoryTypeIndex].heapIndex;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mAllocations.try_emplace((uint64_t)(memory), Allocation {bytes, heapIndex, category}).second)
+        {
+            return;
+        }
+    }
+    mCategoryCounters[static_cast<size_t>(category)].add(bytes);
+    mTotalCounters.add(bytes);
+    mHeapBytes[heapIndex] += bytes;
+    mFrameAllocationCount++;
+    mFrameAllocatedBytes += bytes;
+}
+
+void DeviceMemoryTracker::remove(uint64_t memory)
+{
+    Allocation allocation;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mAllocations.find(memory);
+        if (it == mAllocations.end())
+        {
+            return;
+        }
+        allocation = it->second;
+        mAllocations.erase(it);
+    }
+    mCategoryCounters[static_cast<size_t>(allocation.category)].remove(allocation.bytes);
+    mTotalCounters.remove(allocation.bytes);
+    mHeapBytes[allocation.heapIndex] -= allocation.bytes;
+    mFrameFreeCount++;
+    mFrameFreedBytes += allocation.bytes;
+}
+
+void DeviceMemoryTracker::endFrame(uint64_t frameIndex)
+{
+    DeviceMemoryFrameCounters& counters = mFrameHistory[mFrameHistoryNext];
+    counters.frameIndex = frameIndex;
+    counters.allocationCount = mFrameAllocationCount.exchange(0);
+    counters.freeCount = mFrameFreeCount.exchange(0);
+    counters.allocatedBytes = mFrameAllocatedBytes.exchange(0);
+    counters.freedBytes = mFrameFreedBytes.exchange(0);
+    counters.bytes = mTotalCounters.bytes;
+    mFrameHistoryNext = (mFrameHistoryNext + 1) % FRAME_HISTORY_SIZE;
+    mFrameHistorySize = std::min(mFrameHistorySize + 1, FRAME_HISTORY_SIZE);
+}
+
+void DeviceMemoryTracker::updateBudget()
+{
+    if (!mbMemoryBudget)
+    {
+        return;
+    }
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties {};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 memoryProperties {};
+    memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memoryProperties.pNext = &budgetProperties;
+    vkGetPhysicalDeviceMemoryProperties2(mCapabilities->getPhysicalDevice(), &memoryProperties);
+    for (uint32_t i = 0; i < mHeapCount; i++)
+    {
+        mHeapBudgets[i] = budgetProperties.heapBudget[i];
+        mHeapUsages[i] = budgetProperties.heapUsage[i];
+    }
+}
+
+DeviceMemoryStatistics DeviceMemoryTracker::getStatistics(DeviceMemoryCategory category) const
+{
+    return mCategoryCounters[static_cast<size_t>(category)].load<DeviceMemoryStatistics>();
+}
+
+DeviceMemoryStatistics DeviceMemoryTracker::getTotalStatistics() const
+{
+    return mTotalCounters.load<DeviceMemoryStatistics>();
+}
+
+DeviceMemoryHeapUsage DeviceMemoryTracker::getHeapUsage(uint32_t heapIndex) const
+{
+    const VkMemoryHeap& heap = mCapabilities->getMemoryProperties().memoryHeaps[heapIndex];
+    DeviceMemoryHeapUsage usage;
+    usage.size = heap.size;
+    usage.flags = heap.flags;
+    usage.trackedBytes = mHeapBytes[heapIndex];
+    usage.budget = mHeapBudgets[heapIndex];
+    usage.usage = mbMemoryBudget ? mHeapUsages[heapIndex] : usage.trackedBytes;
+    return usage;
+}
+
+const DeviceMemoryFrameCounters& DeviceMemoryTracker::getFrameCounters(size_t age) const
+{
+    return mFrameHistory[(mFrameHistoryNext + FRAME_HISTORY_SIZE - mFrameHistorySize + age) % FRAME_HISTORY_SIZE];
+}
+
+bool DeviceMemoryTracker::isOverBudget() const
+{
+    for (uint32_t i = 0; i < mHeapCount; i++)
+    {
+        DeviceMemoryHeapUsage usage = getHeapUsage(i);
+        if (usage.usage > usage.budget)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DeviceMemoryTracker::printReport(const char* title) const
+{
+    DeviceMemoryStatistics total = getTotalStatistics();
+    std::cout << title << ": " << toMebibytes(total.bytes) << " MiB live in " << total.liveCount << " allocations, peak " << toMebibytes(total.peakBytes) << " MiB, "
+              << total.allocationCount << " allocations so far" << std::endl;
+    for (size_t i = 0; i < CATEGORY_COUNT; i++)
+    {
+        DeviceMemoryCategory category = static_cast<DeviceMemoryCategory>(i);
+        DeviceMemoryStatistics statistics = getStatistics(category);
+        if (statistics.allocationCount == 0)
+        {
+            continue;
+        }
+        std::cout << "  " << getDeviceMemoryCategoryName(category) << ": " << toMebibytes(statistics.bytes) << " MiB live, peak " << toMebibytes(statistics.peakBytes) << " MiB, "
+                  << statistics.allocationCount << " allocations" << std::endl;
+    }
+    for (uint32_t i = 0; i < mHeapCount; i++)
+    {
+        DeviceMemoryHeapUsage usage = getHeapUsage(i);
+        std::cout << "  Heap " << i << ((usage.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " (device local)" : "") << ": " << toMebibytes(usage.trackedBytes) << " MiB ours, "
+                  << toMebibytes(usage.usage) << " of " << toMebibytes(usage.budget) << " MiB budget used" << (mbMemoryBudget ? "" : " (no VK_EXT_memory_budget)") << std::endl;
+    }
+}
+
+void DeviceMemoryTracker::writeJson(std::ostream& out) const
+{
+    DeviceMemoryStatistics total = getTotalStatistics();
+    out << "{\"bytes\": " << total.bytes << ", \"peakBytes\": " << total.peakBytes << ", \"liveCount\": " << total.liveCount << ", \"allocationCount\": " << total.allocationCount
+        << ", \"memoryBudget\": " << (mbMemoryBudget ? "true" : "false") << ",\n  \"categories\": [";
+    for (size_t i = 0; i < CATEGORY_COUNT; i++)
+    {
+        DeviceMemoryCategory category = static_cast<DeviceMemoryCategory>(i);
+        DeviceMemoryStatistics statistics = getStatistics(category);
+        out << (i > 0 ? ",\n    " : "\n    ") << "{\"name\": \"" << getDeviceMemoryCategoryName(category) << "\", \"bytes\": " << statistics.bytes << ", \"peakBytes\": " << statistics.peakBytes
+            << ", \"liveCount\": " << statistics.liveCount << ", \"allocationCount\": " << statistics.allocationCount << "}";
+    }
+    out << "],\n  \"heaps\": [";
+    for (uint32_t i = 0; i < mHeapCount; i++)
+    {
+        DeviceMemoryHeapUsage usage = getHeapUsage(i);
+        out << (i > 0 ? ",\n    " : "\n    ") << "{\"index\": " << i << ", \"deviceLocal\": " << ((usage.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "true" : "false")
+            << ", \"size\": " << usage.size << ", \"trackedBytes\": " << usage.trackedBytes << ", \"budget\": " << usage.budget << ", \"usage\": " << usage.usage << "}";
+    }
+    out << "],\n  \"frames\": [";
+    for (size_t age = 0; age < mFrameHistorySize; age++)
+    {
+        const DeviceMemoryFrameCounters& counters = getFrameCounters(age);
+        out << (age > 0 ? ",\n    " : "\n    ") << "{\"frame\": " << counters.frameIndex << ", \"allocations\": " << counters.allocationCount << ", \"frees\": " << counters.freeCount
+            << ", \"allocatedBytes\": " << counters.allocatedBytes << ", \"freedBytes\": " << counters.freedBytes << ", \"bytes\": " << counters.bytes << "}";
+    }
+    out << "]}";
+}
@@ -0,0 +1,365 @@
+#include "VulkanUtility/HostAllocator.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    // Precedes every allocation, so frees and reallocations know where the memory came from and whom to charge
+    struct AllocationHeader
+    {
+        uint64_t size;
+        // From the start of the malloc allocation or pool block to the memory handed out
+        uint32_t offset;
+        uint8_t subsystem;
+        uint8_t scope;
+        uint8_t sizeClass;
+        uint8_t reserved;
+    };
+
+    // Keeps the memory after the header aligned like malloc's
+    const size_t HEADER_SIZE = 16;
+    static_assert(sizeof(AllocationHeader) == HEADER_SIZE);
+    const uint8_t NOT_POOLED = UINT8_MAX;
+    // Drivers make many allocations of a few dozen bytes for every object and command, larger ones go to malloc
+    const size_t SIZE_CLASS_PAYLOADS[] = {64, 128, 256, 512};
+    const size_t POOL_PAGE_SIZE = 64 * 1024;
+
+    const char* SCOPE_NAMES[] = {"command", "object", "cache", "device", "instance"};
+
+    AllocationHeader* getHeader(void* memory)
+    {
+        return reinterpret_cast<AllocationHeader*>(static_cast<std::byte*>(memory) - HEADER_SIZE);
+    }
+
+    uint32_t getScopeIndex(VkSystemAllocationScope scope)
+    {
+        return static_cast<uint32_t>(scope) < HostAllocator::SCOPE_COUNT ? static_cast<uint32_t>(scope) : static_cast<uint32_t>(VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    }
+
+    double toKibibytes(uint64_t bytes)
+    {
+        return bytes / 1024.0;
+    }
+}  // namespace
+
+const char* LearnVulkan::getHostAllocationSubsystemName(HostAllocationSubsystem subsystem)
+{
+    switch (subsystem)
+    {
+        case HostAllocationSubsystem::Instance: return "Instance";
+        case HostAllocationSubsystem::Device: return "Device";
+        case HostAllocationSubsystem::Swapchain: return "Swapchain";
+        case HostAllocationSubsystem::RenderTargets: return "Render targets";
+        case HostAllocationSubsystem::Pipelines: return "Pipelines";
+        case HostAllocationSubsystem::Descriptors: return "Descriptors";
+        case HostAllocationSubsystem::Resources: return "Resources";
+        case HostAllocationSubsystem::Commands: return "Commands";
+        case HostAllocationSubsystem::Synchronization: return "Synchronization";
+        default: return "Unknown";
+    }
+}
+
+HostAllocator::HostAllocator()
+{
+    static_assert(std::size(SIZE_CLASS_PAYLOADS) == SIZE_CLASS_COUNT);
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; i++)
+    {
+        mSizeClasses[i].blockSize = HEADER_SIZE + SIZE_CLASS_PAYLOADS[i];
+    }
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; i++)
+    {
+        mContexts[i] = {this, static_cast<HostAllocationSubsystem>(i)};
+        VkAllocationCallbacks& callbacks = mCallbacks[i];
+        callbacks.pUserData = &mContexts[i];
+        callbacks.pfnAllocation = allocation;
+        callbacks.pfnReallocation = reallocation;
+        callbacks.pfnFree = freeMemory;
+        callbacks.pfnInternalAllocation = internalAllocation;
+        callbacks.pfnInternalFree = internalFree;
+    }
+}
+
+HostAllocator::~HostAllocator()
+{
+    for (SizeClass& sizeClass : mSizeClasses)
+    {
+        for (void* page : sizeClass.pages)
+        {
+            std::free(page);
+        }
+    }
+}
+
+void HostAllocator::initialize(bool bEnabled, bool bPooled)
+{
+    mbEnabled = bEnabled;
+    mbPooled = bEnabled && bPooled;
+}
+
+const VkAllocationCallbacks* HostAllocator::getCallbacks(HostAllocationSubsystem subsystem) const
+{
+    return mbEnabled ? &mCallbacks[static_cast<size_t>(subsystem)] : nullptr;
+}
+
+HostAllocationStatistics HostAllocator::getStatistics(HostAllocationSubsystem subsystem, VkSystemAllocationScope scope) const
+{
+    return load(mCounters[static_cast<size_t>(subsystem)][getScopeIndex(scope)]);
+}
+
+HostAllocationStatistics HostAllocator::getStatistics(HostAllocationSubsystem subsystem) const
+{
+    return load(mCounters[static_cast<size_t>(subsystem)][SCOPE_COUNT]);
+}
+
+HostAllocationStatistics HostAllocator::getTotalStatistics() const
+{
+    return load(mTotalCounters);
+}
+
+uint64_t HostAllocator::getPoolCapacity() const
+{
+    uint64_t capacity = 0;
+    for (const SizeClass& sizeClass : mSizeClasses)
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        capacity += sizeClass.pages.size() * POOL_PAGE_SIZE;
+    }
+    return capacity;
+}
+
+void HostAllocator::printReport(const char* title) const
+{
+    if (!mbEnabled)
+    {
+        return;
+    }
+    HostAllocationStatistics total = getTotalStatistics();
+    std::cout << title << ": " << toKibibytes(total.bytes) << " KiB live in " << total.liveCount << " allocations, peak " << toKibibytes(total.peakBytes) << " KiB, "
+              << total.allocationCount << " allocations so far";
+    if (mbPooled)
+    {
+        std::cout << ", " << (total.allocationCount > 0 ? 100.0 * mPooledAllocationCount / total.allocationCount : 0.0) << "% from a " << toKibibytes(getPoolCapacity())
+                  << " KiB pool";
+    }
+    std::cout << std::endl;
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; i++)
+    {
+        HostAllocationSubsystem subsystem = static_cast<HostAllocationSubsystem>(i);
+        HostAllocationStatistics statistics = getStatistics(subsystem);
+        if (statistics.allocationCount == 0 && statistics.internalBytes == 0)
+        {
+            continue;
+        }
+        std::cout << "  " << getHostAllocationSubsystemName(subsystem) << ": " << toKibibytes(statistics.bytes) << " KiB live, peak " << toKibibytes(statistics.peakBytes)
+                  << " KiB, " << statistics.allocationCount << " allocations";
+        // Peak by scope shows whether a subsystem holds memory for its objects or churns it while recording
+        for (uint32_t scope = 0; scope < SCOPE_COUNT; scope++)
+        {
+            HostAllocationStatistics scopeStatistics = getStatistics(subsystem, static_cast<VkSystemAllocationScope>(scope));
+            if (scopeStatistics.allocationCount > 0)
+            {
+                std::cout << ", " << SCOPE_NAMES[scope] << " peak " << toKibibytes(scopeStatistics.peakBytes) << " KiB";
+            }
+        }
+        if (statistics.internalBytes > 0)
+        {
+            std::cout << ", " << toKibibytes(statistics.internalBytes) << " KiB internal";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void* HostAllocator::allocate(size_t size, size_t alignment, VkSystemAllocationScope scope, HostAllocationSubsystem subsystem)
+{
+    if (size == 0)
+    {
+        return nullptr;
+    }
+    alignment = std::max<size_t>(alignment, 1);
+    uint8_t sizeClass = NOT_POOLED;
+    std::byte* base = nullptr;
+    std::byte* memory = nullptr;
+    if (mbPooled && alignment <= HEADER_SIZE)
+    {
+        for (size_t i = 0; i < SIZE_CLASS_COUNT && sizeClass == NOT_POOLED; i++)
+        {
+            if (size <= SIZE_CLASS_PAYLOADS[i])
+            {
+                sizeClass = static_cast<uint8_t>(i);
+            }
+        }
+    }
+    if (sizeClass != NOT_POOLED)
+    {
+        base = static_cast<std::byte*>(allocateBlock(sizeClass));
+        memory = base ? base + HEADER_SIZE : nullptr;
+    }
+    else
+    {
+        // malloc only aligns for max_align_t, larger alignments are found inside a bigger allocation
+        base = static_cast<std::byte*>(std::malloc(size + HEADER_SIZE + alignment - 1));
+        if (base)
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(base) + HEADER_SIZE;
+            memory = base + ((address + alignment - 1) & ~(alignment - 1)) - reinterpret_cast<uintptr_t>(base);
+        }
+    }
+    if (!memory)
+    {
+        return nullptr;
+    }
+
+    uint32_t scopeIndex = getScopeIndex(scope);
+    AllocationHeader* header = getHeader(memory);
+    header->size = size;
+    header->offset = static_cast<uint32_t>(memory - base);
+    header->subsystem = static_cast<uint8_t>(subsystem);
+    header->scope = static_cast<uint8_t>(scopeIndex);
+    header->sizeClass = sizeClass;
+    header->reserved = 0;
+    count(subsystem, scopeIndex, size, true);
+    if (sizeClass != NOT_POOLED)
+    {
+        mPooledAllocationCount++;
+    }
+    return memory;
+}
+
+// The spec requires the new allocation to keep the original's alignment and the original to survive a failure
+void* HostAllocator::reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope, HostAllocationSubsystem subsystem)
+{
+    if (!original)
+    {
+        return allocate(size, alignment, scope, subsystem);
+    }
+    if (size == 0)
+    {
+        free(original);
+        return nullptr;
+    }
+    void* memory = allocate(size, alignment, scope, subsystem);
+    if (memory)
+    {
+        std::memcpy(memory, original, std::min<size_t>(size, getHeader(original)->size));
+        free(original);
+    }
+    return memory;
+}
+
+void HostAllocator::free(void* memory)
+{
+    if (!memory)
+    {
+        return;
+    }
+    const AllocationHeader* header = getHeader(memory);
+    count(static_cast<HostAllocationSubsystem>(header->subsystem), header->scope, header->size, false);
+    std::byte* base = static_cast<std::byte*>(memory) - header->offset;
+    if (header->sizeClass != NOT_POOLED)
+    {
+        freeBlock(header->sizeClass, base);
+    }
+    else
+    {
+        std::free(base);
+    }
+}
+
+void* HostAllocator::allocateBlock(size_t sizeClassIndex)
+{
+    SizeClass& sizeClass = mSizeClasses[sizeClassIndex];
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    if (!sizeClass.freeBlocks)
+    {
+        std::byte* page = static_cast<std::byte*>(std::malloc(POOL_PAGE_SIZE));
+        if (!page)
+        {
+            return nullptr;
+        }
+        sizeClass.pages.push_back(page);
+        // Free blocks store the next free block in their first bytes
+        for (size_t offset = (POOL_PAGE_SIZE / sizeClass.blockSize - 1) * sizeClass.blockSize;; offset -= sizeClass.blockSize)
+        {
+            void* block = page + offset;
+            std::memcpy(block, &sizeClass.freeBlocks, sizeof(void*));
+            sizeClass.freeBlocks = block;
+            if (offset == 0)
+            {
+                break;
+            }
+        }
+    }
+    void* block = sizeClass.freeBlocks;
+    std::memcpy(&sizeClass.freeBlocks, block, sizeof(void*));
+    return block;
+}
+
+void HostAllocator::freeBlock(size_t sizeClassIndex, void* block)
+{
+    SizeClass& sizeClass = mSizeClasses[sizeClassIndex];
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    std::memcpy(block, &sizeClass.freeBlocks, sizeof(void*));
+    sizeClass.freeBlocks = block;
+}
+
+void HostAllocator::count(HostAllocationSubsystem subsystem, uint32_t scope, uint64_t bytes, bool bAllocation)
+{
+    std::array<Counters, SCOPE_COUNT + 1>& subsystemCounters = mCounters[static_cast<size_t>(subsystem)];
+    for (Counters* counters : {&subsystemCounters[scope], &subsystemCounters[SCOPE_COUNT], &mTotalCounters})
+    {
+        if (bAllocation)
+        {
+            counters->add(bytes);
+        }
+        else
+        {
+            counters->remove(bytes);
+        }
+    }
+}
+
+HostAllocationStatistics HostAllocator::load(const Counters& counters)
+{
+    HostAllocationStatistics statistics = counters.load<HostAllocationStatistics>();
+    statistics.internalBytes = static_cast<uint64_t>(std::max<int64_t>(counters.internalBytes, 0));
+    return statistics;
+}
+
+void* VKAPI_PTR HostAllocator::allocation(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    Context* context = static_cast<Context*>(userData);
+    return context->allocator->allocate(size, alignment, scope, context->subsystem);
+}
+
+void* VKAPI_PTR HostAllocator::reallocation(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    Context* context = static_cast<Context*>(userData);
+    return context->allocator->reallocate(original, size, alignment, scope, context->subsystem);
+}
+
+void VKAPI_PTR HostAllocator::freeMemory(void* userData, void* memory)
+{
+    static_cast<Context*>(userData)->allocator->free(memory);
+}
+
+void VKAPI_PTR HostAllocator::internalAllocation(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope)
+{
+    Context* context = static_cast<Context*>(userData);
+    std::array<Counters, SCOPE_COUNT + 1>& counters = context->allocator->mCounters[static_cast<size_t>(context->subsystem)];
+    counters[getScopeIndex(scope)].internalBytes += size;
+    counters[SCOPE_COUNT].internalBytes += size;
+    context->allocator->mTotalCounters.internalBytes += size;
+}
+
+void VKAPI_PTR HostAllocator::internalFree(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope)
+{
+    Context* context = static_cast<Context*>(userData);
+    std::array<Counters, SCOPE_COUNT + 1>& counters = context->allocator->mCounters[static_cast<size_t>(context->subsystem)];
+    counters[getScopeIndex(scope)].internalBytes -= size;
+    counters[SCOPE_COUNT].internalBytes -= size;
+    context->allocator->mTotalCounters.internalBytes -= size;
+}
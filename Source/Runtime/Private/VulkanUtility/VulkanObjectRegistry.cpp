@@ -0,0 +1,172 @@
+#include "VulkanUtility/VulkanObjectRegistry.hpp"
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    struct SiteSummary
+    {
+        VkObjectType type;
+        std::source_location location;
+        size_t count;
+        VkDeviceSize bytes;
+        uint64_t newestFrameIndex;
+    };
+
+    bool isSameSite(const std::source_location& a, const std::source_location& b)
+    {
+        return a.line() == b.line() && std::string_view(a.file_name()) == b.file_name();
+    }
+
+    // Paths are as the compiler saw them, only the file name is worth printing
+    std::string_view getFileName(const std::source_location& location)
+    {
+        std::string_view path = location.file_name();
+        size_t separator = path.find_last_of("/\\");
+        return separator == std::string_view::npos ? path : path.substr(separator + 1);
+    }
+}  // namespace
+
+const char* LearnVulkan::getVulkanObjectTypeName(VkObjectType type)
+{
+    switch (type)
+    {
+        case VK_OBJECT_TYPE_BUFFER:
+            return "Buffer";
+        case VK_OBJECT_TYPE_DEVICE_MEMORY:
+            return "DeviceMemory";
+        case VK_OBJECT_TYPE_IMAGE:
+            return "Image";
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+            return "ImageView";
+        case VK_OBJECT_TYPE_SAMPLER:
+            return "Sampler";
+        case VK_OBJECT_TYPE_FRAMEBUFFER:
+            return "Framebuffer";
+        case VK_OBJECT_TYPE_RENDER_PASS:
+            return "RenderPass";
+        case VK_OBJECT_TYPE_PIPELINE:
+            return "Pipeline";
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+            return "PipelineLayout";
+        case VK_OBJECT_TYPE_PIPELINE_CACHE:
+            return "PipelineCache";
+        case VK_OBJECT_TYPE_SHADER_MODULE:
+            return "ShaderModule";
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+            return "DescriptorSetLayout";
+        case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+            return "DescriptorPool";
+        case VK_OBJECT_TYPE_COMMAND_POOL:
+            return "CommandPool";
+        case VK_OBJECT_TYPE_QUERY_POOL:
+            return "QueryPool";
+        case VK_OBJECT_TYPE_SEMAPHORE:
+            return "Semaphore";
+        case VK_OBJECT_TYPE_FENCE:
+            return "Fence";
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+            return "Swapchain";
+        default:
+            return "Object";
+    }
+}
+
+void VulkanObjectRegistry::add(VkObjectType type, uint64_t handle, VkDeviceSize bytes, const std::source_location& location)
+{
+    if (handle == 0)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mObjects.try_emplace({type, handle}, Record {bytes, location, mFrameIndex.load(std::memory_order_relaxed)}).second)
+    {
+        mLiveBytes += bytes;
+    }
+}
+
+void VulkanObjectRegistry::remove(VkObjectType type, uint64_t handle)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mObjects.find({type, handle});
+    if (it != mObjects.end())
+    {
+        mLiveBytes -= it->second.bytes;
+        mObjects.erase(it);
+    }
+}
+
+size_t VulkanObjectRegistry::getLiveCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mObjects.size();
+}
+
+VkDeviceSize VulkanObjectRegistry::getLiveBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLiveBytes;
+}
+
+void VulkanObjectRegistry::printLiveObjects(const char* title, size_t maxSites) const
+{
+    std::vector<SiteSummary> sites;
+    size_t liveCount = 0;
+    VkDeviceSize liveBytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        liveCount = mObjects.size();
+        liveBytes = mLiveBytes;
+        for (const auto& [key, record] : mObjects)
+        {
+            auto site = std::find_if(sites.begin(), sites.end(), [&](const SiteSummary& summary) {
+                return summary.type == key.type && isSameSite(summary.location, record.location);
+            });
+            if (site == sites.end())
+            {
+                sites.push_back({key.type, record.location, 0, 0, 0});
+                site = sites.end() - 1;
+            }
+            site->count++;
+            site->bytes += record.bytes;
+            site->newestFrameIndex = std::max(site->newestFrameIndex, record.frameIndex);
+        }
+    }
+    std::sort(sites.begin(), sites.end(), [](const SiteSummary& a, const SiteSummary& b) { return a.count > b.count; });
+    std::cout << title << ": " << liveCount << " live Vulkan objects, " << liveBytes / 1024 << " KiB of device memory" << std::endl;
+    for (size_t i = 0; i < std::min(maxSites, sites.size()); i++)
+    {
+        const SiteSummary& site = sites[i];
+        std::cout << "  " << site.count << " x " << getVulkanObjectTypeName(site.type) << " from " << getFileName(site.location) << ":" << site.location.line();
+        if (site.bytes > 0)
+        {
+            std::cout << ", " << site.bytes / 1024 << " KiB";
+        }
+        std::cout << ", newest created in frame " << site.newestFrameIndex << std::endl;
+    }
+}
+
+size_t VulkanObjectRegistry::printLeaks(const char* title) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mObjects.empty())
+    {
+        return 0;
+    }
+    std::cerr << title << ": " << mObjects.size() << " Vulkan objects leaked, " << mLiveBytes / 1024 << " KiB of device memory!" << std::endl;
+    for (const auto& [key, record] : mObjects)
+    {
+        std::cerr << "  " << getVulkanObjectTypeName(key.type) << " 0x" << std::hex << key.handle << std::dec;
+        if (record.bytes > 0)
+        {
+            std::cerr << " (" << record.bytes << " bytes)";
+        }
+        std::cerr << " created in frame " << record.frameIndex << " by " << record.location.function_name() << " at " << getFileName(record.location) << ":"
+                  << record.location.line() << std::endl;
+    }
+    return mObjects.size();
+}
@@ -1,12 +1,46 @@
 #pragma once
 
 #include "Configuration.hpp"
+#include "FileSystem/DerivedDataCache.hpp"
+#include "FileSystem/FileWatcher.hpp"
+#include "FileSystem/VirtualFileSystem.hpp"
+#include "Geometry/MeshLod.hpp"
+#include "Geometry/Meshlet.hpp"
 #include "Interface/IApplication.hpp"
 #include "Interface/Interface.hpp"
+#include "Memory/LinearAllocator.hpp"
+#include "Profiling/FrameCapture.hpp"
+#include "Render/AntiAliasing.hpp"
+#include "Render/BindlessResourceTable.hpp"
+#include "Render/DrawSorting.hpp"
+#include "Render/GraphicsPipelineKey.hpp"
+#include "Render/Material.hpp"
+#include "Render/RenderGraph.hpp"
+#include "Render/RenderTargetAllocator.hpp"
+#include "Scene/Scene.hpp"
+#include "Shader/ShaderReflection.hpp"
+#include "Task/WorkerPool.hpp"
+#include "Time/FrameLimiter.hpp"
 #include "Vertex.hpp"
+#include "VulkanUtility/DeletionQueue.hpp"
+#include "VulkanUtility/DeviceCapabilities.hpp"
+#include "VulkanUtility/DeviceMemoryTracker.hpp"
+#include "VulkanUtility/HostAllocator.hpp"
+#include "VulkanUtility/MeshletCullingObject.hpp"
+#include "VulkanUtility/PushConstantObject.hpp"
 #include "VulkanUtility/QueueFamilyIndices.hpp"
 #include "VulkanUtility/SwapchainSupportDetails.hpp"
 #include "VulkanUtility/UniformBufferObject.hpp"
+#include "VulkanUtility/VulkanHandle.hpp"
+#include "VulkanUtility/VulkanObjectRegistry.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <source_location>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -25,56 +59,272 @@ namespace LearnVulkan
         bool isQuit() override;
 
     protected:
-        bool mbQuit;
+        // Written by initialization steps running on several threads
+        std::atomic<bool> mbQuit;
         const ApplicationConfiguration& mConfig;
+        // Declared first so it outlives every Vulkan object it allocated for
+        HostAllocator mHostAllocator;
         VkInstance mVulkanInstance;
         VkSurfaceKHR mWindowSurface;
         VkPhysicalDevice mPhysicalDevice = VK_NULL_HANDLE;
-        VkPhysicalDeviceProperties mPhysicalDeviceProperties;
+        // Of mPhysicalDevice, queried once while picking it
+        DeviceCapabilities mDeviceCapabilities;
         VkDevice mLogicalDevice;
+        // Every Vulkan object the application owns, only filled in debug builds
+        VulkanObjectRegistry mObjectRegistry;
+        // Live object count at the last growth check
+        size_t mObjectCountSample = 0;
+        // Every device memory allocation by category and heap
+        DeviceMemoryTracker mDeviceMemoryTracker;
+        bool mbMemoryBudgetSupported = false;
+        bool mbOverMemoryBudget = false;
+        // Device memory in use at the first growth check, the soak test limit is relative to it
+        uint64_t mDeviceMemoryBaseline = 0;
+        bool mbMemorySnapshotRequested = false;
+        // Destroys the device objects below, its device is cleared once the device is gone
+        VulkanDeviceContext mDeviceContext;
         VkQueue mGraphicsQueue;
         VkQueue mPresentQueue;
         VkSwapchainKHR mSwapchain;
         std::vector<VkImage> mSwapchainImages;
         VkFormat mSwapchainImageFormat;
         VkExtent2D mSwapchainExtent;
-        std::vector<VkImageView> mSwapchainImageViews;
-        VkRenderPass mRenderPass;
-        VkDescriptorSetLayout mDescriptorSetLayout;
-        VkPipelineLayout mPipelineLayout;
-        VkPipeline mGraphicsPipeline;
-        std::vector<VkFramebuffer> mSwapchainFramebuffers;
-        VkCommandPool mCommandPool;
-        VkImage mDepthImage;
-        VkDeviceMemory mDepthImageMemory;
-        VkImageView mDepthImageView;
+        std::vector<UniqueImageView> mSwapchainImageViews;
+        // Stays VK_NULL_HANDLE with dynamic rendering, as do the framebuffers
+        UniqueRenderPass mRenderPass;
+        bool mbDynamicRenderingSupported = false;
+        bool mbDynamicRendering = false;
+        PFN_vkCmdBeginRenderingKHR mCmdBeginRendering = nullptr;
+        PFN_vkCmdEndRenderingKHR mCmdEndRendering = nullptr;
+        // Meshlet culling needs multiDrawIndirect and VK_KHR_draw_indirect_count
+        bool mbMeshletCullingSupported = false;
+        PFN_vkCmdDrawIndexedIndirectCountKHR mCmdDrawIndexedIndirectCount = nullptr;
+        UniqueDescriptorSetLayout mDescriptorSetLayout;
+        UniquePipelineLayout mPipelineLayout;
+        // Every compiled permutation, looked up by key while recording
+        std::unordered_map<GraphicsPipelineKey, UniquePipeline> mGraphicsPipelines;
+        GraphicsPipelineKey mGraphicsPipelineKey;
+        uint64_t mCompiledGraphicsPipelineCount = 0;
+        UniquePipelineCache mPipelineCache;
+        // Compiles permutations at startup and again on every key switch, tier change and hot reload
+        WorkerPool mPipelineCompilePool;
+        // Start out as the embedded shaders, code is repointed to the storage below on hot reload
+        ShaderReflection mVertShader;
+        ShaderReflection mFragShader;
+        std::vector<uint32_t> mVertShaderCode;
+        std::vector<uint32_t> mFragShaderCode;
+        std::vector<UniqueFramebuffer> mSwapchainFramebuffers;
+        UniqueCommandPool mCommandPool;
+        UniqueImage mDepthImage;
+        UniqueDeviceMemory mDepthImageMemory;
+        UniqueImageView mDepthImageView;
         uint32_t mMipLevels;
-        VkImage mTextureImage;
-        VkDeviceMemory mTextureImageMemory;
-        VkImageView mTextureImageView;
-        VkSampler mTextureSampler;
+        // Decoded on a worker during initialization, released once uploaded
+        struct DecodedTexture
+        {
+            std::shared_ptr<unsigned char> pixels;
+            int width = 0;
+            int height = 0;
+        };
+        DecodedTexture mDecodedTexture;
+        UniqueImage mTextureImage;
+        UniqueDeviceMemory mTextureImageMemory;
+        UniqueImageView mTextureImageView;
+        UniqueSampler mTextureSampler;
+        // The bindless stress materials each sample their own small texture
+        struct StressTexture
+        {
+            UniqueImage image;
+            UniqueDeviceMemory memory;
+            UniqueImageView imageView;
+        };
+        std::vector<StressTexture> mStressTextures;
         VkSampleCountFlagBits mMsaaSamples = VK_SAMPLE_COUNT_1_BIT;
-        VkImage mColorImage;
-        VkDeviceMemory mColorImageMemory;
-        VkImageView mColorImageView;
-        VkBuffer mVertexBuffer;
-        VkDeviceMemory mVertexBufferMemory;
-        VkBuffer mIndexBuffer;
-        VkDeviceMemory mIndexBufferMemory;
-        std::vector<VkBuffer> mUniformBuffers;
-        std::vector<VkDeviceMemory> mUniformBuffersMemory;
-        VkDescriptorPool mDescriptorPool;
+        VkSampleCountFlagBits mMaxMsaaSamples = VK_SAMPLE_COUNT_1_BIT;
+        AntiAliasingTier mAntiAliasingTier;
+        AntiAliasingSettings mAntiAliasing;
+        // Set from input, applied at the next frame boundary
+        std::optional<AntiAliasingTier> mRequestedAntiAliasingTier;
+        RenderTargetAllocator mRenderTargetAllocator;
+        // Render targets are created from the compiled frame graph so transient ones can share memory
+        struct FrameGraphImage
+        {
+            RenderGraphResource resource;
+            RenderTargetDescription description;
+            UniqueImage* image;
+            UniqueDeviceMemory* memory;
+        };
+        RenderGraph mFrameGraph;
+        std::vector<FrameGraphImage> mFrameGraphImages;
+        RenderGraphResource mFrameGraphSwapchainImage = 0;
+        // Swapchain image the frame graph is being recorded for
+        uint32_t mImageIndex = 0;
+        UniqueImage mColorImage;
+        UniqueDeviceMemory mColorImageMemory;
+        UniqueImageView mColorImageView;
+        // Post-processed tiers render into the scene color image, the compute pass writes
+        // the post-process image which is then blitted into the swapchain image
+        bool mbSwapchainTransferDst = false;
+        UniqueImage mSceneColorImage;
+        UniqueDeviceMemory mSceneColorImageMemory;
+        UniqueImageView mSceneColorImageView;
+        UniqueImage mPostProcessImage;
+        UniqueDeviceMemory mPostProcessImageMemory;
+        UniqueImageView mPostProcessImageView;
+        UniqueSampler mPostProcessSampler;
+        UniqueDescriptorSetLayout mPostProcessDescriptorSetLayout;
+        UniqueDescriptorPool mPostProcessDescriptorPool;
+        VkDescriptorSet mPostProcessDescriptorSet = VK_NULL_HANDLE;
+        UniquePipelineLayout mPostProcessPipelineLayout;
+        UniquePipeline mPostProcessPipeline;
+        UniqueBuffer mVertexBuffer;
+        UniqueDeviceMemory mVertexBufferMemory;
+        UniqueBuffer mIndexBuffer;
+        UniqueDeviceMemory mIndexBufferMemory;
+        std::vector<UniqueBuffer> mUniformBuffers;
+        std::vector<UniqueDeviceMemory> mUniformBuffersMemory;
+        UniqueDescriptorPool mDescriptorPool;
         std::vector<VkDescriptorSet> mDescriptorSets;
+        BindlessResourceTable mBindlessResourceTable;
+        std::vector<Material> mMaterials;
+        UniqueBuffer mMaterialBuffer;
+        UniqueDeviceMemory mMaterialBufferMemory;
+        // One entry per draw, pushed as constants while recording
+        std::vector<PushConstantObject> mDrawObjects;
+        // Every draw object is an entity, only the world matrices that changed are copied into mDrawObjects
+        Scene mScene;
+        std::vector<Entity> mDrawObjectEntities;
+        // Entity index to draw object
+        std::vector<uint32_t> mEntityDrawObjects;
+        // Levels of detail of the model, index ranges into the shared index buffer
+        std::vector<MeshLod> mMeshLods;
+        // Derived data key of the cooked model, the meshlets built from it are keyed by it
+        std::string mModelCacheKey;
+        // Level each draw object was drawn with last frame, the starting point of the hysteresis
+        std::vector<uint32_t> mDrawObjectLods;
+        // Draw order of the frame being recorded, rebuilt from the camera every frame in mFrameAllocator
+        std::span<DrawCommand> mDepthPrepassDraws;
+        std::span<DrawCommand> mShadingDraws;
+        bool mbDepthPrepass = false;
+        // Set from input, applied at the next frame boundary
+        std::optional<bool> mRequestedDepthPrepass;
+
+        // Meshlets of the full detail level, their index ranges follow the levels of detail in the index buffer
+        MeshletMesh mMeshlets;
+        uint32_t mMeshletFirstIndex = 0;
+        bool mbMeshletCulling = false;
+        std::optional<bool> mRequestedMeshletCulling;
+        UniqueBuffer mMeshletBuffer;
+        UniqueDeviceMemory mMeshletBufferMemory;
+        UniqueDescriptorSetLayout mMeshletCullingDescriptorSetLayout;
+        UniqueDescriptorPool mMeshletCullingDescriptorPool;
+        UniquePipelineLayout mMeshletCullingPipelineLayout;
+        UniquePipeline mMeshletCullingPipeline;
+        // Per frame in flight, objects get consecutive slots and every slot meshletCount indirect draws
+        struct MeshletCullingFrame
+        {
+            UniqueBuffer objectBuffer;
+            UniqueDeviceMemory objectBufferMemory;
+            UniqueBuffer drawBuffer;
+            UniqueDeviceMemory drawBufferMemory;
+            UniqueBuffer drawCountBuffer;
+            UniqueDeviceMemory drawCountBufferMemory;
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            uint32_t slotCapacity = 0;
+            uint32_t meshletCount = 0;
+            VkBuffer meshletBuffer = VK_NULL_HANDLE;
+        };
+        std::vector<MeshletCullingFrame> mMeshletCullingFrames;
+        // Slot of every draw object this frame, NO_MESHLET_SLOT for objects drawn at a coarser level
+        std::vector<uint32_t> mMeshletObjectSlots;
+        uint32_t mMeshletSlotCount = 0;
+        MeshletCullingPushConstantObject mMeshletCullingConstants {};
         std::vector<VkCommandBuffer> mCommandBuffers;
-        std::vector<VkSemaphore> mImageAvailableSemaphores;
-        std::vector<VkSemaphore> mRenderFinishedSemaphores;
-        std::vector<VkFence> mInFlightFences;
+        std::vector<UniqueSemaphore> mImageAvailableSemaphores;
+        std::vector<UniqueSemaphore> mRenderFinishedSemaphores;
+        std::vector<UniqueFence> mInFlightFences;
         bool mbFramebufferResized = false;
         uint32_t mCurrentFrame = 0;
+        // Monotonic count of submitted frames, used to key deferred destruction
+        uint64_t mFrameIndex = 0;
+        DeletionQueue mDeletionQueue;
+        FrameLimiter mFrameLimiter;
+        // Temporaries of the frame being built, such as the draw lists, reset before every update
+        LinearAllocator mFrameAllocator;
+        // Frames since anything last reconfigured the frame loop, allocations are expected until the warmup is over
+        uint32_t mSteadyFrameCount = 0;
+        uint64_t mCheckedFrameCount = 0;
+
+        // Inputs of the frame being built, written to the capture once it is recorded
+        FrameCaptureRecord mFrameInputs;
+        FrameCaptureWriter mFrameCapture;
+        std::chrono::steady_clock::time_point mFrameCaptureStart;
+        // Time spent writing frames, and in the updates and recordings they describe
+        uint64_t mFrameCaptureNanoseconds = 0;
+        uint64_t mFrameCaptureMaxNanoseconds = 0;
+        double mCapturedFrameMilliseconds = 0.0;
+        // Drives the frame loop from a capture instead of the clock and input
+        FrameCaptureReader mFrameReplay;
+        size_t mReplayFrame = 0;
+        uint32_t mReplayPass = 0;
+        // Update and record time of every captured frame summed over the passes
+        std::vector<double> mReplayMilliseconds;
+        uint64_t mReplayMismatchCount = 0;
+
+        struct HotReloadJob
+        {
+            std::string path;
+            std::chrono::steady_clock::time_point detectedTime;
+            // Loading runs on a worker thread and yields the main thread step that swaps the resource in
+            std::future<std::function<bool()>> future;
+        };
+        FileWatcher mFileWatcher;
+        // Initialization loads assets through it, hot reload reads the loose files it watches directly
+        VirtualFileSystem mFileSystem;
+        // Decoded textures, parsed models with their levels of detail and meshlets, compiled hot reload shaders
+        DerivedDataCache mDerivedDataCache;
+        std::vector<FileChangeEvent> mFileChangeEvents;
+        std::vector<HotReloadJob> mHotReloadJobs;
+        // Detection times of changes swapped in this frame, reported once the frame is presented
+        std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>> mHotReloadLatencies;
+
+        struct AntiAliasingBenchmark
+        {
+            bool bActive = false;
+            AntiAliasingTier tier = AntiAliasingTier::Off;
+            uint32_t frame = 0;
+            double gpuMilliseconds = 0.0;
+            uint32_t gpuFrameCount = 0;
+        };
+        AntiAliasingBenchmark mAntiAliasingBenchmark;
+        // GPU frame timestamps, two per frame in flight, only created for benchmarks
+        UniqueQueryPool mTimestampQueryPool;
+        std::vector<bool> mbTimestampsWritten;
+
+        struct DepthPrepassBenchmark
+        {
+            bool bActive = false;
+            bool bPrepass = false;
+            uint32_t frame = 0;
+            uint64_t fragmentInvocations = 0;
+            uint32_t queryFrameCount = 0;
+            // Fragment shader invocations per frame without the prepass
+            double baselineInvocations = 0.0;
+        };
+        DepthPrepassBenchmark mDepthPrepassBenchmark;
+        bool mbPipelineStatisticsQuerySupported = false;
+        // Fragment shader invocations of the scene pass, one per frame in flight, only created for benchmarks
+        UniqueQueryPool mPipelineStatisticsQueryPool;
+        std::vector<bool> mbPipelineStatisticsWritten;
 
         virtual void initWindow() override;
         virtual void initVulkan() override;
+        void mountFileSystem();
         void drawFrame();
+        void checkFrameAllocations(uint64_t allocationCount);
+        void checkObjectGrowth();
+        void updateMemoryTelemetry();
+        void writeMemorySnapshot(const char* path) const;
 
     private:
         const std::string modelPath = "Model/viking_room.obj";
@@ -82,6 +332,7 @@ namespace LearnVulkan
         std::vector<Vertex> vertices;
         std::vector<uint32_t> indices;
         static void frameBufferResizeCallback(GLFWwindow* window, int width, int height);
+        static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
         void createVulkanInstance();
         static bool checkExtensionSupport();
         static std::vector<const char*> getRequiredExtensions();
@@ -101,9 +352,12 @@ namespace LearnVulkan
 #endif
 
         void pickPhysicalDevice();
-        int rateDeviceSuitability(VkPhysicalDevice device);
-        QueueFamilyIndices findQueueFamilyIndices(VkPhysicalDevice device);
-        static bool checkPhysicalDeviceSupport(VkPhysicalDevice device);
+        int rateDeviceSuitability(const DeviceCapabilities& capabilities);
+        static QueueFamilyIndices findQueueFamilyIndices(const DeviceCapabilities& capabilities);
+        static bool checkPhysicalDeviceSupport(const DeviceCapabilities& capabilities);
+        static bool checkDescriptorIndexingSupport(const DeviceCapabilities& capabilities);
+        static bool checkDynamicRenderingSupport(const DeviceCapabilities& capabilities);
+        static bool checkMeshletCullingSupport(const DeviceCapabilities& capabilities);
         static const std::vector<const char*> PHYSICAL_DEVICE_EXTENSIONS;
 
         void createLogicalDevice();
@@ -111,38 +365,94 @@ namespace LearnVulkan
 
         SwapchainSupportDetails querySwapchainSupport(VkPhysicalDevice device);
         static VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
-        static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
+        VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) const;
         VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
-        void createSwapchain();
+        bool createSwapchain(VkSwapchainKHR oldSwapchain);
         void recreateSwapchain();
         void clearSwapchain();
+        void clearRenderTargets();
         void createImageViews();
         void createRenderPass();
         void createDescriptorSetLayout();
-        void createGraphicsPipeline();
+        void createBindlessResourceTable();
+        void createPipelineLayout();
+        void createGraphicsPipelines();
+        bool compileGraphicsPipelines(const std::vector<GraphicsPipelineKey>& keys);
+        VkPipeline buildGraphicsPipeline(const GraphicsPipelineKey& key,
+                                         VkShaderModule vertShaderModule,
+                                         VkShaderModule fragShaderModule,
+                                         const VkVertexInputBindingDescription& bindingDescription,
+                                         const std::vector<VkVertexInputAttributeDescription>& attributeDescriptions) const;
+        VkPipeline getGraphicsPipeline(const GraphicsPipelineKey& key) const;
+        void compileActiveGraphicsPipelines();
+        void retireGraphicsPipelines();
+        void setViewportAndScissor(VkCommandBuffer commandBuffer);
+        void updateGraphicsPipelineKey();
+        void retireIncompatibleGraphicsPipelines();
+
+        static const VkFormat SCENE_COLOR_FORMAT;
+        static const uint32_t POST_PROCESS_DESCRIPTOR_SETS;
+        VkFormat getSceneColorFormat() const;
+        void applyAntiAliasingTier(AntiAliasingTier tier);
+        VkDeviceSize getRenderTargetMemorySize() const;
+        void printRenderTargetMemory() const;
+        void createPostProcessPipeline();
+        void createPostProcessDescriptorSet();
+        void recordPostProcess(VkCommandBuffer commandBuffer);
+        void recordPostProcessBlit(VkCommandBuffer commandBuffer);
+        void startAntiAliasingBenchmark();
+        void updateAntiAliasingBenchmark();
+        void createPipelineCache();
 
-        VkShaderModule createShaderModule(std::vector<char> shaderCode);
+        UniqueShaderModule createShaderModule(const ShaderReflection& shader);
+        static const std::vector<const ShaderReflection*> SHADERS;
 
         static const int MAX_FRAMES_IN_FLIGHT;
+        static const uint32_t INIT_THREAD_COUNT;
         void createFramebuffers();
         void createCommandPool();
-        void createColorResources();
-        void createDepthResources();
+        void createRenderTargets();
+        void buildFrameGraph();
+        RenderGraphResource addFrameGraphImage(const std::string& name, const RenderTargetDescription& description, VkImageAspectFlags aspectMask, UniqueImage& image, UniqueDeviceMemory& memory);
+        void createFrameGraphImages();
         void createVertexBuffer();
         void createIndexBuffer();
         void createUniformBuffers();
         void createDescriptorPool();
         void createDescriptorSets();
+        void createMaterials();
         void createCommandBuffers();
         void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+        void recordScenePass(VkCommandBuffer commandBuffer);
+        void recordDrawList(VkCommandBuffer commandBuffer, std::span<const DrawCommand> draws);
+        void beginScenePass(VkCommandBuffer commandBuffer);
+        void endScenePass(VkCommandBuffer commandBuffer);
         void createSyncronizationObjects();
 
         uint32_t findPhysicalDeviceMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
-        void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+        // The call site is recorded as the creator of the objects in debug builds
+        void createBuffer(VkDeviceSize size,
+                          VkBufferUsageFlags usage,
+                          VkMemoryPropertyFlags properties,
+                          DeviceMemoryCategory category,
+                          UniqueBuffer& buffer,
+                          UniqueDeviceMemory& bufferMemory,
+                          std::source_location location = std::source_location::current());
         void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-        void createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
-        VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels);
+        void createImage(uint32_t width,
+                         uint32_t height,
+                         uint32_t mipLevels,
+                         VkSampleCountFlagBits numSamples,
+                         VkFormat format,
+                         VkImageTiling tiling,
+                         VkImageUsageFlags usage,
+                         VkMemoryPropertyFlags properties,
+                         DeviceMemoryCategory category,
+                         UniqueImage& image,
+                         UniqueDeviceMemory& imageMemory,
+                         std::source_location location = std::source_location::current());
+        UniqueImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels, std::source_location location = std::source_location::current());
         void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
         void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t width, int32_t height, uint32_t mipLevels);
 
@@ -150,18 +460,72 @@ namespace LearnVulkan
         void endSingleTimeCommands(VkCommandBuffer commandBuffer);
 
         void updateUniformBuffer(uint32_t currentImageIndex);
+        void updateDrawObjects(float time);
+        void updateModelBounds();
+        void buildDrawLists(const glm::mat4& view, const glm::mat4& projection);
 
+        GraphicsPipelineKey getDepthPrepassPipelineKey() const;
+        void setDepthPrepass(bool bEnabled);
+        void startDepthPrepassBenchmark();
+        void updateDepthPrepassBenchmark();
+
+        static MeshletMesh buildModelMeshlets(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const MeshLod& lod, uint32_t& meshletFirstIndex);
+        void createMeshletCullingPipeline();
+        void createMeshletBuffer();
+        void setMeshletCulling(bool bEnabled);
+        void updateMeshletCulling(const glm::mat4& view, const glm::mat4& projection);
+        void updateMeshletCullingFrame(MeshletCullingFrame& frame);
+        void recordMeshletCulling(VkCommandBuffer commandBuffer);
+        void destroyMeshletCulling();
+        static const uint32_t NO_MESHLET_SLOT;
+
+        void decodeTextureImage();
         void createTextureImage();
+        void uploadTextureImage(const unsigned char* pixels, int textureWidth, int textureHeight, UniqueImage& image, UniqueDeviceMemory& imageMemory, uint32_t& mipLevels);
         void createTextureImageView();
         void createTextureSampler();
         VkSampleCountFlagBits getMaxUsableSampleCount() const;
 
         void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels);
 
-        VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
-        VkFormat findDepthFormat();
+        VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
+        VkFormat findDepthFormat() const;
         static bool hasStencilComponent(VkFormat format);
 
+        // Parses the model and builds its levels of detail, needs no device
         void loadModel();
+        // Meshlets are only built if the picked device can cull them
+        void loadModelMeshlets();
+        static std::vector<MeshLod> buildModelLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+        static void parseModel(const FileView& file, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        void startFrameCapture();
+        void startFrameReplay();
+        void beginReplayFrame();
+        void captureFrame(uint32_t imageIndex, std::chrono::steady_clock::time_point updateStart, std::chrono::steady_clock::time_point recordStart);
+        void endReplayFrame(float updateMilliseconds, float recordMilliseconds);
+        void printFrameCaptureReport() const;
+        void printReplayReport() const;
+
+        void startHotReload();
+        void stopHotReload();
+        void processHotReload();
+        void reportHotReloadLatency();
+        std::function<bool()> reloadShader(const std::string& path, ShaderReflection& shader, std::vector<uint32_t>& codeStorage);
+        std::function<bool()> reloadTexture(const std::string& path);
+        std::function<bool()> reloadModel(const std::string& path);
+
+        static const uint32_t BINDLESS_MAX_TEXTURES;
+        static const uint32_t BINDLESS_MAX_STORAGE_BUFFERS;
+        static const uint32_t MATERIAL_BUFFER_INDEX;
+
+        void runStartupBenchmarks();
+        void benchmarkDescriptorBinding(uint32_t drawCount);
+        void benchmarkPerDrawData(uint32_t drawCount);
+        void benchmarkRenderingPaths(uint32_t recreateCount);
+        void benchmarkVulkanHandles(uint32_t drawCount);
+        void benchmarkDeviceMemoryTracker(uint32_t bufferCount);
+        template<typename PerDrawFunction>
+        double measureDrawRecording(VkCommandBuffer commandBuffer, uint32_t drawCount, PerDrawFunction&& perDraw);
     };
 }  // namespace LearnVulkan
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace LearnVulkan
+{
+    // LZ4 block format (no frame header or checksums), compatible with LZ4_compress_default / LZ4_decompress_safe.
+    // Greedy single probe matching: compresses less than the reference library, decompresses just as fast.
+
+    // Largest compressed size of size bytes, for sizing the destination
+    size_t getLz4CompressBound(size_t size);
+
+    // Returns the compressed size, or 0 if destination is too small. source must be smaller than 4 GiB.
+    size_t compressLz4(std::span<const std::byte> source, std::span<std::byte> destination);
+
+    // Decompresses exactly destination.size() bytes. Returns false on malformed or truncated input instead of
+    // reading or writing out of bounds, so archives from disk can be decompressed without further checks.
+    bool decompressLz4(std::span<const std::byte> source, std::span<std::byte> destination);
+}  // namespace LearnVulkan
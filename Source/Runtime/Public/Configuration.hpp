@@ -1,9 +1,18 @@
 #pragma once
 
+#include "Render/AntiAliasing.hpp"
 #include <cstdint>
 
 namespace LearnVulkan
 {
+    enum class PresentPolicy
+    {
+        Fifo,
+        FifoRelaxed,
+        Mailbox,
+        Immediate,
+    };
+
     struct ApplicationConfiguration
     {
         ApplicationConfiguration(uint32_t windowWidth, uint32_t windowHeight, const char* windowTitle)
@@ -14,5 +23,69 @@ namespace LearnVulkan
         uint32_t    windowWidth;
         uint32_t    windowHeight;
         const char* windowTitle;
+
+        // Falls back to FIFO, which every device supports, if the requested mode is unavailable
+        PresentPolicy presentPolicy = PresentPolicy::Mailbox;
+        // 0 means unlimited
+        uint32_t frameRateLimit = 0;
+        // Delay input sampling and uniform updates until right before command recording
+        bool bJustInTimeFrame = false;
+
+        // Initial tier, switched at runtime with the number keys 1-5. Per-sample shading at the highest sample
+        // count costs several times more fragment work than 4x MSAA for little visible gain, so it is opt-in.
+        AntiAliasingTier antiAliasingTier = AntiAliasingTier::Msaa4x;
+        // Renders a few hundred frames with every tier and prints frame time and render target memory
+        bool bBenchmarkAntiAliasingTiers = false;
+
+        // Creates this many extra small textures, each with its own material and descriptor, and draws one object per material
+        uint32_t bindlessStressTextureCount = 0;
+        // Runs the CPU micro benchmarks once after initialization and prints their results
+        bool bRunStartupBenchmarks = false;
+        // Aborts on the first steady-state frame that allocates on the heap. Needs the LEARN_VULKAN_COUNT_ALLOCATIONS
+        // CMake option, which is off by default, and no validation layers, they allocate through operator new for every command.
+        bool bCheckFrameAllocations = false;
+        // Passes VkAllocationCallbacks to every Vulkan call and prints host memory per subsystem on exit
+        bool bTrackVulkanHostMemory = false;
+        // With tracking, serves small driver allocations from fixed size blocks instead of malloc
+        bool bPoolVulkanHostAllocations = false;
+        // Device and host memory by category, heap budgets and recent frames are written here when F9 is pressed.
+        // nullptr disables it.
+        const char* memorySnapshotPath = "MemorySnapshot.json";
+        // Aborts once device memory in use grows this many bytes past what was in use after the first thousand
+        // frames, for soak tests. 0 disables the check.
+        uint64_t deviceMemoryGrowthLimit = 0;
+        // Records the inputs of every frame into a ring buffer mapped from this file, which survives the process
+        // crashing. The previous run's capture is kept as <path>.previous. nullptr disables it.
+        const char* frameCapturePath = nullptr;
+        // Size of the ring in bytes, the newest frames that fit are kept
+        uint64_t frameCaptureSize = uint64_t {16} << 20;
+        // Replays a capture in a hidden window instead of running live and quits once done, see Source/Tools/FrameReplay
+        const char* frameReplayPath = nullptr;
+        uint32_t frameReplayPassCount = 1;
+        // Mounted over the loose asset files if it exists, built by the LearnVulkanAssets target. nullptr disables it.
+        const char* assetArchivePath = "Assets.pak";
+        // Cooked assets keyed by a hash of their source and import settings, shared by every build on this machine.
+        // nullptr uses the per-user cache directory, an empty string disables the cache.
+        const char* derivedDataCachePath = nullptr;
+        // Least recently used entries are deleted beyond this many bytes
+        uint64_t derivedDataCacheMaxSize = uint64_t {1} << 30;
+        // Watches Shader/, Texture/ and Model/ and swaps edited resources in without restarting
+        bool bHotReload = false;
+        // Compiles every blend / cull / sample shading / feature permutation at startup instead of when the tier or passes switch to it
+        bool bPrecompilePipelinePermutations = false;
+        // Lays down depth for every opaque draw first so the shading pass runs the fragment shader once per pixel.
+        // Toggled at runtime with Z.
+        bool bDepthPrepass = false;
+        // Renders a few hundred frames without and with the depth prepass and prints frame time and fragment shader invocations
+        bool bBenchmarkDepthPrepass = false;
+        // Begins the scene with VK_KHR_dynamic_rendering instead of render pass and framebuffer objects, if supported
+        bool bDynamicRendering = false;
+        // Screen-space error in pixels up to which a coarser level of detail is drawn, 0 always draws the full mesh
+        float lodPixelError = 1.0f;
+        // Adds this many copies of the model scattered far behind it, drawn at coarse levels of detail
+        uint32_t distantObjectCount = 0;
+        // Culls the meshlets of full detail objects on the GPU and draws the survivors indirectly, if supported.
+        // Toggled at runtime with M.
+        bool bMeshletCulling = false;
     };
 }  // namespace LearnVulkan
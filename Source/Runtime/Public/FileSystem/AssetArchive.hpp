@@ -0,0 +1,87 @@
+#pragma once
+
+#include "FileSystem/VirtualFileSystem.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace LearnVulkan
+{
+    class MappedFile;
+
+    // Bundles files into one archive for ArchiveFileSource, see Source/Tools/AssetPacker.
+    //
+    // Layout: header, then every entry's data aligned to 4 KiB pages, then the table of contents, entries
+    // sorted by the hash of their path followed by the block table and the path strings. Compressed entries are
+    // split into independently compressed LZ4 blocks so large files decompress on several threads.
+    class AssetArchiveWriter
+    {
+    public:
+        // path is the virtual path, e.g. "Texture/viking_room.png". Compression is only kept for blocks it shrinks,
+        // so already compressed formats cost nothing to load.
+        void addFile(const std::string& path, std::vector<std::byte> bytes, bool bCompress);
+        // Returns false if nativePath cannot be read
+        bool addNativeFile(const std::string& path, const std::string& nativePath, bool bCompress);
+
+        // Throws std::runtime_error on duplicate paths or if the archive cannot be written
+        void write(const std::string& archivePath) const;
+
+    private:
+        struct PendingFile
+        {
+            std::string path;
+            std::vector<std::byte> bytes;
+            bool bCompress;
+        };
+
+        std::vector<PendingFile> mFiles;
+    };
+
+    // Files of an archive written by AssetArchiveWriter, looked up with one binary search over the hashed table
+    // of contents. The archive is mapped once: stored entries are views straight into the mapping, compressed
+    // ones are decompressed into their own buffer on every open.
+    class ArchiveFileSource : _implements_ IFileSource
+    {
+    public:
+        // Returns false if the archive is missing, not an archive or truncated
+        bool load(const std::string& archivePath);
+        size_t getFileCount() const { return mEntries.size(); }
+
+        bool contains(const std::string& path) const override;
+        bool open(const std::string& path, FileView& view) const override;
+        // Packed files have no native path
+        std::string getNativePath(const std::string& path) const override;
+
+        static uint64_t hashPath(std::string_view path);
+
+    private:
+        struct Entry
+        {
+            uint64_t pathHash;
+            uint64_t offset;
+            uint64_t size;
+            // Stored uncompressed at offset if blockCount is 0
+            uint32_t firstBlock;
+            uint32_t blockCount;
+            std::string_view path;
+        };
+
+        struct Block
+        {
+            uint64_t offset;
+            // Stored uncompressed if storedSize equals size
+            uint32_t storedSize;
+            uint32_t size;
+        };
+
+        std::shared_ptr<MappedFile> mArchive;
+        std::vector<Entry> mEntries;
+        std::vector<Block> mBlocks;
+
+        const Entry* find(const std::string& path) const;
+        bool decompress(const Entry& entry, std::byte* destination) const;
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LearnVulkan
+{
+    enum class AsyncFileBackend
+    {
+        // One thread keeps up to QUEUE_DEPTH reads in flight in the kernel, Linux only
+        IoUring,
+        // Blocking reads on a few threads
+        ThreadPool,
+    };
+
+    struct FileReadResult
+    {
+        std::string path;
+        std::vector<std::byte> bytes;
+        bool bSuccess = false;
+    };
+
+    // Called on a reader thread once the whole file is in memory or the read failed.
+    // May issue further reads, but must not call wait() or stop().
+    using FileReadCallback = std::function<void(FileReadResult& result)>;
+
+    // Reads whole files in the background for streaming, the callback owns the bytes
+    class AsyncFileReader
+    {
+    public:
+        AsyncFileReader();
+        ~AsyncFileReader();
+        AsyncFileReader(const AsyncFileReader&) = delete;
+        AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+        // Falls back to the thread pool where io_uring is unavailable (other platforms, old kernels, seccomp).
+        // threadCount sizes the pool, 0 uses every core.
+        void start(AsyncFileBackend backend = AsyncFileBackend::IoUring, uint32_t threadCount = 0);
+        // Completes every read issued so far first
+        void stop();
+        AsyncFileBackend getBackend() const { return mBackend; }
+
+        // Reads issued while the reader is stopped run on the calling thread
+        void read(std::string path, FileReadCallback callback);
+        // Blocks until every read issued so far has completed and its callback has returned
+        void wait();
+
+    private:
+        struct Request
+        {
+            std::string path;
+            FileReadCallback callback;
+        };
+
+        static constexpr uint32_t QUEUE_DEPTH = 64;
+
+        AsyncFileBackend mBackend = AsyncFileBackend::ThreadPool;
+        std::vector<std::thread> mThreads;
+        std::mutex mMutex;
+        std::condition_variable mRequestAvailable;
+        std::condition_variable mReadCompleted;
+        std::deque<Request> mRequests;
+        // Issued and not yet completed, including queued requests
+        size_t mPendingCount = 0;
+        bool mbRunning = false;
+        // Only defined where io_uring is available
+        struct IoUring;
+        std::unique_ptr<IoUring> mRing;
+
+        void runIoUring();
+        void runThreadPool();
+        void complete(FileReadCallback& callback, FileReadResult& result);
+        static bool readWholeFile(const std::string& path, std::vector<std::byte>& bytes);
+    };
+}  // namespace LearnVulkan
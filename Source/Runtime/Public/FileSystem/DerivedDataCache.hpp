@@ -0,0 +1,164 @@
+#pragma once
+
+#include "FileSystem/VirtualFileSystem.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // 128-bit hash of everything an importer's output depends on: its name and version, its settings and the
+    // source bytes. Fast rather than cryptographic, it only has to tell honest inputs apart.
+    class DerivedDataKey
+    {
+    public:
+        // Bump version whenever the importer or its output format changes, so older entries stop matching
+        DerivedDataKey(std::string_view importer, uint32_t version);
+
+        DerivedDataKey& add(std::span<const std::byte> bytes);
+        DerivedDataKey& add(std::string_view text);
+        template<typename T>
+        DerivedDataKey& addValue(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return add(std::span<const std::byte>(reinterpret_cast<const std::byte*>(&value), sizeof(T)));
+        }
+
+        // 32 hex digits, the entry's file name
+        std::string toString() const;
+
+        static uint64_t hashBytes(std::span<const std::byte> bytes, uint64_t seed);
+
+    private:
+        uint64_t mHashes[2];
+    };
+
+    struct DerivedDataStatistics
+    {
+        uint32_t hitCount = 0;
+        uint32_t missCount = 0;
+        // Entries that failed their integrity check, counted as misses too
+        uint32_t corruptCount = 0;
+        uint32_t storeCount = 0;
+        uint32_t evictionCount = 0;
+        uint64_t bytesRead = 0;
+        uint64_t bytesWritten = 0;
+        // Recorded build time of every hit minus the time to read it
+        double savedMilliseconds = 0.0;
+    };
+
+    // Cooked importer outputs on local disk, one file per key below the cache directory. The directory is meant to
+    // be per user rather than per build, so every build and branch importing the same source with the same
+    // importer shares the entry. Entries carry a hash of their contents that is checked on every load, a
+    // truncated or damaged entry is deleted and reported as a miss. Once the cache outgrows its size limit the
+    // least recently used entries are deleted, hits refresh an entry's modification time.
+    // Loads and stores are thread safe, also across processes: entries are written to a temporary file and renamed.
+    class DerivedDataCache
+    {
+    public:
+        // Returns false and leaves the cache disabled if the directory cannot be created
+        bool initialize(const std::string& directory, uint64_t maxSize);
+        bool isEnabled() const { return !mDirectory.empty(); }
+
+        // False on a miss. The view maps the entry, so it stays valid if the entry is evicted later.
+        bool load(const DerivedDataKey& key, FileView& data);
+        // buildMilliseconds is what the import cost, credited as saved time whenever the entry is hit
+        void store(const DerivedDataKey& key, std::span<const std::byte> data, double buildMilliseconds);
+
+        DerivedDataStatistics getStatistics() const;
+        void printReport(const char* title) const;
+
+        // $XDG_CACHE_HOME, ~/.cache or %LOCALAPPDATA%, followed by LearnVulkan/DerivedData
+        static std::string getDefaultDirectory();
+
+    private:
+        std::string mDirectory;
+        uint64_t mMaxSize = 0;
+        mutable std::mutex mMutex;
+        uint64_t mTotalSize = 0;
+        DerivedDataStatistics mStatistics;
+
+        std::string getEntryPath(const DerivedDataKey& key) const;
+        void removeEntry(const std::string& path);
+        // Deletes least recently used entries until the cache takes up at most targetSize, holds mMutex
+        void trim(uint64_t targetSize);
+    };
+
+    // Appends trivially copyable values and vectors of them to a cooked asset
+    class DerivedDataWriter
+    {
+    public:
+        template<typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+            mBytes.insert(mBytes.end(), bytes, bytes + sizeof(T));
+        }
+
+        template<typename T>
+        void writeVector(const std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            write(static_cast<uint64_t>(values.size()));
+            const std::byte* bytes = reinterpret_cast<const std::byte*>(values.data());
+            mBytes.insert(mBytes.end(), bytes, bytes + values.size() * sizeof(T));
+        }
+
+        std::span<const std::byte> getBytes() const { return mBytes; }
+
+    private:
+        std::vector<std::byte> mBytes;
+    };
+
+    // Reads back what DerivedDataWriter wrote, every read fails once the data runs out
+    class DerivedDataReader
+    {
+    public:
+        explicit DerivedDataReader(std::span<const std::byte> bytes)
+            : mBytes(bytes) {}
+
+        template<typename T>
+        bool read(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (mBytes.size() - mOffset < sizeof(T))
+            {
+                return false;
+            }
+            memcpy(&value, mBytes.data() + mOffset, sizeof(T));
+            mOffset += sizeof(T);
+            return true;
+        }
+
+        template<typename T>
+        bool readVector(std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            uint64_t count;
+            if (!read(count) || count > (mBytes.size() - mOffset) / sizeof(T))
+            {
+                return false;
+            }
+            values.resize(static_cast<size_t>(count));
+            if (!values.empty())
+            {
+                memcpy(values.data(), mBytes.data() + mOffset, values.size() * sizeof(T));
+                mOffset += values.size() * sizeof(T);
+            }
+            return true;
+        }
+
+        bool isAtEnd() const { return mOffset == mBytes.size(); }
+
+    private:
+        std::span<const std::byte> mBytes;
+        size_t mOffset = 0;
+    };
+}  // namespace LearnVulkan
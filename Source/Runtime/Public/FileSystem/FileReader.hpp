@@ -1,8 +0,0 @@
-#pragma once
-
-#include <fstream>
-#include <vector>
-
-using namespace std;
-
-vector<char> readFile(const string& filename);
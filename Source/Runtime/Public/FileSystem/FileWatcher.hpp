@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LearnVulkan
+{
+    struct FileChangeEvent
+    {
+        // Watched directory joined with the file name, e.g. "Shader/Shader.frag"
+        std::string path;
+        std::chrono::steady_clock::time_point detectedTime;
+    };
+
+    // Watches directories for files being written or moved in on a background thread.
+    // Uses inotify on Linux and falls back to polling modification times elsewhere.
+    class FileWatcher
+    {
+    public:
+        FileWatcher() = default;
+        ~FileWatcher();
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        // Directories must be added before start()
+        void addDirectory(const std::string& directory);
+        bool start();
+        void stop();
+
+        // Moves all events gathered since the last call into events, one per path
+        void pollEvents(std::vector<FileChangeEvent>& events);
+
+    private:
+        std::vector<std::string> mDirectories;
+        std::thread mThread;
+        std::atomic<bool> mbRunning = false;
+        std::mutex mEventMutex;
+        std::vector<FileChangeEvent> mPendingEvents;
+#ifdef __linux__
+        int mInotifyFileDescriptor = -1;
+        std::vector<int> mWatchDescriptors;
+#endif
+
+        void run();
+        void pushEvent(std::string path);
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace LearnVulkan
+{
+    // Memory mapping of a whole file. Pages are faulted in from the page cache on first touch, so nothing is
+    // copied and untouched parts of large files are never read. Files are mapped read-only unless created.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Returns false if the file cannot be opened or mapped. Empty files open with an empty view.
+        bool open(const std::string& path);
+        // Creates or truncates the file to size bytes of zeros and maps it writable and shared. Writes reach the
+        // page cache as they are made, so they survive the process crashing, but not the machine.
+        bool create(const std::string& path, size_t size);
+        void close();
+        bool isOpen() const { return mbOpen; }
+
+        std::span<const std::byte> getBytes() const { return {mData, mSize}; }
+        const std::byte* getData() const { return mData; }
+        // Null unless the file was created
+        std::byte* getMutableData() const { return mbWritable ? const_cast<std::byte*>(mData) : nullptr; }
+        size_t getSize() const { return mSize; }
+
+    private:
+        const std::byte* mData = nullptr;
+        size_t mSize = 0;
+        bool mbOpen = false;
+        bool mbWritable = false;
+#ifdef _WIN32
+        void* mFileHandle = nullptr;
+        void* mMappingHandle = nullptr;
+#endif
+
+        void moveFrom(MappedFile& other);
+    };
+
+    // Drops the clean cached pages of a file so the next read comes from the disk, for cold start measurements.
+    // Best effort: only supported on Linux, returns false elsewhere or if the file cannot be opened.
+    bool evictFromPageCache(const std::string& path);
+}  // namespace LearnVulkan
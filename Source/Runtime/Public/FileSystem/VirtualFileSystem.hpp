@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Interface/Interface.hpp"
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Read-only bytes of one file. Shares ownership of whatever backs them, a mapping of the loose file or of the
+    // archive containing it, so views stay valid after the source that opened them is gone.
+    class FileView
+    {
+    public:
+        FileView() = default;
+        FileView(std::shared_ptr<const void> owner, std::span<const std::byte> bytes)
+            : mOwner(std::move(owner))
+            , mBytes(bytes) {}
+
+        bool isValid() const { return mOwner != nullptr; }
+        std::span<const std::byte> getBytes() const { return mBytes; }
+        const std::byte* getData() const { return mBytes.data(); }
+        size_t getSize() const { return mBytes.size(); }
+        // For parsers of text formats
+        std::string_view getText() const { return {reinterpret_cast<const char*>(mBytes.data()), mBytes.size()}; }
+
+    private:
+        std::shared_ptr<const void> mOwner;
+        std::span<const std::byte> mBytes;
+    };
+
+    // Maps a file of the native file system into a view
+    bool mapFile(const std::string& path, FileView& view);
+
+    // Somewhere virtual paths can be looked up, e.g. a directory or a packed archive
+    _Interface_ IFileSource
+    {
+    public:
+        virtual ~IFileSource() = default;
+
+        virtual bool contains(const std::string& path) const = 0;
+        // Returns false if the file is missing or cannot be read
+        virtual bool open(const std::string& path, FileView& view) const = 0;
+        // Native path of the file, for libraries and readers that only take file names. Empty if the file has none.
+        virtual std::string getNativePath(const std::string& path) const = 0;
+    };
+
+    // Loose files below a root directory
+    class DirectoryFileSource : _implements_ IFileSource
+    {
+    public:
+        explicit DirectoryFileSource(std::string root);
+
+        bool contains(const std::string& path) const override;
+        bool open(const std::string& path, FileView& view) const override;
+        std::string getNativePath(const std::string& path) const override;
+
+    private:
+        std::string mRoot;
+    };
+
+    // Resolves forward slash separated paths relative to the asset root, e.g. "Texture/viking_room.png", against
+    // the mounted sources. Later mounts take precedence, so an archive can be mounted over the loose files.
+    // Mount everything before the file system is shared between threads, lookups are const and thread safe.
+    class VirtualFileSystem
+    {
+    public:
+        void mount(std::shared_ptr<IFileSource> source);
+
+        bool exists(const std::string& path) const;
+        bool open(const std::string& path, FileView& view) const;
+        std::string getNativePath(const std::string& path) const;
+
+        // Backslashes become forward slashes and leading "./" is dropped
+        static std::string normalizePath(std::string_view path);
+
+    private:
+        std::vector<std::shared_ptr<IFileSource>> mSources;
+    };
+}  // namespace LearnVulkan
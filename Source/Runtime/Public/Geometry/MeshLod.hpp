@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Vertex.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Index range of one level of detail in the shared index buffer, every level indexes the original vertices
+    struct MeshLod
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        // Estimated distance between this level and the full resolution surface, in model units
+        float error;
+    };
+
+    // Quadric error metric edge collapse towards targetIndexCount. Vertices only ever move onto a neighbour,
+    // so the result indexes the input vertices. Vertices sharing a position (UV seams) move together and only
+    // along the seam, open borders only along the border, so neither tears. error receives the RMS distance
+    // of the worst collapse to the surface it replaced.
+    std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float& error);
+
+    // Appends coarser levels to indices, each about half the triangles of the previous one, level 0 is the input
+    std::vector<MeshLod> buildMeshLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, uint32_t maxLodCount);
+
+    // Coarsest level whose error projects to at most pixelError pixels at the given view depth. A coarser level
+    // is only taken below (1 - hysteresis) * pixelError and the current one kept up to (1 + hysteresis) * pixelError,
+    // so objects near a switching distance do not flicker between levels.
+    uint32_t selectMeshLod(const std::vector<MeshLod>& lods, float viewDepth, float pixelsPerUnit, float pixelError, float hysteresis, uint32_t currentLod);
+}  // namespace LearnVulkan
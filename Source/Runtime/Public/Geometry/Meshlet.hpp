@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Vertex.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Limits of one cluster, 124 triangles leave room for the primitive count in a 128 entry mesh shader output
+    const uint32_t MESHLET_MAX_VERTICES = 64;
+    const uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+    // Ranges into MeshletMesh::vertices and MeshletMesh::triangles
+    struct Meshlet
+    {
+        uint32_t vertexOffset;
+        uint32_t triangleOffset;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+
+    // Bounding sphere and normal cone of a meshlet, in model space
+    struct MeshletBounds
+    {
+        glm::vec3 center;
+        float radius;
+        glm::vec3 coneAxis;
+        // Sine of the cone half angle, 1 when the normals spread too far for the cone to ever cull
+        float coneCutoff;
+    };
+
+    // Meshlets of one mesh, each one a list of mesh vertices and triangles indexing into that list
+    struct MeshletMesh
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshletBounds> bounds;
+        // Indices into the mesh vertices, meshlet after meshlet
+        std::vector<uint32_t> vertices;
+        // Three local vertex indices per triangle, meshlet after meshlet
+        std::vector<uint8_t> triangles;
+    };
+
+    // Greedy clustering: every meshlet grows by the adjacent triangle adding the fewest new vertices, then by
+    // distance to its centroid, which keeps vertex reuse high and bounds tight. indices is a triangle list.
+    MeshletMesh buildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t maxVertices = MESHLET_MAX_VERTICES, uint32_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+    // Mesh indices of all meshlets in order, the triangles of meshlet m start at index 3 * triangleOffset
+    std::vector<uint32_t> unpackMeshletIndices(const MeshletMesh& mesh);
+
+    // True if every triangle of the meshlet faces away from the camera, mirrored by MeshletCull.comp
+    bool isMeshletBackfacing(const MeshletBounds& bounds, const glm::vec3& cameraPosition);
+}  // namespace LearnVulkan
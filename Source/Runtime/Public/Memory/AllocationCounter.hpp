@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace LearnVulkan
+{
+    // Global operator new is replaced to count heap allocations per thread when LEARN_VULKAN_COUNT_ALLOCATIONS is
+    // defined. Shared libraries calling operator new are counted too, direct malloc calls are not.
+    bool isAllocationCountingEnabled();
+    // Operator new calls on the calling thread since it started, always 0 without counting
+    uint64_t getThreadAllocationCount();
+}  // namespace LearnVulkan
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Bump allocator for data that lives for one frame. Allocating advances an offset into one block, reset()
+    // releases everything at once. Requests past the block fall back to the heap for the rest of the frame and
+    // the next reset grows the block to the peak, so a frame that settles into the same workload stops allocating.
+    class LinearAllocator
+    {
+    public:
+        explicit LinearAllocator(size_t capacity = 0);
+        LinearAllocator(const LinearAllocator&) = delete;
+        LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+        // Alignment must be a power of two. Returns nullptr for zero bytes.
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // Default initialized, nothing is destroyed on reset so only trivially destructible types are allowed
+        template<typename T>
+        std::span<T> allocateArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Frame allocations are never destroyed");
+            T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+            std::uninitialized_default_construct_n(data, count);
+            return {data, count};
+        }
+
+        // Invalidates every allocation made since the last reset
+        void reset();
+
+        // Bytes handed out since the last reset, including alignment padding and overflow
+        size_t getUsed() const { return mOffset + mOverflowSize; }
+        size_t getCapacity() const { return mCapacity; }
+        // Most bytes used by any frame so far
+        size_t getPeak() const { return mPeak; }
+        // Heap allocations made because the block was full, since construction
+        uint64_t getOverflowCount() const { return mOverflowCount; }
+
+    private:
+        std::unique_ptr<std::byte[]> mBlock;
+        size_t mCapacity = 0;
+        size_t mOffset = 0;
+        size_t mPeak = 0;
+        size_t mOverflowSize = 0;
+        uint64_t mOverflowCount = 0;
+        std::vector<std::unique_ptr<std::byte[]>> mOverflowBlocks;
+    };
+
+    // Fixed size slots for objects that are created and destroyed often. Slots are carved out of pages of
+    // SLOTS_PER_PAGE and recycled through a free list, pages are only freed with the pool.
+    // Every object must be destroyed before the pool is.
+    template<typename T, size_t SLOTS_PER_PAGE = 64>
+    class PoolAllocator
+    {
+    public:
+        PoolAllocator() = default;
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        template<typename... Args>
+        T* create(Args&&... args)
+        {
+            if (!mFreeSlots)
+            {
+                addPage();
+            }
+            Slot* slot = mFreeSlots;
+            mFreeSlots = slot->next;
+            T* object = new (slot->storage) T(std::forward<Args>(args)...);
+            mLiveCount++;
+            return object;
+        }
+
+        void destroy(T* object)
+        {
+            if (!object)
+            {
+                return;
+            }
+            object->~T();
+            Slot* slot = reinterpret_cast<Slot*>(object);
+            slot->next = mFreeSlots;
+            mFreeSlots = slot;
+            mLiveCount--;
+        }
+
+        // Adds pages until count objects fit without allocating
+        void reserve(size_t count)
+        {
+            while (getCapacity() < count)
+            {
+                addPage();
+            }
+        }
+
+        size_t getLiveCount() const { return mLiveCount; }
+        size_t getCapacity() const { return mPages.size() * SLOTS_PER_PAGE; }
+
+    private:
+        union Slot
+        {
+            Slot* next;
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> mPages;
+        Slot* mFreeSlots = nullptr;
+        size_t mLiveCount = 0;
+
+        void addPage()
+        {
+            mPages.push_back(std::make_unique<Slot[]>(SLOTS_PER_PAGE));
+            Slot* page = mPages.back().get();
+            // Chained in address order so consecutive creates touch consecutive memory
+            for (size_t i = SLOTS_PER_PAGE; i > 0; i--)
+            {
+                page[i - 1].next = mFreeSlots;
+                mFreeSlots = &page[i - 1];
+            }
+        }
+    };
+}  // namespace LearnVulkan
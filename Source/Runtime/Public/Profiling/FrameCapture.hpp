@@ -0,0 +1,124 @@
+#pragma once
+
+#include "FileSystem/MappedFile.hpp"
+#include "Render/DrawSorting.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace LearnVulkan
+{
+    enum FrameCaptureFlagBits : uint8_t
+    {
+        FRAME_CAPTURE_DEPTH_PREPASS_BIT = 1 << 0,
+        FRAME_CAPTURE_MESHLET_CULLING_BIT = 1 << 1,
+        FRAME_CAPTURE_DYNAMIC_RENDERING_BIT = 1 << 2,
+    };
+
+    // Everything updateUniformBuffer and recordCommandBuffer derive a frame from, and how long they took
+    struct FrameCaptureRecord
+    {
+        uint64_t frameIndex = 0;
+        // Since the capture was opened, when the frame started updating
+        uint64_t timestampMicroseconds = 0;
+        uint64_t graphicsPipelineKeyHash = 0;
+        // Seconds the scene has been animating for
+        float time = 0.0f;
+        float updateMilliseconds = 0.0f;
+        float recordMilliseconds = 0.0f;
+        uint32_t swapchainWidth = 0;
+        uint32_t swapchainHeight = 0;
+        // Frame in flight, which picks the uniform buffer, descriptor set and command buffer
+        uint32_t currentFrame = 0;
+        uint32_t imageIndex = 0;
+        uint32_t objectCount = 0;
+        uint8_t antiAliasingTier = 0;
+        uint8_t flags = 0;
+        uint16_t reserved = 0;
+        // Filled in by FrameCaptureWriter
+        uint32_t depthPrepassDrawCount = 0;
+        uint32_t shadingDrawCount = 0;
+        glm::mat4 view {1.0f};
+        glm::mat4 projection {1.0f};
+    };
+
+    struct FrameCaptureDraw
+    {
+        uint32_t objectIndex;
+        uint32_t lod;
+    };
+
+    // Appends the inputs of every frame to a ring buffer in a file mapping, the newest frames that fit are kept.
+    // Space is freed before it is written and a frame is only published once complete, so the file holds every
+    // frame up to the last complete one at any moment, including when the process crashes.
+    class FrameCaptureWriter
+    {
+    public:
+        // Frames larger than this share of the ring are dropped, so one huge frame cannot flush the history
+        static constexpr uint64_t MAX_FRAME_SHARE = 4;
+
+        // A capture already at path is kept as path + ".previous", it is usually what the run was started to look at.
+        // capacity is the size of the ring in bytes.
+        bool open(const std::string& path, size_t capacity);
+        void close();
+        bool isOpen() const { return mRing != nullptr; }
+
+        // Copies the frame and its draws into the ring, lod of each draw is objectLods[objectIndex]. Allocates and
+        // locks nothing. Returns false if the frame was dropped.
+        bool write(const FrameCaptureRecord& record,
+                   std::span<const DrawCommand> depthPrepassDraws,
+                   std::span<const DrawCommand> shadingDraws,
+                   std::span<const uint32_t> objectLods);
+
+        // Frames in the ring right now
+        uint64_t getFrameCount() const { return mFrameCount; }
+        uint64_t getWrittenCount() const { return mWrittenCount; }
+        uint64_t getDroppedCount() const { return mDroppedCount; }
+
+    private:
+        MappedFile mFile;
+        std::byte* mRing = nullptr;
+        uint64_t mCapacity = 0;
+        // Oldest frame and where the next one goes, mirrored into the header once they are safe to read
+        uint64_t mBegin = 0;
+        uint64_t mEnd = 0;
+        uint64_t mFrameCount = 0;
+        uint64_t mWrittenCount = 0;
+        uint64_t mDroppedCount = 0;
+
+        bool isFree(uint64_t offset, uint64_t size) const;
+        void evictOldest();
+    };
+
+    // Frames of a capture, oldest first. Everything is validated on open, a damaged file yields no frames.
+    class FrameCaptureReader
+    {
+    public:
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const { return mFile.isOpen(); }
+
+        size_t getFrameCount() const { return mFrames.size(); }
+        const FrameCaptureRecord& getFrame(size_t index) const { return mFrames[index].record; }
+        std::span<const FrameCaptureDraw> getDepthPrepassDraws(size_t index) const { return mFrames[index].depthPrepassDraws; }
+        std::span<const FrameCaptureDraw> getShadingDraws(size_t index) const { return mFrames[index].shadingDraws; }
+        // Every frame the writer was given, including those the ring no longer holds
+        uint64_t getWrittenCount() const { return mWrittenCount; }
+
+    private:
+        struct Frame
+        {
+            FrameCaptureRecord record;
+            // Views into the mapping
+            std::span<const FrameCaptureDraw> depthPrepassDraws;
+            std::span<const FrameCaptureDraw> shadingDraws;
+        };
+
+        MappedFile mFile;
+        std::vector<Frame> mFrames;
+        uint64_t mWrittenCount = 0;
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "vulkan/vulkan.h"
+#include <cstdint>
+
+namespace LearnVulkan
+{
+    enum class AntiAliasingTier : uint8_t
+    {
+        Off,
+        Msaa2x,
+        Msaa4x,
+        // Highest usable sample count with per-sample shading, the most expensive tier
+        MsaaSampleShading,
+        // Single sampled rendering followed by an FXAA compute pass
+        Fxaa,
+        Count,
+    };
+
+    const char* toString(AntiAliasingTier tier);
+
+    struct AntiAliasingSettings
+    {
+        VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
+        bool bSampleShading = false;
+        bool bPostProcess = false;
+
+        // Sample counts are clamped to what the device supports for both color and depth
+        static AntiAliasingSettings fromTier(AntiAliasingTier tier, VkSampleCountFlagBits maxSampleCount);
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "vulkan/vulkan.h"
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // A single descriptor set holding large, partially bound arrays of sampled images and storage buffers.
+    // Resources are referenced by their array index, so the set is bound once per command buffer and
+    // slots can be (re)written while earlier frames using other slots are still in flight.
+    //
+    // set = BINDLESS_SET, binding = TEXTURE_BINDING: sampler2D textures[]
+    // set = BINDLESS_SET, binding = STORAGE_BUFFER_BINDING: buffer storageBuffers[]
+    class BindlessResourceTable
+    {
+    public:
+        static const uint32_t TEXTURE_BINDING = 0;
+        static const uint32_t STORAGE_BUFFER_BINDING = 1;
+        static const uint32_t INVALID_INDEX = UINT32_MAX;
+
+        void initialize(VkDevice device, uint32_t maxTextures, uint32_t maxStorageBuffers, const VkAllocationCallbacks* allocator);
+        void finalize();
+
+        uint32_t registerTexture(VkImageView imageView, VkSampler sampler);
+        // The caller must make sure no frame in flight still reads the slot
+        void releaseTexture(uint32_t index);
+        uint32_t registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+        void releaseStorageBuffer(uint32_t index);
+
+        VkDescriptorSetLayout getDescriptorSetLayout() const { return mDescriptorSetLayout; }
+        VkDescriptorSet getDescriptorSet() const { return mDescriptorSet; }
+        uint32_t getTextureCount() const { return mTextureSlots.getUsedCount(); }
+        uint32_t getTextureCapacity() const { return mTextureSlots.getCapacity(); }
+        uint32_t getStorageBufferCount() const { return mStorageBufferSlots.getUsedCount(); }
+
+    private:
+        class SlotAllocator
+        {
+        public:
+            void reset(uint32_t capacity);
+            uint32_t allocate();
+            // Throws on slots that are not allocated, releasing one twice would hand it out to two resources
+            void release(uint32_t index);
+            uint32_t getUsedCount() const { return mNextUnused - static_cast<uint32_t>(mFreeList.size()); }
+            uint32_t getCapacity() const { return mCapacity; }
+
+        private:
+            uint32_t mCapacity = 0;
+            uint32_t mNextUnused = 0;
+            std::vector<uint32_t> mFreeList;
+            std::vector<bool> mUsedSlots;
+        };
+
+        VkDevice mDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* mAllocator = nullptr;
+        VkDescriptorSetLayout mDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool mDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet mDescriptorSet = VK_NULL_HANDLE;
+        SlotAllocator mTextureSlots;
+        SlotAllocator mStorageBufferSlots;
+    };
+}  // namespace LearnVulkan
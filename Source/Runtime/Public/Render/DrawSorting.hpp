@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace LearnVulkan
+{
+    enum class DrawSortOrder : uint8_t
+    {
+        // Nearest first so early depth testing rejects hidden fragments, then by state
+        FrontToBack,
+        // Fewest pipeline and material changes, for passes where the order does not change overdraw
+        State,
+        // Farthest first, for blended draws
+        BackToFront,
+    };
+
+    struct DrawCommand
+    {
+        uint64_t sortKey;
+        uint32_t objectIndex;
+    };
+
+    // Packs view depth (32 bits) and state (12 bits of pipeline, 20 bits of material) into one key.
+    // The order decides whether depth or state is the most significant half.
+    uint64_t makeDrawSortKey(DrawSortOrder order, float viewDepth, uint32_t pipelineIndex, uint32_t materialIndex);
+    void sortDrawCommands(std::span<DrawCommand> commands);
+}  // namespace LearnVulkan
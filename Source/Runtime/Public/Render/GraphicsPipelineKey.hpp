@@ -0,0 +1,68 @@
+#pragma once
+
+#include "vulkan/vulkan.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace LearnVulkan
+{
+    enum class BlendMode : uint8_t
+    {
+        Opaque,
+        AlphaBlend,
+    };
+
+    // Role of the pipeline in the scene pass
+    enum class DepthPass : uint8_t
+    {
+        // Tests with LESS and writes depth, no prepass
+        Combined,
+        // Depth only prepass, no fragment shader and no color writes
+        Prepass,
+        // Shades what the prepass left visible, tests with EQUAL and does not write depth
+        Shading,
+    };
+
+    // Feature toggles passed to Shader.frag as boolean specialization constants
+    enum PipelineFeatureFlagBits : uint32_t
+    {
+        PIPELINE_FEATURE_ALBEDO_TEXTURE_BIT = 1 << 0,
+    };
+
+    // Everything that differs between permutations of the graphics pipeline.
+    // Shaders, vertex layout and pipeline layout are shared by all of them.
+    struct GraphicsPipelineKey
+    {
+        // Must match the constant_id declarations in Shader.frag
+        static const uint32_t UV_SCALE_CONSTANT_ID = 0;
+        static const uint32_t ALBEDO_TEXTURE_CONSTANT_ID = 1;
+
+        // Color format and sample count decide which render passes, or dynamic rendering attachments, the pipeline is compatible with
+        VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+        VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
+        bool bSampleShading = false;
+        BlendMode blendMode = BlendMode::Opaque;
+        DepthPass depthPass = DepthPass::Combined;
+        VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+        float uvScale = 2.0f;
+        uint32_t featureFlags = PIPELINE_FEATURE_ALBEDO_TEXTURE_BIT;
+
+        bool operator==(const GraphicsPipelineKey& another) const = default;
+        size_t hash() const;
+        std::string toString() const;
+    };
+}  // namespace LearnVulkan
+
+namespace std
+{
+    template<>
+    struct hash<LearnVulkan::GraphicsPipelineKey>
+    {
+        size_t operator()(LearnVulkan::GraphicsPipelineKey const& key) const
+        {
+            return key.hash();
+        }
+    };
+}  // namespace std
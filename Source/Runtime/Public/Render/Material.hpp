@@ -0,0 +1,16 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+namespace LearnVulkan
+{
+    // Mirrors the std430 Material struct in Shader.frag, textures are referenced by bindless table index
+    struct Material
+    {
+        alignas(16) glm::vec4 baseColor;
+        uint32_t albedoTextureIndex;
+        uint32_t padding[3];
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Task/WorkerPool.hpp"
+#include "vulkan/vulkan.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LearnVulkan
+{
+    using RenderGraphResource = uint32_t;
+    using RenderGraphPass = uint32_t;
+
+    enum class RenderGraphAccess : uint8_t
+    {
+        ColorAttachmentWrite,
+        DepthAttachmentWrite,
+        DepthAttachmentRead,
+        FragmentSampledRead,
+        ComputeSampledRead,
+        ComputeStorageRead,
+        ComputeStorageWrite,
+        TransferRead,
+        TransferWrite,
+        // Transition for vkQueuePresentKHR, passes with a present access are never culled
+        Present,
+    };
+
+    struct RenderGraphImageState
+    {
+        VkPipelineStageFlags2KHR stageMask;
+        VkAccessFlags2KHR accessMask;
+        VkImageLayout layout;
+    };
+
+    RenderGraphImageState getAccessState(RenderGraphAccess access);
+    bool isWriteAccess(RenderGraphAccess access);
+    // Conservative stages and accesses for one-off transitions outside the graph
+    RenderGraphImageState getLayoutState(VkImageLayout layout);
+
+    struct RenderGraphImageDescription
+    {
+        VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        // Memory requirements of the image, images with a zero size are never aliased (e.g. lazily allocated ones)
+        VkDeviceSize size = 0;
+        uint32_t memoryTypeBits = 0;
+    };
+
+    struct RenderGraphBarrier
+    {
+        RenderGraphResource resource;
+        VkPipelineStageFlags2KHR srcStageMask;
+        VkAccessFlags2KHR srcAccessMask;
+        VkPipelineStageFlags2KHR dstStageMask;
+        VkAccessFlags2KHR dstAccessMask;
+        VkImageLayout oldLayout;
+        VkImageLayout newLayout;
+    };
+
+    struct RenderGraphStatistics
+    {
+        uint32_t passCount = 0;
+        uint32_t culledPassCount = 0;
+        uint32_t levelCount = 0;
+        uint32_t barrierCount = 0;
+        uint32_t aliasedImageCount = 0;
+        // Memory of every aliasable image, and what is left after aliasing
+        VkDeviceSize transientBytes = 0;
+        VkDeviceSize aliasedBytes = 0;
+    };
+
+    struct RenderGraphParallelRecording
+    {
+        // Called from worker threads, has to return a secondary command buffer from a pool no other pass records into
+        std::function<VkCommandBuffer(RenderGraphPass pass)> getSecondaryCommandBuffer;
+    };
+
+    // Frame graph of passes declaring how they access images. compile() culls passes whose results are never
+    // used, groups independent passes into levels, plans one batch of synchronization2 barriers per level and
+    // lets transient images with disjoint lifetimes share memory. Passes are declared in submission order.
+    class RenderGraph
+    {
+    public:
+        using RecordFunction = std::function<void(VkCommandBuffer commandBuffer)>;
+
+        // Only needed to record, building, compiling and validating work without a device
+        void initialize(VkDevice device);
+        void clear();
+
+        RenderGraphResource createImage(const std::string& name, const RenderGraphImageDescription& description);
+        // Lives outside the graph, initialState is the last access before the graph runs
+        RenderGraphResource importImage(const std::string& name, VkImageAspectFlags aspectMask, const RenderGraphImageState& initialState);
+        RenderGraphPass addPass(const std::string& name, RecordFunction record);
+        void addAccess(RenderGraphPass pass, RenderGraphResource resource, RenderGraphAccess access);
+        // Keeps the pass, and everything it reads from, even though no other pass uses its results
+        void setSideEffect(RenderGraphPass pass);
+        // The pass does not begin a render pass and may be recorded into a secondary command buffer
+        void setSecondaryRecordable(RenderGraphPass pass);
+
+        void compile();
+        // Replays the compiled plan and checks every hazard is covered by a barrier and aliased images never overlap
+        bool validate(std::string& error) const;
+
+        void bindImage(RenderGraphResource resource, VkImage image);
+        VkImage getImage(RenderGraphResource resource) const { return mResources[resource].image; }
+        void execute(VkCommandBuffer commandBuffer, const RenderGraphParallelRecording* parallelRecording = nullptr);
+        void recordImageBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspectMask, uint32_t mipLevels, const RenderGraphImageState& oldState, const RenderGraphImageState& newState) const;
+
+        bool isCulled(RenderGraphPass pass) const { return mPasses[pass].bCulled; }
+        uint32_t getPassLevel(RenderGraphPass pass) const { return mPasses[pass].level; }
+        uint32_t getLevelCount() const { return static_cast<uint32_t>(mLevels.size()); }
+        const std::vector<RenderGraphPass>& getLevelPasses(uint32_t level) const { return mLevels[level].passes; }
+        const std::vector<RenderGraphBarrier>& getLevelBarriers(uint32_t level) const { return mLevels[level].barriers; }
+        // Images sharing one allocation, ordered by first use. Images outside every group get their own memory.
+        const std::vector<std::vector<RenderGraphResource>>& getAliasGroups() const { return mAliasGroups; }
+        const RenderGraphStatistics& getStatistics() const { return mStatistics; }
+
+    private:
+        struct Resource
+        {
+            std::string name;
+            RenderGraphImageDescription description;
+            bool bImported;
+            RenderGraphImageState initialState;
+            VkImage image = VK_NULL_HANDLE;
+            // Filled by compile
+            bool bUsed = false;
+            uint32_t firstLevel = 0;
+            uint32_t lastLevel = 0;
+            RenderGraphResource aliasPredecessor = 0;
+            RenderGraphImageState finalState {};
+        };
+
+        struct Access
+        {
+            RenderGraphResource resource;
+            RenderGraphAccess access;
+        };
+
+        struct Pass
+        {
+            std::string name;
+            RecordFunction record;
+            std::vector<Access> accesses;
+            bool bSideEffect = false;
+            bool bSecondaryRecordable = false;
+            // Filled by compile
+            bool bCulled = false;
+            uint32_t level = 0;
+        };
+
+        struct Level
+        {
+            std::vector<RenderGraphPass> passes;
+            std::vector<RenderGraphBarrier> barriers;
+        };
+
+        std::vector<Resource> mResources;
+        std::vector<Pass> mPasses;
+        std::vector<Level> mLevels;
+        std::vector<std::vector<RenderGraphResource>> mAliasGroups;
+        RenderGraphStatistics mStatistics;
+        PFN_vkCmdPipelineBarrier2KHR mCmdPipelineBarrier2 = nullptr;
+        std::vector<VkImageMemoryBarrier2KHR> mImageBarriers;
+        // Passes of the level being recorded that go to secondary command buffers
+        std::vector<RenderGraphPass> mSecondaryPasses;
+        std::vector<VkCommandBuffer> mSecondaryCommandBuffers;
+        // Created by the first level with more than one secondary pass
+        std::unique_ptr<WorkerPool> mWorkerPool;
+
+        void cullPasses();
+        void assignLevels();
+        void planAliasing();
+        void planBarriers();
+        void recordLevel(VkCommandBuffer commandBuffer, const Level& level, const RenderGraphParallelRecording* parallelRecording);
+        VkImageMemoryBarrier2KHR makeImageBarrier(const RenderGraphBarrier& barrier) const;
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "VulkanUtility/DeviceCapabilities.hpp"
+#include "VulkanUtility/DeviceMemoryTracker.hpp"
+#include "VulkanUtility/VulkanObjectRegistry.hpp"
+#include "vulkan/vulkan.h"
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkan
+{
+    struct RenderTargetDescription
+    {
+        uint32_t width;
+        uint32_t height;
+        VkFormat format;
+        VkSampleCountFlagBits samples;
+        VkImageUsageFlags usage;
+        // Contents never leave the render pass (resolved MSAA color, depth that is not stored),
+        // so tile based devices can back the image with lazily allocated memory that is never committed
+        bool bTransient;
+    };
+
+    struct RenderTargetMemoryStatistics
+    {
+        // Sum of the memory requirements of every image
+        VkDeviceSize requestedBytes = 0;
+        // Sum of the allocation sizes, smaller than requested when images alias
+        VkDeviceSize allocatedBytes = 0;
+        // Allocated bytes with lazily allocated memory counted at its current commitment
+        VkDeviceSize committedBytes = 0;
+        uint32_t lazyAllocationCount = 0;
+        uint32_t aliasedImageCount = 0;
+    };
+
+    // Creates render target images and their memory. Freeing goes through the DeletionQueue with the image,
+    // aliased images only hand out the shared memory once.
+    class RenderTargetAllocator
+    {
+    public:
+        // capabilities must outlive the allocator. Memory is added to registry and memoryTracker if there are any.
+        void initialize(const DeviceCapabilities& capabilities,
+                        VkDevice device,
+                        const VkAllocationCallbacks* allocator,
+                        VulkanObjectRegistry* registry,
+                        DeviceMemoryTracker* memoryTracker);
+        bool supportsLazyAllocation() const { return mbLazyAllocationSupported; }
+        // Lazily allocated images have no memory worth sharing and must not alias anything
+        bool usesLazyAllocation(const RenderTargetDescription& description) const { return description.bTransient && mbLazyAllocationSupported; }
+        // Requirements of the image createAliasedImages would create, used to plan aliasing before anything is allocated
+        VkMemoryRequirements getMemoryRequirements(const RenderTargetDescription& description) const;
+
+        void createImage(const RenderTargetDescription& description, VkImage& image, VkDeviceMemory& memory);
+        // The images share one allocation, so at most one of them may hold live contents at any time and
+        // switching between them needs a barrier from VK_IMAGE_LAYOUT_UNDEFINED. Only images[0] receives the
+        // memory handle in memory, the others get VK_NULL_HANDLE so the memory is freed exactly once.
+        void createAliasedImages(const RenderTargetDescription* descriptions, uint32_t count, VkImage* images, VkDeviceMemory* memories);
+
+        // Forgets the allocations of the previous render target generation, their owners retire them
+        void resetStatistics();
+        RenderTargetMemoryStatistics getStatistics() const;
+
+    private:
+        struct Allocation
+        {
+            VkDeviceMemory memory;
+            VkDeviceSize size;
+            bool bLazy;
+        };
+
+        const DeviceCapabilities* mCapabilities = nullptr;
+        VkDevice mDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* mAllocator = nullptr;
+        VulkanObjectRegistry* mRegistry = nullptr;
+        DeviceMemoryTracker* mMemoryTracker = nullptr;
+        bool mbLazyAllocationSupported = false;
+        std::vector<Allocation> mAllocations;
+        VkDeviceSize mRequestedBytes = 0;
+        uint32_t mAliasedImageCount = 0;
+
+        VkImage createUnboundImage(const RenderTargetDescription& description, bool bLazy) const;
+        VkDeviceMemory allocate(const VkMemoryRequirements& requirements, bool bLazy);
+    };
+}  // namespace LearnVulkan
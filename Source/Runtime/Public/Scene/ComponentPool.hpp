@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Sparse set of one component type. Components are packed densely, a sparse table maps entity indices
+    // to their slot. Removal moves the last component into the hole, so iterating getData() never skips gaps.
+    template<typename T>
+    class ComponentPool
+    {
+    public:
+        static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+        bool contains(uint32_t entityIndex) const
+        {
+            return entityIndex < mSlots.size() && mSlots[entityIndex] != NO_SLOT;
+        }
+
+        // Replaces the component if the entity already has one
+        T& add(uint32_t entityIndex, const T& component)
+        {
+            if (contains(entityIndex))
+            {
+                return mData[mSlots[entityIndex]] = component;
+            }
+            if (entityIndex >= mSlots.size())
+            {
+                mSlots.resize(entityIndex + 1, NO_SLOT);
+            }
+            mSlots[entityIndex] = static_cast<uint32_t>(mData.size());
+            mEntities.push_back(entityIndex);
+            mData.push_back(component);
+            return mData.back();
+        }
+
+        void remove(uint32_t entityIndex)
+        {
+            if (!contains(entityIndex))
+            {
+                return;
+            }
+            uint32_t slot = mSlots[entityIndex];
+            uint32_t lastEntity = mEntities.back();
+            mData[slot] = mData.back();
+            mEntities[slot] = lastEntity;
+            mSlots[lastEntity] = slot;
+            mData.pop_back();
+            mEntities.pop_back();
+            mSlots[entityIndex] = NO_SLOT;
+        }
+
+        T& get(uint32_t entityIndex)
+        {
+            return mData[mSlots[entityIndex]];
+        }
+
+        const T& get(uint32_t entityIndex) const
+        {
+            return mData[mSlots[entityIndex]];
+        }
+
+        size_t size() const
+        {
+            return mData.size();
+        }
+
+        // Entry i of getEntities() owns entry i of getData()
+        const std::vector<uint32_t>& getEntities() const
+        {
+            return mEntities;
+        }
+
+        std::vector<T>& getData()
+        {
+            return mData;
+        }
+
+        const std::vector<T>& getData() const
+        {
+            return mData;
+        }
+
+    private:
+        std::vector<uint32_t> mSlots;
+        std::vector<uint32_t> mEntities;
+        std::vector<T> mData;
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Scene/ComponentPool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace LearnVulkan
+{
+    // The generation changes whenever an index is reused, so handles of destroyed entities are detected
+    struct Entity
+    {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool operator==(const Entity&) const = default;
+    };
+
+    const Entity NULL_ENTITY {};
+
+    // Relative to the parent, or to the world for roots
+    struct Transform
+    {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+    };
+
+    // Index into the meshes loaded by the application
+    struct MeshReference
+    {
+        uint32_t meshIndex;
+    };
+
+    // Index into the bindless material buffer
+    struct MaterialReference
+    {
+        uint32_t materialIndex;
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 center;
+        float radius;
+    };
+
+    // World bounds follow the world matrix on every transform update
+    struct Bounds
+    {
+        BoundingSphere local;
+        BoundingSphere world;
+    };
+
+    struct SceneUpdateStatistics
+    {
+        // World matrices recomputed by the last update
+        uint32_t updatedTransformCount;
+        uint32_t levelCount;
+        uint32_t threadCount;
+        double milliseconds;
+    };
+
+    // Entities with a mandatory transform and optional mesh, material and bounds components.
+    // Transforms are stored as parallel arrays ordered by hierarchy depth, so every level is one contiguous
+    // range whose parents all come before it, and a level can be split over threads without locks.
+    class Scene
+    {
+    public:
+        Entity createEntity(Entity parent = NULL_ENTITY);
+        // Destroys the descendants too, linear in the entity count
+        void destroyEntity(Entity entity);
+        bool isAlive(Entity entity) const;
+        size_t getEntityCount() const;
+
+        // Throws if parent has been destroyed, or is entity itself or one of its descendants
+        void setParent(Entity entity, Entity parent);
+        Entity getParent(Entity entity) const;
+        void setLocalTransform(Entity entity, const Transform& transform);
+        Transform getLocalTransform(Entity entity) const;
+        // As of the last updateTransforms
+        const glm::mat4& getWorldMatrix(Entity entity) const;
+
+        ComponentPool<MeshReference>& getMeshes() { return mMeshes; }
+        ComponentPool<MaterialReference>& getMaterials() { return mMaterials; }
+        // World bounds are refreshed by the next update
+        void setLocalBounds(Entity entity, const BoundingSphere& bounds);
+        const ComponentPool<Bounds>& getBounds() const { return mBounds; }
+
+        // Recomputes the world matrix of every entity whose local transform changed and of all their descendants,
+        // level by level, each level split over up to threadCount threads (0 uses every core). Small scenes stay
+        // on the calling thread. Hierarchy changes since the last update reorder the transforms first.
+        void updateTransforms(uint32_t threadCount = 0);
+        // Entities whose world matrix changed in the last update, the only ones that need uploading
+        const std::vector<Entity>& getChangedEntities() const { return mChangedEntities; }
+        const SceneUpdateStatistics& getUpdateStatistics() const { return mUpdateStatistics; }
+
+    private:
+        static constexpr uint32_t NO_INDEX = UINT32_MAX;
+
+        std::vector<uint32_t> mGenerations;
+        std::vector<uint32_t> mFreeIndices;
+        // Entity index to transform slot, NO_INDEX for destroyed entities
+        std::vector<uint32_t> mTransformSlots;
+
+        // One entry per transform slot
+        std::vector<uint32_t> mSlotEntities;
+        // Parent entity index, NO_INDEX for roots
+        std::vector<uint32_t> mParents;
+        // Parent slot, only valid while the hierarchy is sorted
+        std::vector<uint32_t> mParentSlots;
+        std::vector<glm::vec3> mPositions;
+        std::vector<glm::quat> mRotations;
+        std::vector<glm::vec3> mScales;
+        std::vector<glm::mat4> mWorldMatrices;
+        std::vector<uint8_t> mDirtyFlags;
+        // Set by an update for the slots whose world matrix it recomputed, children read their parent's flag
+        std::vector<uint8_t> mChangedFlags;
+        // First slot of every depth, plus the slot count
+        std::vector<uint32_t> mLevelOffsets;
+        // Next unclaimed slot of every level during an update, kept so updates do not allocate
+        std::vector<std::atomic<uint32_t>> mLevelCursors;
+        bool mbHierarchyChanged = false;
+        bool mbAnyDirty = false;
+
+        ComponentPool<MeshReference> mMeshes;
+        ComponentPool<MaterialReference> mMaterials;
+        ComponentPool<Bounds> mBounds;
+
+        std::vector<Entity> mChangedEntities;
+        SceneUpdateStatistics mUpdateStatistics {};
+
+        uint32_t getSlot(Entity entity) const;
+        void sortHierarchy();
+        uint32_t updateTransformRange(uint32_t firstSlot, uint32_t endSlot);
+    };
+}  // namespace LearnVulkan
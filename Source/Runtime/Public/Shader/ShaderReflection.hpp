@@ -0,0 +1,45 @@
+#pragma once
+
+#include "vulkan/vulkan.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkan
+{
+    struct ShaderDescriptorBinding
+    {
+        uint32_t set;
+        uint32_t binding;
+        VkDescriptorType descriptorType;
+        // 0 for runtime sized (bindless) arrays
+        uint32_t descriptorCount;
+    };
+
+    struct ShaderVertexInput
+    {
+        uint32_t location;
+        VkFormat format;
+        uint32_t size;
+    };
+
+    // Embedded SPIR-V and its reflection, instances are generated at build time by ShaderReflect
+    struct ShaderReflection
+    {
+        const char* sourceName;
+        VkShaderStageFlagBits stage;
+        const uint32_t* code;
+        size_t codeSize;
+        const ShaderDescriptorBinding* descriptorBindings;
+        uint32_t descriptorBindingCount;
+        // Sorted by location
+        const ShaderVertexInput* vertexInputs;
+        uint32_t vertexInputCount;
+        uint32_t pushConstantSize;
+
+        // Attributes packed tightly in location order, returns the resulting vertex stride
+        uint32_t getVertexAttributeDescriptions(uint32_t binding, std::vector<VkVertexInputAttributeDescription>& attributeDescriptions) const;
+        // Appends the bindings of the given set, merging stage flags of bindings already present
+        void collectDescriptorSetLayoutBindings(uint32_t set, std::vector<VkDescriptorSetLayoutBinding>& layoutBindings) const;
+    };
+}  // namespace LearnVulkan
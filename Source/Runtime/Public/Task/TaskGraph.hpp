@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LearnVulkan
+{
+    using TaskId = uint32_t;
+
+    // One-shot set of tasks with dependencies, run on a few threads as soon as each task's dependencies have
+    // finished. Dependencies must be added before their dependents, which keeps the graph acyclic and makes the
+    // ids a valid serial order. Records when every task ran so the critical path can be reported.
+    class TaskGraph
+    {
+    public:
+        TaskId addTask(const char* name, std::function<void()> function, const std::vector<TaskId>& dependencies = {});
+
+        // Runs on up to threadCount threads including the calling one, 0 uses every core. Among ready tasks the
+        // one added first runs first. If a task throws, tasks that have not started are skipped and the first
+        // exception is rethrown once every thread has stopped.
+        void execute(uint32_t threadCount = 0);
+
+        // Start and duration of every task, wall time against the summed task time and the critical path,
+        // the chain of dependencies with the longest total duration
+        void printReport(const char* title) const;
+
+    private:
+        struct Task
+        {
+            std::string name;
+            std::function<void()> function;
+            std::vector<TaskId> dependencies;
+            std::vector<TaskId> dependents;
+            // Relative to the start of execute
+            double startMilliseconds = 0.0;
+            double milliseconds = 0.0;
+            uint32_t threadIndex = 0;
+        };
+
+        std::vector<Task> mTasks;
+        double mWallMilliseconds = 0.0;
+        uint32_t mThreadCount = 0;
+    };
+}  // namespace LearnVulkan
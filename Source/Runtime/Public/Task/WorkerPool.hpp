@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Threads that live as long as the pool and run one parallel loop at a time, for work that repeats every
+    // frame. Starting a loop neither creates threads nor allocates.
+    class WorkerPool
+    {
+    public:
+        // Workers besides the calling thread, which joins every loop. 0 uses every core.
+        explicit WorkerPool(uint32_t workerCount = 0);
+        ~WorkerPool();
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // Calls function(i) once for every i below count, on the workers and the calling thread, and returns once
+        // every call has. Calls from one loop may run in any order and concurrently. Not reentrant.
+        template<typename Function>
+        void parallelFor(size_t count, Function&& function)
+        {
+            run(count, [](void* context, size_t index) { (*static_cast<std::remove_reference_t<Function>*>(context))(index); }, &function);
+        }
+
+        // Including the calling thread
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(mWorkers.size()) + 1; }
+
+    private:
+        using InvokeFunction = void (*)(void* context, size_t index);
+
+        std::vector<std::thread> mWorkers;
+        std::mutex mMutex;
+        std::condition_variable mLoopStarted;
+        std::condition_variable mLoopFinished;
+        // The current loop, written under the mutex before mGeneration moves on
+        InvokeFunction mInvoke = nullptr;
+        void* mContext = nullptr;
+        size_t mCount = 0;
+        std::atomic<size_t> mNextIndex = 0;
+        uint64_t mGeneration = 0;
+        // Workers that have not finished the current loop yet
+        uint32_t mBusyCount = 0;
+        bool mbStopping = false;
+
+        void run(size_t count, InvokeFunction invoke, void* context);
+        void runItems();
+        void workerLoop();
+    };
+}  // namespace LearnVulkan
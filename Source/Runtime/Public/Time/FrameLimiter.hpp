@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace LearnVulkan
+{
+    struct FramePacingStatistics
+    {
+        uint64_t frameCount = 0;
+        double meanMilliseconds = 0.0;
+        double varianceMilliseconds2 = 0.0;
+        double minMilliseconds = 0.0;
+        double maxMilliseconds = 0.0;
+    };
+
+    // CPU side frame rate limiter, it sleeps while the deadline is far away and spins for the last stretch
+    // because OS sleeps routinely overshoot by a millisecond or more.
+    class FrameLimiter
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        void setTargetFrameRate(uint32_t framesPerSecond);
+        bool isEnabled() const { return mFramePeriod.count() > 0; }
+
+        // Blocks until the next frame deadline, returns immediately when disabled
+        void wait();
+        // Records a frame boundary for pacing statistics
+        void markFrame();
+
+        const FramePacingStatistics& getStatistics() const { return mStatistics; }
+        void resetStatistics();
+
+    private:
+        static constexpr std::chrono::microseconds SPIN_THRESHOLD {2000};
+
+        Clock::duration mFramePeriod {0};
+        Clock::time_point mNextDeadline {};
+        Clock::time_point mLastFrame {};
+        bool mbHasLastFrame = false;
+        FramePacingStatistics mStatistics;
+        // Running sum of squared differences from the mean (Welford)
+        double mSquaredDeviationSum = 0.0;
+    };
+}  // namespace LearnVulkan
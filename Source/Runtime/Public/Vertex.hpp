@@ -1,4 +1,5 @@
-#include <array>
+#pragma once
+
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #define GLM_ENABLE_EXPERIMENTAL
@@ -16,7 +17,6 @@ namespace LearnVulkan
 
         bool operator==(const Vertex& another) const;
         static VkVertexInputBindingDescription getBindingDescription();
-        static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
     };
 }  // namespace LearnVulkan
 
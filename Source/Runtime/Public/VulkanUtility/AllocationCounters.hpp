@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace LearnVulkan
+{
+    // Live bytes and allocations with the peak and a running total, updated lock free from any thread
+    struct AllocationCounters
+    {
+        std::atomic<uint64_t> bytes = 0;
+        std::atomic<uint64_t> peakBytes = 0;
+        std::atomic<uint64_t> liveCount = 0;
+        // Every allocation so far
+        std::atomic<uint64_t> allocationCount = 0;
+
+        void add(uint64_t size)
+        {
+            uint64_t current = bytes += size;
+            liveCount++;
+            allocationCount++;
+            uint64_t peak = peakBytes.load(std::memory_order_relaxed);
+            while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void remove(uint64_t size)
+        {
+            bytes -= size;
+            liveCount--;
+        }
+
+        // Fills the fields every statistics struct has in common, the rest keep their defaults
+        template<typename Statistics>
+        Statistics load() const
+        {
+            Statistics statistics;
+            statistics.bytes = bytes;
+            statistics.peakBytes = peakBytes;
+            statistics.liveCount = liveCount;
+            statistics.allocationCount = allocationCount;
+            return statistics;
+        }
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "VulkanUtility/VulkanHandle.hpp"
+#include "vulkan/vulkan.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace LearnVulkan
+{
+    // Defers destruction of Vulkan objects until the frame that last used them has finished on the GPU.
+    // Frames are submitted to a single queue, so they complete in order and the queue stays sorted by frame index.
+    class DeletionQueue
+    {
+    public:
+        // Destroys one retired object, auxiliaryHandle is what it was retired with. Returns false if the object was not destroyed.
+        using DestroyFunction = bool (*)(VkDevice device, VkObjectType type, uint64_t handle, uint64_t auxiliaryHandle, const VkAllocationCallbacks* allocator);
+
+        DeletionQueue() = default;
+        ~DeletionQueue();
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        // Objects are destroyed with the context's allocator and removed from its registry
+        void initialize(const VulkanDeviceContext& context);
+        // Replaces the vkDestroy* calls, lets tests run the queue without a device
+        void setDestroyFunction(DestroyFunction destroyFunction) { mDestroyFunction = destroyFunction; }
+
+        // Take over ownership, the handles are left empty. Aliased images may come without memory.
+        void retireBuffer(UniqueBuffer&& buffer, UniqueDeviceMemory&& memory, uint64_t frameIndex);
+        void retireImage(UniqueImage&& image, UniqueDeviceMemory&& memory, uint64_t frameIndex);
+        void retireImageView(UniqueImageView&& imageView, uint64_t frameIndex);
+        void retireSampler(UniqueSampler&& sampler, uint64_t frameIndex);
+        void retireFramebuffer(UniqueFramebuffer&& framebuffer, uint64_t frameIndex);
+        void retireRenderPass(UniqueRenderPass&& renderPass, uint64_t frameIndex);
+        void retirePipeline(UniquePipeline&& pipeline, uint64_t frameIndex);
+        void retirePipelineLayout(UniquePipelineLayout&& pipelineLayout, uint64_t frameIndex);
+        void retireDescriptorPool(UniqueDescriptorPool&& descriptorPool, uint64_t frameIndex);
+        // The pool must have been created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+        void retireDescriptorSet(VkDescriptorSet descriptorSet, VkDescriptorPool descriptorPool, uint64_t frameIndex);
+        void retireSwapchain(VkSwapchainKHR swapchain, uint64_t frameIndex);
+        // For resources that are not Vulkan objects, e.g. bindless table slots
+        void retireCallback(std::function<void()> callback, uint64_t frameIndex);
+
+        // Destroys every object whose last user is at or before completedFrameIndex
+        void collect(uint64_t completedFrameIndex);
+        // Destroys everything regardless of frame index, the device must be idle
+        void flush();
+
+        size_t getPendingCount() const { return mRetiredObjects.size() + mRetiredCallbacks.size(); }
+        uint64_t getRetiredCount() const { return mRetiredCount; }
+        uint64_t getDestroyedCount() const { return mDestroyedCount; }
+        // Objects the destroy function refused, they are reported and stay in the registry
+        uint64_t getLeakedCount() const { return mLeakedCount; }
+
+        // The types destroyVulkanObject handles, the retire functions only compile for these
+        static constexpr bool canDestroy(VkObjectType type)
+        {
+            switch (type)
+            {
+                case VK_OBJECT_TYPE_BUFFER:
+                case VK_OBJECT_TYPE_IMAGE:
+                case VK_OBJECT_TYPE_IMAGE_VIEW:
+                case VK_OBJECT_TYPE_SAMPLER:
+                case VK_OBJECT_TYPE_FRAMEBUFFER:
+                case VK_OBJECT_TYPE_RENDER_PASS:
+                case VK_OBJECT_TYPE_PIPELINE:
+                case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+                case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+                case VK_OBJECT_TYPE_DESCRIPTOR_SET:
+                case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+    private:
+        struct RetiredObject
+        {
+            VkObjectType type;
+            uint64_t handle;
+            // Memory bound to a buffer / image, or the owning pool of a descriptor set
+            uint64_t auxiliaryHandle;
+            uint64_t frameIndex;
+        };
+
+        VkDevice mDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* mAllocator = nullptr;
+        VulkanObjectRegistry* mRegistry = nullptr;
+        DeviceMemoryTracker* mMemoryTracker = nullptr;
+        DestroyFunction mDestroyFunction = destroyVulkanObject;
+        std::deque<RetiredObject> mRetiredObjects;
+        std::deque<std::pair<uint64_t, std::function<void()>>> mRetiredCallbacks;
+        uint64_t mRetiredCount = 0;
+        uint64_t mDestroyedCount = 0;
+        uint64_t mLeakedCount = 0;
+
+        template<VkObjectType TYPE>
+        void retire(uint64_t handle, uint64_t auxiliaryHandle, uint64_t frameIndex)
+        {
+            static_assert(canDestroy(TYPE), "DeletionQueue cannot destroy this object type");
+            retire(TYPE, handle, auxiliaryHandle, frameIndex);
+        }
+        void retire(VkObjectType type, uint64_t handle, uint64_t auxiliaryHandle, uint64_t frameIndex);
+        void destroy(const RetiredObject& object);
+        static bool destroyVulkanObject(VkDevice device, VkObjectType type, uint64_t handle, uint64_t auxiliaryHandle, const VkAllocationCallbacks* allocator);
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "vulkan/vulkan.h"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Everything the application asks about a physical device, queried once when the device is rated and
+    // shared by every subsystem afterwards. Read-only after query, so it can be used from worker threads.
+    // Surface capabilities are not included, they change with the window size.
+    class DeviceCapabilities
+    {
+    public:
+        // present support is queried against surface for every queue family
+        void query(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
+
+        VkPhysicalDevice getPhysicalDevice() const { return mPhysicalDevice; }
+        const VkPhysicalDeviceProperties& getProperties() const { return mProperties; }
+        const VkPhysicalDeviceFeatures& getFeatures() const { return mFeatures; }
+        const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const { return mMemoryProperties; }
+        const VkPhysicalDeviceDescriptorIndexingFeatures& getDescriptorIndexingFeatures() const { return mDescriptorIndexingFeatures; }
+        const VkPhysicalDeviceDescriptorIndexingProperties& getDescriptorIndexingProperties() const { return mDescriptorIndexingProperties; }
+        // False unless the extension is available
+        bool supportsSynchronization2() const { return mSynchronization2Features.synchronization2; }
+        bool supportsDynamicRendering() const { return mDynamicRenderingFeatures.dynamicRendering; }
+
+        const std::vector<VkQueueFamilyProperties>& getQueueFamilies() const { return mQueueFamilies; }
+        bool supportsPresent(uint32_t queueFamilyIndex) const { return mPresentSupport[queueFamilyIndex]; }
+
+        bool hasExtension(const char* extensionName) const { return mExtensions.count(extensionName) != 0; }
+        // Core formats come from a table filled by query, extension formats are queried on every call
+        VkFormatProperties getFormatProperties(VkFormat format) const;
+        bool findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex) const;
+
+    private:
+        VkPhysicalDevice mPhysicalDevice = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties mProperties {};
+        VkPhysicalDeviceFeatures mFeatures {};
+        VkPhysicalDeviceMemoryProperties mMemoryProperties {};
+        VkPhysicalDeviceDescriptorIndexingFeatures mDescriptorIndexingFeatures {};
+        VkPhysicalDeviceDescriptorIndexingProperties mDescriptorIndexingProperties {};
+        VkPhysicalDeviceSynchronization2FeaturesKHR mSynchronization2Features {};
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR mDynamicRenderingFeatures {};
+        std::vector<VkQueueFamilyProperties> mQueueFamilies;
+        std::vector<bool> mPresentSupport;
+        std::unordered_set<std::string> mExtensions;
+        // Indexed by VkFormat, covers the contiguous range of core formats
+        std::vector<VkFormatProperties> mFormatProperties;
+    };
+}  // namespace LearnVulkan
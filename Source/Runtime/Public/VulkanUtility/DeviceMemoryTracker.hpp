@@ -0,0 +1,132 @@
+#pragma once
+
+#include "VulkanUtility/AllocationCounters.hpp"
+#include "VulkanUtility/DeviceCapabilities.hpp"
+#include "vulkan/vulkan.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+namespace LearnVulkan
+{
+    // What a device memory allocation backs
+    enum class DeviceMemoryCategory : uint8_t
+    {
+        Vertex,
+        Index,
+        Uniform,
+        // Materials, meshlets and the meshlet culling buffers
+        Storage,
+        Texture,
+        RenderTarget,
+        // Upload sources, freed right after their copy
+        Staging,
+        Count,
+    };
+
+    const char* getDeviceMemoryCategoryName(DeviceMemoryCategory category);
+
+    struct DeviceMemoryStatistics
+    {
+        uint64_t bytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t liveCount = 0;
+        // Every allocation so far
+        uint64_t allocationCount = 0;
+    };
+
+    struct DeviceMemoryHeapUsage
+    {
+        VkDeviceSize size = 0;
+        VkMemoryHeapFlags flags = 0;
+        // Allocated through the tracker
+        VkDeviceSize trackedBytes = 0;
+        // From VK_EXT_memory_budget, usage includes other processes and the driver. Without the extension the
+        // budget is the heap size and usage the tracked bytes.
+        VkDeviceSize budget = 0;
+        VkDeviceSize usage = 0;
+    };
+
+    struct DeviceMemoryFrameCounters
+    {
+        uint64_t frameIndex = 0;
+        uint32_t allocationCount = 0;
+        uint32_t freeCount = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t freedBytes = 0;
+        // In use at the end of the frame
+        uint64_t bytes = 0;
+    };
+
+    // Device memory by category and heap, per frame allocation counters and heap budgets. Allocations are added by
+    // whoever allocates them and removed by whoever frees them, VulkanHandle and DeletionQueue do the latter.
+    // add and remove are thread safe, everything else belongs to the thread running the frame loop.
+    class DeviceMemoryTracker
+    {
+    public:
+        static constexpr size_t FRAME_HISTORY_SIZE = 256;
+
+        // capabilities must outlive the tracker. bMemoryBudget if VK_EXT_memory_budget is enabled on the device.
+        void initialize(const DeviceCapabilities& capabilities, bool bMemoryBudget);
+        bool hasMemoryBudget() const { return mbMemoryBudget; }
+
+        void add(VkDeviceMemory memory, uint32_t memoryTypeIndex, VkDeviceSize bytes, DeviceMemoryCategory category);
+        // Memory that was never added is ignored
+        void remove(uint64_t memory);
+
+        // Closes the counters of the frame and keeps them in the history, allocates nothing
+        void endFrame(uint64_t frameIndex);
+        // Asks the driver for the current budgets, no-op without VK_EXT_memory_budget
+        void updateBudget();
+
+        DeviceMemoryStatistics getStatistics(DeviceMemoryCategory category) const;
+        DeviceMemoryStatistics getTotalStatistics() const;
+        uint32_t getHeapCount() const { return mHeapCount; }
+        // As of the last updateBudget
+        DeviceMemoryHeapUsage getHeapUsage(uint32_t heapIndex) const;
+        // Oldest first, at most FRAME_HISTORY_SIZE
+        size_t getFrameHistorySize() const { return mFrameHistorySize; }
+        const DeviceMemoryFrameCounters& getFrameCounters(size_t age) const;
+        // True if a heap's usage went over its budget on the last updateBudget
+        bool isOverBudget() const;
+
+        void printReport(const char* title) const;
+        // One JSON object with the totals, every category, every heap and the frame history
+        void writeJson(std::ostream& out) const;
+
+    private:
+        struct Allocation
+        {
+            VkDeviceSize bytes;
+            uint32_t heapIndex;
+            DeviceMemoryCategory category;
+        };
+
+        static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(DeviceMemoryCategory::Count);
+
+        const DeviceCapabilities* mCapabilities = nullptr;
+        bool mbMemoryBudget = false;
+        uint32_t mHeapCount = 0;
+        std::array<AllocationCounters, CATEGORY_COUNT> mCategoryCounters;
+        AllocationCounters mTotalCounters;
+        std::array<std::atomic<uint64_t>, VK_MAX_MEMORY_HEAPS> mHeapBytes {};
+        std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> mHeapBudgets {};
+        std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> mHeapUsages {};
+
+        mutable std::mutex mMutex;
+        std::unordered_map<uint64_t, Allocation> mAllocations;
+
+        // Since the last endFrame
+        std::atomic<uint32_t> mFrameAllocationCount = 0;
+        std::atomic<uint32_t> mFrameFreeCount = 0;
+        std::atomic<uint64_t> mFrameAllocatedBytes = 0;
+        std::atomic<uint64_t> mFrameFreedBytes = 0;
+        std::array<DeviceMemoryFrameCounters, FRAME_HISTORY_SIZE> mFrameHistory {};
+        size_t mFrameHistoryNext = 0;
+        size_t mFrameHistorySize = 0;
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "VulkanUtility/AllocationCounters.hpp"
+#include "vulkan/vulkan.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace LearnVulkan
+{
+    // Who created the Vulkan object a host allocation was made for. Command scope allocations made while recording
+    // or submitting go to the subsystem of the pool or device they were made through.
+    enum class HostAllocationSubsystem : uint8_t
+    {
+        // Instance, surface and debug messenger, also what the loader allocates for them
+        Instance,
+        Device,
+        Swapchain,
+        RenderTargets,
+        Pipelines,
+        Descriptors,
+        // Buffers, textures, views, samplers and their memory
+        Resources,
+        Commands,
+        Synchronization,
+        Count,
+    };
+
+    const char* getHostAllocationSubsystemName(HostAllocationSubsystem subsystem);
+
+    struct HostAllocationStatistics
+    {
+        // Currently allocated through the callbacks, excluding headers and padding
+        uint64_t bytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t liveCount = 0;
+        // Every allocation and reallocation so far
+        uint64_t allocationCount = 0;
+        // Memory the driver allocated itself and only reported, e.g. executable code
+        uint64_t internalBytes = 0;
+    };
+
+    // Implements VkAllocationCallbacks on malloc, with statistics per subsystem and allocation scope and an optional
+    // pool of fixed size blocks for small allocations. Every subsystem gets its own callbacks, all of them free
+    // through the same allocator so objects may be destroyed with the callbacks of any subsystem.
+    // Must outlive the instance, drivers may call it from any thread.
+    class HostAllocator
+    {
+    public:
+        static constexpr size_t SCOPE_COUNT = 5;
+
+        HostAllocator();
+        ~HostAllocator();
+        HostAllocator(const HostAllocator&) = delete;
+        HostAllocator& operator=(const HostAllocator&) = delete;
+
+        // Call before the instance is created. Disabled, every subsystem gets nullptr and Vulkan allocates itself.
+        void initialize(bool bEnabled, bool bPooled);
+        bool isEnabled() const { return mbEnabled; }
+
+        const VkAllocationCallbacks* getCallbacks(HostAllocationSubsystem subsystem) const;
+
+        HostAllocationStatistics getStatistics(HostAllocationSubsystem subsystem, VkSystemAllocationScope scope) const;
+        // Summed over every scope
+        HostAllocationStatistics getStatistics(HostAllocationSubsystem subsystem) const;
+        HostAllocationStatistics getTotalStatistics() const;
+        uint64_t getPooledAllocationCount() const { return mPooledAllocationCount; }
+        // Reserved for the pool, whether in use or not
+        uint64_t getPoolCapacity() const;
+        void printReport(const char* title) const;
+
+    private:
+        struct Counters : AllocationCounters
+        {
+            std::atomic<int64_t> internalBytes = 0;
+        };
+
+        // What the callbacks of one subsystem point pUserData at
+        struct Context
+        {
+            HostAllocator* allocator;
+            HostAllocationSubsystem subsystem;
+        };
+
+        struct SizeClass
+        {
+            size_t blockSize = 0;
+            mutable std::mutex mutex;
+            void* freeBlocks = nullptr;
+            std::vector<void*> pages;
+        };
+
+        static constexpr size_t SUBSYSTEM_COUNT = static_cast<size_t>(HostAllocationSubsystem::Count);
+        static constexpr size_t SIZE_CLASS_COUNT = 4;
+
+        bool mbEnabled = false;
+        bool mbPooled = false;
+        std::array<Context, SUBSYSTEM_COUNT> mContexts;
+        std::array<VkAllocationCallbacks, SUBSYSTEM_COUNT> mCallbacks;
+        // One entry per scope plus the sum of all scopes
+        std::array<std::array<Counters, SCOPE_COUNT + 1>, SUBSYSTEM_COUNT> mCounters;
+        Counters mTotalCounters;
+        std::array<SizeClass, SIZE_CLASS_COUNT> mSizeClasses;
+        std::atomic<uint64_t> mPooledAllocationCount = 0;
+
+        void* allocate(size_t size, size_t alignment, VkSystemAllocationScope scope, HostAllocationSubsystem subsystem);
+        void* reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope, HostAllocationSubsystem subsystem);
+        void free(void* memory);
+        void* allocateBlock(size_t sizeClass);
+        void freeBlock(size_t sizeClass, void* block);
+        void count(HostAllocationSubsystem subsystem, uint32_t scope, uint64_t bytes, bool bAllocation);
+        static HostAllocationStatistics load(const Counters& counters);
+
+        static void* VKAPI_PTR allocation(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static void* VKAPI_PTR reallocation(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static void VKAPI_PTR freeMemory(void* userData, void* memory);
+        static void VKAPI_PTR internalAllocation(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+        static void VKAPI_PTR internalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+    };
+}  // namespace LearnVulkan
@@ -0,0 +1,35 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+namespace LearnVulkan
+{
+    // One per meshlet in the meshlet storage buffer, must match Meshlet in MeshletCull.comp
+    struct MeshletBufferObject
+    {
+        // Bounding sphere center and radius
+        alignas(16) glm::vec4 sphere;
+        // Normal cone axis and cutoff
+        alignas(16) glm::vec4 cone;
+        // Index range in the model index buffer
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t padding[2];
+    };
+
+    // Camera data of MeshletCull.comp, written once per frame
+    struct MeshletCullingPushConstantObject
+    {
+        // World space planes facing inwards, xyz normalized
+        alignas(16) glm::vec4 frustumPlanes[6];
+        alignas(16) glm::vec4 cameraPosition;
+        uint32_t meshletCount;
+        // Cone culling is only valid when the pipeline culls back faces
+        uint32_t bConeCulling;
+    };
+
+    static_assert(sizeof(MeshletBufferObject) == 48, "MeshletBufferObject must match the std430 layout of Meshlet");
+    static_assert(sizeof(MeshletCullingPushConstantObject) <= 128, "Push constants larger than 128 bytes are not portable");
+}  // namespace LearnVulkan
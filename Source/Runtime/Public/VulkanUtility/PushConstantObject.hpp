@@ -0,0 +1,17 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+namespace LearnVulkan
+{
+    // Per-draw data pushed before every draw, must stay within the guaranteed 128 bytes of push constant space
+    struct PushConstantObject
+    {
+        alignas(16) glm::mat4 model;
+        uint32_t materialIndex;
+    };
+
+    static_assert(sizeof(PushConstantObject) <= 128, "Push constants larger than 128 bytes are not portable");
+}  // namespace LearnVulkan
@@ -6,9 +6,9 @@
 
 namespace LearnVulkan
 {
+    // Per-frame camera data, written once per frame
     struct UniformBufferObject
     {
-        alignas(16) glm::mat4 model;
         alignas(16) glm::mat4 view;
         alignas(16) glm::mat4 projection;
     };
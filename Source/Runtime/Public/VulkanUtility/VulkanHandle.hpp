@@ -0,0 +1,170 @@
+#pragma once
+
+#include "VulkanUtility/DeviceMemoryTracker.hpp"
+#include "VulkanUtility/VulkanObjectRegistry.hpp"
+#include "vulkan/vulkan.h"
+#include <cstdint>
+#include <source_location>
+
+namespace LearnVulkan
+{
+    // What device objects need to destroy themselves. Handles do not store it, every handle goes through the bound
+    // one, which keeps an owning handle the size of the raw handle. One device at a time.
+    struct VulkanDeviceContext
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        // Must free compatibly with whatever each object was created with, HostAllocator callbacks all do
+        const VkAllocationCallbacks* allocator = nullptr;
+        // Null unless objects are tracked
+        VulkanObjectRegistry* registry = nullptr;
+        // Told when device memory is freed, allocations are added by whoever allocates them
+        DeviceMemoryTracker* memoryTracker = nullptr;
+
+        // Bound by the owner of the device before the first handle is created and unbound after the device is
+        // destroyed. Not synchronized, handles may only be used on other threads while the binding stays the same.
+        static void bind(const VulkanDeviceContext* context) { sBoundContext = context; }
+        static const VulkanDeviceContext* getBound() { return sBoundContext; }
+
+    private:
+        static inline const VulkanDeviceContext* sBoundContext = nullptr;
+    };
+
+    // Handle type and destroy function per object type. Keyed by VkObjectType rather than the handle type,
+    // non-dispatchable handles are all uint64_t on 32-bit platforms.
+    template<VkObjectType TYPE>
+    struct VulkanObjectTraits;
+
+#define LEARN_VULKAN_OBJECT_TRAITS(objectType, HandleType, destroyFunction)                                     \
+    template<>                                                                                                  \
+    struct VulkanObjectTraits<objectType>                                                                       \
+    {                                                                                                           \
+        using Handle = HandleType;                                                                              \
+        static void destroy(VkDevice device, Handle handle, const VkAllocationCallbacks* allocator)            \
+        {                                                                                                       \
+            destroyFunction(device, handle, allocator);                                                         \
+        }                                                                                                       \
+    };
+
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_BUFFER, VkBuffer, vkDestroyBuffer)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_DEVICE_MEMORY, VkDeviceMemory, vkFreeMemory)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_IMAGE, VkImage, vkDestroyImage)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_IMAGE_VIEW, VkImageView, vkDestroyImageView)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_SAMPLER, VkSampler, vkDestroySampler)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_FRAMEBUFFER, VkFramebuffer, vkDestroyFramebuffer)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_RENDER_PASS, VkRenderPass, vkDestroyRenderPass)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_PIPELINE, VkPipeline, vkDestroyPipeline)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_PIPELINE_LAYOUT, VkPipelineLayout, vkDestroyPipelineLayout)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_PIPELINE_CACHE, VkPipelineCache, vkDestroyPipelineCache)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_SHADER_MODULE, VkShaderModule, vkDestroyShaderModule)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, VkDescriptorSetLayout, vkDestroyDescriptorSetLayout)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_DESCRIPTOR_POOL, VkDescriptorPool, vkDestroyDescriptorPool)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_COMMAND_POOL, VkCommandPool, vkDestroyCommandPool)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_QUERY_POOL, VkQueryPool, vkDestroyQueryPool)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_SEMAPHORE, VkSemaphore, vkDestroySemaphore)
+    LEARN_VULKAN_OBJECT_TRAITS(VK_OBJECT_TYPE_FENCE, VkFence, vkDestroyFence)
+#undef LEARN_VULKAN_OBJECT_TRAITS
+
+    // Owns one device object and destroys it when it goes out of scope or is overwritten. Converts to the raw
+    // handle implicitly so it can be passed to any Vulkan call, which costs nothing over the raw handle.
+    // Destroying is immediate, objects the GPU may still use are handed to DeletionQueue instead.
+    // Without a bound context, or once its device is reset to VK_NULL_HANDLE, handles are dropped without destroying them.
+    template<VkObjectType TYPE>
+    class VulkanHandle
+    {
+    public:
+        using Handle = typename VulkanObjectTraits<TYPE>::Handle;
+
+        VulkanHandle() = default;
+        // Takes ownership and adds the object to the bound context's registry. bytes is the size of device memory.
+        explicit VulkanHandle(Handle handle, VkDeviceSize bytes = 0, std::source_location location = std::source_location::current())
+            : mHandle(handle)
+        {
+            const VulkanDeviceContext* context = VulkanDeviceContext::getBound();
+            if (context && context->registry)
+            {
+                context->registry->add(TYPE, (uint64_t)(mHandle), bytes, location);
+            }
+        }
+        ~VulkanHandle()
+        {
+            // Checked here, where the class is complete, for every handle type that is used
+            static_assert(sizeof(VulkanHandle) == sizeof(Handle), "Owning handles must be no larger than the raw handle");
+            reset();
+        }
+        VulkanHandle(const VulkanHandle&) = delete;
+        VulkanHandle& operator=(const VulkanHandle&) = delete;
+        VulkanHandle(VulkanHandle&& other) noexcept
+            : mHandle(other.mHandle)
+        {
+            other.mHandle = VK_NULL_HANDLE;
+        }
+        VulkanHandle& operator=(VulkanHandle&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                mHandle = other.mHandle;
+                other.mHandle = VK_NULL_HANDLE;
+            }
+            return *this;
+        }
+
+        Handle get() const { return mHandle; }
+        operator Handle() const { return mHandle; }
+
+        // Destroys the object now, the GPU must be done with it
+        void reset()
+        {
+            if (mHandle == VK_NULL_HANDLE)
+            {
+                return;
+            }
+            const VulkanDeviceContext* context = VulkanDeviceContext::getBound();
+            if (context && context->device != VK_NULL_HANDLE)
+            {
+                VulkanObjectTraits<TYPE>::destroy(context->device, mHandle, context->allocator);
+                if (context->registry)
+                {
+                    context->registry->remove(TYPE, (uint64_t)(mHandle));
+                }
+                if constexpr (TYPE == VK_OBJECT_TYPE_DEVICE_MEMORY)
+                {
+                    if (context->memoryTracker)
+                    {
+                        context->memoryTracker->remove((uint64_t)(mHandle));
+                    }
+                }
+            }
+            mHandle = VK_NULL_HANDLE;
+        }
+
+        // Gives up ownership without destroying. The object stays in the registry until its new owner destroys it.
+        Handle release()
+        {
+            Handle handle = mHandle;
+            mHandle = VK_NULL_HANDLE;
+            return handle;
+        }
+
+    private:
+        Handle mHandle = VK_NULL_HANDLE;
+    };
+
+    using UniqueBuffer = VulkanHandle<VK_OBJECT_TYPE_BUFFER>;
+    using UniqueDeviceMemory = VulkanHandle<VK_OBJECT_TYPE_DEVICE_MEMORY>;
+    using UniqueImage = VulkanHandle<VK_OBJECT_TYPE_IMAGE>;
+    using UniqueImageView = VulkanHandle<VK_OBJECT_TYPE_IMAGE_VIEW>;
+    using UniqueSampler = VulkanHandle<VK_OBJECT_TYPE_SAMPLER>;
+    using UniqueFramebuffer = VulkanHandle<VK_OBJECT_TYPE_FRAMEBUFFER>;
+    using UniqueRenderPass = VulkanHandle<VK_OBJECT_TYPE_RENDER_PASS>;
+    using UniquePipeline = VulkanHandle<VK_OBJECT_TYPE_PIPELINE>;
+    using UniquePipelineLayout = VulkanHandle<VK_OBJECT_TYPE_PIPELINE_LAYOUT>;
+    using UniquePipelineCache = VulkanHandle<VK_OBJECT_TYPE_PIPELINE_CACHE>;
+    using UniqueShaderModule = VulkanHandle<VK_OBJECT_TYPE_SHADER_MODULE>;
+    using UniqueDescriptorSetLayout = VulkanHandle<VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT>;
+    using UniqueDescriptorPool = VulkanHandle<VK_OBJECT_TYPE_DESCRIPTOR_POOL>;
+    using UniqueCommandPool = VulkanHandle<VK_OBJECT_TYPE_COMMAND_POOL>;
+    using UniqueQueryPool = VulkanHandle<VK_OBJECT_TYPE_QUERY_POOL>;
+    using UniqueSemaphore = VulkanHandle<VK_OBJECT_TYPE_SEMAPHORE>;
+    using UniqueFence = VulkanHandle<VK_OBJECT_TYPE_FENCE>;
+}  // namespace LearnVulkan
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "vulkan/vulkan.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <source_location>
+#include <unordered_map>
+
+namespace LearnVulkan
+{
+    const char* getVulkanObjectTypeName(VkObjectType type);
+
+    // Every live device object with the size of its memory, where and in which frame it was created. Objects are
+    // added by whoever creates them and removed by whoever destroys them, VulkanHandle and DeletionQueue do both.
+    // Meant for debug builds and soak tests, lookups take a lock. Thread safe.
+    class VulkanObjectRegistry
+    {
+    public:
+        // Stamped on objects added from now on
+        void setFrameIndex(uint64_t frameIndex) { mFrameIndex.store(frameIndex, std::memory_order_relaxed); }
+
+        // The first add of a handle wins, so a creator that knows more, e.g. the size of memory, can add before
+        // the handle is wrapped. bytes is only meaningful for VkDeviceMemory.
+        void add(VkObjectType type, uint64_t handle, VkDeviceSize bytes, const std::source_location& location);
+        // Handles that were never added are ignored
+        void remove(VkObjectType type, uint64_t handle);
+
+        size_t getLiveCount() const;
+        VkDeviceSize getLiveBytes() const;
+        // Live objects grouped by type and creation site, largest groups first. Sites that grow between two calls
+        // are what leaks during a soak test.
+        void printLiveObjects(const char* title, size_t maxSites) const;
+        // Prints every live object, returns how many there were
+        size_t printLeaks(const char* title) const;
+
+    private:
+        struct Key
+        {
+            VkObjectType type;
+            uint64_t handle;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const { return std::hash<uint64_t>()(key.handle) ^ static_cast<size_t>(key.type); }
+        };
+
+        struct Record
+        {
+            VkDeviceSize bytes;
+            std::source_location location;
+            uint64_t frameIndex;
+        };
+
+        mutable std::mutex mMutex;
+        std::unordered_map<Key, Record, KeyHash> mObjects;
+        VkDeviceSize mLiveBytes = 0;
+        std::atomic<uint64_t> mFrameIndex = 0;
+    };
+}  // namespace LearnVulkan
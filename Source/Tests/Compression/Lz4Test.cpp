@@ -0,0 +1,126 @@
+#include "Compression/Lz4.hpp"
+#include "Test.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    template<size_t N>
+    std::vector<std::byte> makeBlock(const char (&block)[N])
+    {
+        // Without the terminator, blocks contain zeros
+        const std::byte* bytes = reinterpret_cast<const std::byte*>(block);
+        return std::vector<std::byte>(bytes, bytes + N - 1);
+    }
+
+    std::vector<std::byte> makeBytes(const std::string& text)
+    {
+        const std::byte* bytes = reinterpret_cast<const std::byte*>(text.data());
+        return std::vector<std::byte>(bytes, bytes + text.size());
+    }
+
+    // Stands in for already compressed formats
+    std::vector<std::byte> makeRandomBytes(size_t size, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<std::byte> bytes(size);
+        for (std::byte& byte : bytes)
+        {
+            byte = static_cast<std::byte>(random());
+        }
+        return bytes;
+    }
+
+    // Compresses like OBJ models do
+    std::vector<std::byte> makeObjText(size_t size, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+        std::string text;
+        while (text.size() < size)
+        {
+            text += "v " + std::to_string(coordinate(random)) + " " + std::to_string(coordinate(random)) + " " + std::to_string(coordinate(random)) + "\n";
+        }
+        text.resize(size);
+        return makeBytes(text);
+    }
+
+    // Returns an empty vector if compression failed
+    std::vector<std::byte> compress(const std::vector<std::byte>& source)
+    {
+        std::vector<std::byte> compressed(getLz4CompressBound(source.size()));
+        compressed.resize(compressLz4(source, compressed));
+        return compressed;
+    }
+
+    bool roundTrips(const std::vector<std::byte>& source)
+    {
+        std::vector<std::byte> compressed = compress(source);
+        std::vector<std::byte> decompressed(source.size());
+        return (!compressed.empty() || source.empty()) && decompressLz4(compressed, decompressed) && decompressed == source;
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(Lz4, RoundTripsEverySize)
+{
+    // Around the minimum match length and the end of block rules, and across the 64 KiB match window
+    for (size_t size : {0, 1, 4, 12, 13, 16, 100, 4096, 65535, 65536, 200000})
+    {
+        CHECK(roundTrips(makeObjText(size, static_cast<uint32_t>(size))));
+        CHECK(roundTrips(makeRandomBytes(size, static_cast<uint32_t>(size))));
+        CHECK(roundTrips(std::vector<std::byte>(size, std::byte {7})));
+    }
+}
+
+LEARN_VULKAN_TEST(Lz4, CompressesRepetitiveData)
+{
+    std::vector<std::byte> text = makeObjText(64 * 1024, 1);
+    CHECK(compress(text).size() < text.size() * 3 / 4);
+    std::vector<std::byte> zeros(64 * 1024);
+    CHECK(compress(zeros).size() < zeros.size() / 100);
+    // Incompressible data only grows by the literal length bytes
+    std::vector<std::byte> random = makeRandomBytes(64 * 1024, 1);
+    CHECK(compress(random).size() <= getLz4CompressBound(random.size()));
+}
+
+// Hand written blocks: three literals, a nine byte match at offset 3, then the five literals every block ends with
+LEARN_VULKAN_TEST(Lz4, DecodesReferenceBlocks)
+{
+    std::vector<std::byte> block = makeBlock("\x35" "abc" "\x03\x00" "\x50" "XYZWV");
+    std::vector<std::byte> decompressed(17);
+    REQUIRE(decompressLz4(block, decompressed));
+    CHECK(decompressed == makeBytes("abcabcabcabcXYZWV"));
+
+    std::vector<std::byte> literals = makeBlock("\x50" "hello");
+    decompressed.resize(5);
+    REQUIRE(decompressLz4(literals, decompressed));
+    CHECK(decompressed == makeBytes("hello"));
+}
+
+LEARN_VULKAN_TEST(Lz4, RejectsBadInput)
+{
+    std::vector<std::byte> source = makeObjText(10000, 2);
+    std::vector<std::byte> compressed = compress(source);
+    REQUIRE(!compressed.empty());
+
+    std::vector<std::byte> tooSmall(compressed.size() / 2);
+    CHECK(compressLz4(source, tooSmall) == 0);
+
+    std::vector<std::byte> decompressed(source.size());
+    std::vector<std::byte> truncated(compressed.begin(), compressed.begin() + compressed.size() / 2);
+    CHECK(!decompressLz4(truncated, decompressed));
+    std::vector<std::byte> shorter(source.size() - 1);
+    CHECK(!decompressLz4(compressed, shorter));
+    // A match reaching before the start of the output
+    CHECK(!decompressLz4(makeBlock("\x15" "a" "\x09\x00" "\x50" "XYZWV"), decompressed));
+
+    // Garbage must fail or succeed without touching memory outside the buffers, which sanitizers would catch
+    for (uint32_t seed = 0; seed < 200; seed++)
+    {
+        std::vector<std::byte> garbage = makeRandomBytes(64 + seed, seed);
+        decompressLz4(garbage, decompressed);
+    }
+}
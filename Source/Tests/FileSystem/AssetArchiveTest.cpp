@@ -0,0 +1,131 @@
+#include "FileSystem/AssetArchive.hpp"
+#include "FileSystem/SyntheticAssets.hpp"
+#include "FileSystem/TemporaryDirectory.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    bool isEqual(std::span<const std::byte> bytes, const std::vector<std::byte>& expected)
+    {
+        return std::equal(bytes.begin(), bytes.end(), expected.begin(), expected.end());
+    }
+
+    std::string writeArchive(const TemporaryDirectory& directory, const std::string& name, const std::map<std::string, std::vector<std::byte>>& assets, bool bCompress)
+    {
+        AssetArchiveWriter writer;
+        for (const auto& [path, bytes] : assets)
+        {
+            writer.addFile(path, bytes, bCompress);
+        }
+        std::string archivePath = (directory.getPath() / name).string();
+        writer.write(archivePath);
+        return archivePath;
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(AssetArchive, ArchivesReturnTheAddedFiles)
+{
+    TemporaryDirectory directory;
+    std::map<std::string, std::vector<std::byte>> assets = makeSyntheticAssets();
+    for (bool bCompress : {false, true})
+    {
+        std::string archivePath = writeArchive(directory, bCompress ? "Compressed.pak" : "Stored.pak", assets, bCompress);
+        ArchiveFileSource archive;
+        REQUIRE(archive.load(archivePath));
+        CHECK(archive.getFileCount() == assets.size());
+        for (const auto& [path, bytes] : assets)
+        {
+            FileView view;
+            CHECK(archive.contains(path));
+            REQUIRE(archive.open(path, view));
+            CHECK(isEqual(view.getBytes(), bytes));
+            CHECK(archive.getNativePath(path).empty());
+        }
+
+        FileView view;
+        CHECK(!archive.contains("Model/Missing.obj"));
+        CHECK(!archive.open("Model/Missing.obj", view));
+    }
+}
+
+// Views of compressed entries own their buffer, stored ones the mapping
+LEARN_VULKAN_TEST(AssetArchive, ViewsOutliveTheArchive)
+{
+    TemporaryDirectory directory;
+    std::map<std::string, std::vector<std::byte>> assets = makeSyntheticAssets();
+    for (bool bCompress : {false, true})
+    {
+        FileView view;
+        {
+            ArchiveFileSource archive;
+            REQUIRE(archive.load(writeArchive(directory, "Archive.pak", assets, bCompress)));
+            REQUIRE(archive.open("Texture/Binary.bin", view));
+        }
+        CHECK(isEqual(view.getBytes(), assets["Texture/Binary.bin"]));
+    }
+}
+
+LEARN_VULKAN_TEST(AssetArchive, ArchivesMountOverLooseFiles)
+{
+    TemporaryDirectory directory;
+    std::map<std::string, std::vector<std::byte>> assets = makeSyntheticAssets();
+    std::string archivePath = writeArchive(directory, "Archive.pak", assets, true);
+    std::vector<std::byte> looseBytes = makeRandomBytes(10, 3);
+    TemporaryDirectory looseDirectory;
+    looseDirectory.writeFile("Texture/Binary.bin", looseBytes);
+    looseDirectory.writeFile("Texture/LooseOnly.bin", looseBytes);
+
+    VirtualFileSystem fileSystem;
+    fileSystem.mount(std::make_shared<DirectoryFileSource>(looseDirectory.getPath().string()));
+    std::shared_ptr<ArchiveFileSource> archive = std::make_shared<ArchiveFileSource>();
+    REQUIRE(archive->load(archivePath));
+    fileSystem.mount(archive);
+
+    FileView view;
+    REQUIRE(fileSystem.open("Texture\\Binary.bin", view));
+    CHECK(isEqual(view.getBytes(), assets["Texture/Binary.bin"]));
+    REQUIRE(fileSystem.open("Texture/LooseOnly.bin", view));
+    CHECK(isEqual(view.getBytes(), looseBytes));
+}
+
+LEARN_VULKAN_TEST(AssetArchive, DamagedArchivesFailToLoad)
+{
+    TemporaryDirectory directory;
+    std::string archivePath = writeArchive(directory, "Archive.pak", makeSyntheticAssets(), true);
+    ArchiveFileSource archive;
+    CHECK(!archive.load((directory.getPath() / "Missing.pak").string()));
+    CHECK(!archive.load(directory.writeFile("NotAnArchive.pak", makeRandomBytes(8192, 4))));
+
+    // Truncation loses the table of contents, which is written last, or the data it points to
+    uintmax_t size = std::filesystem::file_size(archivePath);
+    for (uintmax_t truncatedSize : {uintmax_t {0}, uintmax_t {16}, size / 2, size - 1})
+    {
+        std::filesystem::resize_file(archivePath, truncatedSize);
+        CHECK(!archive.load(archivePath));
+    }
+}
+
+LEARN_VULKAN_TEST(AssetArchive, DuplicatePathsThrow)
+{
+    TemporaryDirectory directory;
+    AssetArchiveWriter writer;
+    writer.addFile("Model/a.obj", makeRandomBytes(10, 1), false);
+    writer.addFile("Model/a.obj", makeRandomBytes(10, 2), true);
+    bool bThrew = false;
+    try
+    {
+        writer.write((directory.getPath() / "Archive.pak").string());
+    }
+    catch (const std::runtime_error&)
+    {
+        bThrew = true;
+    }
+    CHECK(bThrew);
+}
@@ -0,0 +1,110 @@
+#include "FileSystem/AsyncFileReader.hpp"
+#include "FileSystem/TemporaryDirectory.hpp"
+#include "Test.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    struct ReadResults
+    {
+        std::mutex mutex;
+        std::map<std::string, FileReadResult> results;
+
+        FileReadCallback getCallback()
+        {
+            return [this](FileReadResult& result) {
+                std::lock_guard<std::mutex> lock(mutex);
+                results[result.path] = std::move(result);
+            };
+        }
+    };
+}  // namespace
+
+LEARN_VULKAN_TEST(AsyncFileReader, EveryBackendReadsWholeFiles)
+{
+    const uint32_t SMALL_FILE_COUNT = 200;
+    const size_t SMALL_FILE_SIZE = 4 * 1024;
+    const uint32_t LARGE_FILE_COUNT = 2;
+    const size_t LARGE_FILE_SIZE = 8 * 1024 * 1024;
+
+    TemporaryDirectory directory;
+    std::map<std::string, std::vector<std::byte>> files;
+    for (uint32_t i = 0; i < SMALL_FILE_COUNT + LARGE_FILE_COUNT; i++)
+    {
+        std::vector<std::byte> bytes = makeRandomBytes(i < SMALL_FILE_COUNT ? SMALL_FILE_SIZE : LARGE_FILE_SIZE, i);
+        std::string path = directory.writeFile("File" + std::to_string(i), bytes);
+        files[path] = std::move(bytes);
+    }
+
+    // io_uring falls back to the thread pool where it is unavailable, either way every file has to arrive intact
+    for (AsyncFileBackend backend : {AsyncFileBackend::IoUring, AsyncFileBackend::ThreadPool})
+    {
+        ReadResults reads;
+        AsyncFileReader reader;
+        reader.start(backend, 4);
+        for (const auto& [path, bytes] : files)
+        {
+            reader.read(path, reads.getCallback());
+        }
+        reader.wait();
+        REQUIRE(reads.results.size() == files.size());
+        for (const auto& [path, bytes] : files)
+        {
+            const FileReadResult& result = reads.results[path];
+            CHECK(result.bSuccess);
+            CHECK(result.bytes == bytes);
+        }
+    }
+}
+
+LEARN_VULKAN_TEST(AsyncFileReader, MissingFilesReportFailure)
+{
+    TemporaryDirectory directory;
+    std::string path = (directory.getPath() / "Missing").string();
+    ReadResults reads;
+    AsyncFileReader reader;
+    reader.start(AsyncFileBackend::ThreadPool, 2);
+    reader.read(path, reads.getCallback());
+    reader.wait();
+    REQUIRE(reads.results.count(path) == 1);
+    CHECK(!reads.results[path].bSuccess);
+    CHECK(reads.results[path].bytes.empty());
+}
+
+LEARN_VULKAN_TEST(AsyncFileReader, ReadsWhileStoppedRunOnTheCaller)
+{
+    TemporaryDirectory directory;
+    std::vector<std::byte> bytes = makeRandomBytes(100, 1);
+    std::string path = directory.writeFile("File", bytes);
+    AsyncFileReader reader;
+    std::thread::id caller = std::this_thread::get_id();
+    bool bOnCaller = false;
+    reader.read(path, [&](FileReadResult& result) { bOnCaller = std::this_thread::get_id() == caller && result.bytes == bytes; });
+    CHECK(bOnCaller);
+}
+
+// wait() covers reads issued from callbacks, the way a streamed asset pulls in its dependencies
+LEARN_VULKAN_TEST(AsyncFileReader, CallbacksMayIssueReads)
+{
+    TemporaryDirectory directory;
+    std::string first = directory.writeFile("First", makeRandomBytes(100, 1));
+    std::string second = directory.writeFile("Second", makeRandomBytes(100, 2));
+    for (AsyncFileBackend backend : {AsyncFileBackend::IoUring, AsyncFileBackend::ThreadPool})
+    {
+        AsyncFileReader reader;
+        reader.start(backend, 2);
+        std::atomic<uint32_t> completedCount = 0;
+        reader.read(first, [&](FileReadResult&) {
+            completedCount++;
+            reader.read(second, [&](FileReadResult&) { completedCount++; });
+        });
+        reader.wait();
+        CHECK(completedCount == 2);
+    }
+}
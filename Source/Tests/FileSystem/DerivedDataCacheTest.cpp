@@ -0,0 +1,184 @@
+#include "FileSystem/DerivedDataCache.hpp"
+#include "FileSystem/TemporaryDirectory.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    const uint64_t MAX_SIZE = 64 * 1024 * 1024;
+
+    bool isEqual(std::span<const std::byte> bytes, const std::vector<std::byte>& expected)
+    {
+        return std::equal(bytes.begin(), bytes.end(), expected.begin(), expected.end());
+    }
+
+    DerivedDataKey makeKey(const std::string& path)
+    {
+        return DerivedDataKey("Test", 1).add(path);
+    }
+
+    // Entries live in a directory named after the first two digits of their key
+    std::filesystem::path getEntryPath(const TemporaryDirectory& directory, const DerivedDataKey& key)
+    {
+        std::string name = key.toString();
+        return directory.getPath() / name.substr(0, 2) / name;
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(DerivedDataCache, KeysDependOnEveryInput)
+{
+    std::vector<std::byte> bytes = makeRandomBytes(1000, 1);
+    std::vector<std::byte> changed = bytes;
+    changed[500] ^= std::byte {1};
+    std::string key = DerivedDataKey("Model", 1).add(bytes).addValue(1.0f).toString();
+
+    CHECK(key.size() == 32);
+    CHECK(std::all_of(key.begin(), key.end(), [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); }));
+    CHECK(DerivedDataKey("Model", 1).add(bytes).addValue(1.0f).toString() == key);
+    CHECK(DerivedDataKey("Texture", 1).add(bytes).addValue(1.0f).toString() != key);
+    CHECK(DerivedDataKey("Model", 2).add(bytes).addValue(1.0f).toString() != key);
+    CHECK(DerivedDataKey("Model", 1).add(changed).addValue(1.0f).toString() != key);
+    CHECK(DerivedDataKey("Model", 1).add(bytes).addValue(2.0f).toString() != key);
+}
+
+LEARN_VULKAN_TEST(DerivedDataCache, StoredEntriesLoadBack)
+{
+    TemporaryDirectory directory;
+    DerivedDataCache cache;
+    REQUIRE(cache.initialize(directory.getPath().string(), MAX_SIZE));
+    REQUIRE(cache.isEnabled());
+
+    std::vector<std::byte> bytes = makeRandomBytes(10000, 2);
+    FileView view;
+    CHECK(!cache.load(makeKey("A"), view));
+    cache.store(makeKey("A"), bytes, 1000.0);
+    REQUIRE(cache.load(makeKey("A"), view));
+    CHECK(isEqual(view.getBytes(), bytes));
+    CHECK(!cache.load(makeKey("B"), view));
+
+    DerivedDataStatistics statistics = cache.getStatistics();
+    CHECK(statistics.hitCount == 1);
+    CHECK(statistics.missCount == 2);
+    CHECK(statistics.storeCount == 1);
+    CHECK(statistics.corruptCount == 0);
+    // The recorded build time minus the time the read took
+    CHECK(statistics.savedMilliseconds > 0.0 && statistics.savedMilliseconds <= 1000.0);
+    CHECK(statistics.bytesRead > bytes.size());
+
+    // A second cache on the same directory sees the entry
+    DerivedDataCache reopened;
+    REQUIRE(reopened.initialize(directory.getPath().string(), MAX_SIZE));
+    REQUIRE(reopened.load(makeKey("A"), view));
+    CHECK(isEqual(view.getBytes(), bytes));
+}
+
+LEARN_VULKAN_TEST(DerivedDataCache, DisabledCacheAlwaysMisses)
+{
+    DerivedDataCache cache;
+    CHECK(!cache.isEnabled());
+    cache.store(makeKey("A"), makeRandomBytes(100, 3), 1.0);
+    FileView view;
+    CHECK(!cache.load(makeKey("A"), view));
+}
+
+// Damaged entries must never reach an importer, they are reported as misses and removed so the next store replaces them
+LEARN_VULKAN_TEST(DerivedDataCache, CorruptEntriesAreMissesAndRemoved)
+{
+    TemporaryDirectory directory;
+    DerivedDataCache cache;
+    REQUIRE(cache.initialize(directory.getPath().string(), MAX_SIZE));
+    cache.store(makeKey("Flipped"), makeRandomBytes(1000, 4), 1.0);
+    cache.store(makeKey("Truncated"), makeRandomBytes(1000, 5), 1.0);
+
+    std::filesystem::path flipped = getEntryPath(directory, makeKey("Flipped"));
+    {
+        std::fstream file(flipped, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(-1, std::ios::end);
+        char last = static_cast<char>(file.get());
+        file.seekp(-1, std::ios::end);
+        file.put(static_cast<char>(last ^ 1));
+    }
+    std::filesystem::path truncated = getEntryPath(directory, makeKey("Truncated"));
+    std::filesystem::resize_file(truncated, std::filesystem::file_size(truncated) - 1);
+
+    FileView view;
+    CHECK(!cache.load(makeKey("Flipped"), view));
+    CHECK(!cache.load(makeKey("Truncated"), view));
+    CHECK(!std::filesystem::exists(flipped));
+    CHECK(!std::filesystem::exists(truncated));
+    DerivedDataStatistics statistics = cache.getStatistics();
+    CHECK(statistics.corruptCount == 2);
+    CHECK(statistics.missCount == 2);
+    CHECK(statistics.hitCount == 0);
+}
+
+// Loading refreshes an entry, so the one evicted is the one used longest ago
+LEARN_VULKAN_TEST(DerivedDataCache, TrimmingEvictsLeastRecentlyUsed)
+{
+    const size_t ENTRY_SIZE = 1000;
+    TemporaryDirectory directory;
+    DerivedDataCache cache;
+    // Room for three entries and their headers, but not four
+    REQUIRE(cache.initialize(directory.getPath().string(), 3500));
+    for (const char* name : {"A", "B", "C"})
+    {
+        cache.store(makeKey(name), makeRandomBytes(ENTRY_SIZE, 6), 1.0);
+    }
+    // File times are too coarse on some file systems to order entries stored back to back
+    auto now = std::filesystem::file_time_type::clock::now();
+    std::filesystem::last_write_time(getEntryPath(directory, makeKey("A")), now - std::chrono::hours(3));
+    std::filesystem::last_write_time(getEntryPath(directory, makeKey("B")), now - std::chrono::hours(2));
+    std::filesystem::last_write_time(getEntryPath(directory, makeKey("C")), now - std::chrono::hours(1));
+
+    FileView view;
+    REQUIRE(cache.load(makeKey("A"), view));
+    cache.store(makeKey("D"), makeRandomBytes(ENTRY_SIZE, 6), 1.0);
+
+    CHECK(cache.getStatistics().evictionCount == 1);
+    CHECK(!std::filesystem::exists(getEntryPath(directory, makeKey("B"))));
+    CHECK(cache.load(makeKey("A"), view));
+    CHECK(cache.load(makeKey("C"), view));
+    CHECK(cache.load(makeKey("D"), view));
+}
+
+LEARN_VULKAN_TEST(DerivedDataCache, ReaderReturnsWhatWriterWrote)
+{
+    DerivedDataWriter writer;
+    writer.write(uint32_t(7));
+    writer.writeVector(std::vector<float> {1.0f, 2.0f, 3.0f});
+    writer.writeVector(std::vector<uint16_t> {});
+
+    DerivedDataReader reader(writer.getBytes());
+    uint32_t value = 0;
+    std::vector<float> floats;
+    std::vector<uint16_t> shorts {1};
+    REQUIRE(reader.read(value));
+    REQUIRE(reader.readVector(floats));
+    REQUIRE(reader.readVector(shorts));
+    CHECK(value == 7);
+    CHECK(floats == std::vector<float>({1.0f, 2.0f, 3.0f}));
+    CHECK(shorts.empty());
+    CHECK(reader.isAtEnd());
+    CHECK(!reader.read(value));
+}
+
+// A count larger than the remaining bytes must fail rather than read past the end
+LEARN_VULKAN_TEST(DerivedDataCache, ReaderRejectsTruncatedData)
+{
+    DerivedDataWriter writer;
+    writer.writeVector(std::vector<uint32_t> {1, 2, 3, 4});
+    std::span<const std::byte> bytes = writer.getBytes();
+
+    DerivedDataReader reader(bytes.first(bytes.size() - 1));
+    std::vector<uint32_t> values;
+    CHECK(!reader.readVector(values));
+    uint64_t value = 0;
+    DerivedDataReader shortReader(bytes.first(4));
+    CHECK(!shortReader.read(value));
+}
@@ -0,0 +1,81 @@
+#include "FileSystem/MappedFile.hpp"
+#include "FileSystem/TemporaryDirectory.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <utility>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    bool isEqual(std::span<const std::byte> bytes, const std::vector<std::byte>& expected)
+    {
+        return std::equal(bytes.begin(), bytes.end(), expected.begin(), expected.end());
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(MappedFile, OpenMapsTheWholeFile)
+{
+    TemporaryDirectory directory;
+    std::vector<std::byte> bytes = makeRandomBytes(3 * 4096 + 17, 1);
+    std::string path = directory.writeFile("File", bytes);
+
+    MappedFile file;
+    REQUIRE(file.open(path));
+    CHECK(file.isOpen());
+    CHECK(file.getSize() == bytes.size());
+    CHECK(isEqual(file.getBytes(), bytes));
+    // Opened files are read-only
+    CHECK(file.getMutableData() == nullptr);
+    file.close();
+    CHECK(!file.isOpen());
+    CHECK(file.getBytes().empty());
+}
+
+LEARN_VULKAN_TEST(MappedFile, EmptyAndMissingFiles)
+{
+    TemporaryDirectory directory;
+    MappedFile file;
+    CHECK(file.open(directory.writeFile("Empty", {})));
+    CHECK(file.isOpen());
+    CHECK(file.getSize() == 0);
+
+    MappedFile missing;
+    CHECK(!missing.open((directory.getPath() / "Missing").string()));
+    CHECK(!missing.isOpen());
+}
+
+// Writes go to the file through the shared mapping, without a separate flush
+LEARN_VULKAN_TEST(MappedFile, CreatedFilesAreWritable)
+{
+    TemporaryDirectory directory;
+    std::string path = (directory.getPath() / "Created").string();
+    std::vector<std::byte> bytes = makeRandomBytes(10000, 2);
+    {
+        MappedFile file;
+        REQUIRE(file.create(path, bytes.size()));
+        REQUIRE(file.getMutableData() != nullptr);
+        CHECK(std::all_of(file.getBytes().begin(), file.getBytes().end(), [](std::byte byte) { return byte == std::byte {0}; }));
+        std::copy(bytes.begin(), bytes.end(), file.getMutableData());
+    }
+    MappedFile file;
+    REQUIRE(file.open(path));
+    CHECK(isEqual(file.getBytes(), bytes));
+}
+
+LEARN_VULKAN_TEST(MappedFile, MovesTransferTheMapping)
+{
+    TemporaryDirectory directory;
+    std::vector<std::byte> bytes = makeRandomBytes(5000, 3);
+    MappedFile file;
+    REQUIRE(file.open(directory.writeFile("File", bytes)));
+
+    MappedFile moved(std::move(file));
+    CHECK(!file.isOpen());
+    CHECK(isEqual(moved.getBytes(), bytes));
+    MappedFile assigned;
+    assigned = std::move(moved);
+    CHECK(!moved.isOpen());
+    CHECK(isEqual(assigned.getBytes(), bytes));
+}
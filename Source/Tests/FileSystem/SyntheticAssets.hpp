@@ -0,0 +1,33 @@
+#pragma once
+
+#include "FileSystem/TemporaryDirectory.hpp"
+#include <cstddef>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    // Text compresses like OBJ models do, random bytes stand in for textures that are already compressed.
+    // The large text file spans several compression blocks.
+    inline std::map<std::string, std::vector<std::byte>> makeSyntheticAssets()
+    {
+        std::map<std::string, std::vector<std::byte>> assets;
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+        for (size_t size : {size_t {0}, size_t {100}, size_t {16 * 1024}, size_t {600 * 1024}})
+        {
+            std::string text;
+            while (text.size() < size)
+            {
+                text += "v " + std::to_string(coordinate(random)) + " " + std::to_string(coordinate(random)) + " " + std::to_string(coordinate(random)) + "\n";
+            }
+            text.resize(size);
+            const std::byte* bytes = reinterpret_cast<const std::byte*>(text.data());
+            assets["Model/Text" + std::to_string(size) + ".obj"] = std::vector<std::byte>(bytes, bytes + text.size());
+        }
+        assets["Texture/Binary.bin"] = makeRandomBytes(300 * 1024, 2);
+        return assets;
+    }
+}  // namespace LearnVulkan::Test
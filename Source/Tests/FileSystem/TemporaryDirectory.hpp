@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    // Empty directory below the system temporary directory, removed with everything in it on destruction
+    class TemporaryDirectory
+    {
+    public:
+        TemporaryDirectory()
+        {
+            std::random_device random;
+            mPath = std::filesystem::temp_directory_path() / ("LearnVulkan.Test." + std::to_string(random()));
+            std::filesystem::create_directories(mPath);
+        }
+
+        ~TemporaryDirectory()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(mPath, error);
+        }
+
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+        const std::filesystem::path& getPath() const { return mPath; }
+
+        // Writes the file, and any directories leading to it, and returns its native path
+        std::string writeFile(const std::string& name, const std::vector<std::byte>& bytes) const
+        {
+            std::filesystem::path path = mPath / name;
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream file(path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            return path.string();
+        }
+
+    private:
+        std::filesystem::path mPath;
+    };
+
+    inline std::vector<std::byte> makeRandomBytes(size_t size, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<std::byte> bytes(size);
+        for (std::byte& byte : bytes)
+        {
+            byte = static_cast<std::byte>(random());
+        }
+        return bytes;
+    }
+}  // namespace LearnVulkan::Test
@@ -0,0 +1,63 @@
+#include "FileSystem/TemporaryDirectory.hpp"
+#include "FileSystem/VirtualFileSystem.hpp"
+#include "Test.hpp"
+#include <algorithm>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    std::vector<std::byte> makeText(const std::string& text)
+    {
+        std::vector<std::byte> bytes(text.size());
+        std::transform(text.begin(), text.end(), bytes.begin(), [](char c) { return static_cast<std::byte>(c); });
+        return bytes;
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(VirtualFileSystem, NormalizePath)
+{
+    CHECK(VirtualFileSystem::normalizePath("Texture\\viking_room.png") == "Texture/viking_room.png");
+    CHECK(VirtualFileSystem::normalizePath("././Shader/a.spv") == "Shader/a.spv");
+    CHECK(VirtualFileSystem::normalizePath("Model/./b.obj") == "Model/./b.obj");
+}
+
+LEARN_VULKAN_TEST(VirtualFileSystem, LaterMountsTakePrecedence)
+{
+    TemporaryDirectory base;
+    TemporaryDirectory patch;
+    base.writeFile("Texture/a.png", makeText("base a"));
+    base.writeFile("Texture/b.png", makeText("base b"));
+    patch.writeFile("Texture/a.png", makeText("patch a"));
+
+    VirtualFileSystem fileSystem;
+    fileSystem.mount(std::make_shared<DirectoryFileSource>(base.getPath().string()));
+    fileSystem.mount(std::make_shared<DirectoryFileSource>(patch.getPath().string()));
+
+    FileView view;
+    REQUIRE(fileSystem.open("Texture\\a.png", view));
+    CHECK(view.getText() == "patch a");
+    REQUIRE(fileSystem.open("./Texture/b.png", view));
+    CHECK(view.getText() == "base b");
+    CHECK(fileSystem.exists("Texture/b.png"));
+    CHECK(!fileSystem.exists("Texture/c.png"));
+    CHECK(!fileSystem.open("Texture/c.png", view));
+    CHECK(fileSystem.getNativePath("Texture/c.png").empty());
+    CHECK(fileSystem.getNativePath("Texture/a.png") == patch.getPath().string() + "/Texture/a.png");
+}
+
+// The view shares ownership of the mapping
+LEARN_VULKAN_TEST(VirtualFileSystem, ViewsOutliveTheirSource)
+{
+    TemporaryDirectory directory;
+    directory.writeFile("File", makeText("contents"));
+    FileView view;
+    {
+        VirtualFileSystem fileSystem;
+        fileSystem.mount(std::make_shared<DirectoryFileSource>(directory.getPath().string()));
+        REQUIRE(fileSystem.open("File", view));
+    }
+    CHECK(view.isValid());
+    CHECK(view.getText() == "contents");
+}
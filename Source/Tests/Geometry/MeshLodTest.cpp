@@ -0,0 +1,187 @@
+#include "Geometry/MeshLod.hpp"
+#include "Geometry/SphereMesh.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    float distanceToTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+    {
+        // Closest point by Voronoi region of the triangle, see Ericson, Real-Time Collision Detection 5.1.5
+        glm::vec3 ab = b - a;
+        glm::vec3 ac = c - a;
+        glm::vec3 ap = p - a;
+        float d1 = glm::dot(ab, ap);
+        float d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f)
+        {
+            return glm::length(ap);
+        }
+        glm::vec3 bp = p - b;
+        float d3 = glm::dot(ab, bp);
+        float d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3)
+        {
+            return glm::length(bp);
+        }
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        {
+            return glm::length(p - (a + ab * (d1 / (d1 - d3))));
+        }
+        glm::vec3 cp = p - c;
+        float d5 = glm::dot(ab, cp);
+        float d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6)
+        {
+            return glm::length(cp);
+        }
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        {
+            return glm::length(p - (a + ac * (d2 / (d2 - d6))));
+        }
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+        {
+            return glm::length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+        }
+        float denominator = 1.0f / (va + vb + vc);
+        return glm::length(p - (a + ab * (vb * denominator) + ac * (vc * denominator)));
+    }
+
+    // Largest distance from a vertex of the original mesh to the simplified surface
+    float measureSimplificationError(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& original, const std::vector<uint32_t>& simplified)
+    {
+        float maxDistance = 0.0f;
+        for (uint32_t index : original)
+        {
+            float distance = std::numeric_limits<float>::max();
+            for (size_t i = 0; i < simplified.size(); i += 3)
+            {
+                distance = std::min(distance, distanceToTriangle(vertices[index].pos, vertices[simplified[i]].pos, vertices[simplified[i + 1]].pos, vertices[simplified[i + 2]].pos));
+            }
+            maxDistance = std::max(maxDistance, distance);
+        }
+        return maxDistance;
+    }
+
+    // Every edge between positions has a twin running the other way, so no collapse opened a hole along the seam
+    bool isWatertight(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+    {
+        std::unordered_map<glm::vec3, uint32_t> positionIds;
+        std::unordered_map<uint64_t, int32_t> edges;
+        auto positionId = [&](uint32_t index) -> uint64_t {
+            return positionIds.try_emplace(vertices[index].pos, static_cast<uint32_t>(positionIds.size())).first->second;
+        };
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                uint64_t a = positionId(indices[i + corner]);
+                uint64_t b = positionId(indices[i + (corner + 1) % 3]);
+                // Directed edges count up, their twins count down
+                if (a < b)
+                {
+                    edges[(a << 32) | b]++;
+                }
+                else
+                {
+                    edges[(b << 32) | a]--;
+                }
+            }
+        }
+        return std::all_of(edges.begin(), edges.end(), [](const auto& edge) { return edge.second == 0; });
+    }
+
+    // A triangle stretching from one side of the seam to the other would sample the whole texture width
+    bool keepsUvSeam(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+    {
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            float minU = std::min({vertices[indices[i]].texCoord.x, vertices[indices[i + 1]].texCoord.x, vertices[indices[i + 2]].texCoord.x});
+            float maxU = std::max({vertices[indices[i]].texCoord.x, vertices[indices[i + 1]].texCoord.x, vertices[indices[i + 2]].texCoord.x});
+            if (maxU - minU > 0.5f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(MeshLod, SimplifiedSphereKeepsSeamAndSurface)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    buildUvSphere(64, 32, vertices, indices);
+    for (uint32_t percent : {50u, 25u, 10u})
+    {
+        size_t targetIndexCount = indices.size() * percent / 100 / 3 * 3;
+        float error = 0.0f;
+        std::vector<uint32_t> simplified = simplifyMesh(vertices, indices, targetIndexCount, error);
+        REQUIRE(!simplified.empty());
+        CHECK(simplified.size() % 3 == 0);
+        CHECK(simplified.size() <= targetIndexCount);
+        CHECK(std::all_of(simplified.begin(), simplified.end(), [&](uint32_t index) { return index < vertices.size(); }));
+        CHECK(isWatertight(vertices, simplified));
+        CHECK(keepsUvSeam(vertices, simplified));
+        // A tenth of the triangles still approximates the unit sphere closely
+        float measuredError = measureSimplificationError(vertices, indices, simplified);
+        CHECK(error > 0.0f);
+        CHECK(measuredError < 0.1f);
+    }
+}
+
+LEARN_VULKAN_TEST(MeshLod, LodChainCoarsensMonotonically)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    buildUvSphere(512, 256, vertices, indices);
+    size_t triangleCount = indices.size() / 3;
+    std::vector<MeshLod> lods = buildMeshLods(vertices, indices, 6);
+    REQUIRE(lods.size() > 1);
+    CHECK(lods.size() <= 6);
+    CHECK(lods[0].firstIndex == 0);
+    CHECK(lods[0].indexCount == triangleCount * 3);
+    CHECK(lods[0].error == 0.0f);
+    for (size_t i = 1; i < lods.size(); i++)
+    {
+        CHECK(lods[i].firstIndex == lods[i - 1].firstIndex + lods[i - 1].indexCount);
+        CHECK(lods[i].indexCount < lods[i - 1].indexCount);
+        CHECK(lods[i].error >= lods[i - 1].error);
+    }
+    CHECK(lods.back().firstIndex + lods.back().indexCount == indices.size());
+}
+
+// Hovering around the depth where level 1 becomes acceptable must not switch back and forth
+LEARN_VULKAN_TEST(MeshLod, SelectionHasHysteresis)
+{
+    const float PIXELS_PER_UNIT = 1000.0f;
+    const float PIXEL_ERROR = 1.0f;
+    const float HYSTERESIS = 0.25f;
+    std::vector<MeshLod> lods {{0, 300, 0.0f}, {300, 150, 0.01f}, {450, 75, 0.04f}};
+    float switchDepth = lods[1].error * PIXELS_PER_UNIT / PIXEL_ERROR;
+
+    CHECK(selectMeshLod(lods, switchDepth * 0.5f, PIXELS_PER_UNIT, PIXEL_ERROR, HYSTERESIS, 0) == 0);
+    CHECK(selectMeshLod(lods, switchDepth * 2.0f, PIXELS_PER_UNIT, PIXEL_ERROR, HYSTERESIS, 0) == 1);
+    CHECK(selectMeshLod(lods, switchDepth * 100.0f, PIXELS_PER_UNIT, PIXEL_ERROR, HYSTERESIS, 0) == 2);
+    // Out of range levels are clamped before they are compared
+    CHECK(selectMeshLod(lods, switchDepth * 100.0f, PIXELS_PER_UNIT, PIXEL_ERROR, HYSTERESIS, 7) == 2);
+
+    uint32_t lod = selectMeshLod(lods, switchDepth * 2.0f, PIXELS_PER_UNIT, PIXEL_ERROR, HYSTERESIS, 0);
+    uint32_t switchCount = 0;
+    for (int frame = 0; frame < 100; frame++)
+    {
+        float depth = switchDepth * (frame % 2 == 0 ? 0.9f : 1.1f);
+        uint32_t nextLod = selectMeshLod(lods, depth, PIXELS_PER_UNIT, PIXEL_ERROR, HYSTERESIS, lod);
+        switchCount += nextLod != lod ? 1 : 0;
+        lod = nextLod;
+    }
+    CHECK(switchCount <= 1);
+}
@@ -0,0 +1,126 @@
+#include "Geometry/Meshlet.hpp"
+#include "Geometry/SphereMesh.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    std::vector<std::array<uint32_t, 3>> sortTriangles(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles(indices.size() / 3);
+        for (size_t i = 0; i < triangles.size(); i++)
+        {
+            triangles[i] = {indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2]};
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    Vertex makeVertex(float x, float y, float z)
+    {
+        Vertex vertex {};
+        vertex.pos = {x, y, z};
+        return vertex;
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(Meshlet, SphereMeshletsStayWithinLimits)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    buildUvSphere(512, 256, vertices, indices);
+    MeshletMesh mesh = buildMeshlets(vertices, indices);
+    REQUIRE(!mesh.meshlets.empty());
+    REQUIRE(mesh.bounds.size() == mesh.meshlets.size());
+
+    uint32_t vertexOffset = 0;
+    uint32_t triangleOffset = 0;
+    for (const Meshlet& meshlet : mesh.meshlets)
+    {
+        CHECK(meshlet.vertexCount <= MESHLET_MAX_VERTICES);
+        CHECK(meshlet.triangleCount <= MESHLET_MAX_TRIANGLES);
+        // Meshlets are packed one after the other
+        CHECK(meshlet.vertexOffset == vertexOffset);
+        CHECK(meshlet.triangleOffset == triangleOffset);
+        vertexOffset += meshlet.vertexCount;
+        triangleOffset += meshlet.triangleCount;
+    }
+    CHECK(vertexOffset == mesh.vertices.size());
+    CHECK(triangleOffset * 3 == mesh.triangles.size());
+}
+
+LEARN_VULKAN_TEST(Meshlet, UnpackingReturnsEveryTriangleOnce)
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    buildUvSphere(64, 32, vertices, indices);
+    MeshletMesh mesh = buildMeshlets(vertices, indices);
+    // In any order, but with the winding of the input
+    CHECK(sortTriangles(unpackMeshletIndices(mesh)) == sortTriangles(indices));
+}
+
+// A flat quad facing +z has a zero width cone: culled from anywhere behind its plane, never from in front
+LEARN_VULKAN_TEST(Meshlet, FlatConeCullsOnlyBehindThePlane)
+{
+    std::vector<Vertex> vertices {makeVertex(-1.0f, -1.0f, 0.0f), makeVertex(1.0f, -1.0f, 0.0f), makeVertex(1.0f, 1.0f, 0.0f), makeVertex(-1.0f, 1.0f, 0.0f)};
+    MeshletMesh mesh = buildMeshlets(vertices, {0, 1, 2, 0, 2, 3});
+    REQUIRE(mesh.bounds.size() == 1);
+    const MeshletBounds& bounds = mesh.bounds[0];
+    CHECK(glm::length(bounds.coneAxis - glm::vec3(0.0f, 0.0f, 1.0f)) < 1e-5f);
+    CHECK(bounds.coneCutoff < 1e-3f);
+
+    CHECK(!isMeshletBackfacing(bounds, glm::vec3(0.0f, 0.0f, 5.0f)));
+    CHECK(!isMeshletBackfacing(bounds, glm::vec3(100.0f, 0.0f, 0.5f)));
+    CHECK(isMeshletBackfacing(bounds, glm::vec3(0.0f, 0.0f, -5.0f)));
+    // The bounding sphere is subtracted, so a camera behind the plane but close to the edge is kept
+    CHECK(!isMeshletBackfacing(bounds, glm::vec3(3.0f, 0.0f, -0.1f)));
+}
+
+// A culled meshlet must not contain a single triangle facing the camera
+LEARN_VULKAN_TEST(Meshlet, ConeCullingKeepsVisibleTriangles)
+{
+    const uint32_t CAMERA_COUNT = 64;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    buildUvSphere(128, 64, vertices, indices);
+    MeshletMesh mesh = buildMeshlets(vertices, indices);
+    std::vector<uint32_t> unpacked = unpackMeshletIndices(mesh);
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    size_t culledCount = 0;
+    size_t falselyCulledCount = 0;
+    for (uint32_t camera = 0; camera < CAMERA_COUNT; camera++)
+    {
+        glm::vec3 direction(distribution(random), distribution(random), distribution(random));
+        glm::vec3 cameraPosition = direction * (3.0f / std::max(glm::length(direction), 1e-3f));
+        for (size_t i = 0; i < mesh.meshlets.size(); i++)
+        {
+            if (!isMeshletBackfacing(mesh.bounds[i], cameraPosition))
+            {
+                continue;
+            }
+            culledCount++;
+            const Meshlet& meshlet = mesh.meshlets[i];
+            for (uint32_t triangle = meshlet.triangleOffset; triangle < meshlet.triangleOffset + meshlet.triangleCount; triangle++)
+            {
+                glm::vec3 p0 = vertices[unpacked[triangle * 3]].pos;
+                glm::vec3 p1 = vertices[unpacked[triangle * 3 + 1]].pos;
+                glm::vec3 p2 = vertices[unpacked[triangle * 3 + 2]].pos;
+                if (glm::dot(glm::cross(p1 - p0, p2 - p0), p0 - cameraPosition) < 0.0f)
+                {
+                    falselyCulledCount++;
+                    break;
+                }
+            }
+        }
+    }
+    CHECK(falselyCulledCount == 0);
+    // From outside a sphere some of the far side has to go
+    CHECK(culledCount > 0);
+}
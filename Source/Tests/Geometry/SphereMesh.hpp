@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Vertex.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    // Unit sphere with a UV seam at longitude 0, where every ring has a vertex with u = 0 and one with u = 1
+    inline void buildUvSphere(uint32_t segmentCount, uint32_t ringCount, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        const float PI = 3.14159265f;
+        vertices.clear();
+        indices.clear();
+        for (uint32_t ring = 0; ring <= ringCount; ring++)
+        {
+            float v = static_cast<float>(ring) / ringCount;
+            // The poles are a single vertex each
+            uint32_t columnCount = ring == 0 || ring == ringCount ? 1 : segmentCount + 1;
+            for (uint32_t column = 0; column < columnCount; column++)
+            {
+                float u = columnCount == 1 ? 0.5f : static_cast<float>(column) / segmentCount;
+                // The seam column repeats the exact position of column 0
+                float longitude = column == segmentCount ? 0.0f : u * 2.0f * PI;
+                Vertex vertex {};
+                vertex.pos = {std::sin(v * PI) * std::cos(longitude), std::sin(v * PI) * std::sin(longitude), std::cos(v * PI)};
+                vertex.color = {1.0f, 1.0f, 1.0f};
+                vertex.texCoord = {u, v};
+                vertices.push_back(vertex);
+            }
+        }
+        auto ringVertex = [segmentCount, ringCount](uint32_t ring, uint32_t column) -> uint32_t {
+            if (ring == 0)
+            {
+                return 0;
+            }
+            if (ring == ringCount)
+            {
+                return 1 + (ringCount - 1) * (segmentCount + 1);
+            }
+            return 1 + (ring - 1) * (segmentCount + 1) + column;
+        };
+        for (uint32_t ring = 0; ring < ringCount; ring++)
+        {
+            for (uint32_t column = 0; column < segmentCount; column++)
+            {
+                uint32_t a = ringVertex(ring, column);
+                uint32_t b = ringVertex(ring + 1, column);
+                uint32_t c = ringVertex(ring + 1, column + 1);
+                uint32_t d = ringVertex(ring, column + 1);
+                if (ring != 0)
+                {
+                    indices.insert(indices.end(), {a, b, d});
+                }
+                if (ring != ringCount - 1)
+                {
+                    indices.insert(indices.end(), {d, b, c});
+                }
+            }
+        }
+    }
+}  // namespace LearnVulkan::Test
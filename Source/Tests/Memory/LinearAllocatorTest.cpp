@@ -0,0 +1,106 @@
+#include "Memory/AllocationCounter.hpp"
+#include "Memory/LinearAllocator.hpp"
+#include "Memory/TransientFrameWorkload.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <utility>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+LEARN_VULKAN_TEST(LinearAllocator, AllocationsAreAlignedAndDisjoint)
+{
+    LinearAllocator allocator(16384);
+    std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+    for (size_t i = 0; i < 64; i++)
+    {
+        size_t size = 1 + i * 3;
+        size_t alignment = size_t(1) << (i % 9);
+        uintptr_t address = reinterpret_cast<uintptr_t>(allocator.allocate(size, alignment));
+        REQUIRE(address != 0);
+        CHECK(address % alignment == 0);
+        ranges.emplace_back(address, address + size);
+    }
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); i++)
+    {
+        CHECK(ranges[i - 1].second <= ranges[i].first);
+    }
+    CHECK(allocator.getOverflowCount() == 0);
+    CHECK(allocator.allocate(0) == nullptr);
+
+    std::span<double> values = allocator.allocateArray<double>(8);
+    CHECK(values.size() == 8);
+    CHECK(reinterpret_cast<uintptr_t>(values.data()) % alignof(double) == 0);
+}
+
+LEARN_VULKAN_TEST(LinearAllocator, ResetReleasesEverything)
+{
+    LinearAllocator allocator(1024);
+    void* first = allocator.allocate(100);
+    allocator.allocate(200);
+    CHECK(allocator.getUsed() >= 300);
+    allocator.reset();
+    CHECK(allocator.getUsed() == 0);
+    CHECK(allocator.allocate(100) == first);
+    CHECK(allocator.getPeak() >= 300);
+}
+
+// Overflow is served from the heap for the rest of the frame, after which the block grows to the peak
+LEARN_VULKAN_TEST(LinearAllocator, OverflowGrowsTheBlock)
+{
+    LinearAllocator allocator;
+    auto runFrame = [&]() {
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            std::span<uint32_t> values = allocator.allocateArray<uint32_t>(256);
+            std::fill(values.begin(), values.end(), i);
+        }
+    };
+    runFrame();
+    uint64_t overflowCount = allocator.getOverflowCount();
+    CHECK(overflowCount == 100);
+    allocator.reset();
+    CHECK(allocator.getCapacity() >= allocator.getPeak());
+    runFrame();
+    CHECK(allocator.getOverflowCount() == overflowCount);
+}
+
+// Once warmed up the allocator frames must not touch the heap and produce the same result as the heap frames
+LEARN_VULKAN_TEST(LinearAllocator, SteadyFramesDoNotAllocate)
+{
+    const uint32_t WARMUP_FRAMES = 16;
+    const uint32_t FRAME_COUNT = 100;
+    REQUIRE(isAllocationCountingEnabled());
+
+    TransientFrameWorkload workload;
+    std::vector<uint64_t> checksums(FRAME_COUNT);
+    for (bool bFrameAllocator : {false, true})
+    {
+        uint64_t allocationCount = 0;
+        uint32_t differentCount = 0;
+        for (uint32_t frame = 0; frame < WARMUP_FRAMES + FRAME_COUNT; frame++)
+        {
+            uint64_t allocationsBefore = getThreadAllocationCount();
+            uint64_t checksum = workload.runFrame(bFrameAllocator, frame);
+            if (frame < WARMUP_FRAMES)
+            {
+                continue;
+            }
+            allocationCount += getThreadAllocationCount() - allocationsBefore;
+            uint64_t& expected = checksums[frame - WARMUP_FRAMES];
+            differentCount += bFrameAllocator && expected != checksum ? 1 : 0;
+            expected = checksum;
+        }
+        if (bFrameAllocator)
+        {
+            CHECK(allocationCount == 0);
+            CHECK(differentCount == 0);
+        }
+        else
+        {
+            CHECK(allocationCount > 0);
+        }
+    }
+    CHECK(workload.transientPool.getLiveCount() == 0);
+}
@@ -0,0 +1,101 @@
+#include "Memory/AllocationCounter.hpp"
+#include "Memory/LinearAllocator.hpp"
+#include "Test.hpp"
+#include <algorithm>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    struct Counted
+    {
+        static inline int liveCount = 0;
+        uint64_t value;
+
+        explicit Counted(uint64_t value)
+            : value(value)
+        {
+            liveCount++;
+        }
+
+        ~Counted() { liveCount--; }
+    };
+}  // namespace
+
+LEARN_VULKAN_TEST(PoolAllocator, ObjectsAreConstructedAndDestroyed)
+{
+    PoolAllocator<Counted, 16> pool;
+    std::vector<Counted*> objects;
+    for (uint64_t i = 0; i < 40; i++)
+    {
+        objects.push_back(pool.create(i));
+    }
+    CHECK(Counted::liveCount == 40);
+    CHECK(pool.getLiveCount() == 40);
+    CHECK(pool.getCapacity() == 48);
+    for (uint64_t i = 0; i < 40; i++)
+    {
+        CHECK(objects[i]->value == i);
+        CHECK(reinterpret_cast<uintptr_t>(objects[i]) % alignof(Counted) == 0);
+    }
+    for (Counted* object : objects)
+    {
+        pool.destroy(object);
+    }
+    pool.destroy(nullptr);
+    CHECK(Counted::liveCount == 0);
+    CHECK(pool.getLiveCount() == 0);
+}
+
+// Freed slots are handed out again before a new page is added
+LEARN_VULKAN_TEST(PoolAllocator, DestroyedSlotsAreReused)
+{
+    PoolAllocator<uint64_t, 16> pool;
+    std::vector<uint64_t*> first;
+    for (uint64_t i = 0; i < 16; i++)
+    {
+        first.push_back(pool.create(i));
+    }
+    for (size_t i = 0; i < first.size(); i += 2)
+    {
+        pool.destroy(first[i]);
+    }
+    std::vector<uint64_t*> second;
+    for (uint64_t i = 0; i < 8; i++)
+    {
+        second.push_back(pool.create(i));
+    }
+    CHECK(pool.getCapacity() == 16);
+    for (uint64_t* object : second)
+    {
+        CHECK(std::find(first.begin(), first.end(), object) != first.end());
+    }
+    for (size_t i = 1; i < first.size(); i += 2)
+    {
+        pool.destroy(first[i]);
+    }
+    for (uint64_t* object : second)
+    {
+        pool.destroy(object);
+    }
+}
+
+LEARN_VULKAN_TEST(PoolAllocator, ReservedSlotsDoNotAllocate)
+{
+    REQUIRE(isAllocationCountingEnabled());
+    PoolAllocator<uint64_t, 64> pool;
+    pool.reserve(200);
+    CHECK(pool.getCapacity() == 256);
+
+    std::vector<uint64_t*> objects(256);
+    uint64_t allocationsBefore = getThreadAllocationCount();
+    for (uint64_t i = 0; i < objects.size(); i++)
+    {
+        objects[i] = pool.create(i);
+    }
+    CHECK(getThreadAllocationCount() == allocationsBefore);
+    for (uint64_t* object : objects)
+    {
+        pool.destroy(object);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Memory/LinearAllocator.hpp"
+#include "Render/DrawSorting.hpp"
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    // Stands in for engine objects that only live for part of a frame, e.g. upload or visibility records
+    struct TransientObject
+    {
+        float transform[16];
+        uint32_t objectIndex;
+        uint32_t flags;
+    };
+
+    // The temporaries of one frame, a sorted draw list and short-lived objects, built either on the heap or from a
+    // frame allocator and a pool. Both ways produce the same checksum for the same frame.
+    struct TransientFrameWorkload
+    {
+        static constexpr uint32_t DRAW_COUNT = 20000;
+        static constexpr uint32_t TRANSIENT_OBJECT_COUNT = 4000;
+
+        std::vector<float> viewDepths;
+        std::vector<uint32_t> materialIndices;
+        // Starts empty, so growing to the working size is part of the warmup
+        LinearAllocator frameAllocator;
+        PoolAllocator<TransientObject> transientPool;
+
+        TransientFrameWorkload()
+            : viewDepths(DRAW_COUNT)
+            , materialIndices(DRAW_COUNT)
+        {
+            std::mt19937 random(1);
+            std::uniform_real_distribution<float> distribution(0.1f, 100.0f);
+            for (uint32_t i = 0; i < DRAW_COUNT; i++)
+            {
+                viewDepths[i] = distribution(random);
+                materialIndices[i] = random() % 256;
+            }
+        }
+
+        uint64_t runFrame(bool bFrameAllocator, uint32_t frame)
+        {
+            // The camera moves a little every frame, so the sort has work to do
+            float cameraOffset = static_cast<float>(frame % 16) * 0.5f;
+            std::vector<DrawCommand> heapDraws;
+            std::vector<std::unique_ptr<TransientObject>> heapObjects;
+            std::span<DrawCommand> draws;
+            std::span<TransientObject*> objects;
+            if (bFrameAllocator)
+            {
+                frameAllocator.reset();
+                draws = frameAllocator.allocateArray<DrawCommand>(DRAW_COUNT);
+                objects = frameAllocator.allocateArray<TransientObject*>(TRANSIENT_OBJECT_COUNT);
+            }
+            for (uint32_t i = 0; i < DRAW_COUNT; i++)
+            {
+                DrawCommand draw {makeDrawSortKey(DrawSortOrder::FrontToBack, std::abs(viewDepths[i] - cameraOffset), 0, materialIndices[i]), i};
+                if (bFrameAllocator)
+                {
+                    draws[i] = draw;
+                }
+                else
+                {
+                    heapDraws.push_back(draw);
+                }
+            }
+            if (!bFrameAllocator)
+            {
+                draws = heapDraws;
+            }
+            sortDrawCommands(draws);
+            for (uint32_t i = 0; i < TRANSIENT_OBJECT_COUNT; i++)
+            {
+                TransientObject object {{}, draws[i].objectIndex, i};
+                if (bFrameAllocator)
+                {
+                    objects[i] = transientPool.create(object);
+                }
+                else
+                {
+                    heapObjects.push_back(std::make_unique<TransientObject>(object));
+                }
+            }
+            // Objects die in a different order than they were created in, as they would across systems
+            uint64_t checksum = 0;
+            for (uint32_t i = 0; i < TRANSIENT_OBJECT_COUNT; i++)
+            {
+                uint32_t index = (i * 7919) % TRANSIENT_OBJECT_COUNT;
+                TransientObject* object = bFrameAllocator ? objects[index] : heapObjects[index].get();
+                checksum += static_cast<uint64_t>(object->objectIndex) * (object->flags + 1);
+                if (bFrameAllocator)
+                {
+                    transientPool.destroy(object);
+                }
+                else
+                {
+                    heapObjects[index].reset();
+                }
+            }
+            return checksum;
+        }
+    };
+}  // namespace LearnVulkan::Test
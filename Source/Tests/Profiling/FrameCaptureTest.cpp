@@ -0,0 +1,131 @@
+#include "FileSystem/TemporaryDirectory.hpp"
+#include "Memory/AllocationCounter.hpp"
+#include "Profiling/FrameDraws.hpp"
+#include "Test.hpp"
+#include <filesystem>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    const size_t CAPACITY = 4 * 1024 * 1024;
+}  // namespace
+
+// The capture is read back while the writer still holds it, as it would be after a crash, and must hold the newest
+// frames intact
+LEARN_VULKAN_TEST(FrameCapture, RingKeepsTheNewestFrames)
+{
+    const uint32_t DRAW_COUNT = 10000;
+    const uint32_t FRAME_COUNT = 1000;
+    TemporaryDirectory directory;
+    const std::string path = (directory.getPath() / "Frames.lvfc").string();
+    FrameDraws draws(DRAW_COUNT);
+    FrameCaptureWriter writer;
+    REQUIRE(writer.open(path, CAPACITY));
+
+    uint32_t failedCount = 0;
+    for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        failedCount += draws.write(writer, frame) ? 0 : 1;
+    }
+    CHECK(failedCount == 0);
+    CHECK(writer.getWrittenCount() == FRAME_COUNT);
+    // The ring is far too small for every frame
+    CHECK(writer.getFrameCount() > 0);
+    CHECK(writer.getFrameCount() < FRAME_COUNT);
+
+    FrameCaptureReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.getFrameCount() == writer.getFrameCount());
+    CHECK(reader.getWrittenCount() == FRAME_COUNT);
+    uint32_t damagedCount = 0;
+    for (size_t i = 0; i < reader.getFrameCount(); i++)
+    {
+        damagedCount += draws.isCaptured(reader, i, FRAME_COUNT - static_cast<uint32_t>(reader.getFrameCount() - i)) ? 0 : 1;
+    }
+    CHECK(damagedCount == 0);
+}
+
+// Frames larger than MAX_FRAME_SHARE of the ring are dropped without touching the frames already in it
+LEARN_VULKAN_TEST(FrameCapture, OversizedFramesAreDropped)
+{
+    TemporaryDirectory directory;
+    const std::string path = (directory.getPath() / "Frames.lvfc").string();
+    FrameDraws draws(1000);
+    FrameCaptureWriter writer;
+    REQUIRE(writer.open(path, CAPACITY));
+    REQUIRE(draws.write(writer, 0));
+
+    std::vector<DrawCommand> hugeDraws(CAPACITY / FrameCaptureWriter::MAX_FRAME_SHARE / sizeof(FrameCaptureDraw));
+    CHECK(!writer.write(FrameCaptureRecord(), {}, hugeDraws, draws.objectLods));
+    CHECK(writer.getDroppedCount() == 1);
+    CHECK(writer.getFrameCount() == 1);
+
+    FrameCaptureReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.getFrameCount() == 1);
+    CHECK(draws.isCaptured(reader, 0, 0));
+}
+
+LEARN_VULKAN_TEST(FrameCapture, WritesDoNotAllocate)
+{
+    REQUIRE(isAllocationCountingEnabled());
+    TemporaryDirectory directory;
+    FrameDraws draws(1000);
+    FrameCaptureWriter writer;
+    REQUIRE(writer.open((directory.getPath() / "Frames.lvfc").string(), CAPACITY));
+    uint64_t allocationsBefore = getThreadAllocationCount();
+    for (uint32_t frame = 0; frame < 200; frame++)
+    {
+        draws.write(writer, frame);
+    }
+    CHECK(getThreadAllocationCount() == allocationsBefore);
+}
+
+// The capture of the previous run is usually what the new run was started to look at
+LEARN_VULKAN_TEST(FrameCapture, ReopeningKeepsThePreviousCapture)
+{
+    TemporaryDirectory directory;
+    const std::string path = (directory.getPath() / "Frames.lvfc").string();
+    FrameDraws draws(100);
+    {
+        FrameCaptureWriter writer;
+        REQUIRE(writer.open(path, CAPACITY));
+        draws.write(writer, 7);
+    }
+    FrameCaptureWriter writer;
+    REQUIRE(writer.open(path, CAPACITY));
+    draws.write(writer, 8);
+
+    FrameCaptureReader previous;
+    REQUIRE(previous.open(path + ".previous"));
+    REQUIRE(previous.getFrameCount() == 1);
+    CHECK(draws.isCaptured(previous, 0, 7));
+    FrameCaptureReader current;
+    REQUIRE(current.open(path));
+    REQUIRE(current.getFrameCount() == 1);
+    CHECK(draws.isCaptured(current, 0, 8));
+}
+
+LEARN_VULKAN_TEST(FrameCapture, DamagedCapturesFailToOpen)
+{
+    TemporaryDirectory directory;
+    const std::string path = (directory.getPath() / "Frames.lvfc").string();
+    FrameDraws draws(100);
+    {
+        FrameCaptureWriter writer;
+        REQUIRE(writer.open(path, 64 * 1024));
+        draws.write(writer, 0);
+    }
+    FrameCaptureReader reader;
+    REQUIRE(reader.open(path));
+    reader.close();
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    CHECK(!reader.open(path));
+    CHECK(reader.getFrameCount() == 0);
+    directory.writeFile("Empty.lvfc", {});
+    CHECK(!reader.open((directory.getPath() / "Empty.lvfc").string()));
+    CHECK(!reader.open((directory.getPath() / "Missing.lvfc").string()));
+}
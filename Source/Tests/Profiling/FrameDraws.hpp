@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Profiling/FrameCapture.hpp"
+#include <span>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    // Every frame draws a different subset in a different order, so stale or torn frames fail the checks
+    struct FrameDraws
+    {
+        std::vector<DrawCommand> depthPrepassDraws;
+        std::vector<DrawCommand> shadingDraws;
+        std::vector<uint32_t> objectLods;
+
+        explicit FrameDraws(uint32_t drawCount)
+            : depthPrepassDraws(drawCount / 4)
+            , shadingDraws(drawCount)
+            , objectLods(drawCount)
+        {}
+
+        void update(uint32_t frame)
+        {
+            uint32_t drawCount = static_cast<uint32_t>(shadingDraws.size());
+            for (uint32_t i = 0; i < drawCount; i++)
+            {
+                objectLods[i] = (i + frame) % 4;
+                shadingDraws[i].objectIndex = (i * 7 + frame) % drawCount;
+            }
+            for (size_t i = 0; i < depthPrepassDraws.size(); i++)
+            {
+                depthPrepassDraws[i].objectIndex = shadingDraws[i * 4].objectIndex;
+            }
+        }
+
+        bool write(FrameCaptureWriter& writer, uint32_t frame)
+        {
+            update(frame);
+            FrameCaptureRecord record;
+            record.frameIndex = frame;
+            record.time = frame / 60.0f;
+            return writer.write(record, depthPrepassDraws, shadingDraws, objectLods);
+        }
+
+        bool isCaptured(const FrameCaptureReader& reader, size_t index, uint32_t frame) const
+        {
+            uint32_t drawCount = static_cast<uint32_t>(shadingDraws.size());
+            std::span<const FrameCaptureDraw> shading = reader.getShadingDraws(index);
+            std::span<const FrameCaptureDraw> depthPrepass = reader.getDepthPrepassDraws(index);
+            if (reader.getFrame(index).frameIndex != frame || shading.size() != drawCount || depthPrepass.size() != drawCount / 4)
+            {
+                return false;
+            }
+            for (uint32_t d = 0; d < drawCount; d++)
+            {
+                uint32_t objectIndex = (d * 7 + frame) % drawCount;
+                if (shading[d].objectIndex != objectIndex || shading[d].lod != (objectIndex + frame) % 4)
+                {
+                    return false;
+                }
+            }
+            return depthPrepass.back().objectIndex == shading[(drawCount / 4 - 1) * 4].objectIndex;
+        }
+    };
+}  // namespace LearnVulkan::Test
@@ -0,0 +1,130 @@
+#include "Render/RenderGraph.hpp"
+#include "Render/SyntheticRenderGraph.hpp"
+#include "Test.hpp"
+#include <string>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+// Graphs are only compiled and validated, which needs no device
+
+namespace
+{
+    const RenderGraphImageState ACQUIRED_STATE {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_NONE_KHR, VK_IMAGE_LAYOUT_UNDEFINED};
+
+    bool findBarrier(const RenderGraph& graph, uint32_t level, RenderGraphResource resource, RenderGraphBarrier& barrier)
+    {
+        for (const RenderGraphBarrier& candidate : graph.getLevelBarriers(level))
+        {
+            if (candidate.resource == resource)
+            {
+                barrier = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+}  // namespace
+
+// Chain with one dead branch: raster -> compute -> copy -> blit to the backbuffer
+LEARN_VULKAN_TEST(RenderGraph, ChainCullsDeadPassesAndAliasesDisjointImages)
+{
+    RenderGraph graph;
+    RenderGraphResource backbuffer = graph.importImage("Backbuffer", VK_IMAGE_ASPECT_COLOR_BIT, ACQUIRED_STATE);
+    RenderGraphResource x = graph.createImage("X", makeImageDescription(4096));
+    RenderGraphResource y = graph.createImage("Y", makeImageDescription(4096));
+    RenderGraphResource z = graph.createImage("Z", makeImageDescription(4096));
+    RenderGraphResource unused = graph.createImage("Unused", makeImageDescription(4096));
+    RenderGraphPass raster = graph.addPass("Raster", nullptr);
+    graph.addAccess(raster, x, RenderGraphAccess::ColorAttachmentWrite);
+    RenderGraphPass compute = graph.addPass("Compute", nullptr);
+    graph.addAccess(compute, x, RenderGraphAccess::ComputeSampledRead);
+    graph.addAccess(compute, y, RenderGraphAccess::ComputeStorageWrite);
+    RenderGraphPass dead = graph.addPass("Dead", nullptr);
+    graph.addAccess(dead, x, RenderGraphAccess::FragmentSampledRead);
+    graph.addAccess(dead, unused, RenderGraphAccess::ColorAttachmentWrite);
+    RenderGraphPass copy = graph.addPass("Copy", nullptr);
+    graph.addAccess(copy, y, RenderGraphAccess::TransferRead);
+    graph.addAccess(copy, z, RenderGraphAccess::TransferWrite);
+    RenderGraphPass blit = graph.addPass("Blit", nullptr);
+    graph.addAccess(blit, z, RenderGraphAccess::TransferRead);
+    graph.addAccess(blit, backbuffer, RenderGraphAccess::TransferWrite);
+    RenderGraphPass present = graph.addPass("Present", nullptr);
+    graph.addAccess(present, backbuffer, RenderGraphAccess::Present);
+    graph.compile();
+
+    std::string error;
+    CHECK(graph.validate(error));
+    CHECK(graph.isCulled(dead));
+    CHECK(!graph.isCulled(compute));
+    REQUIRE(graph.getLevelCount() == 5);
+
+    // Color write to compute read needs a transition
+    RenderGraphBarrier barrier {};
+    REQUIRE(findBarrier(graph, 1, x, barrier));
+    CHECK(barrier.oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    CHECK(barrier.newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    CHECK((barrier.srcStageMask & VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR) != 0);
+    CHECK((barrier.dstStageMask & VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR) != 0);
+
+    REQUIRE(findBarrier(graph, 4, backbuffer, barrier));
+    CHECK(barrier.newLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+    // X and Z have disjoint lifetimes
+    CHECK(graph.getAliasGroups().size() == 2);
+    CHECK(graph.getStatistics().aliasedImageCount == 2);
+}
+
+// Two readers of one image share a level and a barrier, a later reader in a covered stage needs none
+LEARN_VULKAN_TEST(RenderGraph, ReadersInOneLevelShareABarrier)
+{
+    RenderGraph graph;
+    RenderGraphResource backbuffer = graph.importImage("Backbuffer", VK_IMAGE_ASPECT_COLOR_BIT, ACQUIRED_STATE);
+    RenderGraphResource x = graph.createImage("X", makeImageDescription(4096));
+    RenderGraphResource y = graph.createImage("Y", makeImageDescription(4096));
+    RenderGraphResource z = graph.createImage("Z", makeImageDescription(4096));
+    RenderGraphPass raster = graph.addPass("Raster", nullptr);
+    graph.addAccess(raster, x, RenderGraphAccess::ColorAttachmentWrite);
+    RenderGraphPass fragment = graph.addPass("Fragment", nullptr);
+    graph.addAccess(fragment, x, RenderGraphAccess::FragmentSampledRead);
+    graph.addAccess(fragment, y, RenderGraphAccess::ColorAttachmentWrite);
+    RenderGraphPass compute = graph.addPass("Compute", nullptr);
+    graph.addAccess(compute, x, RenderGraphAccess::ComputeSampledRead);
+    graph.addAccess(compute, z, RenderGraphAccess::ComputeStorageWrite);
+    RenderGraphPass composite = graph.addPass("Composite", nullptr);
+    graph.addAccess(composite, x, RenderGraphAccess::FragmentSampledRead);
+    graph.addAccess(composite, y, RenderGraphAccess::FragmentSampledRead);
+    graph.addAccess(composite, z, RenderGraphAccess::FragmentSampledRead);
+    graph.addAccess(composite, backbuffer, RenderGraphAccess::ColorAttachmentWrite);
+    RenderGraphPass present = graph.addPass("Present", nullptr);
+    graph.addAccess(present, backbuffer, RenderGraphAccess::Present);
+    graph.compile();
+
+    std::string error;
+    CHECK(graph.validate(error));
+    CHECK(graph.getPassLevel(fragment) == 1);
+    CHECK(graph.getPassLevel(compute) == 1);
+
+    RenderGraphBarrier barrier {};
+    REQUIRE(findBarrier(graph, 1, x, barrier));
+    CHECK((barrier.dstStageMask & VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR) != 0);
+    CHECK((barrier.dstStageMask & VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR) != 0);
+    CHECK(graph.getLevelBarriers(1).size() == 3);
+    CHECK(!findBarrier(graph, 2, x, barrier));
+}
+
+LEARN_VULKAN_TEST(RenderGraph, SyntheticGraphsValidate)
+{
+    for (uint32_t passCount : {100u, 250u, 500u, 1000u})
+    {
+        RenderGraph graph;
+        buildSyntheticRenderGraph(graph, passCount, passCount);
+        graph.compile();
+
+        std::string error;
+        CHECK(graph.validate(error));
+        const RenderGraphStatistics& statistics = graph.getStatistics();
+        CHECK(statistics.culledPassCount < statistics.passCount);
+        CHECK(statistics.aliasedBytes <= statistics.transientBytes);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Render/RenderGraph.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    inline RenderGraphImageDescription makeImageDescription(VkDeviceSize size)
+    {
+        RenderGraphImageDescription description {};
+        description.size = size;
+        description.memoryTypeBits = 1;
+        return description;
+    }
+
+    // Chains of passes over transient images, each reading a few recent outputs. Outputs nobody reads get culled.
+    inline void buildSyntheticRenderGraph(RenderGraph& graph, uint32_t passCount, uint32_t seed)
+    {
+        const RenderGraphAccess READS[] = {RenderGraphAccess::FragmentSampledRead, RenderGraphAccess::ComputeSampledRead, RenderGraphAccess::TransferRead};
+        const RenderGraphAccess WRITES[] = {RenderGraphAccess::ColorAttachmentWrite, RenderGraphAccess::DepthAttachmentWrite, RenderGraphAccess::ComputeStorageWrite, RenderGraphAccess::TransferWrite};
+        const uint32_t READ_WINDOW = 16;
+
+        std::mt19937 random(seed);
+        RenderGraphResource backbuffer = graph.importImage("Backbuffer", VK_IMAGE_ASPECT_COLOR_BIT, {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_NONE_KHR, VK_IMAGE_LAYOUT_UNDEFINED});
+        std::vector<RenderGraphResource> images;
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            RenderGraphPass pass = graph.addPass("Pass " + std::to_string(i), nullptr);
+            // Consecutive outputs, so a pass never reads one image in two layouts
+            size_t window = std::min<size_t>(images.size(), READ_WINDOW);
+            size_t first = window == 0 ? 0 : random() % window;
+            uint32_t readCount = random() % 4;
+            for (uint32_t r = 0; r < readCount && first + r < window; r++)
+            {
+                graph.addAccess(pass, images[images.size() - 1 - first - r], READS[random() % 3]);
+            }
+            // Stands in for readbacks and other results leaving the graph
+            if (i % 64 == 63)
+            {
+                graph.setSideEffect(pass);
+            }
+
+            RenderGraphResource output = graph.createImage("Image " + std::to_string(i), makeImageDescription((1 + random() % 16) * 1024 * 1024));
+            graph.addAccess(pass, output, WRITES[random() % 4]);
+            images.push_back(output);
+        }
+
+        RenderGraphPass composite = graph.addPass("Composite", nullptr);
+        for (size_t i = 0; i < 4 && i < images.size(); i++)
+        {
+            graph.addAccess(composite, images[images.size() - 1 - i], RenderGraphAccess::FragmentSampledRead);
+        }
+        graph.addAccess(composite, backbuffer, RenderGraphAccess::ColorAttachmentWrite);
+        RenderGraphPass present = graph.addPass("Present", nullptr);
+        graph.addAccess(present, backbuffer, RenderGraphAccess::Present);
+    }
+}  // namespace LearnVulkan::Test
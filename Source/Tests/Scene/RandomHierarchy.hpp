@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Scene/Scene.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    // Every entity past the roots is a child of an earlier one, which gives a hierarchy several levels deep
+    struct RandomHierarchy
+    {
+        static constexpr uint32_t ROOT_COUNT = 1024;
+        static constexpr uint32_t CHILD_COUNT = 8;
+
+        Scene scene;
+        std::vector<Entity> entities;
+        // Index into entities, UINT32_MAX for roots
+        std::vector<uint32_t> parents;
+        std::mt19937 random {1};
+
+        explicit RandomHierarchy(uint32_t entityCount)
+            : entities(entityCount)
+            , parents(entityCount)
+        {
+            for (uint32_t i = 0; i < entityCount; i++)
+            {
+                parents[i] = i < ROOT_COUNT ? UINT32_MAX : (i - ROOT_COUNT) / CHILD_COUNT;
+                entities[i] = scene.createEntity(parents[i] == UINT32_MAX ? NULL_ENTITY : entities[parents[i]]);
+                scene.setLocalTransform(entities[i], makeRandomTransform());
+            }
+        }
+
+        Transform makeRandomTransform()
+        {
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+            Transform transform;
+            transform.position = glm::vec3(distribution(random), distribution(random), distribution(random)) * 4.0f;
+            transform.rotation = glm::angleAxis(distribution(random) * 3.14159265f, glm::normalize(glm::vec3(distribution(random), distribution(random), 1.0f)));
+            transform.scale = glm::vec3(1.0f + 0.1f * distribution(random));
+            return transform;
+        }
+
+        uint32_t getRandomIndex() { return std::uniform_int_distribution<uint32_t>(0, static_cast<uint32_t>(entities.size()) - 1)(random); }
+    };
+}  // namespace LearnVulkan::Test
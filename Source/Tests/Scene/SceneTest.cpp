@@ -0,0 +1,202 @@
+#include "Memory/AllocationCounter.hpp"
+#include "Scene/RandomHierarchy.hpp"
+#include "Scene/Scene.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+namespace
+{
+    template<typename Function>
+    bool throwsRuntimeError(Function&& function)
+    {
+        try
+        {
+            function();
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+}  // namespace
+
+LEARN_VULKAN_TEST(Scene, ReusedIndicesGetNewGenerations)
+{
+    Scene scene;
+    Entity first = scene.createEntity();
+    scene.destroyEntity(first);
+    Entity second = scene.createEntity();
+    CHECK(second.index == first.index);
+    CHECK(second.generation != first.generation);
+    CHECK(!scene.isAlive(first));
+    CHECK(scene.isAlive(second));
+    CHECK(throwsRuntimeError([&]() { scene.getLocalTransform(first); }));
+}
+
+// A handle to a destroyed parent must not attach to whatever entity reused its index
+LEARN_VULKAN_TEST(Scene, StaleParentsAreRejected)
+{
+    Scene scene;
+    Entity parent = scene.createEntity();
+    Entity child = scene.createEntity();
+    scene.destroyEntity(parent);
+    Entity reused = scene.createEntity();
+    REQUIRE(reused.index == parent.index);
+
+    CHECK(throwsRuntimeError([&]() { scene.createEntity(parent); }));
+    CHECK(throwsRuntimeError([&]() { scene.setParent(child, parent); }));
+    CHECK(scene.getParent(child) == NULL_ENTITY);
+    scene.setParent(child, reused);
+    CHECK(scene.getParent(child) == reused);
+}
+
+LEARN_VULKAN_TEST(Scene, CyclesAreRejected)
+{
+    Scene scene;
+    Entity root = scene.createEntity();
+    Entity child = scene.createEntity(root);
+    Entity grandchild = scene.createEntity(child);
+    CHECK(throwsRuntimeError([&]() { scene.setParent(root, root); }));
+    CHECK(throwsRuntimeError([&]() { scene.setParent(root, grandchild); }));
+    CHECK(scene.getParent(root) == NULL_ENTITY);
+}
+
+LEARN_VULKAN_TEST(Scene, DestroyingAParentDestroysItsDescendants)
+{
+    Scene scene;
+    Entity root = scene.createEntity();
+    Entity child = scene.createEntity(root);
+    Entity grandchild = scene.createEntity(child);
+    Entity other = scene.createEntity();
+    scene.destroyEntity(child);
+    CHECK(scene.isAlive(root));
+    CHECK(!scene.isAlive(child));
+    CHECK(!scene.isAlive(grandchild));
+    CHECK(scene.isAlive(other));
+    CHECK(scene.getEntityCount() == 2);
+}
+
+// Matrices are composed the same way on every thread count, so results must match exactly
+LEARN_VULKAN_TEST(Scene, ParallelUpdateMatchesSingleThreaded)
+{
+    const uint32_t ENTITY_COUNT = 100000;
+    RandomHierarchy hierarchy(ENTITY_COUNT);
+    Scene& scene = hierarchy.scene;
+    const SceneUpdateStatistics& statistics = scene.getUpdateStatistics();
+
+    std::vector<glm::mat4> singleThreaded;
+    // An explicit count, so the levels are split even on machines with a single core
+    for (uint32_t threadCount : {1u, 4u})
+    {
+        for (Entity entity : hierarchy.entities)
+        {
+            scene.setLocalTransform(entity, scene.getLocalTransform(entity));
+        }
+        scene.updateTransforms(threadCount);
+        CHECK(statistics.updatedTransformCount == ENTITY_COUNT);
+        if (threadCount == 1)
+        {
+            for (Entity entity : hierarchy.entities)
+            {
+                singleThreaded.push_back(scene.getWorldMatrix(entity));
+            }
+            continue;
+        }
+        uint32_t differentCount = 0;
+        for (uint32_t i = 0; i < ENTITY_COUNT; i++)
+        {
+            differentCount += scene.getWorldMatrix(hierarchy.entities[i]) == singleThreaded[i] ? 0 : 1;
+        }
+        CHECK(differentCount == 0);
+    }
+}
+
+// Changed entities must be exactly the modified ones and their descendants
+LEARN_VULKAN_TEST(Scene, PartialUpdateChangesOnlyModifiedSubtrees)
+{
+    const uint32_t ENTITY_COUNT = 20000;
+    RandomHierarchy hierarchy(ENTITY_COUNT);
+    Scene& scene = hierarchy.scene;
+    scene.updateTransforms();
+
+    std::vector<uint8_t> bExpected(ENTITY_COUNT, 0);
+    for (uint32_t i = 0; i < ENTITY_COUNT / 100; i++)
+    {
+        uint32_t index = hierarchy.getRandomIndex();
+        scene.setLocalTransform(hierarchy.entities[index], hierarchy.makeRandomTransform());
+        bExpected[index] = 1;
+    }
+    // Children come after their parents
+    size_t expectedCount = 0;
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++)
+    {
+        bExpected[i] = bExpected[i] || (hierarchy.parents[i] != UINT32_MAX && bExpected[hierarchy.parents[i]]);
+        expectedCount += bExpected[i];
+    }
+    scene.updateTransforms();
+    const std::vector<Entity>& changed = scene.getChangedEntities();
+    CHECK(changed.size() == expectedCount);
+    CHECK(std::all_of(changed.begin(), changed.end(), [&](const Entity& entity) { return bExpected[entity.index]; }));
+
+    scene.updateTransforms();
+    CHECK(scene.getChangedEntities().empty());
+}
+
+LEARN_VULKAN_TEST(Scene, WorldMatricesComposeParentChains)
+{
+    RandomHierarchy hierarchy(20000);
+    Scene& scene = hierarchy.scene;
+    scene.updateTransforms();
+    for (uint32_t sample = 0; sample < 1000; sample++)
+    {
+        uint32_t index = hierarchy.getRandomIndex();
+        glm::mat4 expected(1.0f);
+        for (uint32_t ancestor = index; ancestor != UINT32_MAX; ancestor = hierarchy.parents[ancestor])
+        {
+            Transform transform = scene.getLocalTransform(hierarchy.entities[ancestor]);
+            expected = glm::scale(glm::translate(glm::mat4(1.0f), transform.position) * glm::mat4_cast(transform.rotation), transform.scale) * expected;
+        }
+        const glm::mat4& world = scene.getWorldMatrix(hierarchy.entities[index]);
+        float maxError = 0.0f;
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                maxError = std::max(maxError, std::abs(world[column][row] - expected[column][row]));
+            }
+        }
+        REQUIRE(maxError < 1e-3f);
+    }
+}
+
+// Once the hierarchy is sorted, single threaded updates reuse everything they need
+LEARN_VULKAN_TEST(Scene, RepeatedUpdatesDoNotAllocate)
+{
+    REQUIRE(isAllocationCountingEnabled());
+    Scene scene;
+    std::vector<Entity> entities;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        entities.push_back(scene.createEntity(i < 100 ? NULL_ENTITY : entities[i / 10]));
+    }
+    for (int update = 0; update < 3; update++)
+    {
+        uint64_t allocationsBefore = getThreadAllocationCount();
+        for (Entity entity : entities)
+        {
+            scene.setLocalTransform(entity, {glm::vec3(static_cast<float>(update)), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f)});
+        }
+        scene.updateTransforms(1);
+        if (update > 0)
+        {
+            CHECK(getThreadAllocationCount() == allocationsBefore);
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include "Task/WorkerPool.hpp"
+#include "Test.hpp"
+#include <atomic>
+#include <vector>
+
+using namespace LearnVulkan;
+
+LEARN_VULKAN_TEST(WorkerPool, EveryIndexRunsOnce)
+{
+    WorkerPool pool(3);
+    CHECK(pool.getThreadCount() == 4);
+    // Loops of every size back to back, the way frames reuse the pool
+    for (size_t count : {0, 1, 2, 7, 1000})
+    {
+        std::vector<std::atomic<uint32_t>> calls(count);
+        pool.parallelFor(count, [&](size_t i) { calls[i]++; });
+        for (size_t i = 0; i < count; i++)
+        {
+            CHECK(calls[i] == 1);
+        }
+    }
+}
+
+LEARN_VULKAN_TEST(WorkerPool, RepeatedLoopsSeeTheirOwnFunction)
+{
+    WorkerPool pool(2);
+    std::atomic<uint64_t> sum = 0;
+    for (uint64_t loop = 0; loop < 2000; loop++)
+    {
+        pool.parallelFor(4, [&, loop](size_t i) { sum += loop * 4 + i; });
+    }
+    // Sum of 0 .. 7999
+    CHECK(sum == uint64_t {7999} * 8000 / 2);
+}
+
+LEARN_VULKAN_TEST(WorkerPool, SingleCallsStayOnTheCaller)
+{
+    WorkerPool pool(2);
+    std::thread::id caller = std::this_thread::get_id();
+    bool bOnCaller = false;
+    pool.parallelFor(1, [&](size_t) { bOnCaller = std::this_thread::get_id() == caller; });
+    CHECK(bOnCaller);
+}
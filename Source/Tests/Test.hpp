@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    struct TestCase
+    {
+        const char* suite;
+        const char* name;
+        void (*function)();
+    };
+
+    std::vector<TestCase>& getTestCases();
+    // Fails the running test, it carries on unless the check returns
+    void reportFailure(const char* expression, const char* file, int line);
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* suite, const char* name, void (*function)()) { getTestCases().push_back({suite, name, function}); }
+    };
+}  // namespace LearnVulkan::Test
+
+// Defines a test, suite must match the file name without its Test suffix for ctest to run it
+#define LEARN_VULKAN_TEST(suite, name)                                                                            \
+    static void suite##_##name();                                                                                 \
+    static const LearnVulkan::Test::TestRegistrar suite##_##name##_registrar(#suite, #name, suite##_##name);      \
+    static void suite##_##name()
+
+// Unlike assert, both stay in release builds. CHECK carries on after a failure, REQUIRE returns from the test.
+#define CHECK(expression)                                                                                         \
+    do                                                                                                            \
+    {                                                                                                             \
+        if (!(expression))                                                                                        \
+        {                                                                                                         \
+            LearnVulkan::Test::reportFailure(#expression, __FILE__, __LINE__);                                   \
+        }                                                                                                         \
+    } while (false)
+
+#define REQUIRE(expression)                                                                                       \
+    do                                                                                                            \
+    {                                                                                                             \
+        if (!(expression))                                                                                        \
+        {                                                                                                         \
+            LearnVulkan::Test::reportFailure(#expression, __FILE__, __LINE__);                                    \
+            return;                                                                                               \
+        }                                                                                                         \
+    } while (false)
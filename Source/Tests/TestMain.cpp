@@ -0,0 +1,54 @@
+// Runs the CPU side tests, those of one suite when its name is given. Nothing here needs a Vulkan device.
+//
+// Usage: Tests [suite]
+
+#include "Test.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace LearnVulkan;
+
+namespace
+{
+    size_t failureCount = 0;
+}  // namespace
+
+std::vector<Test::TestCase>& Test::getTestCases()
+{
+    static std::vector<TestCase> testCases;
+    return testCases;
+}
+
+void Test::reportFailure(const char* expression, const char* file, int line)
+{
+    std::cerr << "  " << file << ":" << line << ": " << expression << " failed" << std::endl;
+    failureCount++;
+}
+
+int main(int argc, char** argv)
+{
+    const char* suite = argc > 1 ? argv[1] : nullptr;
+    size_t runCount = 0;
+    size_t failedCount = 0;
+    for (const Test::TestCase& testCase : Test::getTestCases())
+    {
+        if (suite && std::strcmp(suite, testCase.suite) != 0)
+        {
+            continue;
+        }
+        size_t previousFailureCount = failureCount;
+        testCase.function();
+        bool bPassed = failureCount == previousFailureCount;
+        std::cout << (bPassed ? "passed " : "FAILED ") << testCase.suite << "." << testCase.name << std::endl;
+        runCount++;
+        failedCount += bPassed ? 0 : 1;
+    }
+    if (runCount == 0)
+    {
+        std::cerr << "No tests in suite " << (suite ? suite : "") << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << runCount - failedCount << " of " << runCount << " tests passed" << std::endl;
+    return failedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "VulkanUtility/HostAllocator.hpp"
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace LearnVulkan::Test
+{
+    // Drives the callbacks the way a driver recording commands would, short-lived small allocations with the
+    // occasional reallocation. Everything is freed again before returning. Returns the allocations that failed or
+    // came back misaligned, and the reallocations that lost their contents.
+    inline uint32_t runCommandChurn(HostAllocator& allocator, uint32_t allocationCount)
+    {
+        const uint32_t LIVE_ALLOCATIONS = 256;
+        const size_t SIZES[] = {24, 48, 64, 96, 160, 256, 400, 1024, 4096};
+        const VkAllocationCallbacks* commands = allocator.getCallbacks(HostAllocationSubsystem::Commands);
+        // Freed with the callbacks of another subsystem, which every caller of DeletionQueue relies on
+        const VkAllocationCallbacks* resources = allocator.getCallbacks(HostAllocationSubsystem::Resources);
+        std::mt19937 random(1);
+        std::vector<void*> live(LIVE_ALLOCATIONS, nullptr);
+        uint32_t failedCount = 0;
+        for (uint32_t i = 0; i < allocationCount; i++)
+        {
+            uint32_t slotIndex = random() % LIVE_ALLOCATIONS;
+            void*& slot = live[slotIndex];
+            size_t size = SIZES[random() % std::size(SIZES)];
+            // Reallocations have to keep the alignment of the original, so it is fixed per slot
+            size_t alignment = slotIndex % 4 == 0 ? 64 : 8;
+            if (slot && i % 8 == 0)
+            {
+                *static_cast<uint32_t*>(slot) = i;
+                slot = commands->pfnReallocation(commands->pUserData, slot, size, alignment, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+                failedCount += slot && *static_cast<uint32_t*>(slot) == i && reinterpret_cast<uintptr_t>(slot) % alignment == 0 ? 0 : 1;
+                continue;
+            }
+            if (slot)
+            {
+                resources->pfnFree(resources->pUserData, slot);
+            }
+            slot = commands->pfnAllocation(commands->pUserData, size, alignment, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+            failedCount += slot && reinterpret_cast<uintptr_t>(slot) % alignment == 0 ? 0 : 1;
+        }
+        for (void* memory : live)
+        {
+            commands->pfnFree(commands->pUserData, memory);
+        }
+        return failedCount;
+    }
+}  // namespace LearnVulkan::Test
@@ -0,0 +1,106 @@
+#include "Test.hpp"
+#include "VulkanUtility/DeletionQueue.hpp"
+#include "VulkanUtility/FakeVulkanHandles.hpp"
+#include <utility>
+#include <vector>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+// The queue destroys through a stub that records what it was given
+
+namespace
+{
+    std::vector<std::pair<VkObjectType, uint64_t>> destroyedObjects;
+
+    bool destroyStub(VkDevice, VkObjectType type, uint64_t handle, uint64_t, const VkAllocationCallbacks*)
+    {
+        destroyedObjects.emplace_back(type, handle);
+        return true;
+    }
+
+    struct Fixture : BoundDeviceContext
+    {
+        DeletionQueue queue;
+
+        Fixture()
+        {
+            destroyedObjects.clear();
+            context.device = makeFakeHandle<VkDevice>(1);
+            queue.initialize(context);
+            queue.setDestroyFunction(destroyStub);
+        }
+    };
+}  // namespace
+
+LEARN_VULKAN_TEST(DeletionQueue, CollectDestroysOnlyCompletedFrames)
+{
+    Fixture fixture;
+    bool bCallbackRan = false;
+    fixture.queue.retireImageView(UniqueImageView(makeFakeHandle<VkImageView>(10)), 1);
+    fixture.queue.retireBuffer(UniqueBuffer(makeFakeHandle<VkBuffer>(20)), UniqueDeviceMemory(makeFakeHandle<VkDeviceMemory>(21), 256), 2);
+    fixture.queue.retireCallback([&]() { bCallbackRan = true; }, 2);
+    CHECK(fixture.registry.getLiveCount() == 3);
+    CHECK(fixture.queue.getPendingCount() == 3);
+
+    fixture.queue.collect(0);
+    CHECK(destroyedObjects.empty());
+    CHECK(fixture.registry.getLiveCount() == 3);
+
+    fixture.queue.collect(1);
+    REQUIRE(destroyedObjects.size() == 1);
+    CHECK(destroyedObjects[0] == std::make_pair(VK_OBJECT_TYPE_IMAGE_VIEW, uint64_t {10}));
+    CHECK(fixture.registry.getLiveCount() == 2);
+    CHECK(!bCallbackRan);
+
+    // Buffer memory goes with its buffer
+    fixture.queue.collect(2);
+    CHECK(destroyedObjects.size() == 2);
+    CHECK(bCallbackRan);
+    CHECK(fixture.registry.getLiveCount() == 0);
+    CHECK(fixture.registry.getLiveBytes() == 0);
+    CHECK(fixture.queue.getPendingCount() == 0);
+    CHECK(fixture.queue.getRetiredCount() == fixture.queue.getDestroyedCount());
+}
+
+LEARN_VULKAN_TEST(DeletionQueue, FlushDestroysEverything)
+{
+    Fixture fixture;
+    for (uint64_t frame = 0; frame < 8; frame++)
+    {
+        fixture.queue.retireFramebuffer(UniqueFramebuffer(makeFakeHandle<VkFramebuffer>(100 + frame)), frame);
+        fixture.queue.retireImage(UniqueImage(makeFakeHandle<VkImage>(200 + frame)), UniqueDeviceMemory(makeFakeHandle<VkDeviceMemory>(300 + frame), 1024), frame);
+    }
+    CHECK(fixture.registry.getLiveCount() == 24);
+    fixture.queue.flush();
+    CHECK(destroyedObjects.size() == 16);
+    CHECK(fixture.registry.getLiveCount() == 0);
+    CHECK(fixture.queue.getPendingCount() == 0);
+}
+
+LEARN_VULKAN_TEST(DeletionQueue, EmptyHandlesAreNotRetired)
+{
+    Fixture fixture;
+    fixture.queue.retireSampler(UniqueSampler(), 0);
+    fixture.queue.retireSwapchain(VK_NULL_HANDLE, 0);
+    CHECK(fixture.queue.getPendingCount() == 0);
+    CHECK(fixture.queue.getRetiredCount() == 0);
+}
+
+// Retiring a type the queue cannot destroy does not compile
+static_assert(DeletionQueue::canDestroy(VK_OBJECT_TYPE_SWAPCHAIN_KHR));
+static_assert(!DeletionQueue::canDestroy(VK_OBJECT_TYPE_QUERY_POOL));
+
+// A failed destroy is counted and the object stays in the registry, so the shutdown leak report names it
+LEARN_VULKAN_TEST(DeletionQueue, FailedDestroysAreReported)
+{
+    Fixture fixture;
+    fixture.queue.setDestroyFunction([](VkDevice, VkObjectType, uint64_t, uint64_t, const VkAllocationCallbacks*) { return false; });
+    fixture.queue.retirePipeline(UniquePipeline(makeFakeHandle<VkPipeline>(40)), 0);
+    fixture.queue.collect(0);
+    CHECK(fixture.queue.getLeakedCount() == 1);
+    CHECK(fixture.queue.getDestroyedCount() == 0);
+    CHECK(fixture.queue.getPendingCount() == 0);
+    CHECK(fixture.registry.getLiveCount() == 1);
+    fixture.registry.remove(VK_OBJECT_TYPE_PIPELINE, 40);
+}
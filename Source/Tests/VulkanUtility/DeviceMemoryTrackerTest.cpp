@@ -0,0 +1,146 @@
+#include "Test.hpp"
+#include "VulkanUtility/DeviceMemoryTracker.hpp"
+#include "VulkanUtility/FakeVulkanHandles.hpp"
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+// The capabilities are never queried, so every memory type maps to heap 0 and there is no budget to ask the driver for
+
+LEARN_VULKAN_TEST(DeviceMemoryTracker, AllocationsAreCountedPerCategory)
+{
+    DeviceCapabilities capabilities;
+    DeviceMemoryTracker tracker;
+    tracker.initialize(capabilities, false);
+    tracker.add(makeFakeHandle<VkDeviceMemory>(1), 0, 1000, DeviceMemoryCategory::Vertex);
+    tracker.add(makeFakeHandle<VkDeviceMemory>(2), 0, 2000, DeviceMemoryCategory::Vertex);
+    tracker.add(makeFakeHandle<VkDeviceMemory>(3), 0, 4000, DeviceMemoryCategory::Texture);
+    // Adding a handle twice or adding nothing changes nothing
+    tracker.add(makeFakeHandle<VkDeviceMemory>(3), 0, 8000, DeviceMemoryCategory::Staging);
+    tracker.add(VK_NULL_HANDLE, 0, 8000, DeviceMemoryCategory::Staging);
+
+    DeviceMemoryStatistics vertex = tracker.getStatistics(DeviceMemoryCategory::Vertex);
+    CHECK(vertex.bytes == 3000);
+    CHECK(vertex.liveCount == 2);
+    CHECK(tracker.getStatistics(DeviceMemoryCategory::Texture).bytes == 4000);
+    CHECK(tracker.getStatistics(DeviceMemoryCategory::Staging).allocationCount == 0);
+    CHECK(tracker.getTotalStatistics().bytes == 7000);
+    CHECK(tracker.getHeapUsage(0).trackedBytes == 7000);
+    // Without VK_EXT_memory_budget usage is what was tracked
+    CHECK(tracker.getHeapUsage(0).usage == 7000);
+
+    tracker.remove(1);
+    tracker.remove(42);
+    vertex = tracker.getStatistics(DeviceMemoryCategory::Vertex);
+    CHECK(vertex.bytes == 2000);
+    CHECK(vertex.peakBytes == 3000);
+    CHECK(vertex.liveCount == 1);
+    CHECK(vertex.allocationCount == 2);
+    tracker.remove(2);
+    tracker.remove(3);
+    CHECK(tracker.getTotalStatistics().bytes == 0);
+    CHECK(tracker.getTotalStatistics().liveCount == 0);
+    CHECK(tracker.getHeapUsage(0).trackedBytes == 0);
+}
+
+LEARN_VULKAN_TEST(DeviceMemoryTracker, FramesKeepTheirOwnCounters)
+{
+    DeviceCapabilities capabilities;
+    DeviceMemoryTracker tracker;
+    tracker.initialize(capabilities, false);
+    tracker.add(makeFakeHandle<VkDeviceMemory>(1), 0, 100, DeviceMemoryCategory::Uniform);
+    tracker.add(makeFakeHandle<VkDeviceMemory>(2), 0, 200, DeviceMemoryCategory::Uniform);
+    tracker.endFrame(10);
+    tracker.remove(1);
+    tracker.endFrame(11);
+    tracker.endFrame(12);
+
+    REQUIRE(tracker.getFrameHistorySize() == 3);
+    const DeviceMemoryFrameCounters& first = tracker.getFrameCounters(0);
+    CHECK(first.frameIndex == 10);
+    CHECK(first.allocationCount == 2);
+    CHECK(first.allocatedBytes == 300);
+    CHECK(first.bytes == 300);
+    const DeviceMemoryFrameCounters& second = tracker.getFrameCounters(1);
+    CHECK(second.allocationCount == 0);
+    CHECK(second.freeCount == 1);
+    CHECK(second.freedBytes == 100);
+    CHECK(second.bytes == 200);
+    CHECK(tracker.getFrameCounters(2).freeCount == 0);
+    tracker.remove(2);
+}
+
+// Oldest first, and only the newest FRAME_HISTORY_SIZE frames are kept
+LEARN_VULKAN_TEST(DeviceMemoryTracker, HistoryKeepsTheNewestFrames)
+{
+    DeviceCapabilities capabilities;
+    DeviceMemoryTracker tracker;
+    tracker.initialize(capabilities, false);
+    const uint64_t FRAME_COUNT = DeviceMemoryTracker::FRAME_HISTORY_SIZE + 10;
+    for (uint64_t frame = 0; frame < FRAME_COUNT; frame++)
+    {
+        tracker.endFrame(frame);
+    }
+    REQUIRE(tracker.getFrameHistorySize() == DeviceMemoryTracker::FRAME_HISTORY_SIZE);
+    CHECK(tracker.getFrameCounters(0).frameIndex == 10);
+    CHECK(tracker.getFrameCounters(DeviceMemoryTracker::FRAME_HISTORY_SIZE - 1).frameIndex == FRAME_COUNT - 1);
+
+    std::ostringstream json;
+    tracker.writeJson(json);
+    CHECK(json.str().find("\"frame\": " + std::to_string(FRAME_COUNT - 1)) != std::string::npos);
+    CHECK(json.str().find("\"frame\": 9,") == std::string::npos);
+}
+
+// add and remove may be called from any thread
+LEARN_VULKAN_TEST(DeviceMemoryTracker, ConcurrentTrackingBalances)
+{
+    const uint64_t TRACKED_COUNT = 100000;
+    const uint64_t THREAD_COUNT = 4;
+    const VkDeviceSize BUFFER_SIZE = 4096;
+    DeviceCapabilities capabilities;
+    DeviceMemoryTracker tracker;
+    tracker.initialize(capabilities, false);
+
+    std::vector<std::thread> threads;
+    for (uint64_t thread = 0; thread < THREAD_COUNT; thread++)
+    {
+        threads.emplace_back([&, thread]() {
+            for (uint64_t i = thread + 1; i <= TRACKED_COUNT; i += THREAD_COUNT)
+            {
+                tracker.add(makeFakeHandle<VkDeviceMemory>(i), 0, BUFFER_SIZE, DeviceMemoryCategory::Vertex);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(tracker.getStatistics(DeviceMemoryCategory::Vertex).bytes == BUFFER_SIZE * TRACKED_COUNT);
+    threads.clear();
+    for (uint64_t thread = 0; thread < THREAD_COUNT; thread++)
+    {
+        threads.emplace_back([&, thread]() {
+            for (uint64_t i = thread + 1; i <= TRACKED_COUNT; i += THREAD_COUNT)
+            {
+                tracker.remove(i);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    tracker.endFrame(0);
+
+    const DeviceMemoryFrameCounters& counters = tracker.getFrameCounters(0);
+    CHECK(counters.allocationCount == TRACKED_COUNT);
+    CHECK(counters.freeCount == TRACKED_COUNT);
+    CHECK(counters.bytes == 0);
+    DeviceMemoryStatistics vertex = tracker.getStatistics(DeviceMemoryCategory::Vertex);
+    CHECK(vertex.peakBytes == BUFFER_SIZE * TRACKED_COUNT);
+    CHECK(vertex.liveCount == 0);
+    CHECK(tracker.getHeapUsage(0).trackedBytes == 0);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "VulkanUtility/VulkanHandle.hpp"
+#include <cstdint>
+
+namespace LearnVulkan::Test
+{
+    // Handle that is only stored and compared, it never reaches Vulkan
+    template<typename Handle>
+    Handle makeFakeHandle(uint64_t value)
+    {
+        return (Handle)(value);
+    }
+
+    // Binds a context that tracks objects in its own registry for as long as it lives. It has no device until a test
+    // gives it one, and without a device handles are dropped rather than destroyed, so no vkDestroy* call is made.
+    struct BoundDeviceContext
+    {
+        VulkanObjectRegistry registry;
+        VulkanDeviceContext context;
+
+        BoundDeviceContext()
+        {
+            context.registry = &registry;
+            VulkanDeviceContext::bind(&context);
+        }
+
+        ~BoundDeviceContext() { VulkanDeviceContext::bind(nullptr); }
+
+        BoundDeviceContext(const BoundDeviceContext&) = delete;
+        BoundDeviceContext& operator=(const BoundDeviceContext&) = delete;
+    };
+}  // namespace LearnVulkan::Test
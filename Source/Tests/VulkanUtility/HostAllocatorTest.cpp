@@ -0,0 +1,83 @@
+#include "Test.hpp"
+#include "VulkanUtility/CommandChurn.hpp"
+#include "VulkanUtility/HostAllocator.hpp"
+#include <cstring>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+LEARN_VULKAN_TEST(HostAllocator, DisabledAllocatorHasNoCallbacks)
+{
+    HostAllocator allocator;
+    allocator.initialize(false, true);
+    CHECK(!allocator.isEnabled());
+    CHECK(allocator.getCallbacks(HostAllocationSubsystem::Device) == nullptr);
+}
+
+// Every allocation of the churn is freed, so the statistics must return to zero
+LEARN_VULKAN_TEST(HostAllocator, CommandChurnLeavesNothingLive)
+{
+    for (bool bPooled : {false, true})
+    {
+        HostAllocator allocator;
+        allocator.initialize(true, bPooled);
+        CHECK(runCommandChurn(allocator, 200000) == 0);
+
+        HostAllocationStatistics total = allocator.getTotalStatistics();
+        HostAllocationStatistics commandScope = allocator.getStatistics(HostAllocationSubsystem::Commands, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+        CHECK(total.liveCount == 0);
+        CHECK(total.bytes == 0);
+        CHECK(total.peakBytes > 0);
+        CHECK(commandScope.allocationCount == total.allocationCount);
+        CHECK(allocator.getStatistics(HostAllocationSubsystem::Resources).allocationCount == 0);
+        CHECK((allocator.getPooledAllocationCount() > 0) == bPooled);
+    }
+}
+
+// Growing out of a pooled block into malloc and back must carry the contents along
+LEARN_VULKAN_TEST(HostAllocator, ReallocationKeepsContents)
+{
+    for (bool bPooled : {false, true})
+    {
+        HostAllocator allocator;
+        allocator.initialize(true, bPooled);
+        const VkAllocationCallbacks* callbacks = allocator.getCallbacks(HostAllocationSubsystem::Pipelines);
+        uint8_t* memory = static_cast<uint8_t*>(callbacks->pfnReallocation(callbacks->pUserData, nullptr, 32, 16, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+        REQUIRE(memory != nullptr);
+        for (uint8_t i = 0; i < 32; i++)
+        {
+            memory[i] = i;
+        }
+        uint8_t expected[32];
+        std::memcpy(expected, memory, sizeof(expected));
+        for (size_t size : {size_t(4096), size_t(64), size_t(100000), size_t(32)})
+        {
+            memory = static_cast<uint8_t*>(callbacks->pfnReallocation(callbacks->pUserData, memory, size, 16, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+            REQUIRE(memory != nullptr);
+            CHECK(reinterpret_cast<uintptr_t>(memory) % 16 == 0);
+            CHECK(std::memcmp(memory, expected, sizeof(expected)) == 0);
+        }
+        CHECK(allocator.getStatistics(HostAllocationSubsystem::Pipelines, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT).bytes == 32);
+
+        // A reallocation to zero bytes frees
+        CHECK(callbacks->pfnReallocation(callbacks->pUserData, memory, 0, 16, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT) == nullptr);
+        CHECK(allocator.getTotalStatistics().liveCount == 0);
+    }
+}
+
+// Driver allocations it makes itself are only reported, and counted apart from the callbacks' own
+LEARN_VULKAN_TEST(HostAllocator, InternalAllocationsAreReported)
+{
+    HostAllocator allocator;
+    allocator.initialize(true, false);
+    const VkAllocationCallbacks* callbacks = allocator.getCallbacks(HostAllocationSubsystem::Pipelines);
+    callbacks->pfnInternalAllocation(callbacks->pUserData, 1000, VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+    HostAllocationStatistics pipelines = allocator.getStatistics(HostAllocationSubsystem::Pipelines);
+    CHECK(pipelines.internalBytes == 1000);
+    CHECK(pipelines.bytes == 0);
+    CHECK(allocator.getStatistics(HostAllocationSubsystem::Pipelines, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE).internalBytes == 1000);
+    CHECK(allocator.getTotalStatistics().internalBytes == 1000);
+
+    callbacks->pfnInternalFree(callbacks->pUserData, 1000, VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+    CHECK(allocator.getTotalStatistics().internalBytes == 0);
+}
@@ -0,0 +1,56 @@
+#include "Test.hpp"
+#include "VulkanUtility/FakeVulkanHandles.hpp"
+#include <utility>
+#include <vector>
+
+using namespace LearnVulkan;
+using namespace LearnVulkan::Test;
+
+LEARN_VULKAN_TEST(VulkanHandle, OwningHandlesAreTheSizeOfRawHandles)
+{
+    CHECK(sizeof(UniqueBuffer) == sizeof(VkBuffer));
+    CHECK(sizeof(UniqueDeviceMemory) == sizeof(VkDeviceMemory));
+    CHECK(sizeof(std::vector<UniqueSampler>::value_type) * 4 == sizeof(VkSampler[4]));
+}
+
+LEARN_VULKAN_TEST(VulkanHandle, HandlesRegisterWithTheBoundContext)
+{
+    BoundDeviceContext bound;
+    UniqueSampler sampler(makeFakeHandle<VkSampler>(10));
+    UniqueDeviceMemory memory(makeFakeHandle<VkDeviceMemory>(11), 256);
+    CHECK(sampler.get() == makeFakeHandle<VkSampler>(10));
+    CHECK(bound.registry.getLiveCount() == 2);
+    CHECK(bound.registry.getLiveBytes() == 256);
+
+    // Moving hands over ownership without touching the registry
+    UniqueSampler moved(std::move(sampler));
+    CHECK(sampler.get() == VK_NULL_HANDLE);
+    CHECK(moved.get() == makeFakeHandle<VkSampler>(10));
+    UniqueSampler assigned;
+    assigned = std::move(moved);
+    CHECK(moved.get() == VK_NULL_HANDLE);
+    CHECK(static_cast<VkSampler>(assigned) == makeFakeHandle<VkSampler>(10));
+    CHECK(bound.registry.getLiveCount() == 2);
+
+    // Released objects stay registered until their new owner destroys them
+    VkDeviceMemory released = memory.release();
+    CHECK(released == makeFakeHandle<VkDeviceMemory>(11));
+    CHECK(memory.get() == VK_NULL_HANDLE);
+    CHECK(bound.registry.getLiveBytes() == 256);
+    bound.registry.remove(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)(released));
+    CHECK(bound.registry.getLiveBytes() == 0);
+
+    // Dropped without a device, so they stay registered too, as they do when the device is destroyed first
+    assigned.reset();
+    CHECK(assigned.get() == VK_NULL_HANDLE);
+    CHECK(bound.registry.getLiveCount() == 1);
+}
+
+LEARN_VULKAN_TEST(VulkanHandle, HandlesWithoutABoundContextAreDropped)
+{
+    VulkanDeviceContext::bind(nullptr);
+    UniqueBuffer buffer(makeFakeHandle<VkBuffer>(20));
+    CHECK(buffer.get() == makeFakeHandle<VkBuffer>(20));
+    buffer.reset();
+    CHECK(buffer.get() == VK_NULL_HANDLE);
+}
@@ -0,0 +1,39 @@
+#include "Test.hpp"
+#include "VulkanUtility/VulkanObjectRegistry.hpp"
+
+using namespace LearnVulkan;
+
+LEARN_VULKAN_TEST(VulkanObjectRegistry, ObjectsAreKeyedByTypeAndHandle)
+{
+    VulkanObjectRegistry registry;
+    registry.add(VK_OBJECT_TYPE_BUFFER, 1, 0, std::source_location::current());
+    registry.add(VK_OBJECT_TYPE_IMAGE, 1, 0, std::source_location::current());
+    registry.add(VK_OBJECT_TYPE_DEVICE_MEMORY, 2, 4096, std::source_location::current());
+    CHECK(registry.getLiveCount() == 3);
+    CHECK(registry.getLiveBytes() == 4096);
+
+    registry.remove(VK_OBJECT_TYPE_BUFFER, 1);
+    CHECK(registry.getLiveCount() == 2);
+    // Handles that were never added are ignored
+    registry.remove(VK_OBJECT_TYPE_BUFFER, 1);
+    registry.remove(VK_OBJECT_TYPE_SAMPLER, 3);
+    CHECK(registry.getLiveCount() == 2);
+
+    registry.remove(VK_OBJECT_TYPE_DEVICE_MEMORY, 2);
+    CHECK(registry.getLiveBytes() == 0);
+    registry.remove(VK_OBJECT_TYPE_IMAGE, 1);
+    CHECK(registry.getLiveCount() == 0);
+    CHECK(registry.printLeaks("Registry test") == 0);
+}
+
+// A creator that knows the size of memory adds it before the handle is wrapped, the wrapper must not reset it
+LEARN_VULKAN_TEST(VulkanObjectRegistry, FirstAddWins)
+{
+    VulkanObjectRegistry registry;
+    registry.add(VK_OBJECT_TYPE_DEVICE_MEMORY, 7, 65536, std::source_location::current());
+    registry.add(VK_OBJECT_TYPE_DEVICE_MEMORY, 7, 0, std::source_location::current());
+    CHECK(registry.getLiveCount() == 1);
+    CHECK(registry.getLiveBytes() == 65536);
+    registry.remove(VK_OBJECT_TYPE_DEVICE_MEMORY, 7);
+    CHECK(registry.getLiveBytes() == 0);
+}
@@ -0,0 +1,61 @@
+// Build time tool: packs asset directories into one archive that the runtime mounts over the loose files.
+// Paths inside the archive are relative to the asset root, e.g. "Texture/viking_room.png".
+//
+// Usage: AssetPacker [--compress] <output.pak> <asset root> <directory>...
+
+#include "FileSystem/AssetArchive.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace LearnVulkan;
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    bool bCompress = !arguments.empty() && arguments.front() == "--compress";
+    if (bCompress)
+    {
+        arguments.erase(arguments.begin());
+    }
+    if (arguments.size() < 3)
+    {
+        std::cerr << "Usage: AssetPacker [--compress] <output.pak> <asset root> <directory>..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::filesystem::path root = arguments[1];
+    AssetArchiveWriter writer;
+    size_t fileCount = 0;
+    try
+    {
+        for (size_t i = 2; i < arguments.size(); i++)
+        {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(root / arguments[i]))
+            {
+                if (!entry.is_regular_file())
+                {
+                    continue;
+                }
+                std::string path = std::filesystem::relative(entry.path(), root).generic_string();
+                if (!writer.addNativeFile(path, entry.path().string(), bCompress))
+                {
+                    std::cerr << "Failed to read " << entry.path().string() << std::endl;
+                    return EXIT_FAILURE;
+                }
+                fileCount++;
+            }
+        }
+        writer.write(arguments[0]);
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Packed " << fileCount << " files into " << arguments[0] << " (" << std::filesystem::file_size(arguments[0]) << " bytes)" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+// Profiling tool: replays a capture written with ApplicationConfiguration::frameCapturePath through the renderer in
+// a hidden window, then prints captured and replayed update and record times side by side. Run it from where
+// LearnVulkan runs so it loads the same scene, attach a profiler to look at the slow frames again.
+//
+// Usage: FrameReplay <capture> [passes]
+
+#include "Application/Application.hpp"
+#include "Profiling/FrameCapture.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace LearnVulkan;
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: FrameReplay <capture> [passes]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The swapchain starts out the size and tier of the first frame, so replay does not begin with a recreation
+    FrameCaptureReader reader;
+    if (!reader.open(argv[1]) || reader.getFrameCount() == 0)
+    {
+        std::cerr << "No frames in capture " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+    const FrameCaptureRecord& first = reader.getFrame(0);
+    ApplicationConfiguration config(first.swapchainWidth, first.swapchainHeight, "Frame Replay");
+    if (first.antiAliasingTier < static_cast<uint8_t>(AntiAliasingTier::Count))
+    {
+        config.antiAliasingTier = static_cast<AntiAliasingTier>(first.antiAliasingTier);
+    }
+    reader.close();
+    // Frames are submitted back to back, the display would otherwise set the pace
+    config.presentPolicy = PresentPolicy::Immediate;
+    config.frameReplayPath = argv[1];
+    config.frameReplayPassCount = argc == 3 ? static_cast<uint32_t>(std::max(std::atoi(argv[2]), 1)) : 1;
+
+    IApplication* application = new Application(config);
+
+    int result;
+    if ((result = application->initialize()) != EXIT_SUCCESS)
+    {
+        return result;
+    }
+
+    while (!application->isQuit())
+    {
+        application->tick();
+    }
+
+    application->finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,531 @@
+// Build time tool: reads a SPIR-V binary and writes a C++ header that embeds the code together with
+// its descriptor bindings, vertex inputs and push constant size.
+//
+// Usage: ShaderReflect <input.spv> <output.hpp> <Identifier> <source name>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const uint32_t SPIRV_MAGIC = 0x07230203;
+
+    enum Op : uint32_t
+    {
+        OpEntryPoint = 15,
+        OpTypeBool = 20,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeMatrix = 24,
+        OpTypeImage = 25,
+        OpTypeSampler = 26,
+        OpTypeSampledImage = 27,
+        OpTypeArray = 28,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpConstant = 43,
+        OpVariable = 59,
+        OpDecorate = 71,
+        OpMemberDecorate = 72,
+    };
+
+    enum Decoration : uint32_t
+    {
+        DecorationBlock = 2,
+        DecorationBufferBlock = 3,
+        DecorationArrayStride = 6,
+        DecorationMatrixStride = 7,
+        DecorationBuiltIn = 11,
+        DecorationLocation = 30,
+        DecorationBinding = 33,
+        DecorationDescriptorSet = 34,
+        DecorationOffset = 35,
+    };
+
+    enum StorageClass : uint32_t
+    {
+        StorageClassUniformConstant = 0,
+        StorageClassInput = 1,
+        StorageClassUniform = 2,
+        StorageClassPushConstant = 9,
+        StorageClassStorageBuffer = 12,
+    };
+
+    enum ExecutionModel : uint32_t
+    {
+        ExecutionModelVertex = 0,
+        ExecutionModelTessellationControl = 1,
+        ExecutionModelTessellationEvaluation = 2,
+        ExecutionModelGeometry = 3,
+        ExecutionModelFragment = 4,
+        ExecutionModelGLCompute = 5,
+    };
+
+    const uint32_t IMAGE_DIM_BUFFER = 5;
+
+    struct Type
+    {
+        uint32_t opcode = 0;
+        std::vector<uint32_t> operands;
+    };
+
+    struct Decorations
+    {
+        std::optional<uint32_t> set;
+        std::optional<uint32_t> binding;
+        std::optional<uint32_t> location;
+        std::optional<uint32_t> arrayStride;
+        bool bBlock = false;
+        bool bBufferBlock = false;
+        bool bBuiltIn = false;
+    };
+
+    struct MemberDecorations
+    {
+        std::optional<uint32_t> offset;
+        std::optional<uint32_t> matrixStride;
+        bool bBuiltIn = false;
+    };
+
+    struct Variable
+    {
+        uint32_t id;
+        uint32_t pointerType;
+        uint32_t storageClass;
+    };
+
+    struct Module
+    {
+        uint32_t executionModel = ExecutionModelVertex;
+        std::map<uint32_t, Type> types;
+        std::map<uint32_t, uint32_t> constants;
+        std::map<uint32_t, Decorations> decorations;
+        std::map<uint32_t, std::map<uint32_t, MemberDecorations>> memberDecorations;
+        std::vector<Variable> variables;
+    };
+
+    struct DescriptorBinding
+    {
+        uint32_t set;
+        uint32_t binding;
+        std::string descriptorType;
+        uint32_t descriptorCount;
+    };
+
+    struct VertexInput
+    {
+        uint32_t location;
+        std::string format;
+        uint32_t size;
+    };
+
+    Module parse(const std::vector<uint32_t>& words)
+    {
+        Module module;
+        size_t offset = 5;
+        while (offset < words.size())
+        {
+            uint32_t wordCount = words[offset] >> 16;
+            uint32_t opcode = words[offset] & 0xFFFF;
+            if (wordCount == 0 || offset + wordCount > words.size())
+            {
+                throw std::runtime_error("Malformed SPIR-V instruction stream");
+            }
+            const uint32_t* operands = &words[offset + 1];
+            uint32_t operandCount = wordCount - 1;
+
+            switch (opcode)
+            {
+                case OpEntryPoint:
+                    module.executionModel = operands[0];
+                    break;
+                case OpTypeBool:
+                case OpTypeInt:
+                case OpTypeFloat:
+                case OpTypeVector:
+                case OpTypeMatrix:
+                case OpTypeImage:
+                case OpTypeSampler:
+                case OpTypeSampledImage:
+                case OpTypeArray:
+                case OpTypeRuntimeArray:
+                case OpTypeStruct:
+                case OpTypePointer:
+                    module.types[operands[0]] = {opcode, std::vector<uint32_t>(operands + 1, operands + operandCount)};
+                    break;
+                case OpConstant:
+                    // Only 32 bit constants are needed to size arrays
+                    module.constants[operands[1]] = operands[2];
+                    break;
+                case OpVariable:
+                    module.variables.push_back({operands[1], operands[0], operands[2]});
+                    break;
+                case OpDecorate:
+                {
+                    Decorations& decorations = module.decorations[operands[0]];
+                    switch (operands[1])
+                    {
+                        case DecorationBlock: decorations.bBlock = true; break;
+                        case DecorationBufferBlock: decorations.bBufferBlock = true; break;
+                        case DecorationBuiltIn: decorations.bBuiltIn = true; break;
+                        case DecorationArrayStride: decorations.arrayStride = operands[2]; break;
+                        case DecorationLocation: decorations.location = operands[2]; break;
+                        case DecorationBinding: decorations.binding = operands[2]; break;
+                        case DecorationDescriptorSet: decorations.set = operands[2]; break;
+                        default: break;
+                    }
+                    break;
+                }
+                case OpMemberDecorate:
+                {
+                    MemberDecorations& decorations = module.memberDecorations[operands[0]][operands[1]];
+                    switch (operands[2])
+                    {
+                        case DecorationOffset: decorations.offset = operands[3]; break;
+                        case DecorationMatrixStride: decorations.matrixStride = operands[3]; break;
+                        case DecorationBuiltIn: decorations.bBuiltIn = true; break;
+                        default: break;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            offset += wordCount;
+        }
+        return module;
+    }
+
+    const Type& getType(const Module& module, uint32_t id)
+    {
+        auto it = module.types.find(id);
+        if (it == module.types.end())
+        {
+            throw std::runtime_error("Unknown SPIR-V type id " + std::to_string(id));
+        }
+        return it->second;
+    }
+
+    uint32_t getTypeSize(const Module& module, uint32_t id, std::optional<uint32_t> matrixStride = std::nullopt)
+    {
+        const Type& type = getType(module, id);
+        switch (type.opcode)
+        {
+            case OpTypeBool:
+                return 4;
+            case OpTypeInt:
+            case OpTypeFloat:
+                return type.operands[0] / 8;
+            case OpTypeVector:
+                return getTypeSize(module, type.operands[0]) * type.operands[1];
+            case OpTypeMatrix:
+                return matrixStride.value_or(getTypeSize(module, type.operands[0])) * type.operands[1];
+            case OpTypeArray:
+            {
+                uint32_t length = module.constants.at(type.operands[1]);
+                auto decorations = module.decorations.find(id);
+                if (decorations != module.decorations.end() && decorations->second.arrayStride)
+                {
+                    return *decorations->second.arrayStride * length;
+                }
+                return getTypeSize(module, type.operands[0]) * length;
+            }
+            case OpTypeStruct:
+            {
+                uint32_t size = 0;
+                auto members = module.memberDecorations.find(id);
+                for (uint32_t member = 0; member < type.operands.size(); member++)
+                {
+                    std::optional<uint32_t> memberOffset;
+                    std::optional<uint32_t> memberMatrixStride;
+                    if (members != module.memberDecorations.end() && members->second.count(member))
+                    {
+                        memberOffset = members->second.at(member).offset;
+                        memberMatrixStride = members->second.at(member).matrixStride;
+                    }
+                    uint32_t memberSize = getTypeSize(module, type.operands[member], memberMatrixStride);
+                    size = std::max(size, memberOffset.value_or(size) + memberSize);
+                }
+                return size;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    std::string getVertexFormat(const Module& module, uint32_t id)
+    {
+        const Type& type = getType(module, id);
+        uint32_t componentCount = 1;
+        const Type* componentType = &type;
+        if (type.opcode == OpTypeVector)
+        {
+            componentType = &getType(module, type.operands[0]);
+            componentCount = type.operands[1];
+        }
+
+        std::string suffix;
+        if (componentType->opcode == OpTypeFloat && componentType->operands[0] == 32)
+        {
+            suffix = "SFLOAT";
+        }
+        else if (componentType->opcode == OpTypeInt && componentType->operands[0] == 32)
+        {
+            suffix = componentType->operands[1] ? "SINT" : "UINT";
+        }
+        else
+        {
+            throw std::runtime_error("Unsupported vertex input component type");
+        }
+
+        static const char* CHANNELS[] = {"R32", "R32G32", "R32G32B32", "R32G32B32A32"};
+        if (componentCount < 1 || componentCount > 4)
+        {
+            throw std::runtime_error("Unsupported vertex input component count");
+        }
+        return std::string("VK_FORMAT_") + CHANNELS[componentCount - 1] + "_" + suffix;
+    }
+
+    std::string getStageFlag(uint32_t executionModel)
+    {
+        switch (executionModel)
+        {
+            case ExecutionModelVertex: return "VK_SHADER_STAGE_VERTEX_BIT";
+            case ExecutionModelTessellationControl: return "VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT";
+            case ExecutionModelTessellationEvaluation: return "VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT";
+            case ExecutionModelGeometry: return "VK_SHADER_STAGE_GEOMETRY_BIT";
+            case ExecutionModelFragment: return "VK_SHADER_STAGE_FRAGMENT_BIT";
+            case ExecutionModelGLCompute: return "VK_SHADER_STAGE_COMPUTE_BIT";
+            default: throw std::runtime_error("Unsupported execution model");
+        }
+    }
+
+    std::optional<DescriptorBinding> reflectDescriptor(const Module& module, const Variable& variable)
+    {
+        if (variable.storageClass != StorageClassUniformConstant && variable.storageClass != StorageClassUniform && variable.storageClass != StorageClassStorageBuffer)
+        {
+            return std::nullopt;
+        }
+        auto decorations = module.decorations.find(variable.id);
+        if (decorations == module.decorations.end() || !decorations->second.binding)
+        {
+            return std::nullopt;
+        }
+
+        DescriptorBinding descriptor {};
+        descriptor.set = decorations->second.set.value_or(0);
+        descriptor.binding = *decorations->second.binding;
+        descriptor.descriptorCount = 1;
+
+        uint32_t typeId = getType(module, variable.pointerType).operands[1];
+        const Type* type = &getType(module, typeId);
+        if (type->opcode == OpTypeArray)
+        {
+            descriptor.descriptorCount = module.constants.at(type->operands[1]);
+            typeId = type->operands[0];
+            type = &getType(module, typeId);
+        }
+        else if (type->opcode == OpTypeRuntimeArray)
+        {
+            descriptor.descriptorCount = 0;
+            typeId = type->operands[0];
+            type = &getType(module, typeId);
+        }
+
+        auto typeDecorations = module.decorations.find(typeId);
+        bool bBufferBlock = typeDecorations != module.decorations.end() && typeDecorations->second.bBufferBlock;
+
+        switch (type->opcode)
+        {
+            case OpTypeSampledImage:
+                descriptor.descriptorType = "VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER";
+                break;
+            case OpTypeSampler:
+                descriptor.descriptorType = "VK_DESCRIPTOR_TYPE_SAMPLER";
+                break;
+            case OpTypeImage:
+            {
+                // Operands: sampled type, dim, depth, arrayed, ms, sampled, format
+                bool bTexelBuffer = type->operands[1] == IMAGE_DIM_BUFFER;
+                bool bStorage = type->operands[5] == 2;
+                if (bTexelBuffer)
+                {
+                    descriptor.descriptorType = bStorage ? "VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER" : "VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER";
+                }
+                else
+                {
+                    descriptor.descriptorType = bStorage ? "VK_DESCRIPTOR_TYPE_STORAGE_IMAGE" : "VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE";
+                }
+                break;
+            }
+            case OpTypeStruct:
+                if (variable.storageClass == StorageClassStorageBuffer || bBufferBlock)
+                {
+                    descriptor.descriptorType = "VK_DESCRIPTOR_TYPE_STORAGE_BUFFER";
+                }
+                else
+                {
+                    descriptor.descriptorType = "VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER";
+                }
+                break;
+            default:
+                throw std::runtime_error("Unsupported descriptor type for binding " + std::to_string(descriptor.binding));
+        }
+        return descriptor;
+    }
+
+    std::string toUpperSnakeCase(const std::string& identifier)
+    {
+        std::string result;
+        for (size_t i = 0; i < identifier.size(); i++)
+        {
+            char c = identifier[i];
+            if (i > 0 && std::isupper(static_cast<unsigned char>(c)))
+            {
+                result += '_';
+            }
+            result += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        return result;
+    }
+
+    std::string generateHeader(const Module& module, const std::vector<uint32_t>& words, const std::string& identifier, const std::string& sourceName)
+    {
+        std::vector<DescriptorBinding> descriptors;
+        std::vector<VertexInput> vertexInputs;
+        uint32_t pushConstantSize = 0;
+
+        for (const Variable& variable : module.variables)
+        {
+            if (std::optional<DescriptorBinding> descriptor = reflectDescriptor(module, variable))
+            {
+                descriptors.push_back(*descriptor);
+            }
+            else if (variable.storageClass == StorageClassPushConstant)
+            {
+                pushConstantSize = getTypeSize(module, getType(module, variable.pointerType).operands[1]);
+            }
+            else if (variable.storageClass == StorageClassInput && module.executionModel == ExecutionModelVertex)
+            {
+                auto decorations = module.decorations.find(variable.id);
+                if (decorations == module.decorations.end() || decorations->second.bBuiltIn || !decorations->second.location)
+                {
+                    continue;
+                }
+                uint32_t typeId = getType(module, variable.pointerType).operands[1];
+                vertexInputs.push_back({*decorations->second.location, getVertexFormat(module, typeId), getTypeSize(module, typeId)});
+            }
+        }
+
+        std::sort(descriptors.begin(), descriptors.end(), [](const DescriptorBinding& a, const DescriptorBinding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+        std::sort(vertexInputs.begin(), vertexInputs.end(), [](const VertexInput& a, const VertexInput& b) { return a.location < b.location; });
+
+        std::string prefix = toUpperSnakeCase(identifier);
+        std::ostringstream out;
+        out << "// Generated by ShaderReflect from " << sourceName << ", do not edit\n"
+            << "#pragma once\n\n"
+            << "#include \"Shader/ShaderReflection.hpp\"\n\n"
+            << "namespace LearnVulkan\n{\n";
+
+        out << "    inline const uint32_t " << prefix << "_CODE[] = {";
+        for (size_t i = 0; i < words.size(); i++)
+        {
+            out << (i % 8 == 0 ? "\n        " : " ") << "0x" << std::hex << std::setw(8) << std::setfill('0') << words[i] << std::dec << ",";
+        }
+        out << "\n    };\n\n";
+
+        if (!descriptors.empty())
+        {
+            out << "    inline const ShaderDescriptorBinding " << prefix << "_DESCRIPTOR_BINDINGS[] = {\n";
+            for (const DescriptorBinding& descriptor : descriptors)
+            {
+                out << "        {" << descriptor.set << ", " << descriptor.binding << ", " << descriptor.descriptorType << ", " << descriptor.descriptorCount << "},\n";
+            }
+            out << "    };\n\n";
+        }
+
+        if (!vertexInputs.empty())
+        {
+            out << "    inline const ShaderVertexInput " << prefix << "_VERTEX_INPUTS[] = {\n";
+            for (const VertexInput& vertexInput : vertexInputs)
+            {
+                out << "        {" << vertexInput.location << ", " << vertexInput.format << ", " << vertexInput.size << "},\n";
+            }
+            out << "    };\n\n";
+        }
+
+        out << "    inline const ShaderReflection " << prefix << " = {\n"
+            << "        \"" << sourceName << "\",\n"
+            << "        " << getStageFlag(module.executionModel) << ",\n"
+            << "        " << prefix << "_CODE,\n"
+            << "        sizeof(" << prefix << "_CODE),\n"
+            << "        " << (descriptors.empty() ? "nullptr" : prefix + "_DESCRIPTOR_BINDINGS") << ",\n"
+            << "        " << descriptors.size() << ",\n"
+            << "        " << (vertexInputs.empty() ? "nullptr" : prefix + "_VERTEX_INPUTS") << ",\n"
+            << "        " << vertexInputs.size() << ",\n"
+            << "        " << pushConstantSize << ",\n"
+            << "    };\n"
+            << "}  // namespace LearnVulkan\n";
+        return out.str();
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 5)
+    {
+        std::cerr << "Usage: ShaderReflect <input.spv> <output.hpp> <Identifier> <source name>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream input(argv[1], std::ios::ate | std::ios::binary);
+    if (!input.is_open())
+    {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+    size_t byteCount = static_cast<size_t>(input.tellg());
+    if (byteCount % sizeof(uint32_t) != 0 || byteCount < 5 * sizeof(uint32_t))
+    {
+        std::cerr << argv[1] << " is not a SPIR-V binary" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<uint32_t> words(byteCount / sizeof(uint32_t));
+    input.seekg(0);
+    input.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(byteCount));
+    if (words[0] != SPIRV_MAGIC)
+    {
+        std::cerr << argv[1] << " has an invalid SPIR-V magic number" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        Module module = parse(words);
+        std::string header = generateHeader(module, words, argv[3], argv[4]);
+
+        std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+        output << header;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << argv[1] << ": " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}